@@ -25,26 +25,51 @@ template<typename CELL, bool USE_CUDA_FUNCTORS = false>
 class construct_functor
 {
 public:
+    /**
+     * If parallel is set, planes (XY-planes in 3D, rows in 2D) are
+     * distributed among OpenMP threads in a static schedule. Pages
+     * will then be first touched by the thread which is likely to
+     * update them later on, which is key to good memory bandwidth
+     * on NUMA machines.
+     */
     construct_functor(
         std::size_t dim_x,
         std::size_t dim_y,
-        std::size_t dim_z) :
+        std::size_t dim_z,
+        bool parallel = false) :
         dim_x(dim_x),
         dim_y(dim_y),
-        dim_z(dim_z)
+        dim_z(dim_z),
+        parallel(parallel)
     {}
 
     template<long DIM_X, long DIM_Y, long DIM_Z, long INDEX>
     void operator()(soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX>& accessor) const
     {
-        for (std::size_t z = 0; z < dim_z; ++z) {
-            for (std::size_t y = 0; y < dim_y; ++y) {
-                accessor.index() = soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX>::gen_index(0, y, z);
-
-                for (std::size_t x = 0; x < dim_x; ++x) {
-                    accessor.construct_members();
-                    ++accessor;
-                }
+        if (!parallel) {
+            for (std::size_t z = 0; z < dim_z; ++z) {
+                construct_plane(accessor, z, 0, dim_y);
+            }
+            return;
+        }
+
+        if (dim_z > 1) {
+            long planes = dim_z;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (long z = 0; z < planes; ++z) {
+                soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX> my_accessor(accessor);
+                construct_plane(my_accessor, z, 0, dim_y);
+            }
+        } else {
+            long rows = dim_y;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static)
+#endif
+            for (long y = 0; y < rows; ++y) {
+                soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX> my_accessor(accessor);
+                construct_plane(my_accessor, 0, y, y + 1);
             }
         }
     }
@@ -53,6 +78,24 @@ private:
     std::size_t dim_x;
     std::size_t dim_y;
     std::size_t dim_z;
+    bool parallel;
+
+    template<long DIM_X, long DIM_Y, long DIM_Z, long INDEX>
+    void construct_plane(
+        soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX>& accessor,
+        std::size_t z,
+        std::size_t start_y,
+        std::size_t end_y) const
+    {
+        for (std::size_t y = start_y; y < end_y; ++y) {
+            accessor.index() = soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX>::gen_index(0, y, z);
+
+            for (std::size_t x = 0; x < dim_x; ++x) {
+                accessor.construct_members();
+                ++accessor;
+            }
+        }
+    }
 };
 
 #ifdef LIBFLATARRAY_WITH_CUDA
@@ -92,10 +135,15 @@ template<typename CELL>
 class construct_functor<CELL, true>
 {
 public:
+    /**
+     * parallel is ignored as construction happens on the device
+     * anyway.
+     */
     construct_functor(
         std::size_t dim_x,
         std::size_t dim_y,
-        std::size_t dim_z) :
+        std::size_t dim_z,
+        bool /* parallel */ = false) :
         dim_x(dim_x),
         dim_y(dim_y),
         dim_z(dim_z)
@@ -69,7 +69,8 @@ public:
         my_dim_x(0),
         my_dim_y(0),
         my_dim_z(0),
-        my_data(0)
+        my_data(0),
+        my_parallel_construction(false)
     {
         resize(dim_x, dim_y, dim_z);
     }
@@ -79,7 +80,8 @@ public:
         my_dim_y(other.my_dim_y),
         my_dim_z(other.my_dim_z),
         my_byte_size(other.byte_size()),
-        my_data(ALLOCATOR().allocate(other.byte_size()))
+        my_data(ALLOCATOR().allocate(other.byte_size())),
+        my_parallel_construction(other.my_parallel_construction)
     {
         init();
         copy_in(other);
@@ -108,6 +110,7 @@ public:
         swap(my_extent_x, other.my_extent_x);
         swap(my_byte_size, other.my_byte_size);
         swap(my_data, other.my_data);
+        swap(my_parallel_construction, other.my_parallel_construction);
         swap(cell_staging_buffer, other.cell_staging_buffer);
         swap(raw_staging_buffer, other.raw_staging_buffer);
     }
@@ -339,6 +342,21 @@ public:
         my_data = new_data;
     }
 
+    /**
+     * If set, subsequent allocations (via resize() or copying) will
+     * construct the elements with multiple OpenMP threads, see
+     * construct_functor.
+     */
+    void set_parallel_construction(bool flag)
+    {
+        my_parallel_construction = flag;
+    }
+
+    bool parallel_construction() const
+    {
+        return my_parallel_construction;
+    }
+
     std::size_t dim_x() const
     {
         return my_dim_x;
@@ -379,6 +397,7 @@ private:
     std::size_t my_byte_size;
     // We can't use std::vector here since the code needs to work with CUDA, too.
     char *my_data;
+    bool my_parallel_construction;
     cell_staging_buffer_type cell_staging_buffer;
     char_staging_buffer_type raw_staging_buffer;
 
@@ -426,7 +445,8 @@ private:
 
     void init()
     {
-        callback(detail::flat_array::construct_functor<value_type, USE_CUDA_FUNCTORS>(my_dim_x, my_dim_y, my_dim_z));
+        callback(detail::flat_array::construct_functor<value_type, USE_CUDA_FUNCTORS>(
+                     my_dim_x, my_dim_y, my_dim_z, my_parallel_construction));
     }
 
     void destroy_and_deallocate()
@@ -0,0 +1,281 @@
+#ifndef LIBGEODECOMP_COMMUNICATION_BINARYSERIALIZATION_H
+#define LIBGEODECOMP_COMMUNICATION_BINARYSERIALIZATION_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+#include <libgeodecomp/storage/fixedarray.h>
+
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+namespace BinarySerializationHelpers {
+
+/**
+ * Checks whether T has a member function serialize(ARCHIVE&,
+ * version), just like Boost.Serialization expects it.
+ */
+template<typename T, typename ARCHIVE, typename ENABLE = void>
+class HasMemberSerialize : public std::false_type
+{};
+
+template<typename T, typename ARCHIVE>
+class HasMemberSerialize<
+    T,
+    ARCHIVE,
+    decltype(void(std::declval<T&>().serialize(std::declval<ARCHIVE&>(), 0)))> : public std::true_type
+{};
+
+}
+
+/**
+ * A lightweight replacement for Boost.Serialization's binary
+ * archives, to be used for ghost zone exchange of cells with
+ * varying payload (e.g. BoxCell or ContainerCell based particle
+ * codes), see APITraits::HasBinarySerialization.
+ *
+ * Objects are appended to a std::vector<char> without any stream
+ * layer in between. Classes with a member function
+ * serialize(ARCHIVE&, unsigned) are traversed member by member,
+ * trivially copyable types are copied bitwise. FixedArray,
+ * std::vector and std::string are written with a size prefix,
+ * followed by their used elements only. There is no support for
+ * pointers, versioning or portability between architectures.
+ */
+class BinaryOArchive
+{
+public:
+    /**
+     * Appends to buffer. Callers should clear() it beforehand, which
+     * retains its capacity for the next transmission.
+     */
+    explicit BinaryOArchive(std::vector<char> *buffer) :
+        buffer(buffer)
+    {}
+
+    template<typename T>
+    inline BinaryOArchive& operator&(const T& object)
+    {
+        save(object);
+        return *this;
+    }
+
+    template<typename T>
+    inline BinaryOArchive& operator<<(const T& object)
+    {
+        save(object);
+        return *this;
+    }
+
+    inline void saveBinary(const void *data, std::size_t size)
+    {
+        const char *begin = static_cast<const char*>(data);
+        buffer->insert(buffer->end(), begin, begin + size);
+    }
+
+private:
+    std::vector<char> *buffer;
+
+    template<typename T>
+    inline void save(const T& object)
+    {
+        save(object, BinarySerializationHelpers::HasMemberSerialize<T, BinaryOArchive>());
+    }
+
+    template<typename T>
+    inline void save(const T& object, std::true_type /* has serialize() */)
+    {
+        const_cast<T&>(object).serialize(*this, 0);
+    }
+
+    template<typename T>
+    inline void save(const T& object, std::false_type /* has serialize() */)
+    {
+        static_assert(
+            std::is_trivially_copyable<T>::value,
+            "BinaryOArchive requires either serialize() or a trivially copyable type");
+        saveBinary(&object, sizeof(T));
+    }
+
+    template<typename T, int SIZE>
+    inline void save(const FixedArray<T, SIZE>& array)
+    {
+        saveElements(array.begin(), array.size());
+    }
+
+    template<typename T, typename ALLOCATOR>
+    inline void save(const std::vector<T, ALLOCATOR>& vec)
+    {
+        saveElements(vec.empty() ? 0 : &vec[0], vec.size());
+    }
+
+    inline void save(const std::string& string)
+    {
+        saveElements(string.data(), string.size());
+    }
+
+    template<typename T, std::size_t SIZE>
+    inline void save(const T (&array)[SIZE])
+    {
+        saveRange(array, SIZE, std::is_trivially_copyable<T>());
+    }
+
+    template<typename T>
+    inline void saveElements(const T *data, std::size_t size)
+    {
+        saveBinary(&size, sizeof(size));
+        saveRange(data, size, std::is_trivially_copyable<T>());
+    }
+
+    template<typename T>
+    inline void saveRange(const T *data, std::size_t size, std::true_type /* trivially copyable */)
+    {
+        saveBinary(data, size * sizeof(T));
+    }
+
+    template<typename T>
+    inline void saveRange(const T *data, std::size_t size, std::false_type /* trivially copyable */)
+    {
+        for (std::size_t i = 0; i < size; ++i) {
+            save(data[i]);
+        }
+    }
+};
+
+/**
+ * Counterpart of BinaryOArchive, reads from a raw memory block.
+ */
+class BinaryIArchive
+{
+public:
+    BinaryIArchive(const char *data, std::size_t size) :
+        cursor(data),
+        end(data + size)
+    {}
+
+    template<typename T>
+    inline BinaryIArchive& operator&(T& object)
+    {
+        load(object);
+        return *this;
+    }
+
+    template<typename T>
+    inline BinaryIArchive& operator>>(T& object)
+    {
+        load(object);
+        return *this;
+    }
+
+    inline void loadBinary(void *data, std::size_t size)
+    {
+        if (size > std::size_t(end - cursor)) {
+            throw std::logic_error("BinaryIArchive: read beyond end of buffer");
+        }
+
+        std::memcpy(data, cursor, size);
+        cursor += size;
+    }
+
+    /**
+     * Number of bytes which haven't been read yet.
+     */
+    inline std::size_t remaining() const
+    {
+        return end - cursor;
+    }
+
+private:
+    const char *cursor;
+    const char *end;
+
+    template<typename T>
+    inline void load(T& object)
+    {
+        load(object, BinarySerializationHelpers::HasMemberSerialize<T, BinaryIArchive>());
+    }
+
+    template<typename T>
+    inline void load(T& object, std::true_type /* has serialize() */)
+    {
+        object.serialize(*this, 0);
+    }
+
+    template<typename T>
+    inline void load(T& object, std::false_type /* has serialize() */)
+    {
+        static_assert(
+            std::is_trivially_copyable<T>::value,
+            "BinaryIArchive requires either serialize() or a trivially copyable type");
+        loadBinary(&object, sizeof(T));
+    }
+
+    template<typename T, int SIZE>
+    inline void load(FixedArray<T, SIZE>& array)
+    {
+        std::size_t size = loadSize();
+        if (size > FixedArray<T, SIZE>::capacity()) {
+            throw std::logic_error("BinaryIArchive: FixedArray capacity exceeded");
+        }
+
+        array = FixedArray<T, SIZE>(size);
+        loadRange(array.begin(), size, std::is_trivially_copyable<T>());
+    }
+
+    template<typename T, typename ALLOCATOR>
+    inline void load(std::vector<T, ALLOCATOR>& vec)
+    {
+        vec.resize(loadSize());
+        loadRange(vec.empty() ? 0 : &vec[0], vec.size(), std::is_trivially_copyable<T>());
+    }
+
+    inline void load(std::string& string)
+    {
+        std::size_t size = loadSize();
+        if (size > remaining()) {
+            throw std::logic_error("BinaryIArchive: read beyond end of buffer");
+        }
+
+        string.assign(cursor, size);
+        cursor += size;
+    }
+
+    template<typename T, std::size_t SIZE>
+    inline void load(T (&array)[SIZE])
+    {
+        loadRange(array, SIZE, std::is_trivially_copyable<T>());
+    }
+
+    inline std::size_t loadSize()
+    {
+        std::size_t size;
+        loadBinary(&size, sizeof(size));
+        return size;
+    }
+
+    template<typename T>
+    inline void loadRange(T *data, std::size_t size, std::true_type /* trivially copyable */)
+    {
+        loadBinary(data, size * sizeof(T));
+    }
+
+    template<typename T>
+    inline void loadRange(T *data, std::size_t size, std::false_type /* trivially copyable */)
+    {
+        for (std::size_t i = 0; i < size; ++i) {
+            load(data[i]);
+        }
+    }
+};
+
+}
+
+#endif
+
+#endif
@@ -38,7 +38,9 @@ public:
         // reserve [100, 199], assuming there won't be more than 100
         // links between any two nodes.
         PATCH_LINK = 100,
-        PARALLEL_MEMORY_WRITER = 200
+        PARALLEL_MEMORY_WRITER = 200,
+        LOAD_MIGRATION = 300,
+        GLOBAL_REDUCTION = 400
     };
 
     typedef std::map<int, std::vector<MPI_Request> > RequestsMap;
@@ -115,6 +117,37 @@ public:
         requests[tag].push_back(req);
     }
 
+    /**
+     * Blocks until a message from src with the given tag is ready to
+     * be received and returns its length in elements of datatype.
+     * This saves senders of variable-sized messages from having to
+     * announce the length in a separate message.
+     */
+    inline int probe(
+        int src,
+        int tag,
+        const MPI_Datatype& datatype)
+    {
+        MPI_Status status;
+        MPI_Probe(src, tag, comm, &status);
+        int count;
+        MPI_Get_count(&status, datatype, &count);
+        return count;
+    }
+
+    /**
+     * Activates a persistent request (as created by MPI_Send_init()
+     * or MPI_Recv_init()). Once started, it can be waited for or
+     * tested like any other request with the same tag. The request
+     * itself remains owned by the caller, who has to free it via
+     * MPI_Request_free().
+     */
+    inline void start(MPI_Request *request, int waitTag)
+    {
+        MPI_Start(request);
+        requests[waitTag].push_back(*request);
+    }
+
     void cancelAll()
     {
         for (RequestsMap::iterator i = requests.begin();
@@ -377,7 +410,39 @@ public:
             comm);
     }
 
-    // fixme: add mpi_allreduce for minighost, add global reduction api for production code
+    /**
+     * Combines the num elements at source from all nodes via op and
+     * stores the result in target on all nodes.
+     */
+    template<typename T>
+    inline void allReduce(
+        const T *source,
+        T *target,
+        int num,
+        MPI_Op op,
+        const MPI_Datatype& datatype = Typemaps::lookup<T>()) const
+    {
+        MPI_Allreduce(const_cast<T*>(source), target, num, datatype, op, comm);
+    }
+
+    /**
+     * Non-blocking variant of allReduce(). The request can be waited
+     * for or tested like any other request with the same tag.
+     * source and target need to stay valid until then.
+     */
+    template<typename T>
+    inline void allReduceNonBlocking(
+        const T *source,
+        T *target,
+        int num,
+        MPI_Op op,
+        int waitTag,
+        const MPI_Datatype& datatype = Typemaps::lookup<T>())
+    {
+        MPI_Request req;
+        MPI_Iallreduce(const_cast<T*>(source), target, num, datatype, op, comm, &req);
+        requests[waitTag].push_back(req);
+    }
 
     template<typename T>
     inline std::vector<T> gather(
@@ -7,6 +7,9 @@
 #include <deque>
 #include <limits>
 #include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/misc/timelinetracer.h>
+#include <libgeodecomp/storage/displacedgrid.h>
+#include <libgeodecomp/storage/gridvecconv.h>
 #include <libgeodecomp/storage/patchaccepter.h>
 #include <libgeodecomp/storage/patchprovider.h>
 #include <libgeodecomp/storage/serializationbuffer.h>
@@ -18,6 +21,17 @@ namespace LibGeoDecomp {
  * remote processes. PatchLink::Accepter takes the patches from a
  * Stepper hands them on to MPI, while PatchLink::Provider will receive
  * the patches from the net and provide then to a Stepper.
+ *
+ * Links with fixed-size payloads reuse persistent MPI requests for
+ * all transmissions. For DisplacedGrids the memory offsets of the
+ * Region's streaks are computed once, so (un)packing the buffer
+ * boils down to a sequence of block copies. Variable-size payloads
+ * (e.g. for cells with APITraits::HasBinarySerialization) are sent
+ * as a single message whose size the receiver determines via
+ * MPI_Probe(). Cells are still copied
+ * to an intermediate buffer as Steppers may overwrite the sent
+ * cells (or read the ghost cells to be received) while a
+ * transmission is in flight.
  */
 template<class GRID_TYPE>
 class PatchLink
@@ -49,12 +63,18 @@ public:
             mpiLayer(communicator),
             region(region),
             buffer(SerializationBuffer<CellType>::create(region)),
-            tag(tag)
+            tag(tag),
+            persistentRequest(MPI_REQUEST_NULL),
+            haveStreakOffsets(false),
+            streakOffsetsUsable(false)
         {}
 
         virtual ~Link()
         {
             wait();
+            if (persistentRequest != MPI_REQUEST_NULL) {
+                MPI_Request_free(&persistentRequest);
+            }
         }
 
         /**
@@ -73,21 +93,136 @@ public:
 
         inline void wait()
         {
+            TimelineTracer::ScopedSpan span("patch_link_wait");
             mpiLayer.wait(tag);
         }
 
+        /**
+         * Many MPI implementations will only advance non-blocking
+         * transmissions (esp. large ones using a rendezvous protocol)
+         * while the application is inside the MPI library. Calling
+         * this function periodically allows us to truly overlap
+         * communication and calculation.
+         */
+        inline void test()
+        {
+            mpiLayer.test(tag);
+        }
+
         inline void cancel()
         {
             mpiLayer.cancelAll();
         }
 
     protected:
+        typedef std::vector<std::pair<std::ptrdiff_t, std::size_t> > StreakOffsets;
+
         std::size_t lastNanoStep;
         long stride;
         MPILayer mpiLayer;
         Region<DIM> region;
         BufferType buffer;
         int tag;
+        MPI_Request persistentRequest;
+        bool haveStreakOffsets;
+        bool streakOffsetsUsable;
+        CoordBox<DIM> streakOffsetsBox;
+        StreakOffsets streakOffsets;
+
+        template<typename GRID, typename BUFFER>
+        void copyOut(const GRID& grid, BUFFER *target)
+        {
+            GridVecConv::gridToVector(grid, target, region);
+        }
+
+        template<typename CELL, typename TOPOLOGY, bool TOPOLOGICALLY_CORRECT>
+        void copyOut(
+            const DisplacedGrid<CELL, TOPOLOGY, TOPOLOGICALLY_CORRECT>& grid,
+            std::vector<CELL> *target)
+        {
+            if (!lookupStreakOffsets(grid)) {
+                GridVecConv::gridToVector(grid, target, region);
+                return;
+            }
+
+            const CELL *base = grid.baseAddress();
+            CELL *dest = &(*target)[0];
+            for (typename StreakOffsets::iterator i = streakOffsets.begin(); i != streakOffsets.end(); ++i) {
+                std::copy(base + i->first, base + i->first + i->second, dest);
+                dest += i->second;
+            }
+        }
+
+        template<typename GRID, typename BUFFER>
+        void copyIn(BUFFER& source, GRID *grid)
+        {
+            GridVecConv::vectorToGrid(source, grid, region);
+        }
+
+        template<typename CELL, typename TOPOLOGY, bool TOPOLOGICALLY_CORRECT>
+        void copyIn(
+            std::vector<CELL>& source,
+            DisplacedGrid<CELL, TOPOLOGY, TOPOLOGICALLY_CORRECT> *grid)
+        {
+            if (!lookupStreakOffsets(*grid)) {
+                GridVecConv::vectorToGrid(source, grid, region);
+                return;
+            }
+
+            CELL *base = grid->baseAddress();
+            const CELL *cursor = &source[0];
+            for (typename StreakOffsets::iterator i = streakOffsets.begin(); i != streakOffsets.end(); ++i) {
+                std::copy(cursor, cursor + i->second, base + i->first);
+                cursor += i->second;
+            }
+        }
+
+        /**
+         * Computes the offsets of all streaks of our Region relative
+         * to the grid's first cell. These remain valid for all grids
+         * sharing the same bounding box, which is the common case
+         * for Steppers alternating between two grids. Returns false
+         * if some streaks can't be mapped to contiguous memory
+         * (e.g. if they need to be wrapped around a torus).
+         */
+        template<typename CELL, typename TOPOLOGY, bool TOPOLOGICALLY_CORRECT>
+        bool lookupStreakOffsets(const DisplacedGrid<CELL, TOPOLOGY, TOPOLOGICALLY_CORRECT>& grid)
+        {
+            CoordBox<DIM> box = grid.boundingBox();
+            if (haveStreakOffsets && (box == streakOffsetsBox)) {
+                return streakOffsetsUsable;
+            }
+
+            haveStreakOffsets = true;
+            streakOffsetsUsable = false;
+            streakOffsetsBox = box;
+            streakOffsets.clear();
+            if (region.empty()) {
+                return false;
+            }
+
+            const CELL *base = grid.baseAddress();
+            for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+                Coord<DIM> last = i->origin;
+                last.x() = i->endX - 1;
+                if (!box.inBounds(i->origin) || !box.inBounds(last)) {
+                    streakOffsets.clear();
+                    return false;
+                }
+
+                std::ptrdiff_t offset = &grid[i->origin] - base;
+                std::size_t length = i->length();
+                if (!streakOffsets.empty() &&
+                    ((streakOffsets.back().first + std::ptrdiff_t(streakOffsets.back().second)) == offset)) {
+                    streakOffsets.back().second += length;
+                } else {
+                    streakOffsets.push_back(std::make_pair(offset, length));
+                }
+            }
+
+            streakOffsetsUsable = true;
+            return true;
+        }
     };
 
     class Accepter :
@@ -96,8 +231,10 @@ public:
     {
     public:
         using Link::buffer;
+        using Link::copyOut;
         using Link::lastNanoStep;
         using Link::mpiLayer;
+        using Link::persistentRequest;
         using Link::region;
         using Link::stride;
         using Link::tag;
@@ -124,6 +261,11 @@ public:
             pushRequest(next);
         }
 
+        virtual void progress()
+        {
+            Link::test();
+        }
+
         virtual void put(
             const GRID_TYPE& grid,
             const Region<DIM>& /*validRegion*/,
@@ -136,9 +278,8 @@ public:
             }
 
             wait();
-            GridVecConv::gridToVector(grid, &buffer, region);
-            sendHeader(FixedSize());
-            mpiLayer.send(&buffer[0], dest, buffer.size(), tag, cellMPIDatatype);
+            copyOut(grid, &buffer);
+            sendPayload(FixedSize());
 
             std::size_t nextNanoStep = (min)(requestedNanoSteps) + stride;
             if ((lastNanoStep == infinity()) ||
@@ -151,22 +292,32 @@ public:
 
     private:
         int dest;
-        int dataSize;
         MPI_Datatype cellMPIDatatype;
 
-        void sendHeader(APITraits::TrueType)
+        void sendPayload(APITraits::TrueType)
         {
-            // we don't need any header for fixed size buffers
+            if (persistentRequest == MPI_REQUEST_NULL) {
+                MPI_Send_init(
+                    &buffer[0],
+                    buffer.size(),
+                    cellMPIDatatype,
+                    dest,
+                    tag,
+                    mpiLayer.communicator(),
+                    &persistentRequest);
+            }
+
+            mpiLayer.start(&persistentRequest, tag);
         }
 
-        void sendHeader(APITraits::FalseType)
+        void sendPayload(APITraits::FalseType)
         {
+            // no header needed, the receiver will probe for the size:
             if (buffer.size() > std::size_t(std::numeric_limits<int>::max())) {
                 throw std::invalid_argument("buffer size exceeds std::numeric_limits<int>::max()");
             }
 
-            dataSize = buffer.size();
-            mpiLayer.send(&dataSize, dest, 1, tag, MPI_INT);
+            mpiLayer.send(&buffer[0], dest, buffer.size(), tag, cellMPIDatatype);
         }
     };
 
@@ -176,8 +327,10 @@ public:
     {
     public:
         using Link::buffer;
+        using Link::copyIn;
         using Link::lastNanoStep;
         using Link::mpiLayer;
+        using Link::persistentRequest;
         using Link::region;
         using Link::stride;
         using Link::tag;
@@ -214,6 +367,11 @@ public:
             recv(next);
         }
 
+        virtual void progress()
+        {
+            Link::test();
+        }
+
         virtual void get(
             GRID_TYPE *grid,
             const Region<DIM>& patchableRegion,
@@ -231,7 +389,7 @@ public:
             recvSecondPart(FixedSize());
             transmissionInFlight = false;
 
-            GridVecConv::vectorToGrid(buffer, grid, region);
+            copyIn(buffer, grid);
 
             std::size_t nextNanoStep = (min)(storedNanoSteps) + stride;
             if ((lastNanoStep == infinity()) ||
@@ -257,12 +415,23 @@ public:
 
         void recvFirstPart(APITraits::TrueType)
         {
-            mpiLayer.recv(&buffer[0], source, buffer.size(), tag, cellMPIDatatype);
+            if (persistentRequest == MPI_REQUEST_NULL) {
+                MPI_Recv_init(
+                    &buffer[0],
+                    buffer.size(),
+                    cellMPIDatatype,
+                    source,
+                    tag,
+                    mpiLayer.communicator(),
+                    &persistentRequest);
+            }
+
+            mpiLayer.start(&persistentRequest, tag);
         }
 
         void recvFirstPart(APITraits::FalseType)
         {
-            mpiLayer.recv(&dataSize, source, 1, tag, MPI_INT);
+            // size is unknown until the message arrives, see recvSecondPart()
         }
 
         void recvSecondPart(APITraits::TrueType)
@@ -272,6 +441,8 @@ public:
 
         void recvSecondPart(APITraits::FalseType)
         {
+            // resize() reuses the capacity of previous transmissions:
+            dataSize = mpiLayer.probe(source, tag, cellMPIDatatype);
             buffer.resize(dataSize);
             mpiLayer.recv(&buffer[0], source, dataSize, tag, cellMPIDatatype);
             wait();
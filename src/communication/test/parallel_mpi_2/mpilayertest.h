@@ -148,6 +148,38 @@ public:
         TS_ASSERT_EQUALS(c, FloatCoord<3>(0.5, 2.0, 3.0));
     }
 
+    void testPersistentRequests()
+    {
+        MPILayer layer;
+        int tag = 4711;
+        int other = 1 - layer.rank();
+        std::vector<double> buffer(3);
+        MPI_Request request;
+
+        if (layer.rank() == 0) {
+            MPI_Send_init(&buffer[0], 3, MPI_DOUBLE, other, tag, layer.communicator(), &request);
+        } else {
+            MPI_Recv_init(&buffer[0], 3, MPI_DOUBLE, other, tag, layer.communicator(), &request);
+        }
+
+        for (int i = 0; i < 4; ++i) {
+            if (layer.rank() == 0) {
+                buffer[0] = i;
+                buffer[1] = i + 0.5;
+                buffer[2] = -i;
+            }
+
+            layer.start(&request, tag);
+            layer.wait(tag);
+
+            TS_ASSERT_EQUALS(buffer[0], i);
+            TS_ASSERT_EQUALS(buffer[1], i + 0.5);
+            TS_ASSERT_EQUALS(buffer[2], -i);
+        }
+
+        MPI_Request_free(&request);
+    }
+
     void testSendRecvRegion()
     {
         MPILayer layer;
@@ -178,6 +210,23 @@ public:
         TS_ASSERT_EQUALS(actual, expected);
     }
 
+    void testAllReduce()
+    {
+        MPILayer layer;
+        double values[] = { layer.rank() + 1.0, -1.0 * layer.rank() };
+        double sums[2];
+        double maxima[2];
+
+        layer.allReduce(values, sums, 2, MPI_SUM);
+        layer.allReduceNonBlocking(values, maxima, 2, MPI_MAX, MPILayer::GLOBAL_REDUCTION);
+        layer.wait(MPILayer::GLOBAL_REDUCTION);
+
+        TS_ASSERT_EQUALS( 3.0, sums[0]);
+        TS_ASSERT_EQUALS(-1.0, sums[1]);
+        TS_ASSERT_EQUALS( 2.0, maxima[0]);
+        TS_ASSERT_EQUALS( 0.0, maxima[1]);
+    }
+
     void testAllGatherV1()
     {
         MPILayer layer;
@@ -51,6 +51,28 @@ public:
     std::vector<int> cargo;
 };
 
+/**
+ * Test model for use with BinaryOArchive/BinaryIArchive
+ */
+class MyBinaryCell
+{
+public:
+    class API : public APITraits::HasBinarySerialization
+    {};
+
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE& archive, unsigned)
+    {
+        archive & x;
+        archive & cargo;
+        archive & name;
+    }
+
+    int x;
+    std::vector<double> cargo;
+    std::string name;
+};
+
 class PatchLinkTest : public CxxTest::TestSuite
 {
 public:
@@ -62,6 +84,7 @@ public:
     typedef SoAGrid<TestCellSoA, Topologies::Cube<3>::Topology> GridType2;
 
     typedef DisplacedGrid<MyComplicatedCell> GridType3;
+    typedef DisplacedGrid<MyBinaryCell> GridType4;
 
     void setUp()
     {
@@ -236,6 +259,30 @@ public:
         }
     }
 
+    void testRepeatedTransmissionsOf3DFrames()
+    {
+        CoordBox<3> box(Coord<3>(2, 3, 4), Coord<3>(8, 7, 6));
+        Region<3> inner;
+        inner << CoordBox<3>(box.origin + Coord<3>::diagonal(1), box.dimensions - Coord<3>::diagonal(2));
+        Region<3> region;
+        region << box;
+        region -= inner;
+
+        checkRepeatedTransmissions<DisplacedGrid<double, Topologies::Cube<3>::Topology> >(box, region);
+    }
+
+    void testRepeatedTransmissionsWrappingAroundTorus()
+    {
+        // streaks outside of the bounding box can't be copied via
+        // precomputed offsets and have to be wrapped around:
+        CoordBox<3> box(Coord<3>(0, 0, 0), Coord<3>(8, 7, 6));
+        Region<3> region;
+        region << CoordBox<3>(Coord<3>(-3, -1, 0), Coord<3>(3, 2, 6));
+        region << CoordBox<3>(Coord<3>(0, 5, 2), Coord<3>(8, 2, 2));
+
+        checkRepeatedTransmissions<DisplacedGrid<double, Topologies::Torus<3>::Topology, true> >(box, region);
+    }
+
     void testSoA()
     {
         Coord<3> dim(30, 20, 10);
@@ -376,6 +423,80 @@ public:
 #endif
     }
 
+    void testBinarySerialization()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        Coord<2> dim(30, 20);
+        CoordBox<2> box(Coord<2>(), dim);
+        Region<2> boxRegion;
+        boxRegion << box;
+
+        GridType4 sendGrid(box);
+        GridType4 recvGrid(box);
+
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            MyBinaryCell cell;
+            cell.x = i->x();
+            cell.cargo = std::vector<double>(i->x() % 5, 0.5 * mpiLayer->rank());
+            cell.name = std::string(i->y(), 'a');
+            sendGrid.set(*i, cell);
+        }
+
+        std::vector<Region<2> > regions(mpiLayer->size());
+        for (int i = 0; i < mpiLayer->size(); ++i) {
+            regions[i] << Streak<2>(Coord<2>(0, i), dim.x());;
+        }
+
+        PatchLink<GridType4>::Accepter accepter(
+            regions[mpiLayer->rank()],
+            0,
+            2702,
+            MPI_CHAR);
+        accepter.charge(4, 8, 4);
+
+        std::vector<SharedPtr<PatchLink<GridType4>::Provider>::Type> providers;
+        if (mpiLayer->rank() == 0) {
+            for (int i = 0; i < mpiLayer->size(); ++i) {
+                providers.push_back(
+                    SharedPtr<PatchLink<GridType4>::Provider>::Type(
+                        new PatchLink<GridType4>::Provider(
+                            regions[i],
+                            i,
+                            2702,
+                            MPI_CHAR)));
+
+                providers.back()->charge(4, 8, 4);
+            }
+        }
+
+        // two transmissions to check that buffers get reused properly:
+        for (int step = 4; step <= 8; step += 4) {
+            accepter.put(sendGrid, boxRegion, dim, step, mpiLayer->rank());
+
+            if (mpiLayer->rank() == 0) {
+                for (int i = 0; i < mpiLayer->size(); ++i) {
+                    providers[i]->get(&recvGrid, boxRegion, dim, step, i);
+                }
+
+                for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+                    MyBinaryCell cell = recvGrid.get(*i);
+
+                    if (i->y() < mpiLayer->size()) {
+                        TS_ASSERT_EQUALS(cell.x, i->x());
+                        TS_ASSERT(cell.cargo == std::vector<double>(i->x() % 5, 0.5 * i->y()));
+                        TS_ASSERT_EQUALS(cell.name, std::string(i->y(), 'a'));
+                    } else {
+                        TS_ASSERT_EQUALS(cell.cargo.size(), std::size_t(0));
+                        TS_ASSERT_EQUALS(cell.name, std::string());
+                    }
+                }
+            }
+
+            accepter.wait();
+        }
+#endif
+    }
+
 private:
     int tag;
 
@@ -408,6 +529,59 @@ private:
     int genTag(int from, int to) {
         return 100 + from * 10 + to;
     }
+
+    /**
+     * Sends the Region around in a ring, alternating between two
+     * grids on each side just like a Stepper would.
+     */
+    template<typename GRID_TYPE>
+    void checkRepeatedTransmissions(const CoordBox<3>& box, const Region<3>& region)
+    {
+        typedef typename PatchLink<GRID_TYPE>::Accepter AccepterType;
+        typedef typename PatchLink<GRID_TYPE>::Provider ProviderType;
+
+        std::size_t maxNanoSteps = 5;
+        int rank = mpiLayer->rank();
+        int next = (rank + 1) % mpiLayer->size();
+        int prev = (rank - 1 + mpiLayer->size()) % mpiLayer->size();
+        Region<3> boxRegion;
+        boxRegion << box;
+
+        AccepterType accepter(region, next, tag, MPI_DOUBLE);
+        ProviderType provider(region, prev, tag, MPI_DOUBLE);
+        accepter.charge(0, maxNanoSteps, 1);
+        provider.charge(0, maxNanoSteps, 1);
+
+        GRID_TYPE emptyGrid(box, -1, -1, box.dimensions);
+        std::vector<GRID_TYPE> sendGrids(2, emptyGrid);
+        std::vector<GRID_TYPE> recvGrids(2, emptyGrid);
+
+        for (std::size_t nanoStep = 0; nanoStep < maxNanoSteps; ++nanoStep) {
+            GRID_TYPE& sendGrid = sendGrids[nanoStep % 2];
+            GRID_TYPE& recvGrid = recvGrids[nanoStep % 2];
+
+            for (typename CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+                sendGrid[*i] = cellValue(*i, rank, nanoStep);
+                recvGrid[*i] = -1;
+            }
+
+            accepter.put(sendGrid, boxRegion, box.dimensions, nanoStep, rank);
+            provider.get(&recvGrid, boxRegion, box.dimensions, nanoStep, rank);
+
+            GRID_TYPE expected = emptyGrid;
+            for (Region<3>::Iterator i = region.begin(); i != region.end(); ++i) {
+                expected[*i] = sendGrid[*i] - cellValue(Coord<3>(), rank, nanoStep) + cellValue(Coord<3>(), prev, nanoStep);
+            }
+            TS_ASSERT_EQUALS(expected, recvGrid);
+        }
+
+        accepter.wait();
+    }
+
+    double cellValue(const Coord<3>& coord, int rank, std::size_t nanoStep)
+    {
+        return coord.x() + coord.y() * 100 + coord.z() * 10000 + rank * 1000000 + nanoStep * 10000000.0;
+    }
 };
 
 }
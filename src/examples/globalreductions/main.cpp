@@ -2,14 +2,12 @@
 
 using namespace LibGeoDecomp;
 
-class TemperatureRecorder;
 class RainMaker;
 
 class BushFireCell
 {
 public:
     friend void runSimulation();
-    friend class TemperatureRecorder;
     friend class RainMaker;
 
     enum State {BURNING, GUTTED};
@@ -224,38 +222,6 @@ private:
     }
 };
 
-class TemperatureRecorder : public Clonable<Writer<BushFireCell>, TemperatureRecorder>
-{
-public:
-    typedef Writer<BushFireCell>::GridType GridType;
-
-    explicit TemperatureRecorder(const unsigned outputPeriod) :
-        Clonable<Writer<BushFireCell>, TemperatureRecorder>("", outputPeriod),
-        avrgTemperature(0)
-    {}
-
-    void stepFinished(const GridType& grid, unsigned step, WriterEvent event)
-    {
-        avrgTemperature = 0;
-
-        CoordBox<2> box = grid.boundingBox();
-        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
-            avrgTemperature += grid.get(*i).temperature;
-        }
-
-        avrgTemperature /= box.dimensions.prod();
-        std::cout << "averageTemperature(" << step << ") = " << avrgTemperature << "\n";
-    }
-
-    double averageTemperature() const
-    {
-        return avrgTemperature;
-    }
-
-private:
-    double avrgTemperature;
-};
-
 class RainMaker : public Steerer<BushFireCell>
 {
 public:
@@ -263,10 +229,10 @@ public:
     using Steerer<BushFireCell>::GridType;
     using Steerer<BushFireCell>::Topology;
 
-    RainMaker(const unsigned ioPeriod, TemperatureRecorder *trigger) :
+    RainMaker(const unsigned ioPeriod, GlobalReduction<BushFireCell> *totalTemperature) :
         Steerer<BushFireCell>(ioPeriod),
         waterAvailable(true),
-        trigger(trigger)
+        totalTemperature(totalTemperature)
     {}
 
     void nextStep(
@@ -279,7 +245,17 @@ public:
         bool lastCall,
         SteererFeedback *feedback)
     {
-        if (waterAvailable && (trigger->averageTemperature() > 250)) {
+        if (!totalTemperature->hasResult()) {
+            return;
+        }
+
+        double averageTemperature = totalTemperature->value() / globalDimensions.prod();
+        if (lastCall && (rank == 0)) {
+            std::cout << "averageTemperature(" << totalTemperature->resultStep() << ") = "
+                      << averageTemperature << "\n";
+        }
+
+        if (waterAvailable && (averageTemperature > 250)) {
             std::cout << "WARNING---------------------------------------------------\n"
                       << "WARNING: initiating rain at time step " << step << "\n"
                       << "WARNING---------------------------------------------------\n";
@@ -302,7 +278,7 @@ public:
 
 private:
     bool waterAvailable;
-    TemperatureRecorder *trigger;
+    GlobalReduction<BushFireCell> *totalTemperature;
 };
 
 void runSimulation()
@@ -324,15 +300,24 @@ void runSimulation()
 
     sim.addWriter(new TracingWriter<BushFireCell>(500, maxSteps));
 
-    TemperatureRecorder *temperatureRecorder = new TemperatureRecorder(100);
-    sim.addWriter(temperatureRecorder);
-    sim.addSteerer(new RainMaker(100, temperatureRecorder));
+    // the reduction needs to be added before the RainMaker so that
+    // the latter sees the most recent result:
+    GlobalReduction<BushFireCell> *totalTemperature = new GlobalReduction<BushFireCell>(
+        Selector<BushFireCell>(&BushFireCell::temperature, "temperature"),
+        GlobalReduction<BushFireCell>::SUM,
+        100);
+    sim.addSteerer(totalTemperature);
+    sim.addSteerer(new RainMaker(100, totalTemperature));
 
     sim.run();
 }
 
 int main(int argc, char **argv)
 {
+    MPI_Init(&argc, &argv);
+
     runSimulation();
+
+    MPI_Finalize();
     return 0;
 }
@@ -58,9 +58,10 @@ public:
     template<typename HOOD_NEW, typename HOOD_OLD>
     static void updateLineX(HOOD_NEW& hoodNew, int indexEnd, HOOD_OLD& hoodOld, unsigned /* nanoStep */)
     {
-        for (int i = hoodOld.index(); i < indexEnd; ++i, ++hoodOld) {
+        double *sumPtr = &hoodNew->sum();
+        for (int i = hoodOld.index(); i < indexEnd / C; ++i, ++hoodOld, sumPtr += C) {
             ShortVec tmp;
-            tmp.load_aligned(&hoodNew->sum() + i * C);
+            tmp.load_aligned(sumPtr);
             for (const auto& j: hoodOld.weights(0)) {
                 ShortVec weights;
                 ShortVec values;
@@ -69,7 +70,7 @@ public:
                 values.gather(&hoodOld->value(), j.first());
                 tmp += values * weights;
             }
-            tmp.store_aligned(&hoodNew->sum() + i * C);
+            tmp.store_aligned(sumPtr);
         }
     }
 
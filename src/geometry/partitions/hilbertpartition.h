@@ -329,11 +329,10 @@ public:
         return Iterator(origin);
     }
 
-    inline Region<2> getRegion(const std::size_t node) const
+protected:
+    void collectStreaks(long begin, long end, StreakVec *streaks) const
     {
-        return Region<2>(
-            (*this)[startOffsets[node + 0]],
-            (*this)[startOffsets[node + 1]]);
+        collectStreaks(origin, dimensions, LL_TO_LR, 0, begin, end, streaks);
     }
 
 private:
@@ -342,6 +341,72 @@ private:
     Coord<2> origin;
     Coord<2> dimensions;
 
+    /**
+     * Adds the intersection of the square (which spans the curve
+     * positions [pos, pos + squareDim.prod()) ) with the section
+     * [begin, end) of the curve. The sub-squares are visited in the
+     * same order as in Iterator::digDownRecursion().
+     */
+    void collectStreaks(
+        const Coord<2>& squareOrigin,
+        const Coord<2>& squareDim,
+        const Form& form,
+        long pos,
+        long begin,
+        long end,
+        StreakVec *streaks) const
+    {
+        long size = squareDim.prod();
+        if ((size == 0) || (pos >= end) || ((pos + size) <= begin)) {
+            return;
+        }
+
+        if ((begin <= pos) && ((pos + size) <= end)) {
+            addBox(CoordBox<2>(squareOrigin, squareDim), streaks);
+            return;
+        }
+
+        long localBegin = (std::max)(begin, pos);
+        long localEnd = (std::min)(end, pos + size);
+        if (isSmall(squareDim)) {
+            addCoords(Iterator(squareOrigin, squareDim, localBegin - pos, form), localEnd - localBegin, streaks);
+            return;
+        }
+
+        Coord<2> halfDimensions = squareDim / 2;
+        Coord<2> restDimensions = squareDim - halfDimensions;
+
+        for (int quarter = 0; quarter < 4; ++quarter) {
+            Coord<2> quarterOrigin = squareOrigin;
+            Coord<2> quarterDim = halfDimensions;
+
+            switch (squareSectorTransitions[form][quarter]) {
+            case 1:
+                quarterOrigin.x() += halfDimensions.x();
+                quarterDim.x() = restDimensions.x();
+                break;
+            case 2:
+                quarterOrigin.y() += halfDimensions.y();
+                quarterDim.y() = restDimensions.y();
+                break;
+            case 3:
+                quarterOrigin += halfDimensions;
+                quarterDim = restDimensions;
+                break;
+            };
+
+            collectStreaks(
+                quarterOrigin,
+                quarterDim,
+                squareFormTransitions[form][quarter],
+                pos,
+                begin,
+                end,
+                streaks);
+            pos += quarterDim.prod();
+        }
+    }
+
     static inline bool fillCaches()
     {
         Coord<2> maxDim(17, 17);
@@ -15,6 +15,8 @@ SharedPtr<HIndexingPartition::CacheType>::Type HIndexingPartition::triangleCoord
 
 std::map<std::pair<Coord<2>, unsigned>, unsigned> HIndexingPartition::triangleLengthCache;
 
+std::map<std::pair<Coord<2>, unsigned>, Region<2> > HIndexingPartition::triangleShapeCache;
+
 bool HIndexingPartition::cachesInitialized = HIndexingPartition::fillCaches();
 
 }
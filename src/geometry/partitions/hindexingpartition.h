@@ -120,10 +120,13 @@ public:
     static SharedPtr<CacheType>::Type triangleCoordsCache;
     static Coord<2> maxCachedDimensions;
     static std::map<std::pair<Coord<2>, unsigned>, unsigned> triangleLengthCache;
+    // (dimensions, type) -> coordinates of the triangle, relative to its origin
+    static std::map<std::pair<Coord<2>, unsigned>, Region<2> > triangleShapeCache;
     static bool cachesInitialized;
 
     class Iterator : public SpaceFillingCurve<2>::Iterator
     {
+        friend class HIndexingPartition;
         friend class HIndexingPartitionTest;
     public:
         /**
@@ -541,16 +544,25 @@ public:
         return Iterator(origin);
     }
 
-    inline Region<2> getRegion(const std::size_t node) const
+    inline Iterator operator[](unsigned pos) const
     {
-        return Region<2>(
-            (*this)[startOffsets[node + 0]],
-            (*this)[startOffsets[node + 1]]);
+        return Iterator(origin, dimensions, pos);
     }
 
-    inline Iterator operator[](unsigned pos) const
+protected:
+    /**
+     * The rectangle consists of two triangles, see
+     * Iterator::Iterator().
+     */
+    void collectStreaks(long begin, long end, StreakVec *streaks) const
     {
-        return Iterator(origin, dimensions, pos);
+        Triangle lower(2, dimensions, origin);
+        Triangle upper(1, dimensions, origin + dimensions);
+        long pos = 0;
+
+        collectStreaks(lower, pos, begin, end, streaks);
+        pos += Iterator::triangleLength(lower);
+        collectStreaks(upper, pos, begin, end, streaks);
     }
 
 private:
@@ -559,6 +571,102 @@ private:
     Coord<2> origin;
     Coord<2> dimensions;
 
+    /**
+     * Adds the intersection of the triangle (which spans the curve
+     * positions [pos, pos + length) ) with the section [begin, end)
+     * of the curve. Triangles which are covered completely are
+     * looked up via triangleShape().
+     */
+    static void collectStreaks(
+        const Triangle& triangle,
+        long pos,
+        long begin,
+        long end,
+        StreakVec *streaks)
+    {
+        long length = Iterator::triangleLength(triangle);
+        if ((length == 0) || (pos >= end) || ((pos + length) <= begin)) {
+            return;
+        }
+
+        if ((begin <= pos) && ((pos + length) <= end)) {
+            const Region<2>& shape = triangleShape(triangle.dimensions, triangle.type);
+            for (Region<2>::StreakIterator i = shape.beginStreak(); i != shape.endStreak(); ++i) {
+                Streak<2> streak = *i;
+                streak.origin += triangle.origin;
+                streak.endX += triangle.origin.x();
+                streaks->push_back(streak);
+            }
+            return;
+        }
+
+        if (isSmall(triangle.dimensions)) {
+            Iterator iter(triangle.origin, triangle.type, triangle.dimensions);
+            for (long i = pos; i < begin; ++i) {
+                ++iter;
+            }
+            addCoords(iter, (std::min)(end, pos + length) - (std::max)(begin, pos), streaks);
+            return;
+        }
+
+        for (unsigned counter = 0; counter < 4; ++counter) {
+            Triangle subTriangle = triangle;
+            subTriangle.counter = counter;
+            Iterator::nextSubTriangle(&subTriangle);
+
+            collectStreaks(subTriangle, pos, begin, end, streaks);
+            pos += Iterator::triangleLength(subTriangle);
+        }
+    }
+
+    /**
+     * Returns the coordinates covered by a triangle of the given
+     * type and dimensions, relative to its origin. Large triangles
+     * are assembled from the shapes of their four sub-triangles, so
+     * only small triangles ever get traversed coordinate by
+     * coordinate.
+     */
+    static const Region<2>& triangleShape(const Coord<2>& dimensions, unsigned type)
+    {
+        std::pair<Coord<2>, unsigned> key(dimensions, type);
+        std::map<std::pair<Coord<2>, unsigned>, Region<2> >::iterator cached = triangleShapeCache.find(key);
+        if (cached != triangleShapeCache.end()) {
+            return cached->second;
+        }
+
+        StreakVec streaks;
+        Triangle triangle(type, dimensions);
+
+        if (isSmall(dimensions)) {
+            addCoords(
+                Iterator(Coord<2>(), type, dimensions),
+                Iterator::triangleLength(triangle),
+                &streaks);
+        } else {
+            for (unsigned counter = 0; counter < 4; ++counter) {
+                Triangle subTriangle = triangle;
+                subTriangle.counter = counter;
+                Iterator::nextSubTriangle(&subTriangle);
+
+                const Region<2>& subShape = triangleShape(subTriangle.dimensions, subTriangle.type);
+                for (Region<2>::StreakIterator i = subShape.beginStreak(); i != subShape.endStreak(); ++i) {
+                    Streak<2> streak = *i;
+                    streak.origin += subTriangle.origin;
+                    streak.endX += subTriangle.origin.x();
+                    streaks.push_back(streak);
+                }
+            }
+        }
+
+        std::sort(streaks.begin(), streaks.end(), StreakOrder());
+        Region<2>& shape = triangleShapeCache[key];
+        for (StreakVec::iterator i = streaks.begin(); i != streaks.end(); ++i) {
+            shape << *i;
+        }
+
+        return shape;
+    }
+
     static inline bool fillCaches()
     {
         // store triangles of at most maxDim in size
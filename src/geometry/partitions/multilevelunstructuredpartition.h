@@ -0,0 +1,621 @@
+#ifndef LIBGEODECOMP_GEOMETRY_PARTITIONS_MULTILEVELUNSTRUCTUREDPARTITION_H
+#define LIBGEODECOMP_GEOMETRY_PARTITIONS_MULTILEVELUNSTRUCTUREDPARTITION_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/geometry/adjacency.h>
+#include <libgeodecomp/geometry/partitions/partition.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Decomposes an unstructured grid with a built-in multilevel graph
+ * partitioner, so no external library (e.g. PT-Scotch) is required.
+ * Unlike the UnstructuredStripingPartition it takes the grid's
+ * connectivity into account and thus yields much smaller edge cuts,
+ * which translate directly into less ghost zone traffic.
+ *
+ * The k subdomains are created by recursive bisection. Each
+ * bisection follows the usual multilevel scheme:
+ *
+ * 1. the graph is coarsened by heavy-edge matching until it's small,
+ * 2. the coarsest graph is bisected by greedy graph growing,
+ * 3. the bisection is projected back to the finer graphs, level by
+ *    level, and improved by a gain-driven boundary refinement.
+ *
+ * Finally the bisection is balanced exactly, so (given that the
+ * weights add up to the number of cells) each node receives exactly
+ * as many cells as its weight specifies.
+ */
+class MultilevelUnstructuredPartition : public Partition<1>
+{
+public:
+    friend class MultilevelUnstructuredPartitionTest;
+
+    using Partition<1>::startOffsets;
+    using Partition<1>::weights;
+    using Partition<1>::AdjacencyPtr;
+
+    MultilevelUnstructuredPartition(
+        const Coord<1> origin,
+        const Coord<1> dimensions,
+        const long offset,
+        const std::vector<std::size_t>& weights,
+        const AdjacencyPtr& adjacency = AdjacencyPtr()) :
+        Partition<1>(offset, weights),
+        regions(weights.size())
+    {
+        if (weights.empty()) {
+            return;
+        }
+
+        Graph graph;
+        buildGraph(origin.x(), dimensions.x(), adjacency, &graph);
+
+        std::vector<int> ids(graph.size());
+        for (int i = 0; i < graph.size(); ++i) {
+            ids[i] = i;
+        }
+
+        std::vector<std::size_t> owners(graph.size(), 0);
+        partition(graph, ids, 0, weights.size(), &owners);
+
+        // ascending IDs allow us to append to the Regions in O(1):
+        for (int i = 0; i < graph.size(); ++i) {
+            regions[owners[i]] << Coord<1>(origin.x() + i);
+        }
+    }
+
+    Region<1> getRegion(const std::size_t node) const
+#ifdef LIBGEODECOMP_WITH_CPP14
+        override
+#endif
+    {
+        return regions.at(node);
+    }
+
+private:
+    /**
+     * Number of vertices at which coarsening stops.
+     */
+    static const int COARSEST_SIZE = 100;
+
+    /**
+     * Upper bound for the number of refinement passes per level.
+     */
+    static const int MAX_REFINEMENT_PASSES = 8;
+
+    /**
+     * Number of start vertices tried for the initial bisection.
+     */
+    static const int GROWING_TRIES = 4;
+
+    typedef std::priority_queue<std::pair<int, int> > GainQueue;
+
+    /**
+     * Undirected graph in compressed sparse row format: the
+     * neighbors of vertex i are stored at indices [xadj[i],
+     * xadj[i + 1]) of adjncy, the corresponding edge weights in
+     * adjwgt. A vertex' weight is the number of cells it represents.
+     */
+    class Graph
+    {
+    public:
+        Graph() :
+            xadj(1, 0)
+        {}
+
+        inline int size() const
+        {
+            return vwgt.size();
+        }
+
+        inline int totalWeight() const
+        {
+            int ret = 0;
+            for (std::vector<int>::const_iterator i = vwgt.begin(); i != vwgt.end(); ++i) {
+                ret += *i;
+            }
+
+            return ret;
+        }
+
+        std::vector<int> xadj;
+        std::vector<int> adjncy;
+        std::vector<int> adjwgt;
+        std::vector<int> vwgt;
+    };
+
+    std::vector<Region<1> > regions;
+
+    /**
+     * The Adjacency may be directed and contain duplicates or self
+     * loops, the partitioner however needs a simple, undirected
+     * graph.
+     */
+    static void buildGraph(int origin, int numCells, const AdjacencyPtr& adjacency, Graph *graph)
+    {
+        std::vector<std::pair<int, int> > edges;
+        std::vector<int> neighbors;
+
+        if (adjacency) {
+            for (int i = 0; i < numCells; ++i) {
+                neighbors.clear();
+                adjacency->getNeighbors(origin + i, &neighbors);
+
+                for (std::vector<int>::iterator j = neighbors.begin(); j != neighbors.end(); ++j) {
+                    int other = *j - origin;
+                    if ((other == i) || (other < 0) || (other >= numCells)) {
+                        continue;
+                    }
+
+                    edges << std::make_pair(i, other)
+                          << std::make_pair(other, i);
+                }
+            }
+        }
+
+        std::sort(edges.begin(), edges.end());
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        graph->vwgt.assign(numCells, 1);
+        graph->xadj.assign(numCells + 1, 0);
+        graph->adjncy.reserve(edges.size());
+        graph->adjwgt.assign(edges.size(), 1);
+
+        for (std::vector<std::pair<int, int> >::iterator i = edges.begin(); i != edges.end(); ++i) {
+            graph->xadj[i->first + 1]++;
+            graph->adjncy << i->second;
+        }
+        for (int i = 0; i < numCells; ++i) {
+            graph->xadj[i + 1] += graph->xadj[i];
+        }
+    }
+
+    /**
+     * Assigns the vertices of graph (whose IDs in the original graph
+     * are given by ids) to the nodes [beginNode, endNode).
+     */
+    void partition(
+        const Graph& graph,
+        const std::vector<int>& ids,
+        std::size_t beginNode,
+        std::size_t endNode,
+        std::vector<std::size_t> *owners) const
+    {
+        if ((endNode - beginNode) == 1) {
+            for (std::vector<int>::const_iterator i = ids.begin(); i != ids.end(); ++i) {
+                (*owners)[*i] = beginNode;
+            }
+            return;
+        }
+
+        std::size_t middleNode = beginNode + (endNode - beginNode) / 2;
+        long long weightLeft = 0;
+        long long weightTotal = 0;
+        for (std::size_t i = beginNode; i < endNode; ++i) {
+            weightTotal += weights[i];
+            if (i < middleNode) {
+                weightLeft += weights[i];
+            }
+        }
+
+        if (weightLeft == weightTotal) {
+            partition(graph, ids, beginNode, middleNode, owners);
+            return;
+        }
+        if (weightLeft == 0) {
+            partition(graph, ids, middleNode, endNode, owners);
+            return;
+        }
+
+        int target = (graph.totalWeight() * weightLeft + weightTotal / 2) / weightTotal;
+        std::vector<char> side;
+        bisect(graph, target, &side);
+
+        for (int s = 0; s < 2; ++s) {
+            Graph subgraph;
+            std::vector<int> subIDs;
+            extract(graph, ids, side, s, &subgraph, &subIDs);
+
+            if (s == 0) {
+                partition(subgraph, subIDs, beginNode, middleNode, owners);
+            } else {
+                partition(subgraph, subIDs, middleNode, endNode, owners);
+            }
+        }
+    }
+
+    /**
+     * Multilevel bisection: side 0 will end up with a total vertex
+     * weight of target, side 1 with the rest.
+     */
+    static void bisect(const Graph& graph, int target, std::vector<char> *side)
+    {
+        // std::deque doesn't invalidate references upon push_back():
+        std::deque<Graph> levels;
+        std::deque<std::vector<int> > maps;
+        const Graph *current = &graph;
+        int maxVertexWeight = (std::max)(1, 3 * graph.totalWeight() / (2 * COARSEST_SIZE));
+
+        while (current->size() > COARSEST_SIZE) {
+            Graph coarse;
+            std::vector<int> map;
+            coarsen(*current, maxVertexWeight, &coarse, &map);
+
+            // stop if matching isn't effective anymore, e.g. because
+            // the graph has hardly any edges:
+            if (coarse.size() > (current->size() * 9 / 10)) {
+                break;
+            }
+
+            levels.push_back(coarse);
+            maps.push_back(map);
+            current = &levels.back();
+        }
+
+        growBisection(*current, target, side);
+
+        while (!levels.empty()) {
+            levels.pop_back();
+            const Graph& finer = levels.empty() ? graph : levels.back();
+            const std::vector<int>& map = maps.back();
+
+            std::vector<char> finerSide(finer.size());
+            for (int i = 0; i < finer.size(); ++i) {
+                finerSide[i] = (*side)[map[i]];
+            }
+            std::swap(*side, finerSide);
+            maps.pop_back();
+
+            refine(finer, target, side);
+        }
+
+        rebalance(graph, target, side);
+    }
+
+    /**
+     * Heavy-edge matching: each vertex is merged with the unmatched
+     * neighbor to which it has the heaviest edge. Vertices of low
+     * degree are visited first as they have the fewest options.
+     */
+    static void coarsen(const Graph& fine, int maxVertexWeight, Graph *coarse, std::vector<int> *map)
+    {
+        int n = fine.size();
+        std::vector<std::pair<int, int> > order;
+        order.reserve(n);
+        for (int v = 0; v < n; ++v) {
+            order << std::make_pair(fine.xadj[v + 1] - fine.xadj[v], v);
+        }
+        std::sort(order.begin(), order.end());
+
+        std::vector<int> match(n, -1);
+        for (std::vector<std::pair<int, int> >::iterator i = order.begin(); i != order.end(); ++i) {
+            int v = i->second;
+            if (match[v] != -1) {
+                continue;
+            }
+
+            int partner = v;
+            int heaviest = 0;
+            for (int e = fine.xadj[v]; e < fine.xadj[v + 1]; ++e) {
+                int u = fine.adjncy[e];
+                if ((match[u] == -1) &&
+                    (fine.adjwgt[e] > heaviest) &&
+                    ((fine.vwgt[v] + fine.vwgt[u]) <= maxVertexWeight)) {
+                    partner = u;
+                    heaviest = fine.adjwgt[e];
+                }
+            }
+
+            match[v] = partner;
+            match[partner] = v;
+        }
+
+        map->assign(n, -1);
+        std::vector<int> members;
+        members.reserve(2 * n);
+        int coarseSize = 0;
+        for (int v = 0; v < n; ++v) {
+            if ((*map)[v] == -1) {
+                (*map)[v] = coarseSize;
+                (*map)[match[v]] = coarseSize;
+                members << v << match[v];
+                ++coarseSize;
+            }
+        }
+
+        // slots[c] holds the index of the edge to coarse vertex c
+        // within the adjacency list currently being assembled:
+        std::vector<int> slots(coarseSize, -1);
+        coarse->xadj.assign(1, 0);
+        coarse->adjncy.clear();
+        coarse->adjwgt.clear();
+        coarse->vwgt.assign(coarseSize, 0);
+
+        for (int c = 0; c < coarseSize; ++c) {
+            for (int m = 0; m < 2; ++m) {
+                int v = members[2 * c + m];
+                if ((m == 1) && (v == members[2 * c])) {
+                    break;
+                }
+
+                coarse->vwgt[c] += fine.vwgt[v];
+                for (int e = fine.xadj[v]; e < fine.xadj[v + 1]; ++e) {
+                    int target = (*map)[fine.adjncy[e]];
+                    if (target == c) {
+                        continue;
+                    }
+
+                    if (slots[target] == -1) {
+                        slots[target] = coarse->adjncy.size();
+                        coarse->adjncy << target;
+                        coarse->adjwgt << fine.adjwgt[e];
+                    } else {
+                        coarse->adjwgt[slots[target]] += fine.adjwgt[e];
+                    }
+                }
+            }
+
+            for (std::size_t e = coarse->xadj.back(); e < coarse->adjncy.size(); ++e) {
+                slots[coarse->adjncy[e]] = -1;
+            }
+            coarse->xadj << int(coarse->adjncy.size());
+        }
+    }
+
+    /**
+     * Reduction of the edge cut if v was moved to the other side.
+     */
+    static inline int gain(const Graph& graph, const std::vector<char>& side, int v)
+    {
+        int ret = 0;
+        for (int e = graph.xadj[v]; e < graph.xadj[v + 1]; ++e) {
+            ret += (side[graph.adjncy[e]] == side[v]) ? -graph.adjwgt[e] : graph.adjwgt[e];
+        }
+
+        return ret;
+    }
+
+    static inline int edgeCut(const Graph& graph, const std::vector<char>& side)
+    {
+        int ret = 0;
+        for (int v = 0; v < graph.size(); ++v) {
+            for (int e = graph.xadj[v]; e < graph.xadj[v + 1]; ++e) {
+                if (side[graph.adjncy[e]] != side[v]) {
+                    ret += graph.adjwgt[e];
+                }
+            }
+        }
+
+        return ret / 2;
+    }
+
+    /**
+     * Initial bisection of the coarsest graph: side 0 is grown from
+     * a start vertex by repeatedly adding the frontier vertex with
+     * the highest gain. Of multiple start vertices the one which
+     * yields the smallest edge cut after refinement wins.
+     */
+    static void growBisection(const Graph& graph, int target, std::vector<char> *side)
+    {
+        int n = graph.size();
+        int tries = (std::min)(n, int(GROWING_TRIES));
+        int bestCut = -1;
+        side->assign(n, 1);
+
+        for (int t = 0; t < tries; ++t) {
+            std::vector<char> candidate(n, 1);
+            GainQueue queue;
+            int weight = 0;
+            int nextUnvisited = 0;
+            queue.push(std::make_pair(0, t * n / tries));
+
+            while (weight < target) {
+                if (queue.empty()) {
+                    // disconnected graph: continue with another component
+                    while (candidate[nextUnvisited] == 0) {
+                        ++nextUnvisited;
+                    }
+                    queue.push(std::make_pair(0, nextUnvisited));
+                }
+
+                int v = queue.top().second;
+                queue.pop();
+                if (candidate[v] == 0) {
+                    continue;
+                }
+
+                candidate[v] = 0;
+                weight += graph.vwgt[v];
+                for (int e = graph.xadj[v]; e < graph.xadj[v + 1]; ++e) {
+                    int u = graph.adjncy[e];
+                    if (candidate[u] == 1) {
+                        queue.push(std::make_pair(gain(graph, candidate, u), u));
+                    }
+                }
+            }
+
+            refine(graph, target, &candidate);
+            int cut = edgeCut(graph, candidate);
+            if ((bestCut == -1) || (cut < bestCut)) {
+                bestCut = cut;
+                std::swap(*side, candidate);
+            }
+        }
+    }
+
+    /**
+     * Greedy boundary refinement: boundary vertices are moved to the
+     * other side in order of decreasing gain as long as this reduces
+     * the edge cut (or keeps it but improves the balance) and the
+     * target side doesn't exceed its weight by more than a small
+     * tolerance.
+     */
+    static void refine(const Graph& graph, int target, std::vector<char> *side)
+    {
+        int n = graph.size();
+        int targets[] = {target, graph.totalWeight() - target};
+        int sideWeights[] = {0, 0};
+        int maxVertexWeight = 1;
+        for (int v = 0; v < n; ++v) {
+            sideWeights[int((*side)[v])] += graph.vwgt[v];
+            maxVertexWeight = (std::max)(maxVertexWeight, graph.vwgt[v]);
+        }
+        int tolerance = (targets[0] + targets[1]) / 33 + maxVertexWeight;
+
+        for (int pass = 0; pass < MAX_REFINEMENT_PASSES; ++pass) {
+            GainQueue queue;
+            for (int v = 0; v < n; ++v) {
+                int g = gain(graph, *side, v);
+                // only boundary vertices may have a gain > -degree:
+                if (g > -(graph.xadj[v + 1] - graph.xadj[v])) {
+                    queue.push(std::make_pair(g, v));
+                }
+            }
+
+            std::vector<char> locked(n, 0);
+            bool moved = false;
+
+            while (!queue.empty()) {
+                int g = queue.top().first;
+                int v = queue.top().second;
+                queue.pop();
+                if (locked[v]) {
+                    continue;
+                }
+
+                // outdated entry? a more recent one has been queued:
+                if (g != gain(graph, *side, v)) {
+                    continue;
+                }
+                if (g < 0) {
+                    break;
+                }
+
+                int from = (*side)[v];
+                int to = 1 - from;
+                if ((g == 0) && (sideWeights[from] <= targets[from])) {
+                    continue;
+                }
+                if ((sideWeights[to] + graph.vwgt[v]) > (targets[to] + tolerance)) {
+                    continue;
+                }
+
+                (*side)[v] = to;
+                sideWeights[from] -= graph.vwgt[v];
+                sideWeights[to] += graph.vwgt[v];
+                locked[v] = 1;
+                moved = true;
+
+                for (int e = graph.xadj[v]; e < graph.xadj[v + 1]; ++e) {
+                    int u = graph.adjncy[e];
+                    if (!locked[u]) {
+                        queue.push(std::make_pair(gain(graph, *side, u), u));
+                    }
+                }
+            }
+
+            if (!moved) {
+                break;
+            }
+        }
+    }
+
+    /**
+     * Moves vertices from the heavier side to the lighter one until
+     * side 0 has exactly the target weight (or as close as the
+     * vertex weights allow), picking those with the highest gain.
+     */
+    static void rebalance(const Graph& graph, int target, std::vector<char> *side)
+    {
+        int n = graph.size();
+        int weight = 0;
+        for (int v = 0; v < n; ++v) {
+            if ((*side)[v] == 0) {
+                weight += graph.vwgt[v];
+            }
+        }
+        if (weight == target) {
+            return;
+        }
+
+        char from = (weight > target) ? 0 : 1;
+        GainQueue queue;
+        for (int v = 0; v < n; ++v) {
+            if ((*side)[v] == from) {
+                queue.push(std::make_pair(gain(graph, *side, v), v));
+            }
+        }
+
+        while ((weight != target) && !queue.empty()) {
+            int g = queue.top().first;
+            int v = queue.top().second;
+            queue.pop();
+            if (((*side)[v] != from) || (g != gain(graph, *side, v))) {
+                continue;
+            }
+
+            int newWeight = weight + ((from == 0) ? -graph.vwgt[v] : graph.vwgt[v]);
+            if (std::abs(newWeight - target) >= std::abs(weight - target)) {
+                continue;
+            }
+
+            (*side)[v] = 1 - from;
+            weight = newWeight;
+            for (int e = graph.xadj[v]; e < graph.xadj[v + 1]; ++e) {
+                int u = graph.adjncy[e];
+                if ((*side)[u] == from) {
+                    queue.push(std::make_pair(gain(graph, *side, u), u));
+                }
+            }
+        }
+    }
+
+    /**
+     * Creates the subgraph induced by all vertices on side s.
+     */
+    static void extract(
+        const Graph& graph,
+        const std::vector<int>& ids,
+        const std::vector<char>& side,
+        char s,
+        Graph *subgraph,
+        std::vector<int> *subIDs)
+    {
+        std::vector<int> newIndices(graph.size(), -1);
+        for (int v = 0; v < graph.size(); ++v) {
+            if (side[v] == s) {
+                newIndices[v] = subIDs->size();
+                *subIDs << ids[v];
+            }
+        }
+
+        for (int v = 0; v < graph.size(); ++v) {
+            if (side[v] != s) {
+                continue;
+            }
+
+            for (int e = graph.xadj[v]; e < graph.xadj[v + 1]; ++e) {
+                int u = graph.adjncy[e];
+                if (side[u] == s) {
+                    subgraph->adjncy << newIndices[u];
+                    subgraph->adjwgt << graph.adjwgt[e];
+                }
+            }
+
+            subgraph->vwgt << graph.vwgt[v];
+            subgraph->xadj << int(subgraph->adjncy.size());
+        }
+    }
+};
+
+}
+
+#endif
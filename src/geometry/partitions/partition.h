@@ -2,6 +2,7 @@
 #define LIBGEODECOMP_GEOMETRY_PARTITIONS_PARTITION_H
 
 #include <libgeodecomp/geometry/adjacency.h>
+#include <libgeodecomp/geometry/coordbox.h>
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/misc/sharedptr.h>
 #include <libgeodecomp/misc/stdcontaineroverloads.h>
@@ -52,6 +53,17 @@ public:
 
     virtual Region<DIM> getRegion(const std::size_t node) const = 0;
 
+    /**
+     * Returns the bounding box of getRegion(node). Derived classes
+     * should override this if they can compute it without
+     * constructing the Region, as this is meant as a cheap test
+     * whether two nodes could possibly be neighbors.
+     */
+    virtual CoordBox<DIM> getBoundingBox(const std::size_t node) const
+    {
+        return getRegion(node).boundingBox();
+    }
+
 protected:
     std::vector<std::size_t> weights;
     std::vector<std::size_t> startOffsets;
@@ -2,9 +2,14 @@
 #define LIBGEODECOMP_GEOMETRY_PARTITIONS_SPACEFILLINGCURVE_H
 
 #include <libgeodecomp/geometry/coord.h>
+#include <libgeodecomp/geometry/coordbox.h>
 #include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/geometry/streak.h>
 #include <libgeodecomp/geometry/partitions/partition.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace LibGeoDecomp {
 
 enum SpaceFillingCurveSublevelState {TRIVIAL, CACHED};
@@ -13,11 +18,19 @@ enum SpaceFillingCurveSublevelState {TRIVIAL, CACHED};
  * This base class for space-filling curves (SFCs) in LibGeoDecomp
  * aggregates some common functionality to reduce code duplication.
  * It's not useful by itself, only by the classes inheriting from it.
+ *
+ * Regions are not built by walking the curve one Coord at a time.
+ * Instead derived classes implement collectStreaks(), which follows
+ * the curve's recursive decomposition. Any sub-square which lies
+ * completely within the requested section of the curve is added
+ * as a whole. Only the (few and small) squares at either end of the
+ * section need to be traversed coordinate by coordinate.
  */
 template<int DIM>
 class SpaceFillingCurve : public Partition<DIM>
 {
 public:
+    typedef std::vector<Streak<DIM> > StreakVec;
 
     class Iterator
     {
@@ -67,6 +80,97 @@ public:
         const std::vector<std::size_t>& weights) :
         Partition<DIM>(offset, weights)
     {}
+
+    inline Region<DIM> getRegion(const std::size_t node) const
+    {
+        StreakVec streaks;
+        collectStreaks(startOffsets[node], startOffsets[node + 1], &streaks);
+        std::sort(streaks.begin(), streaks.end(), StreakOrder());
+
+        // sorted Streaks can be appended to the Region in O(1):
+        Region<DIM> ret;
+        for (typename StreakVec::iterator i = streaks.begin(); i != streaks.end(); ++i) {
+            ret << *i;
+        }
+
+        return ret;
+    }
+
+    inline CoordBox<DIM> getBoundingBox(const std::size_t node) const
+    {
+        StreakVec streaks;
+        collectStreaks(startOffsets[node], startOffsets[node + 1], &streaks);
+        if (streaks.empty()) {
+            return CoordBox<DIM>();
+        }
+
+        Coord<DIM> lower = streaks[0].origin;
+        Coord<DIM> upper = streaks[0].origin;
+        for (typename StreakVec::iterator i = streaks.begin(); i != streaks.end(); ++i) {
+            Coord<DIM> last = i->origin;
+            last.x() = i->endX - 1;
+            lower = (lower.min)(i->origin);
+            upper = (upper.max)(last);
+        }
+
+        return CoordBox<DIM>(lower, upper - lower + Coord<DIM>::diagonal(1));
+    }
+
+protected:
+    using Partition<DIM>::startOffsets;
+
+    /**
+     * Orders Streaks the same way Region stores them.
+     */
+    class StreakOrder
+    {
+    public:
+        inline bool operator()(const Streak<DIM>& a, const Streak<DIM>& b) const
+        {
+            for (int d = DIM - 1; d > 0; --d) {
+                if (a.origin[d] != b.origin[d]) {
+                    return a.origin[d] < b.origin[d];
+                }
+            }
+
+            return a.origin.x() < b.origin.x();
+        }
+    };
+
+    /**
+     * Appends the Streaks which make up the section [begin, end)
+     * of the curve to streaks, in no particular order.
+     */
+    virtual void collectStreaks(long begin, long end, StreakVec *streaks) const = 0;
+
+    /**
+     * Threshold below which a square which is only partially covered
+     * by a section of the curve gets traversed by an Iterator instead
+     * of being subdivided further.
+     */
+    static inline bool isSmall(const Coord<DIM>& dimensions)
+    {
+        return Iterator::hasTrivialDimensions(dimensions) || (dimensions.prod() <= 256);
+    }
+
+    static inline void addBox(const CoordBox<DIM>& box, StreakVec *streaks)
+    {
+        for (typename CoordBox<DIM>::StreakIterator i = box.beginStreak(); i != box.endStreak(); ++i) {
+            streaks->push_back(*i);
+        }
+    }
+
+    /**
+     * Adds count coordinates, starting at the current position of
+     * iter, as Streaks of length 1 (they'll get fused by the Region).
+     */
+    template<typename ITERATOR>
+    static inline void addCoords(ITERATOR iter, long count, StreakVec *streaks)
+    {
+        for (long i = 0; i < count; ++i, ++iter) {
+            streaks->push_back(Streak<DIM>(*iter, iter->x() + 1));
+        }
+    }
 };
 
 }
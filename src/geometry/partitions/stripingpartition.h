@@ -54,19 +54,29 @@ public:
         return Iterator(origin, origin + endOffset, dimensions);
     }
 
-    inline Region<DIM> getRegion(const std::size_t node) const
-    {
-        return Region<DIM>(
-            (*this)[startOffsets[node + 0]],
-            (*this)[startOffsets[node + 1]]);
-    }
-
     Iterator operator[](unsigned pos) const
     {
         Coord<DIM> cursor = dimensions.indexToCoord(pos) + origin;
         return Iterator(origin, cursor, dimensions);
     }
 
+protected:
+    typedef typename SpaceFillingCurve<DIM>::StreakVec StreakVec;
+
+    /**
+     * Each (partial) row along the x-axis makes up one Streak.
+     */
+    void collectStreaks(long begin, long end, StreakVec *streaks) const
+    {
+        for (long pos = begin; pos < end;) {
+            Coord<DIM> cursor = dimensions.indexToCoord(pos);
+            long rowEnd = (std::min)(end, pos + dimensions.x() - cursor.x());
+            cursor += origin;
+
+            streaks->push_back(Streak<DIM>(cursor, cursor.x() + rowEnd - pos));
+            pos = rowEnd;
+        }
+    }
 
 private:
     using SpaceFillingCurve<DIMENSIONS>::startOffsets;
@@ -144,6 +144,37 @@ public:
         sort(actual);
         TS_ASSERT_EQUALS(expectedSorted, actual);
     }
+    void testGetRegionAndBoundingBox()
+    {
+        checkRegions(Coord<2>(10, 20), Coord<2>(4, 4));
+        checkRegions(Coord<2>(-3, 5),  Coord<2>(37, 91));
+        checkRegions(Coord<2>(0, 0),   Coord<2>(200, 1));
+        checkRegions(Coord<2>(5, 5),   Coord<2>(300, 250));
+    }
+
+
+    void checkRegions(const Coord<2>& origin, const Coord<2>& dimensions)
+    {
+        std::size_t size = dimensions.prod();
+        std::vector<std::size_t> weights;
+        weights << size / 7
+                << 0
+                << size / 3
+                << 1
+                << size / 5;
+        weights << size - sum(weights);
+
+        HilbertPartition p(origin, dimensions, 0, weights);
+        long start = 0;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            long end = start + weights[i];
+            Region<2> expected(p[start], p[end]);
+
+            TS_ASSERT_EQUALS(expected, p.getRegion(i));
+            TS_ASSERT_EQUALS(expected.boundingBox(), p.getBoundingBox(i));
+            start = end;
+        }
+    }
 
 private:
     HilbertPartition partition;
@@ -203,6 +203,49 @@ public:
 
         TS_ASSERT_EQUALS(expected, actual);
     }
+
+    void testGetRegionAndBoundingBox()
+    {
+        checkRegions(Coord<2>(10, 20), Coord<2>(4, 4));
+        checkRegions(Coord<2>(10, 20), Coord<2>(30, 20));
+        checkRegions(Coord<2>(-3, 5),  Coord<2>(37, 91));
+        checkRegions(Coord<2>(0, 0),   Coord<2>(200, 1));
+        checkRegions(Coord<2>(5, 5),   Coord<2>(300, 250));
+    }
+
+private:
+    void checkRegions(const Coord<2>& origin, const Coord<2>& dimensions)
+    {
+        std::size_t size = dimensions.prod();
+        std::vector<std::size_t> weights;
+        weights << size / 7
+                << 0
+                << size / 3
+                << 1
+                << size / 5;
+        weights << size - sum(weights);
+
+        HIndexingPartition p(origin, dimensions, 0, weights);
+        CoordVector coords;
+        for (HIndexingPartition::Iterator i = p.begin(); i != p.end(); ++i) {
+            coords << *i;
+        }
+
+        // operator[] can't be used here as it won't work for
+        // rectangles of height 1:
+        long start = 0;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            long end = start + weights[i];
+            Region<2> expected;
+            for (long j = start; j < end; ++j) {
+                expected << coords[j];
+            }
+
+            TS_ASSERT_EQUALS(expected, p.getRegion(i));
+            TS_ASSERT_EQUALS(expected.boundingBox(), p.getBoundingBox(i));
+            start = end;
+        }
+    }
 };
 
 }
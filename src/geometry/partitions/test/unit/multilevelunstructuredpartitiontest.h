@@ -0,0 +1,157 @@
+#include <libgeodecomp/geometry/partitions/multilevelunstructuredpartition.h>
+#include <libgeodecomp/geometry/partitions/unstructuredstripingpartition.h>
+#include <libgeodecomp/geometry/regionbasedadjacency.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class MultilevelUnstructuredPartitionTest : public CxxTest::TestSuite
+{
+public:
+    typedef SharedPtr<Adjacency>::Type AdjacencyPtr;
+
+    void setUp()
+    {
+        // a 32x32 mesh with a 5-point stencil, but the IDs of its
+        // nodes are scrambled so that a naive striping yields
+        // terrible edge cuts:
+        dim = Coord<2>(32, 32);
+        numCells = dim.prod();
+        mesh.reset(new RegionBasedAdjacency);
+
+        for (int y = 0; y < dim.y(); ++y) {
+            for (int x = 0; x < dim.x(); ++x) {
+                std::vector<int> neighbors;
+                if (x > 0) {
+                    neighbors << id(x - 1, y);
+                }
+                if (x < (dim.x() - 1)) {
+                    neighbors << id(x + 1, y);
+                }
+                if (y > 0) {
+                    neighbors << id(x, y - 1);
+                }
+                if (y < (dim.y() - 1)) {
+                    neighbors << id(x, y + 1);
+                }
+
+                static_cast<RegionBasedAdjacency&>(*mesh).insert(id(x, y), neighbors);
+            }
+        }
+    }
+
+    void testEdgeCut()
+    {
+        std::vector<std::size_t> weights(4, numCells / 4);
+
+        MultilevelUnstructuredPartition partition(Coord<1>(0), Coord<1>(numCells), 0, weights, mesh);
+        UnstructuredStripingPartition striping(Coord<1>(0), Coord<1>(numCells), 0, weights);
+        checkCoverage(partition, weights, 0);
+
+        // the optimum is 64 (two straight cuts):
+        std::size_t cut = edgeCut(partition, weights.size());
+        TS_ASSERT_LESS_THAN(cut, std::size_t(100));
+        TS_ASSERT_LESS_THAN(cut * 5, edgeCut(striping, weights.size()));
+    }
+
+    void testUnevenWeights()
+    {
+        std::vector<std::size_t> weights;
+        weights << 100
+                << 0
+                << 500
+                << 1
+                << 423;
+
+        MultilevelUnstructuredPartition partition(Coord<1>(0), Coord<1>(numCells), 0, weights, mesh);
+        checkCoverage(partition, weights, 0);
+    }
+
+    void testManyNodes()
+    {
+        std::vector<std::size_t> weights;
+        for (int i = 0; i < 13; ++i) {
+            weights << 78;
+        }
+        weights << numCells - sum(weights);
+
+        MultilevelUnstructuredPartition partition(Coord<1>(0), Coord<1>(numCells), 0, weights, mesh);
+        checkCoverage(partition, weights, 0);
+    }
+
+    void testWithoutEdges()
+    {
+        std::vector<std::size_t> weights;
+        weights << 70
+                << 30;
+
+        MultilevelUnstructuredPartition partition(Coord<1>(50), Coord<1>(100), 0, weights);
+        checkCoverage(partition, weights, 50);
+    }
+
+    void testSingleDomain()
+    {
+        std::vector<std::size_t> weights(1, numCells);
+        MultilevelUnstructuredPartition partition(Coord<1>(0), Coord<1>(numCells), 0, weights, mesh);
+
+        Region<1> expected;
+        expected << Streak<1>(Coord<1>(0), numCells);
+        TS_ASSERT_EQUALS(expected, partition.getRegion(0));
+    }
+
+private:
+    Coord<2> dim;
+    int numCells;
+    AdjacencyPtr mesh;
+
+    int id(int x, int y) const
+    {
+        // 389 is coprime to 1024, so this is a permutation:
+        return ((y * dim.x() + x) * 389) % numCells;
+    }
+
+    void checkCoverage(const Partition<1>& partition, const std::vector<std::size_t>& weights, int origin)
+    {
+        Region<1> all;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            Region<1> region = partition.getRegion(i);
+            TS_ASSERT_EQUALS(weights[i], region.size());
+            TS_ASSERT((all & region).empty());
+            all += region;
+        }
+
+        Region<1> expected;
+        expected << Streak<1>(Coord<1>(origin), origin + sum(weights));
+        TS_ASSERT_EQUALS(expected, all);
+    }
+
+    std::size_t edgeCut(const Partition<1>& partition, std::size_t numNodes)
+    {
+        std::vector<std::size_t> owners(numCells);
+        for (std::size_t i = 0; i < numNodes; ++i) {
+            Region<1> region = partition.getRegion(i);
+            for (Region<1>::Iterator j = region.begin(); j != region.end(); ++j) {
+                owners[j->x()] = i;
+            }
+        }
+
+        std::size_t ret = 0;
+        for (int i = 0; i < numCells; ++i) {
+            std::vector<int> neighbors;
+            mesh->getNeighbors(i, &neighbors);
+            for (std::vector<int>::iterator j = neighbors.begin(); j != neighbors.end(); ++j) {
+                if (owners[i] != owners[*j]) {
+                    ++ret;
+                }
+            }
+        }
+
+        // each edge was counted twice:
+        return ret / 2;
+    }
+};
+
+}
@@ -186,6 +186,39 @@ public:
         largeTest(Coord<3>(50, 8, 8));
     }
 
+    void testGetRegionAndBoundingBox()
+    {
+        checkRegions(Coord<2>(10, 20), Coord<2>(4, 4));
+        checkRegions(Coord<2>(-3, 5),  Coord<2>(37, 91));
+        checkRegions(Coord<2>(0, 0),   Coord<2>(200, 1));
+        checkRegions(Coord<3>(1, 2, 3), Coord<3>(17, 23, 29));
+        checkRegions(Coord<3>(0, 0, 0), Coord<3>(64, 5, 31));
+    }
+
+
+    template<int DIM>
+    void checkRegions(const Coord<DIM>& origin, const Coord<DIM>& dimensions)
+    {
+        std::size_t size = dimensions.prod();
+        std::vector<std::size_t> weights;
+        weights << size / 7
+                << 0
+                << size / 3
+                << 1
+                << size / 5;
+        weights << size - sum(weights);
+
+        ZCurvePartition<DIM> p(origin, dimensions, 0, weights);
+        long start = 0;
+        for (std::size_t i = 0; i < weights.size(); ++i) {
+            long end = start + weights[i];
+            Region<DIM> expected(p[start], p[end]);
+
+            TS_ASSERT_EQUALS(expected, p.getRegion(i));
+            TS_ASSERT_EQUALS(expected.boundingBox(), p.getBoundingBox(i));
+            start = end;
+        }
+    }
 
 private:
     ZCurvePartition<2> partition;
@@ -302,13 +302,6 @@ public:
         return Iterator(origin);
     }
 
-    inline Region<DIM> getRegion(const std::size_t node) const
-    {
-        return Region<DIM>(
-            (*this)[startOffsets[node + 0]],
-            (*this)[startOffsets[node + 1]]);
-    }
-
     static inline bool fillCaches()
     {
         // store squares of at most maxDim in size. the division by
@@ -334,8 +327,68 @@ public:
         return true;
     }
 
+protected:
+    typedef typename SpaceFillingCurve<DIM>::StreakVec StreakVec;
+
+    void collectStreaks(long begin, long end, StreakVec *streaks) const
+    {
+        collectStreaks(origin, dimensions, 0, begin, end, streaks);
+    }
+
 private:
     using SpaceFillingCurve<DIM>::startOffsets;
+    using SpaceFillingCurve<DIM>::isSmall;
+    using SpaceFillingCurve<DIM>::addBox;
+    using SpaceFillingCurve<DIM>::addCoords;
+
+    /**
+     * Adds the intersection of the square (which spans the curve
+     * positions [pos, pos + squareDim.prod()) ) with the section
+     * [begin, end) of the curve. Quadrants are visited in the same
+     * order as in Iterator::digDownRecursion().
+     */
+    void collectStreaks(
+        const Coord<DIM>& squareOrigin,
+        const Coord<DIM>& squareDim,
+        long pos,
+        long begin,
+        long end,
+        StreakVec *streaks) const
+    {
+        long size = squareDim.prod();
+        if ((size == 0) || (pos >= end) || ((pos + size) <= begin)) {
+            return;
+        }
+
+        if ((begin <= pos) && ((pos + size) <= end)) {
+            addBox(CoordBox<DIM>(squareOrigin, squareDim), streaks);
+            return;
+        }
+
+        long localBegin = (std::max)(begin, pos);
+        long localEnd = (std::min)(end, pos + size);
+        if (isSmall(squareDim)) {
+            addCoords(Iterator(squareOrigin, squareDim, localBegin - pos), localEnd - localBegin, streaks);
+            return;
+        }
+
+        Coord<DIM> halfDimensions = squareDim / 2;
+        Coord<DIM> remainingDimensions = squareDim - halfDimensions;
+
+        for (int i = 0; i < Iterator::NUM_QUADRANTS; ++i) {
+            std::bitset<DIM> quadrantShift(i);
+            Coord<DIM> quadrantOrigin = squareOrigin;
+            Coord<DIM> quadrantDim;
+
+            for (int d = 0; d < DIM; ++d) {
+                quadrantDim[d] = quadrantShift[d]? remainingDimensions[d] : halfDimensions[d];
+                quadrantOrigin[d] += quadrantShift[d]? halfDimensions[d] : 0;
+            }
+
+            collectStreaks(quadrantOrigin, quadrantDim, pos, begin, end, streaks);
+            pos += quadrantDim.prod();
+        }
+    }
 
     static Cache coordsCache;
     static Coord<DIMENSIONS> maxCachedDimensions;
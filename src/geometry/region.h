@@ -8,6 +8,8 @@
 #include <libgeodecomp/misc/stdcontaineroverloads.h>
 #include <libgeodecomp/storage/selector.h>
 
+#include <limits>
+
 namespace LibGeoDecomp {
 
 template<typename CELL_TYPE, int DIM>
@@ -724,23 +726,16 @@ public:
             RegionHelpers::AddCoord,
             STENCIL>()(&stencil);
 
-        Region accumulator;
-        Region current;
-
+        std::vector<std::pair<StreakIterator, StreakIterator> > sources;
         for (StreakIterator i = stencil.beginStreak(); i != stencil.endStreak(); ++i) {
-            merge2way(
-                accumulator,
-                current.beginStreak(),
-                current.endStreak(),
-                beginStreak(i->origin, i->length() - 1),
-                endStreak(  i->origin, i->length() - 1));
-
-            current.clear();
-            using std::swap;
-            swap(current, accumulator);
+            sources.push_back(std::make_pair(
+                                  beginStreak(i->origin, i->length() - 1),
+                                  endStreak(  i->origin, i->length() - 1)));
         }
 
-        return current;
+        Region ret;
+        mergeKway(ret, &sources);
+        return ret;
     }
 
     /**
@@ -898,7 +893,9 @@ public:
 #endif
 #endif
 
-        RegionHelpers::RegionInsertHelper<DIM - 1>()(this, s);
+        if (!append(s)) {
+            RegionHelpers::RegionInsertHelper<DIM - 1>()(this, s);
+        }
         geometryCacheTainted = true;
         return *this;
     }
@@ -964,6 +961,10 @@ public:
     inline void operator-=(const Region& other)
     {
         using std::swap;
+        if (empty() || other.empty() || !boundingBox().intersects(other.boundingBox())) {
+            return;
+        }
+
         Region newValue = *this - other;
         swap(newValue, *this);
     }
@@ -982,7 +983,7 @@ public:
         if (this->empty()) {
             return ret;
         }
-        if (other.empty()) {
+        if (other.empty() || !boundingBox().intersects(other.boundingBox())) {
             return *this;
         }
 
@@ -992,6 +993,10 @@ public:
         StreakIterator myEnd = endStreak();
         StreakIterator otherEnd = other.endStreak();
 
+        // all of our Streaks end up in the result anyway, but we may
+        // skip over those of the other Region which are not relevant:
+        bool gallopOther = other.numStreaks() > (GALLOP_RATIO * numStreaks());
+
         Streak<DIM> cursor = *myIter;
 
         for (;;) {
@@ -1013,7 +1018,11 @@ public:
                     cursor = *myIter;
                 }
             } else {
-                ++otherIter;
+                if (gallopOther && rowLessThan(*otherIter, cursor)) {
+                    otherIter = other.firstStreakInRowOf(cursor);
+                } else {
+                    ++otherIter;
+                }
                 if (otherIter == otherEnd) {
                     break;
                 }
@@ -1034,8 +1043,9 @@ public:
 
     inline void operator&=(const Region& other)
     {
-        Region intersection = other & *this;
-        *this = intersection;
+        using std::swap;
+        Region intersection = *this & other;
+        swap(intersection, *this);
     }
 
     /**
@@ -1046,12 +1056,21 @@ public:
         using std::max;
         using std::min;
         Region ret;
+        if (empty() || other.empty() || !boundingBox().intersects(other.boundingBox())) {
+            return ret;
+        }
+
         StreakIterator myIter = beginStreak();
         StreakIterator otherIter = other.beginStreak();
 
         StreakIterator myEnd = endStreak();
         StreakIterator otherEnd = other.endStreak();
 
+        // if one Region is much larger than the other, we'll skip
+        // over the rows which can't possibly intersect:
+        bool gallopMine  = numStreaks() > (GALLOP_RATIO * other.numStreaks());
+        bool gallopOther = other.numStreaks() > (GALLOP_RATIO * numStreaks());
+
         for (;;) {
             if ((myIter == myEnd) ||
                 (otherIter == otherEnd)) {
@@ -1066,9 +1085,17 @@ public:
             }
 
             if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*myIter, *otherIter)) {
-                ++myIter;
+                if (gallopMine && rowLessThan(*myIter, *otherIter)) {
+                    myIter = firstStreakInRowOf(*otherIter);
+                } else {
+                    ++myIter;
+                }
             } else {
-                ++otherIter;
+                if (gallopOther && rowLessThan(*otherIter, *myIter)) {
+                    otherIter = other.firstStreakInRowOf(*myIter);
+                } else {
+                    ++otherIter;
+                }
             }
         }
 
@@ -1329,20 +1356,17 @@ public:
             }
 
             // another special case: the current component exceeds all
-            // components in the Region's current level. Solution: dig
-            // down on the current position return the iterator one
-            // past the current position:
+            // components in the Region's current level. Solution: the
+            // first Streak beneath cursor (which belongs to the next
+            // node on the higher levels) is the one we're looking
+            // for. We can't reuse offsets here as the indices on the
+            // higher levels would be off by one:
             if (cursor == iter2) {
-                --offsets[d];
-                --d;
-                for (; d >= 0; --d) {
-                    offsets[d] = cursor->first;
-                    cursor = indices[d].begin() + cursor->second - 1;
+                for (; d > 0; --d) {
+                    cursor = indices[d - 1].begin() + cursor->second;
                 }
 
-                StreakIterator ret = (*this)[offsets];
-                ++ret;
-                return ret;
+                return (*this)[std::size_t(cursor - indices[0].begin())];
             }
 
             // we have to quit here if we're on the last level as the
@@ -1394,6 +1418,144 @@ private:
                 break;                             \
             }
 
+    /**
+     * Skipping ahead via streakIteratorOnOrAfter() costs a couple of
+     * binary searches. It only pays off if one operand has way more
+     * Streaks than the other.
+     */
+    static const std::size_t GALLOP_RATIO = 8;
+
+    /**
+     * Fast path for building Regions from sorted Streaks (as
+     * generated by the set operations below): if s doesn't precede
+     * the last Streak of this Region, it can be appended to the index
+     * vectors in O(DIM) (amortized) without any searches. Returns
+     * false if s needs to be inserted via the general path.
+     */
+    inline bool append(const Streak<DIM>& s)
+    {
+        using std::max;
+
+        if (indices[0].empty()) {
+            for (int d = DIM - 1; d > 0; --d) {
+                indices[d] << IntPair(s.origin[d], 0);
+            }
+            indices[0] << IntPair(s.origin.x(), s.endX);
+            return true;
+        }
+
+        for (int d = DIM - 1; d > 0; --d) {
+            int last = indices[d].back().first;
+
+            if (s.origin[d] < last) {
+                return false;
+            }
+
+            if (s.origin[d] > last) {
+                // s opens a new row (or plane...), so we need new
+                // entries on all levels below d:
+                for (int e = d; e > 0; --e) {
+                    indices[e] << IntPair(s.origin[e], indices[e - 1].size());
+                }
+                indices[0] << IntPair(s.origin.x(), s.endX);
+                return true;
+            }
+        }
+
+        IntPair& lastStreak = indices[0].back();
+        if (s.origin.x() > lastStreak.second) {
+            indices[0] << IntPair(s.origin.x(), s.endX);
+            return true;
+        }
+
+        // s touches the last Streak, but can't reach any prior Streak
+        // in the same row (they'd have been fused otherwise):
+        if (s.origin.x() >= lastStreak.first) {
+            lastStreak.second = max(lastStreak.second, s.endX);
+            return true;
+        }
+
+        return false;
+    }
+
+    /**
+     * Orders Streaks by their origin (starting with the slowest
+     * dimension). Merging in this order ensures that each Streak can
+     * be appended to the result.
+     */
+    static inline bool originLessThan(const Streak<DIM>& a, const Streak<DIM>& b)
+    {
+        for (int d = DIM - 1; d > 0; --d) {
+            if (a.origin[d] != b.origin[d]) {
+                return a.origin[d] < b.origin[d];
+            }
+        }
+
+        return a.origin.x() < b.origin.x();
+    }
+
+    /**
+     * Is a located in a row (i.e. y/z coordinates) before b?
+     */
+    static inline bool rowLessThan(const Streak<DIM>& a, const Streak<DIM>& b)
+    {
+        for (int d = DIM - 1; d > 0; --d) {
+            if (a.origin[d] != b.origin[d]) {
+                return a.origin[d] < b.origin[d];
+            }
+        }
+
+        return false;
+    }
+
+    /**
+     * Returns an iterator to the first Streak which is located in the
+     * same row as s or in any later row.
+     */
+    inline StreakIterator firstStreakInRowOf(const Streak<DIM>& s) const
+    {
+        Coord<DIM> c = s.origin;
+        c.x() = (std::numeric_limits<int>::min)();
+        return streakIteratorOnOrAfter(c);
+    }
+
+    /**
+     * Merges an arbitrary number of sorted Streak sequences in a
+     * single pass. The sequences are consumed (i.e. their iterators
+     * get advanced).
+     */
+    inline static void mergeKway(
+        Region& ret,
+        std::vector<std::pair<StreakIterator, StreakIterator> > *sources)
+    {
+        typedef typename std::vector<std::pair<StreakIterator, StreakIterator> >::iterator Iter;
+
+        for (Iter i = sources->begin(); i != sources->end();) {
+            if (i->first == i->second) {
+                i = sources->erase(i);
+            } else {
+                ++i;
+            }
+        }
+
+        // the number of sources is usually small (e.g. stencil
+        // streaks), so a linear search for the minimum beats a heap:
+        while (!sources->empty()) {
+            Iter min = sources->begin();
+            for (Iter i = min + 1; i != sources->end(); ++i) {
+                if (originLessThan(*i->first, *min->first)) {
+                    min = i;
+                }
+            }
+
+            ret << *min->first;
+            ++min->first;
+            if (min->first == min->second) {
+                sources->erase(min);
+            }
+        }
+    }
+
     /**
      * Checks whether the other Region can be simply pasted at the end
      * of the current Region.
@@ -1435,7 +1597,7 @@ private:
         Streak<DIM> lastInsert;
 
         for (;;) {
-            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*iterA, *iterB)) {
+            if (originLessThan(*iterA, *iterB)) {
                 LIBGEODECOMP_REGION_ADVANCE_ITERATOR(iterA, endA);
             } else {
                 LIBGEODECOMP_REGION_ADVANCE_ITERATOR(iterB, endB);
@@ -1487,14 +1649,14 @@ private:
         Streak<DIM> lastInsert;
 
         for (;;) {
-            if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*iterA, *iterB)) {
-                if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*iterA, *iterC)) {
+            if (originLessThan(*iterA, *iterB)) {
+                if (originLessThan(*iterA, *iterC)) {
                     LIBGEODECOMP_REGION_ADVANCE_ITERATOR(iterA, endA);
                 } else {
                     LIBGEODECOMP_REGION_ADVANCE_ITERATOR(iterC, endC);
                 }
             } else {
-                if (RegionHelpers::RegionIntersectHelper<DIM - 1>::lessThan(*iterB, *iterC)) {
+                if (originLessThan(*iterB, *iterC)) {
                     LIBGEODECOMP_REGION_ADVANCE_ITERATOR(iterB, endB);
                 } else {
                     LIBGEODECOMP_REGION_ADVANCE_ITERATOR(iterC, endC);
@@ -2,10 +2,12 @@
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/geometry/regionbasedadjacency.h>
 #include <libgeodecomp/misc/chronometer.h>
+#include <libgeodecomp/misc/random.h>
 #include <libgeodecomp/storage/displacedgrid.h>
 
 #include <cxxtest/TestSuite.h>
 
+#include <set>
 #include <unistd.h>
 
 using namespace LibGeoDecomp;
@@ -2248,7 +2250,123 @@ public:
         TS_ASSERT( r6.isAppendable(r5));
     }
 
+    void testStreakIteratorOnOrAfterBeyondLastRowOfPlane()
+    {
+        Region<3> region;
+        region << Streak<3>(Coord<3>(0, 14, 0),  5)
+                << Streak<3>(Coord<3>(3,  3, 1), 13)
+                << Streak<3>(Coord<3>(2,  5, 1),  4);
+
+        Region<3>::StreakIterator iter = region.streakIteratorOnOrAfter(Coord<3>(0, 15, 0));
+        TS_ASSERT_EQUALS(Streak<3>(Coord<3>(3, 3, 1), 13), *iter);
+        ++iter;
+        TS_ASSERT_EQUALS(Streak<3>(Coord<3>(2, 5, 1),  4), *iter);
+
+        iter = region.streakIteratorOnOrAfter(Coord<3>(0, 6, 1));
+        TS_ASSERT_EQUALS(region.endStreak(), iter);
+    }
+
+    void testAppendFastPath()
+    {
+        Region<3> actual;
+        actual << Streak<3>(Coord<3>( 0, 0, 0), 10)
+               << Streak<3>(Coord<3>(10, 0, 0), 15)
+               << Streak<3>(Coord<3>(12, 0, 0), 20)
+               << Streak<3>(Coord<3>(30, 0, 0), 40)
+               << Streak<3>(Coord<3>( 5, 1, 0), 10)
+               << Streak<3>(Coord<3>( 0, 1, 1), 10)
+               << Streak<3>(Coord<3>( 0, 3, 4), 10)
+               // these ones don't fit at the end and need to be inserted:
+               << Streak<3>(Coord<3>( 0, 2, 1), 10)
+               << Streak<3>(Coord<3>(20, 0, 0), 30)
+               << Streak<3>(Coord<3>( 0, 1, 0),  2);
+
+        Region<3> expected;
+        expected << Streak<3>(Coord<3>( 0, 1, 0),  2)
+                 << Streak<3>(Coord<3>( 0, 2, 1), 10)
+                 << Streak<3>(Coord<3>( 0, 1, 1), 10)
+                 << Streak<3>(Coord<3>( 0, 3, 4), 10)
+                 << Streak<3>(Coord<3>( 5, 1, 0), 10)
+                 << Streak<3>(Coord<3>( 0, 0, 0), 40);
+
+        TS_ASSERT_EQUALS(expected, actual);
+        TS_ASSERT_EQUALS(6u, actual.numStreaks());
+        TS_ASSERT_EQUALS(Coord<3>(40, 4, 5), actual.boundingBox().dimensions);
+    }
+
+    void testSetOperationsAgainstReference()
+    {
+        Random::seed(4711);
+
+        for (int repetition = 0; repetition < 20; ++repetition) {
+            // vary the ratio of the Region sizes to cover both the
+            // linear merge and the galloping code paths:
+            int numA = 1 + Random::genUnsigned(400);
+            int numB = (repetition % 2) ? (1 + Random::genUnsigned(8)) : numA;
+
+            CoordSet setA = randomCoordSet(numA);
+            CoordSet setB = randomCoordSet(numB);
+            Region<3> a = toRegion(setA);
+            Region<3> b = toRegion(setB);
+
+            CoordSet expectedUnion;
+            CoordSet expectedIntersection;
+            CoordSet expectedDifferenceAB;
+            CoordSet expectedDifferenceBA;
+            for (CoordSet::iterator i = setA.begin(); i != setA.end(); ++i) {
+                expectedUnion.insert(*i);
+                if (setB.count(*i)) {
+                    expectedIntersection.insert(*i);
+                } else {
+                    expectedDifferenceAB.insert(*i);
+                }
+            }
+            for (CoordSet::iterator i = setB.begin(); i != setB.end(); ++i) {
+                expectedUnion.insert(*i);
+                if (!setA.count(*i)) {
+                    expectedDifferenceBA.insert(*i);
+                }
+            }
+
+            TS_ASSERT_EQUALS(toRegion(expectedUnion),        a + b);
+            TS_ASSERT_EQUALS(toRegion(expectedIntersection), a & b);
+            TS_ASSERT_EQUALS(toRegion(expectedIntersection), b & a);
+            TS_ASSERT_EQUALS(toRegion(expectedDifferenceAB), a - b);
+            TS_ASSERT_EQUALS(toRegion(expectedDifferenceBA), b - a);
+
+            Region<3> buf = a;
+            buf -= b;
+            TS_ASSERT_EQUALS(toRegion(expectedDifferenceAB), buf);
+
+            buf = a;
+            buf &= b;
+            TS_ASSERT_EQUALS(toRegion(expectedIntersection), buf);
+
+            TS_ASSERT_EQUALS(a.expand(1), a.expandWithStencil(Stencils::Moore<3, 1>()));
+            TS_ASSERT_EQUALS(b.expand(1), b.expandWithStencil(Stencils::Moore<3, 1>()));
+        }
+    }
+
+    void testSetOperationsWithDisjointBoundingBoxes()
+    {
+        Region<2> a;
+        Region<2> b;
+        a << CoordBox<2>(Coord<2>( 0,  0), Coord<2>(10, 10));
+        b << CoordBox<2>(Coord<2>(10, 10), Coord<2>(10, 10));
+
+        TS_ASSERT_EQUALS(a, a - b);
+        TS_ASSERT((a & b).empty());
+
+        Region<2> buf = a;
+        buf -= b;
+        TS_ASSERT_EQUALS(a, buf);
+        buf &= b;
+        TS_ASSERT(buf.empty());
+    }
+
 private:
+    typedef std::set<Coord<3> > CoordSet;
+
     Region<2> c;
     CoordVector bigInsertOrdered;
     CoordVector bigInsertShuffled;
@@ -2267,6 +2385,33 @@ private:
         return ret;
     }
 
+    CoordSet randomCoordSet(int numStreaks)
+    {
+        CoordSet ret;
+        for (int i = 0; i < numStreaks; ++i) {
+            Coord<3> origin(
+                Random::genUnsigned(40),
+                Random::genUnsigned(20),
+                Random::genUnsigned(10));
+            int length = 1 + Random::genUnsigned(10);
+            for (int x = 0; x < length; ++x) {
+                ret.insert(origin + Coord<3>(x, 0, 0));
+            }
+        }
+
+        return ret;
+    }
+
+    Region<3> toRegion(const CoordSet& coords)
+    {
+        Region<3> ret;
+        for (CoordSet::const_iterator i = coords.begin(); i != coords.end(); ++i) {
+            ret << *i;
+        }
+
+        return ret;
+    }
+
     int bongo(const Coord<2>& c) const
     {
         return c.x() % 13 + c.y() % 17;
@@ -0,0 +1,118 @@
+#ifndef LIBGEODECOMP_IO_ASYNCPARALLELWRITER_H
+#define LIBGEODECOMP_IO_ASYNCPARALLELWRITER_H
+
+#include <libgeodecomp/config.h>
+#if defined(LIBGEODECOMP_WITH_CPP14) && defined(LIBGEODECOMP_WITH_THREADS)
+
+#include <libgeodecomp/io/asyncwriter.h>
+#include <libgeodecomp/io/parallelwriter.h>
+
+namespace LibGeoDecomp {
+
+/**
+ * The equivalent of AsyncWriter for ParallelWriters: only the
+ * validRegion of each call is copied into a pooled buffer, the
+ * delegate is then invoked on a background thread. Calls are passed
+ * on in the same order they were received, so the delegate will
+ * still see the ghost zone/inner set sequence of a step, including
+ * lastCall.
+ *
+ * Beware: delegates which communicate via MPI (e.g. MPI-IO based
+ * writers) may only be wrapped if MPI has been initialized with
+ * MPI_THREAD_MULTIPLE, as the calls will be issued from a different
+ * thread than the simulation's.
+ */
+template<typename CELL_TYPE>
+class AsyncParallelWriter : public ParallelWriter<CELL_TYPE>
+{
+public:
+    typedef typename ParallelWriter<CELL_TYPE>::GridType GridType;
+    typedef typename ParallelWriter<CELL_TYPE>::Topology Topology;
+    typedef DisplacedGrid<CELL_TYPE, Topology> BufferGridType;
+    typedef AsyncWriterHelpers::BufferPool<BufferGridType> BufferPoolType;
+    typedef typename BufferPoolType::GridPtr BufferPtr;
+
+    static const int DIM = Topology::DIM;
+
+    /**
+     * The AsyncParallelWriter takes over ownership of the delegate.
+     */
+    explicit AsyncParallelWriter(
+        ParallelWriter<CELL_TYPE> *delegate,
+        std::size_t maxQueueLength = 2) :
+        ParallelWriter<CELL_TYPE>(delegate->getPrefix(), delegate->getPeriod(), delegate->isAllDoneOnly()),
+        delegate(delegate),
+        maxQueueLength(maxQueueLength),
+        queue(new AsyncWriterHelpers::JobQueue(maxQueueLength)),
+        pool(new BufferPoolType)
+    {}
+
+    ~AsyncParallelWriter()
+    {
+        // stop the worker before the delegate goes out of scope:
+        queue.reset();
+    }
+
+    virtual ParallelWriter<CELL_TYPE> *clone() const
+    {
+        return new AsyncParallelWriter(delegate->clone(), maxQueueLength);
+    }
+
+    virtual void setRegion(const Region<DIM>& newRegion)
+    {
+        // the delegate must not be modified while it's still busy:
+        queue->flush();
+        ParallelWriter<CELL_TYPE>::setRegion(newRegion);
+        delegate->setRegion(newRegion);
+    }
+
+    virtual void stepFinished(
+        const GridType& grid,
+        const Region<DIM>& validRegion,
+        const Coord<DIM>& globalDimensions,
+        unsigned step,
+        WriterEvent event,
+        std::size_t rank,
+        bool lastCall)
+    {
+        BufferPtr buffer = pool->acquire();
+        CoordBox<DIM> box = validRegion.boundingBox();
+        if (buffer->boundingBox() != box) {
+            buffer->resize(box);
+        }
+
+        buffer->paste(grid, validRegion);
+        buffer->setEdge(grid.getEdge());
+
+        ParallelWriter<CELL_TYPE> *writer = &*delegate;
+        BufferPoolType *bufferPool = &*pool;
+        queue->push([writer, bufferPool, buffer, validRegion, globalDimensions, step, event, rank, lastCall]() {
+                writer->stepFinished(*buffer, validRegion, globalDimensions, step, event, rank, lastCall);
+                bufferPool->release(buffer);
+            });
+
+        if ((event == WRITER_ALL_DONE) && lastCall) {
+            queue->flush();
+        }
+    }
+
+    /**
+     * Waits until all queued snapshots have been written.
+     */
+    void flush()
+    {
+        queue->flush();
+    }
+
+private:
+    typename SharedPtr<ParallelWriter<CELL_TYPE> >::Type delegate;
+    std::size_t maxQueueLength;
+    typename SharedPtr<AsyncWriterHelpers::JobQueue>::Type queue;
+    typename SharedPtr<BufferPoolType>::Type pool;
+};
+
+}
+
+#endif
+
+#endif
@@ -0,0 +1,270 @@
+#ifndef LIBGEODECOMP_IO_ASYNCWRITER_H
+#define LIBGEODECOMP_IO_ASYNCWRITER_H
+
+#include <libgeodecomp/config.h>
+#if defined(LIBGEODECOMP_WITH_CPP14) && defined(LIBGEODECOMP_WITH_THREADS)
+
+#include <libgeodecomp/io/writer.h>
+#include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/storage/displacedgrid.h>
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+namespace AsyncWriterHelpers {
+
+/**
+ * Executes jobs in FIFO order on a dedicated background thread. At
+ * most maxQueueLength jobs may be pending at any time, push() will
+ * block otherwise. This back-pressure keeps a fast simulation from
+ * piling up an unbounded number of snapshots in memory. Exceptions
+ * thrown by a job are rethrown by the next call to push() or flush().
+ */
+class JobQueue
+{
+public:
+    typedef std::function<void()> Job;
+
+    explicit JobQueue(std::size_t maxQueueLength) :
+        maxQueueLength(maxQueueLength),
+        busy(false),
+        shutdown(false)
+    {
+        if (maxQueueLength == 0) {
+            throw std::invalid_argument("maxQueueLength must be positive");
+        }
+
+        thread = std::thread(&JobQueue::run, this);
+    }
+
+    ~JobQueue()
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            shutdown = true;
+        }
+        jobAvailable.notify_one();
+        thread.join();
+    }
+
+    void push(const Job& job)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (jobs.size() >= maxQueueLength) {
+            jobDone.wait(lock);
+        }
+        rethrow();
+
+        jobs.push_back(job);
+        jobAvailable.notify_one();
+    }
+
+    /**
+     * Blocks until all pending jobs have been completed.
+     */
+    void flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (busy || !jobs.empty()) {
+            jobDone.wait(lock);
+        }
+        rethrow();
+    }
+
+private:
+    std::size_t maxQueueLength;
+    bool busy;
+    bool shutdown;
+    std::deque<Job> jobs;
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable jobAvailable;
+    std::condition_variable jobDone;
+    std::thread thread;
+
+    void run()
+    {
+        for (;;) {
+            Job job;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                while (jobs.empty() && !shutdown) {
+                    jobAvailable.wait(lock);
+                }
+                if (jobs.empty()) {
+                    return;
+                }
+
+                job = jobs.front();
+                jobs.pop_front();
+                busy = true;
+            }
+
+            std::exception_ptr jobError;
+            try {
+                job();
+            } catch (...) {
+                jobError = std::current_exception();
+            }
+
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                busy = false;
+                if (jobError && !error) {
+                    error = jobError;
+                }
+            }
+            jobDone.notify_all();
+        }
+    }
+
+    /**
+     * expects the mutex to be locked.
+     */
+    void rethrow()
+    {
+        if (error) {
+            std::exception_ptr e = error;
+            error = std::exception_ptr();
+            std::rethrow_exception(e);
+        }
+    }
+};
+
+/**
+ * Recycles snapshot grids so that we don't need to allocate fresh
+ * memory for each output step. Thread-safe.
+ */
+template<typename GRID_TYPE>
+class BufferPool
+{
+public:
+    typedef typename SharedPtr<GRID_TYPE>::Type GridPtr;
+
+    GridPtr acquire()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (buffers.empty()) {
+            return GridPtr(new GRID_TYPE);
+        }
+
+        GridPtr ret = buffers.back();
+        buffers.pop_back();
+        return ret;
+    }
+
+    void release(const GridPtr& buffer)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        buffers.push_back(buffer);
+    }
+
+private:
+    std::mutex mutex;
+    std::vector<GridPtr> buffers;
+};
+
+}
+
+/**
+ * Decouples a Writer from the simulation: on each output step the
+ * grid is copied into a pooled buffer, which is then handed to the
+ * delegate on a background thread. This way the simulation only
+ * stalls for the duration of the copy, not for the encoding and
+ * writing of the output. maxQueueLength controls how many snapshots
+ * may be in flight (2 yields classic double buffering). If the
+ * delegate can't keep up, the simulation will block until a slot
+ * becomes available.
+ *
+ * WRITER_ALL_DONE is passed on synchronously, i.e. once the
+ * simulation has finished all output has been written.
+ */
+template<typename CELL_TYPE>
+class AsyncWriter : public Writer<CELL_TYPE>
+{
+public:
+    typedef typename Writer<CELL_TYPE>::GridType GridType;
+    typedef typename Writer<CELL_TYPE>::Topology Topology;
+    typedef DisplacedGrid<CELL_TYPE, Topology> BufferGridType;
+    typedef AsyncWriterHelpers::BufferPool<BufferGridType> BufferPoolType;
+    typedef typename BufferPoolType::GridPtr BufferPtr;
+
+    static const int DIM = Topology::DIM;
+
+    /**
+     * The AsyncWriter takes over ownership of the delegate.
+     */
+    explicit AsyncWriter(
+        Writer<CELL_TYPE> *delegate,
+        std::size_t maxQueueLength = 2) :
+        Writer<CELL_TYPE>(delegate->getPrefix(), delegate->getPeriod()),
+        delegate(delegate),
+        maxQueueLength(maxQueueLength),
+        queue(new AsyncWriterHelpers::JobQueue(maxQueueLength)),
+        pool(new BufferPoolType)
+    {}
+
+    ~AsyncWriter()
+    {
+        // stop the worker before the delegate goes out of scope:
+        queue.reset();
+    }
+
+    virtual Writer<CELL_TYPE> *clone() const
+    {
+        return new AsyncWriter(delegate->clone(), maxQueueLength);
+    }
+
+    virtual void stepFinished(const GridType& grid, unsigned step, WriterEvent event)
+    {
+        BufferPtr buffer = pool->acquire();
+        CoordBox<DIM> box = grid.boundingBox();
+        if (buffer->boundingBox() != box) {
+            buffer->resize(box);
+        }
+
+        Region<DIM> region;
+        region << box;
+        buffer->paste(grid, region);
+        buffer->setEdge(grid.getEdge());
+
+        Writer<CELL_TYPE> *writer = &*delegate;
+        BufferPoolType *bufferPool = &*pool;
+        queue->push([writer, bufferPool, buffer, step, event]() {
+                writer->stepFinished(*buffer, step, event);
+                bufferPool->release(buffer);
+            });
+
+        if (event == WRITER_ALL_DONE) {
+            queue->flush();
+        }
+    }
+
+    /**
+     * Waits until all queued snapshots have been written.
+     */
+    void flush()
+    {
+        queue->flush();
+    }
+
+private:
+    typename SharedPtr<Writer<CELL_TYPE> >::Type delegate;
+    std::size_t maxQueueLength;
+    typename SharedPtr<AsyncWriterHelpers::JobQueue>::Type queue;
+    typename SharedPtr<BufferPoolType>::Type pool;
+};
+
+}
+
+#endif
+
+#endif
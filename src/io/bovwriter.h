@@ -29,19 +29,32 @@ public:
     using ParallelWriter<CELL_TYPE>::prefix;
 
     typedef typename ParallelWriter<CELL_TYPE>::Topology Topology;
+    typedef MPIIO<CELL_TYPE, Topology> MPIIOType;
+    typedef typename MPIIOType::Hints Hints;
+    typedef typename MPIIOType::template FileLayout<Topology::DIM> FileLayout;
 
     static const int DIM = Topology::DIM;
 
+    /**
+     * Data is written via collective MPI-IO unless collective is set
+     * to false. hints are passed on to MPI_File_open(), see
+     * MPIIO::collectiveBufferingHints().
+     */
     template<typename MEMBER>
     BOVWriter(
         MEMBER CELL_TYPE:: *member,
         const std::string& prefix,
         const unsigned period,
         const Coord<3>& brickletDim = Coord<3>(),
-        const MPI_Comm& communicator = MPI_COMM_WORLD) :
+        const MPI_Comm& communicator = MPI_COMM_WORLD,
+        bool collective = true,
+        const Hints& hints = Hints()) :
         Clonable<ParallelWriter<CELL_TYPE>, BOVWriter<CELL_TYPE> >(prefix, period),
+        mpiio(collective, hints),
         selector(member, "var"),
-        brickletDim(brickletDim)
+        brickletDim(brickletDim),
+        comm(communicator),
+        datatype(selector.mpiDatatype())
     {}
 
     BOVWriter(
@@ -49,8 +62,11 @@ public:
         const std::string& prefix,
         const unsigned period,
         const Coord<3>& brickletDim = Coord<3>(),
-        const MPI_Comm& communicator = MPI_COMM_WORLD) :
+        const MPI_Comm& communicator = MPI_COMM_WORLD,
+        bool collective = true,
+        const Hints& hints = Hints()) :
         Clonable<ParallelWriter<CELL_TYPE>, BOVWriter<CELL_TYPE> >(prefix, period),
+        mpiio(collective, hints),
         selector(selector),
         brickletDim(brickletDim),
         comm(communicator),
@@ -76,7 +92,7 @@ public:
 
 
 private:
-    MPIIO<CELL_TYPE, Topology> mpiio;
+    MPIIOType mpiio;
     Selector<CELL_TYPE> selector;
     Coord<3> brickletDim;
     MPI_Comm comm;
@@ -142,6 +158,33 @@ private:
         MPI_Aint varLength = mpiio.getLength(datatype);
         std::vector<char> buffer;
 
+        if (mpiio.isCollective()) {
+            int dataComponents = selector.arity();
+            FileLayout layout = mpiio.fileLayout(region, dimensions, varLength * dataComponents);
+            buffer.resize(region.size() * selector.sizeOfExternal());
+
+            char *cursor = MPIIOType::bufferPointer(buffer);
+            for (typename FileLayout::iterator i = layout.begin(); i != layout.end(); ++i) {
+                Region<DIM> tempRegion;
+                tempRegion << i->second;
+                grid.saveMemberUnchecked(cursor, MemoryLocation::HOST, selector, tempRegion);
+                cursor += i->second.length() * selector.sizeOfExternal();
+            }
+
+            MPI_Datatype fileType = mpiio.createFileType(layout, dataComponents, varLength, datatype);
+            MPI_File_set_view(file, 0, datatype, fileType, const_cast<char*>("native"), MPI_INFO_NULL);
+            MPI_File_write_all(
+                file,
+                MPIIOType::bufferPointer(buffer),
+                region.size() * dataComponents,
+                datatype,
+                MPI_STATUS_IGNORE);
+            MPI_Type_free(&fileType);
+
+            MPI_File_close(&file);
+            return;
+        }
+
         for (typename Region<DIM>::StreakIterator i = region.beginStreak();
              i != region.endStreak();
              ++i) {
@@ -163,7 +206,7 @@ private:
             tempRegion << *i;
             grid.saveMemberUnchecked(&buffer[0], MemoryLocation::HOST, selector, tempRegion);
 
-            MPI_File_write(file, &buffer[0], length, datatype, MPI_STATUS_IGNORE);
+            MPI_File_write(file, &buffer[0], length * dataComponents, datatype, MPI_STATUS_IGNORE);
         }
 
         MPI_File_close(&file);
@@ -0,0 +1,171 @@
+#ifndef LIBGEODECOMP_IO_CHECKPOINTCODEC_H
+#define LIBGEODECOMP_IO_CHECKPOINTCODEC_H
+
+#include <libgeodecomp/io/ioexception.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Encoding used by CheckpointWriter for its blocks: a byte shuffle
+ * followed by a simple run-length encoding.
+ *
+ * The shuffle groups the i-th byte of all elements together. Values
+ * of a single member tend to be similar across neighboring cells, so
+ * their upper bytes (e.g. sign and exponent of doubles) or the upper
+ * bytes of small integers form long runs which the RLE can then
+ * collapse. This is much cheaper than a general purpose compressor
+ * and needs no external dependencies.
+ *
+ * Compressed format: a sequence of packets, each starting with a
+ * control byte c. If c < 128, then c + 1 literal bytes follow.
+ * Otherwise the next byte is to be repeated (c - 128 + MIN_RUN)
+ * times.
+ */
+class CheckpointCodec
+{
+public:
+    static const std::size_t MIN_RUN = 3;
+    static const std::size_t MAX_RUN = 127 + MIN_RUN;
+    static const std::size_t MAX_LITERALS = 128;
+
+    static void shuffle(
+        const std::vector<char>& source,
+        std::size_t elementSize,
+        std::vector<char> *target)
+    {
+        std::size_t numElements = source.size() / elementSize;
+        target->resize(source.size());
+
+        for (std::size_t i = 0; i < numElements; ++i) {
+            for (std::size_t b = 0; b < elementSize; ++b) {
+                (*target)[b * numElements + i] = source[i * elementSize + b];
+            }
+        }
+
+        // trailing bytes which don't form a whole element are kept as is:
+        std::copy(source.begin() + numElements * elementSize, source.end(), target->begin() + numElements * elementSize);
+    }
+
+    static void unshuffle(
+        const std::vector<char>& source,
+        std::size_t elementSize,
+        std::vector<char> *target)
+    {
+        std::size_t numElements = source.size() / elementSize;
+        target->resize(source.size());
+
+        for (std::size_t i = 0; i < numElements; ++i) {
+            for (std::size_t b = 0; b < elementSize; ++b) {
+                (*target)[i * elementSize + b] = source[b * numElements + i];
+            }
+        }
+
+        std::copy(source.begin() + numElements * elementSize, source.end(), target->begin() + numElements * elementSize);
+    }
+
+    static void compress(const std::vector<char>& source, std::vector<char> *target)
+    {
+        target->clear();
+        std::size_t i = 0;
+
+        while (i < source.size()) {
+            std::size_t run = runLength(source, i);
+            if (run >= MIN_RUN) {
+                target->push_back(static_cast<char>(128 + run - MIN_RUN));
+                target->push_back(source[i]);
+                i += run;
+                continue;
+            }
+
+            // collect literals until the next run worth encoding:
+            std::size_t end = i;
+            while ((end < source.size()) &&
+                   ((end - i) < MAX_LITERALS) &&
+                   (runLength(source, end) < MIN_RUN)) {
+                ++end;
+            }
+
+            target->push_back(static_cast<char>(end - i - 1));
+            target->insert(target->end(), source.begin() + i, source.begin() + end);
+            i = end;
+        }
+    }
+
+    /**
+     * Throws if source is corrupted, i.e. doesn't decode to exactly
+     * rawSize bytes.
+     */
+    static void decompress(
+        const std::vector<char>& source,
+        std::size_t rawSize,
+        std::vector<char> *target)
+    {
+        target->clear();
+        target->reserve(rawSize);
+        std::size_t i = 0;
+
+        while (i < source.size()) {
+            std::size_t control = static_cast<unsigned char>(source[i++]);
+
+            if (control < 128) {
+                std::size_t length = control + 1;
+                if ((i + length) > source.size()) {
+                    throw IOException("truncated literal packet in checkpoint block");
+                }
+                target->insert(target->end(), source.begin() + i, source.begin() + i + length);
+                i += length;
+            } else {
+                if (i >= source.size()) {
+                    throw IOException("truncated run packet in checkpoint block");
+                }
+                target->insert(target->end(), control - 128 + MIN_RUN, source[i++]);
+            }
+
+            if (target->size() > rawSize) {
+                break;
+            }
+        }
+
+        if (target->size() != rawSize) {
+            throw IOException("checkpoint block doesn't match its expected size");
+        }
+    }
+
+    /**
+     * 64-bit FNV-1a hash, used to quickly rule out blocks which
+     * have changed since the previous checkpoint. Equal hashes
+     * don't imply equal contents.
+     */
+    static unsigned long long hash(const std::vector<char>& data)
+    {
+        unsigned long long ret = 14695981039346656037ULL;
+
+        for (std::vector<char>::const_iterator i = data.begin(); i != data.end(); ++i) {
+            ret ^= static_cast<unsigned char>(*i);
+            ret *= 1099511628211ULL;
+        }
+
+        return ret;
+    }
+
+private:
+    static std::size_t runLength(const std::vector<char>& source, std::size_t offset)
+    {
+        std::size_t end = offset + 1;
+        while ((end < source.size()) &&
+               ((end - offset) < MAX_RUN) &&
+               (source[end] == source[offset])) {
+            ++end;
+        }
+
+        return end - offset;
+    }
+};
+
+}
+
+#endif
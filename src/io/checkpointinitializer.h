@@ -0,0 +1,261 @@
+#ifndef LIBGEODECOMP_IO_CHECKPOINTINITIALIZER_H
+#define LIBGEODECOMP_IO_CHECKPOINTINITIALIZER_H
+
+#include <libgeodecomp/io/checkpointcodec.h>
+#include <libgeodecomp/io/checkpointwriter.h>
+#include <libgeodecomp/io/initializer.h>
+#include <libgeodecomp/io/ioexception.h>
+#include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/storage/selector.h>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Restarts a simulation from a checkpoint written by
+ * CheckpointWriter. Each instance reads only those blocks which
+ * intersect the grid it is asked to initialize, so the number of
+ * ranks may differ from the run which wrote the checkpoint. Indices
+ * of ranks whose bounding box doesn't intersect the grid are skipped
+ * after their first line.
+ *
+ * Only the members given by selectors are restored (matched by
+ * name). All other members keep the values set by the optional
+ * baseInitializer, which is invoked first. This way members which
+ * never change (e.g. geometry or material flags) don't need to be
+ * checkpointed at all. Without a baseInitializer they retain the
+ * values the grid was created with.
+ */
+template<typename CELL_TYPE>
+class CheckpointInitializer : public Initializer<CELL_TYPE>
+{
+public:
+    friend class CheckpointWriterTest;
+
+    typedef typename APITraits::SelectTopology<CELL_TYPE>::Value Topology;
+    static const int DIM = Topology::DIM;
+    typedef std::vector<Selector<CELL_TYPE> > SelectorVec;
+    typedef CheckpointHelpers::Block<DIM> Block;
+    typedef typename SharedPtr<Initializer<CELL_TYPE> >::Type InitializerPtr;
+
+    CheckpointInitializer(
+        const std::string& prefix,
+        const unsigned step,
+        const SelectorVec& selectors,
+        const InitializerPtr& baseInitializer = InitializerPtr()) :
+        prefix(prefix),
+        step(step),
+        selectors(selectors),
+        baseInitializer(baseInitializer)
+    {
+        readHeader();
+    }
+
+    virtual void grid(GridBase<CELL_TYPE, DIM> *target)
+    {
+        if (baseInitializer) {
+            baseInitializer->grid(target);
+        }
+
+        Region<DIM> region;
+        region << target->boundingBox();
+        std::ifstream dataFile;
+        std::string dataFileName;
+
+        // index files beyond numRanks are stale leftovers of an
+        // earlier run with more ranks, hence we don't look for them:
+        for (std::size_t rank = 0; rank < numRanks; ++rank) {
+            std::string indexFileName = CheckpointHelpers::fileName(prefix, step, rank, "index");
+            std::ifstream index(indexFileName.c_str());
+            if (!index) {
+                throw FileOpenException(indexFileName);
+            }
+
+            CoordBox<DIM> box;
+            for (int d = 0; d < DIM; ++d) {
+                index >> box.origin[d];
+            }
+            for (int d = 0; d < DIM; ++d) {
+                index >> box.dimensions[d];
+            }
+            if (!index) {
+                throw FileReadException(indexFileName);
+            }
+            if (!box.intersects(target->boundingBox())) {
+                continue;
+            }
+
+            Block block;
+            while (index >> block) {
+                if ((block.member >= selectorIndices.size()) ||
+                    (selectorIndices[block.member] < 0)) {
+                    continue;
+                }
+
+                Region<DIM> overlap = block.region & region;
+                if (!overlap.empty()) {
+                    loadBlock(target, block, selectors[selectorIndices[block.member]], overlap, &dataFile, &dataFileName);
+                }
+            }
+
+            if (!index.eof()) {
+                throw FileReadException(indexFileName);
+            }
+        }
+    }
+
+    virtual Coord<DIM> gridDimensions() const
+    {
+        return dimensions;
+    }
+
+    virtual unsigned maxSteps() const
+    {
+        return maximumSteps;
+    }
+
+    virtual unsigned startStep() const
+    {
+        return step;
+    }
+
+private:
+    std::string prefix;
+    unsigned step;
+    SelectorVec selectors;
+    InitializerPtr baseInitializer;
+    Coord<DIM> dimensions;
+    unsigned maximumSteps;
+    std::size_t numRanks;
+    // maps the members' indices in the checkpoint to our selectors:
+    std::vector<int> selectorIndices;
+    std::vector<char> compressed;
+    std::vector<char> shuffled;
+    std::vector<char> raw;
+    std::vector<char> buffer;
+
+    void readHeader()
+    {
+        std::string headerFileName = CheckpointHelpers::fileName(prefix, step, "checkpoint");
+        std::ifstream header(headerFileName.c_str());
+        if (!header) {
+            throw FileOpenException(headerFileName);
+        }
+
+        std::string magic;
+        int dim = 0;
+        unsigned checkpointStep = 0;
+        std::size_t numMembers = 0;
+        header >> magic >> dim;
+        if ((magic != "LIBGEODECOMP_CHECKPOINT") || (dim != DIM)) {
+            throw FileReadException(headerFileName);
+        }
+
+        for (int d = 0; d < DIM; ++d) {
+            header >> dimensions[d];
+        }
+        header >> checkpointStep >> maximumSteps >> numRanks >> numMembers;
+
+        std::vector<int> found(selectors.size(), 0);
+        for (std::size_t i = 0; header && (i < numMembers); ++i) {
+            std::string name;
+            std::size_t size;
+            header >> name >> size;
+            selectorIndices << -1;
+
+            for (std::size_t j = 0; j < selectors.size(); ++j) {
+                if (selectors[j].name() == name) {
+                    if (selectors[j].sizeOfExternal() != size) {
+                        throw std::invalid_argument("size of member " + name + " doesn't match checkpoint");
+                    }
+                    selectorIndices.back() = j;
+                    found[j] = 1;
+                }
+            }
+        }
+
+        if (!header || (checkpointStep != step) || (numRanks == 0)) {
+            throw FileReadException(headerFileName);
+        }
+
+        for (std::size_t j = 0; j < selectors.size(); ++j) {
+            if (!found[j]) {
+                throw std::invalid_argument("member " + selectors[j].name() + " not found in checkpoint");
+            }
+        }
+    }
+
+    void loadBlock(
+        GridBase<CELL_TYPE, DIM> *target,
+        const Block& block,
+        const Selector<CELL_TYPE>& selector,
+        const Region<DIM>& overlap,
+        std::ifstream *dataFile,
+        std::string *dataFileName)
+    {
+        std::size_t elementSize = selector.sizeOfExternal();
+        if (block.rawSize != (block.region.size() * elementSize)) {
+            throw IOException("corrupted block in checkpoint file " + block.file);
+        }
+
+        // consecutive blocks are usually stored in the same file:
+        if (block.file != *dataFileName) {
+            dataFile->close();
+            dataFile->clear();
+            dataFile->open(block.file.c_str(), std::ios::binary);
+            *dataFileName = block.file;
+            if (!*dataFile) {
+                throw FileOpenException(block.file);
+            }
+        }
+
+        compressed.resize(block.compressedSize);
+        dataFile->seekg(block.offset);
+        dataFile->read(&compressed[0], block.compressedSize);
+        if (!*dataFile) {
+            throw FileReadException(block.file);
+        }
+
+        CheckpointCodec::decompress(compressed, block.rawSize, &shuffled);
+        CheckpointCodec::unshuffle(shuffled, elementSize, &raw);
+
+        if (overlap.size() == block.region.size()) {
+            target->loadMemberUnchecked(&raw[0], MemoryLocation::HOST, selector, overlap);
+            return;
+        }
+
+        // The overlap's streaks are fragments of the block's streaks,
+        // in the same order. So we can simply pick the fragments
+        // while walking along the block's streaks:
+        buffer.clear();
+        std::size_t cursor = 0;
+        for (typename Region<DIM>::StreakIterator i = block.region.beginStreak();
+             i != block.region.endStreak();
+             ++i) {
+            Region<DIM> fragments;
+            fragments << *i;
+            fragments &= overlap;
+
+            for (typename Region<DIM>::StreakIterator j = fragments.beginStreak();
+                 j != fragments.endStreak();
+                 ++j) {
+                std::size_t begin = cursor + (j->origin.x() - i->origin.x()) * elementSize;
+                std::size_t end = begin + j->length() * elementSize;
+                buffer.insert(buffer.end(), raw.begin() + begin, raw.begin() + end);
+            }
+
+            cursor += i->length() * elementSize;
+        }
+
+        target->loadMemberUnchecked(&buffer[0], MemoryLocation::HOST, selector, overlap);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,483 @@
+#ifndef LIBGEODECOMP_IO_CHECKPOINTWRITER_H
+#define LIBGEODECOMP_IO_CHECKPOINTWRITER_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/io/checkpointcodec.h>
+#include <libgeodecomp/io/ioexception.h>
+#include <libgeodecomp/io/parallelwriter.h>
+#include <libgeodecomp/misc/clonable.h>
+#include <libgeodecomp/storage/selector.h>
+
+#ifdef LIBGEODECOMP_WITH_MPI
+#include <mpi.h>
+#endif
+
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+namespace CheckpointHelpers {
+
+/**
+ * Describes where the values of one member for one Region are
+ * stored. Blocks which didn't change since the previous checkpoint
+ * keep referring to the data file they were originally written to.
+ */
+template<int DIM>
+class Block
+{
+public:
+    std::size_t member;
+    Region<DIM> region;
+    std::string file;
+    std::size_t offset;
+    std::size_t compressedSize;
+    std::size_t rawSize;
+    unsigned long long hash;
+    // the compressed contents, only held in memory by the writer to
+    // verify that a block didn't change:
+    std::vector<char> data;
+};
+
+template<int DIM>
+std::ostream& operator<<(std::ostream& os, const Block<DIM>& block)
+{
+    os << block.member << " "
+       << block.file << " "
+       << block.offset << " "
+       << block.compressedSize << " "
+       << block.rawSize << " "
+       << block.hash << " "
+       << block.region.numStreaks();
+
+    for (typename Region<DIM>::StreakIterator i = block.region.beginStreak();
+         i != block.region.endStreak();
+         ++i) {
+        for (int d = 0; d < DIM; ++d) {
+            os << " " << i->origin[d];
+        }
+        os << " " << i->endX;
+    }
+
+    return os;
+}
+
+template<int DIM>
+std::istream& operator>>(std::istream& is, Block<DIM>& block)
+{
+    std::size_t numStreaks = 0;
+    is >> block.member
+       >> block.file
+       >> block.offset
+       >> block.compressedSize
+       >> block.rawSize
+       >> block.hash
+       >> numStreaks;
+
+    block.region.clear();
+    for (std::size_t i = 0; is && (i < numStreaks); ++i) {
+        Streak<DIM> streak;
+        for (int d = 0; d < DIM; ++d) {
+            is >> streak.origin[d];
+        }
+        is >> streak.endX;
+        block.region << streak;
+    }
+
+    return is;
+}
+
+/**
+ * Names of the files which make up a checkpoint: one header, written
+ * by rank 0, plus one index and up to one data file per rank.
+ */
+inline std::string fileName(const std::string& prefix, unsigned step, const std::string& suffix)
+{
+    std::ostringstream buf;
+    buf << prefix << std::setfill('0') << std::setw(5) << step << "." << suffix;
+    return buf.str();
+}
+
+inline std::string fileName(const std::string& prefix, unsigned step, std::size_t rank, const std::string& suffix)
+{
+    std::ostringstream buf;
+    buf << rank << "." << suffix;
+    return fileName(prefix, step, buf.str());
+}
+
+}
+
+/**
+ * Writes checkpoints for restarting a simulation via
+ * CheckpointInitializer. In contrast to ParallelMPIIOWriter it
+ * doesn't dump whole cells but only the members given by selectors,
+ * split into blocks (one per member and tile of size
+ * tileDimensions), and it compresses those via CheckpointCodec.
+ *
+ * Checkpoints are incremental: blocks whose contents didn't change
+ * since the previous checkpoint aren't written again, the index
+ * simply refers to the older data file. So don't delete the data
+ * files of older checkpoints while newer ones are still needed.
+ * Unchanged blocks are detected by comparing their compressed
+ * contents byte by byte (a hash only serves as a quick check), so
+ * each rank keeps a copy of its compressed blocks in memory.
+ *
+ * Each rank writes its own index and data file, hence
+ * CheckpointInitializer can restart with any number of ranks. The
+ * first line of each index holds the bounding box of all of its
+ * blocks, so CheckpointInitializer can skip the indices of ranks
+ * whose domains don't intersect its own. The header records the
+ * number of ranks, so a restart can tell missing index files from
+ * stale ones left over by a larger run. Neither the prefix nor the
+ * selectors' names may contain whitespace.
+ */
+template<typename CELL_TYPE>
+class CheckpointWriter : public Clonable<ParallelWriter<CELL_TYPE>, CheckpointWriter<CELL_TYPE> >
+{
+public:
+    friend class CheckpointWriterTest;
+
+    typedef typename ParallelWriter<CELL_TYPE>::GridType GridType;
+    typedef typename APITraits::SelectTopology<CELL_TYPE>::Value Topology;
+    static const int DIM = Topology::DIM;
+    typedef std::vector<Selector<CELL_TYPE> > SelectorVec;
+    typedef CheckpointHelpers::Block<DIM> Block;
+    typedef std::map<std::pair<std::size_t, Coord<DIM> >, std::vector<Block> > BlockMap;
+
+    using ParallelWriter<CELL_TYPE>::period;
+    using ParallelWriter<CELL_TYPE>::prefix;
+
+    /**
+     * numRanks is the number of processes which write the
+     * checkpoint. 0 means the size of MPI_COMM_WORLD (or 1 if MPI
+     * isn't available).
+     */
+    CheckpointWriter(
+        const std::string& prefix,
+        const unsigned period,
+        const unsigned maxSteps,
+        const SelectorVec& selectors,
+        const Coord<DIM>& tileDimensions = Coord<DIM>::diagonal(32),
+        const std::size_t numRanks = 0) :
+        Clonable<ParallelWriter<CELL_TYPE>, CheckpointWriter<CELL_TYPE> >(prefix, period),
+        maxSteps(maxSteps),
+        numRanks(numRanks ? numRanks : defaultNumRanks()),
+        selectors(selectors),
+        tileDimensions(tileDimensions),
+        lastCheckpoint(-1),
+        dataFileSize(0),
+        bytesWritten(0)
+    {
+        if (selectors.empty()) {
+            throw std::invalid_argument("CheckpointWriter needs at least one Selector");
+        }
+
+        for (int d = 0; d < DIM; ++d) {
+            if (tileDimensions[d] <= 0) {
+                throw std::invalid_argument("tile dimensions must be positive");
+            }
+        }
+    }
+
+    /**
+     * Only the state which survives between checkpoints is copied,
+     * streams can't be copied anyway.
+     */
+    CheckpointWriter(const CheckpointWriter& other) :
+        Clonable<ParallelWriter<CELL_TYPE>, CheckpointWriter<CELL_TYPE> >(other),
+        maxSteps(other.maxSteps),
+        numRanks(other.numRanks),
+        selectors(other.selectors),
+        tileDimensions(other.tileDimensions),
+        lastCheckpoint(other.lastCheckpoint),
+        previousBlocks(other.previousBlocks),
+        dataFileSize(0),
+        bytesWritten(other.bytesWritten)
+    {}
+
+    /**
+     * Checkpoints are skipped for steps which have already been
+     * written (e.g. if WRITER_ALL_DONE follows WRITER_STEP_FINISHED
+     * for the same step).
+     */
+    virtual void stepFinished(
+        const GridType& grid,
+        const Region<DIM>& validRegion,
+        const Coord<DIM>& globalDimensions,
+        unsigned step,
+        WriterEvent event,
+        std::size_t rank,
+        bool lastCall)
+    {
+        if ((event == WRITER_STEP_FINISHED) && (step % period != 0)) {
+            return;
+        }
+        if (long(step) == lastCheckpoint) {
+            return;
+        }
+        if (rank >= numRanks) {
+            throw std::invalid_argument("rank exceeds the number of ranks given to CheckpointWriter");
+        }
+
+        writeBlocks(grid, validRegion, step, rank);
+
+        if (lastCall) {
+            finishCheckpoint(globalDimensions, step, rank);
+        }
+    }
+
+    /**
+     * Amount of (compressed) block data written by this rank for
+     * the most recent checkpoint.
+     */
+    std::size_t getBytesWritten() const
+    {
+        return bytesWritten;
+    }
+
+private:
+    unsigned maxSteps;
+    std::size_t numRanks;
+    SelectorVec selectors;
+    Coord<DIM> tileDimensions;
+    long lastCheckpoint;
+    BlockMap previousBlocks;
+    BlockMap currentBlocks;
+    std::ofstream dataFile;
+    std::string dataFileName;
+    std::size_t dataFileSize;
+    std::size_t bytesWritten;
+    std::vector<char> raw;
+    std::vector<char> shuffled;
+
+    void writeBlocks(const GridType& grid, const Region<DIM>& validRegion, unsigned step, std::size_t rank)
+    {
+        if (validRegion.empty()) {
+            return;
+        }
+
+        if (currentBlocks.empty() && !dataFile.is_open()) {
+            dataFileName = CheckpointHelpers::fileName(prefix, step, rank, "data");
+            dataFileSize = 0;
+            bytesWritten = 0;
+        }
+
+        CoordBox<DIM> box = validRegion.boundingBox();
+        Coord<DIM> firstTile;
+        Coord<DIM> numTiles;
+        for (int d = 0; d < DIM; ++d) {
+            firstTile[d] = floorDiv(box.origin[d], tileDimensions[d]);
+            numTiles[d] = floorDiv(box.origin[d] + box.dimensions[d] - 1, tileDimensions[d]) - firstTile[d] + 1;
+        }
+        CoordBox<DIM> tiles(firstTile, numTiles);
+
+        for (typename CoordBox<DIM>::Iterator t = tiles.begin(); t != tiles.end(); ++t) {
+            Region<DIM> tileRegion;
+            tileRegion << CoordBox<DIM>(t->scale(tileDimensions), tileDimensions);
+            Region<DIM> part = validRegion & tileRegion;
+            if (part.empty()) {
+                continue;
+            }
+
+            for (std::size_t m = 0; m < selectors.size(); ++m) {
+                writeBlock(grid, part, m, *t);
+            }
+        }
+    }
+
+    void writeBlock(const GridType& grid, const Region<DIM>& region, std::size_t member, const Coord<DIM>& tile)
+    {
+        std::size_t elementSize = selectors[member].sizeOfExternal();
+        raw.resize(region.size() * elementSize);
+        grid.saveMemberUnchecked(&raw[0], MemoryLocation::HOST, selectors[member], region);
+
+        Block block;
+        block.member = member;
+        block.region = region;
+        block.rawSize = raw.size();
+        block.hash = CheckpointCodec::hash(raw);
+
+        // the encoding is deterministic, so equal compressed data
+        // implies equal contents:
+        CheckpointCodec::shuffle(raw, elementSize, &shuffled);
+        CheckpointCodec::compress(shuffled, &block.data);
+
+        std::pair<std::size_t, Coord<DIM> > key(member, tile);
+        const Block *previous = findBlock(previousBlocks, key, block);
+
+        if (previous) {
+            block.file = previous->file;
+            block.offset = previous->offset;
+            block.compressedSize = previous->compressedSize;
+        } else {
+            const std::vector<char>& compressed = block.data;
+
+            if (!dataFile.is_open()) {
+                dataFile.open(dataFileName.c_str(), std::ios::binary);
+                if (!dataFile) {
+                    throw FileOpenException(dataFileName);
+                }
+            }
+
+            dataFile.write(&compressed[0], compressed.size());
+            if (!dataFile) {
+                throw FileWriteException(dataFileName);
+            }
+
+            block.file = dataFileName;
+            block.offset = dataFileSize;
+            block.compressedSize = compressed.size();
+            dataFileSize += compressed.size();
+            bytesWritten += compressed.size();
+        }
+
+        std::vector<Block>& blocks = currentBlocks[key];
+        blocks.push_back(Block());
+        std::swap(blocks.back(), block);
+    }
+
+    void finishCheckpoint(const Coord<DIM>& globalDimensions, unsigned step, std::size_t rank)
+    {
+        if (dataFile.is_open()) {
+            dataFile.close();
+            if (!dataFile) {
+                throw FileWriteException(dataFileName);
+            }
+        }
+
+        std::string indexFileName = CheckpointHelpers::fileName(prefix, step, rank, "index");
+        std::ofstream index(indexFileName.c_str());
+        if (!index) {
+            throw FileOpenException(indexFileName);
+        }
+
+        CoordBox<DIM> box = boundingBox(currentBlocks);
+        for (int d = 0; d < DIM; ++d) {
+            index << box.origin[d] << " ";
+        }
+        for (int d = 0; d < DIM; ++d) {
+            index << box.dimensions[d] << " ";
+        }
+        index << "\n";
+
+        for (typename BlockMap::iterator i = currentBlocks.begin(); i != currentBlocks.end(); ++i) {
+            for (typename std::vector<Block>::iterator j = i->second.begin(); j != i->second.end(); ++j) {
+                index << *j << "\n";
+            }
+        }
+
+        index.close();
+        if (!index) {
+            throw FileWriteException(indexFileName);
+        }
+
+        if (rank == 0) {
+            writeHeader(globalDimensions, step);
+        }
+
+        previousBlocks.swap(currentBlocks);
+        currentBlocks.clear();
+        lastCheckpoint = step;
+    }
+
+    void writeHeader(const Coord<DIM>& globalDimensions, unsigned step)
+    {
+        std::string headerFileName = CheckpointHelpers::fileName(prefix, step, "checkpoint");
+        std::ofstream header(headerFileName.c_str());
+        if (!header) {
+            throw FileOpenException(headerFileName);
+        }
+
+        header << "LIBGEODECOMP_CHECKPOINT " << DIM << "\n";
+        for (int d = 0; d < DIM; ++d) {
+            header << globalDimensions[d] << " ";
+        }
+        header << "\n"
+               << step << " " << maxSteps << " " << numRanks << "\n"
+               << selectors.size() << "\n";
+        for (typename SelectorVec::iterator i = selectors.begin(); i != selectors.end(); ++i) {
+            header << i->name() << " " << i->sizeOfExternal() << "\n";
+        }
+
+        header.close();
+        if (!header) {
+            throw FileWriteException(headerFileName);
+        }
+    }
+
+    static std::size_t defaultNumRanks()
+    {
+#ifdef LIBGEODECOMP_WITH_MPI
+        int initialized = 0;
+        MPI_Initialized(&initialized);
+        if (initialized) {
+            int size = 0;
+            MPI_Comm_size(MPI_COMM_WORLD, &size);
+            return size;
+        }
+#endif
+
+        return 1;
+    }
+
+    static const Block *findBlock(
+        const BlockMap& blocks,
+        const std::pair<std::size_t, Coord<DIM> >& key,
+        const Block& block)
+    {
+        typename BlockMap::const_iterator candidates = blocks.find(key);
+        if (candidates == blocks.end()) {
+            return 0;
+        }
+
+        for (typename std::vector<Block>::const_iterator i = candidates->second.begin();
+             i != candidates->second.end();
+             ++i) {
+            if ((i->hash == block.hash) &&
+                (i->rawSize == block.rawSize) &&
+                (i->region == block.region) &&
+                (i->data == block.data)) {
+                return &*i;
+            }
+        }
+
+        return 0;
+    }
+
+    static CoordBox<DIM> boundingBox(const BlockMap& blocks)
+    {
+        if (blocks.empty()) {
+            return CoordBox<DIM>();
+        }
+
+        CoordBox<DIM> box = blocks.begin()->second.front().region.boundingBox();
+        Coord<DIM> minCoord = box.origin;
+        Coord<DIM> maxCoord = box.origin + box.dimensions;
+
+        for (typename BlockMap::const_iterator i = blocks.begin(); i != blocks.end(); ++i) {
+            for (typename std::vector<Block>::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
+                box = j->region.boundingBox();
+                minCoord = (minCoord.min)(box.origin);
+                maxCoord = (maxCoord.max)(box.origin + box.dimensions);
+            }
+        }
+
+        return CoordBox<DIM>(minCoord, maxCoord - minCoord);
+    }
+
+    static int floorDiv(int a, int b)
+    {
+        return (a >= 0) ? (a / b) : -((-a + b - 1) / b);
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,103 @@
+#ifndef LIBGEODECOMP_IO_CHROMETRACEWRITER_H
+#define LIBGEODECOMP_IO_CHROMETRACEWRITER_H
+
+#include <libgeodecomp/config.h>
+#ifdef LIBGEODECOMP_WITH_MPI
+
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/io/ioexception.h>
+#include <libgeodecomp/io/parallelwriter.h>
+#include <libgeodecomp/misc/clonable.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/misc/timelinetracer.h>
+
+#include <fstream>
+
+namespace LibGeoDecomp {
+
+/**
+ * Enables the TimelineTracer upon construction and, once the
+ * simulation is done, gathers the timelines of all ranks on the root
+ * and writes them to a single file in Chrome's trace event format.
+ * Load it in chrome://tracing or ui.perfetto.dev to see per rank and
+ * per thread when cells were updated, ghost zones were awaited and
+ * IO happened.
+ */
+template<typename CELL_TYPE>
+class ChromeTraceWriter : public Clonable<ParallelWriter<CELL_TYPE>, ChromeTraceWriter<CELL_TYPE> >
+{
+public:
+    typedef typename ParallelWriter<CELL_TYPE>::GridType GridType;
+    typedef typename APITraits::SelectTopology<CELL_TYPE>::Value Topology;
+    static const int DIM = Topology::DIM;
+    using ParallelWriter<CELL_TYPE>::prefix;
+
+    /**
+     * The trace will be written to prefix + ".json". Each thread will
+     * retain at most capacityPerThread events, older ones are
+     * discarded.
+     */
+    explicit ChromeTraceWriter(
+        const std::string& prefix,
+        std::size_t capacityPerThread = 65536,
+        int root = 0,
+        const MPI_Comm& communicator = MPI_COMM_WORLD) :
+        // we're only interested in the final call:
+        Clonable<ParallelWriter<CELL_TYPE>, ChromeTraceWriter<CELL_TYPE> >(prefix, 1, true),
+        root(root),
+        comm(communicator)
+    {
+        TimelineTracer::enable(capacityPerThread);
+    }
+
+    virtual void stepFinished(
+        const GridType& grid,
+        const Region<Topology::DIM>& validRegion,
+        const Coord<Topology::DIM>& globalDimensions,
+        unsigned step,
+        WriterEvent event,
+        std::size_t rank,
+        bool lastCall)
+    {
+        if ((event != WRITER_ALL_DONE) || !lastCall) {
+            return;
+        }
+
+        MPILayer mpiLayer(comm);
+        std::string events = TimelineTracer::chromeTraceEvents(mpiLayer.rank());
+        std::vector<int> lengths = mpiLayer.gather(int(events.size()), root);
+
+        // all ranks need valid addresses, even if only the root will
+        // receive anything:
+        lengths.resize(mpiLayer.size());
+        std::vector<char> buffer(1);
+        if (mpiLayer.rank() == root) {
+            buffer.resize(sum(lengths));
+        }
+        mpiLayer.gatherV(events.c_str(), events.size(), lengths, root, &buffer[0], MPI_CHAR);
+
+        if (mpiLayer.rank() != root) {
+            return;
+        }
+
+        std::string filename = prefix + ".json";
+        std::ofstream file(filename.c_str());
+        if (!file.good()) {
+            throw FileOpenException(filename);
+        }
+
+        // JSON doesn't allow a trailing comma after the last event:
+        std::string trace(buffer.begin(), buffer.end());
+        trace.erase(trace.rfind(','), 1);
+        file << "[\n" << trace << "]\n";
+    }
+
+private:
+    int root;
+    MPI_Comm comm;
+};
+
+}
+
+#endif
+#endif
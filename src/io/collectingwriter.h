@@ -9,6 +9,9 @@
 #include <libgeodecomp/misc/clonable.h>
 #include <libgeodecomp/misc/sharedptr.h>
 
+#include <algorithm>
+#include <vector>
+
 namespace LibGeoDecomp {
 
 /**
@@ -16,6 +19,13 @@ namespace LibGeoDecomp {
  * together with a DistributedSimulator. Good for testing, but doesn't
  * scale, as all memory is concentrated on one node and IO is
  * serialized to that node. Use with care!
+ *
+ * The root still needs to hold the whole grid, as that's what the
+ * Writer interface expects. All other buffers are capped: each rank
+ * streams its Region to the root in chunks of at most maxChunkSize
+ * bytes, reading straight from the simulator's grid. Two chunks are
+ * in flight per rank, so packing (or unpacking on the root) of one
+ * chunk overlaps with the transmission of the other.
  */
 template<typename CELL_TYPE>
 class CollectingWriter : public Clonable<ParallelWriter<CELL_TYPE>, CollectingWriter<CELL_TYPE> >
@@ -33,12 +43,14 @@ public:
         Writer<CELL_TYPE> *writer,
         int root = 0,
         MPI_Comm communicator = MPI_COMM_WORLD,
-        MPI_Datatype mpiDatatype = APITraits::SelectMPIDataType<CELL_TYPE>::value()) :
+        MPI_Datatype mpiDatatype = APITraits::SelectMPIDataType<CELL_TYPE>::value(),
+        std::size_t maxChunkSize = 1 << 24) :
         Clonable<ParallelWriter<CELL_TYPE>, CollectingWriter<CELL_TYPE> >("",  1),
         writer(writer),
         mpiLayer(communicator),
         root(root),
-        datatype(mpiDatatype)
+        datatype(mpiDatatype),
+        chunkCells(std::max<std::size_t>(1, maxChunkSize / sizeof(CELL_TYPE)))
     {
         if ((mpiLayer.rank() != root) && (writer != 0)) {
             throw std::invalid_argument("can't call back a writer on a node other than the root");
@@ -73,51 +85,128 @@ public:
             globalGrid.setEdge(grid.getEdge());
         }
 
-        CoordBox<DIM> box = grid.boundingBox();
-        StorageGridType localGrid(box);
-
-        for (typename CoordBox<DIM>::StreakIterator i = box.beginStreak(); i != box.endStreak(); ++i) {
-            Streak<DIM> s(*i);
-            grid.get(s, &localGrid[s.origin]);
-        }
-
         for (int sender = 0; sender < mpiLayer.size(); ++sender) {
             if (sender != root) {
                 if (mpiLayer.rank() == root) {
                     Region<DIM> recvRegion;
                     mpiLayer.recvRegion(&recvRegion, sender);
-                    mpiLayer.recvUnregisteredRegion(
-                        &globalGrid,
-                        recvRegion,
-                        sender,
-                        MPILayer::PARALLEL_MEMORY_WRITER,
-                        datatype);
+                    recvChunks(recvRegion, sender);
                 }
                 if (mpiLayer.rank() == sender) {
                     mpiLayer.sendRegion(validRegion, root);
-                    mpiLayer.sendUnregisteredRegion(
-                        &localGrid,
-                        validRegion,
-                        root,
-                        MPILayer::PARALLEL_MEMORY_WRITER,
-                        datatype);
+                    sendChunks(grid, validRegion);
                 }
             }
         }
 
-        mpiLayer.waitAll();
-
         if (lastCall && (mpiLayer.rank() == root)) {
             writer->stepFinished(*globalGrid.vanillaGrid(), step, event);
         }
     }
 
 private:
+    typedef typename Region<DIM>::StreakIterator StreakIterator;
+    typedef std::vector<Streak<DIM> > StreakVec;
+
     typename SharedPtr<Writer<CELL_TYPE> >::Type writer;
     MPILayer mpiLayer;
     int root;
     StorageGridType globalGrid;
     MPI_Datatype datatype;
+    std::size_t chunkCells;
+    std::vector<CELL_TYPE> buffers[2];
+    StreakVec chunks[2];
+
+    inline void sendChunks(const SimulatorGridType& grid, const Region<DIM>& region)
+    {
+        StreakIterator cursor = region.beginStreak();
+        int offset = 0;
+
+        for (int i = 0; cursor != region.endStreak(); i ^= 1) {
+            // make sure the previous transmission from this buffer is done:
+            mpiLayer.wait(MPILayer::PARALLEL_MEMORY_WRITER + i);
+
+            std::size_t size = nextChunk(&cursor, region.endStreak(), &offset, &chunks[i]);
+            buffers[i].resize(size);
+            CELL_TYPE *data = &buffers[i][0];
+            for (typename StreakVec::iterator s = chunks[i].begin(); s != chunks[i].end(); ++s) {
+                grid.get(*s, data);
+                data += s->length();
+            }
+
+            mpiLayer.send(&buffers[i][0], root, size, MPILayer::PARALLEL_MEMORY_WRITER + i, datatype);
+        }
+
+        mpiLayer.wait(MPILayer::PARALLEL_MEMORY_WRITER + 0);
+        mpiLayer.wait(MPILayer::PARALLEL_MEMORY_WRITER + 1);
+    }
+
+    inline void recvChunks(const Region<DIM>& region, int sender)
+    {
+        StreakIterator cursor = region.beginStreak();
+        int offset = 0;
+        int i = 0;
+
+        chunks[i].clear();
+        if (cursor != region.endStreak()) {
+            postRecv(&cursor, region.endStreak(), &offset, sender, i);
+        }
+
+        while (!chunks[i].empty()) {
+            // prefetch the next chunk while we're unpacking this one:
+            chunks[i ^ 1].clear();
+            if (cursor != region.endStreak()) {
+                postRecv(&cursor, region.endStreak(), &offset, sender, i ^ 1);
+            }
+
+            mpiLayer.wait(MPILayer::PARALLEL_MEMORY_WRITER + i);
+            const CELL_TYPE *data = &buffers[i][0];
+            for (typename StreakVec::iterator s = chunks[i].begin(); s != chunks[i].end(); ++s) {
+                std::copy(data, data + s->length(), &globalGrid[s->origin]);
+                data += s->length();
+            }
+
+            i ^= 1;
+        }
+    }
+
+    inline void postRecv(StreakIterator *cursor, const StreakIterator& end, int *offset, int sender, int i)
+    {
+        std::size_t size = nextChunk(cursor, end, offset, &chunks[i]);
+        buffers[i].resize(size);
+        mpiLayer.recv(&buffers[i][0], sender, size, MPILayer::PARALLEL_MEMORY_WRITER + i, datatype);
+    }
+
+    /**
+     * Gathers the next streaks (or fragments thereof) from a Region
+     * into chunk, starting offset cells into the streak at cursor,
+     * until chunkCells have been collected or the Region is
+     * exhausted. Sender and root both use this to agree on the chunk
+     * boundaries. Returns the number of cells in the chunk.
+     */
+    inline std::size_t nextChunk(StreakIterator *cursor, const StreakIterator& end, int *offset, StreakVec *chunk)
+    {
+        chunk->clear();
+        std::size_t size = 0;
+
+        while ((*cursor != end) && (size < chunkCells)) {
+            Streak<DIM> streak = **cursor;
+            streak.origin.x() += *offset;
+            std::size_t remainder = chunkCells - size;
+            if (std::size_t(streak.length()) > remainder) {
+                streak.endX = streak.origin.x() + remainder;
+                *offset += remainder;
+            } else {
+                ++*cursor;
+                *offset = 0;
+            }
+
+            chunk->push_back(streak);
+            size += streak.length();
+        }
+
+        return size;
+    }
 };
 
 }
@@ -0,0 +1,435 @@
+#ifndef LIBGEODECOMP_IO_GLOBALREDUCTION_H
+#define LIBGEODECOMP_IO_GLOBALREDUCTION_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/io/steerer.h>
+#include <libgeodecomp/storage/selector.h>
+
+#ifdef LIBGEODECOMP_WITH_MPI
+#include <libgeodecomp/communication/mpilayer.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Computes a global sum, minimum, maximum or histogram of a member
+ * (chosen by a Selector) of all cells, so users don't have to
+ * hand-roll reductions in their Writers/Steerers (which typically
+ * boils down to a synchronous gather per step).
+ *
+ * Each node reduces its own part of the grid right after the update
+ * (the member is extracted in bulk via saveMemberUnchecked() and
+ * reduced in chunks by multiple threads). The partial results are
+ * then combined via a non-blocking MPI_Iallreduce, which overlaps
+ * with the next time step(s). The result for step s is published
+ * when the GlobalReduction is called for its next step, i.e. at step
+ * s + period. Steerers which want to react to it (e.g. for
+ * convergence checks or energy monitoring) should hold a pointer to
+ * the GlobalReduction and be added to the Simulator after it.
+ * value(), bins() and resultStep() may then be queried from within
+ * their nextStep(). Results are identical on all nodes, so steering
+ * decisions based on them are consistent.
+ *
+ * The member may be of any arithmetic type, or an array thereof (in
+ * which case all elements are taken into account).
+ */
+template<typename CELL_TYPE>
+class GlobalReduction : public Steerer<CELL_TYPE>
+{
+public:
+    typedef typename Steerer<CELL_TYPE>::SteererFeedback SteererFeedback;
+    typedef typename Steerer<CELL_TYPE>::Topology Topology;
+    typedef typename Steerer<CELL_TYPE>::GridType GridType;
+    typedef typename Steerer<CELL_TYPE>::CoordType CoordType;
+    static const int DIM = Topology::DIM;
+
+    /**
+     * Values are reduced in chunks of this many elements. The chunk
+     * partials are always combined in the same order, so that sums
+     * don't depend on the number of threads.
+     */
+    static const std::size_t CHUNK_SIZE = 16384;
+
+    enum Operation {
+        SUM,
+        MIN,
+        MAX,
+        HISTOGRAM
+    };
+
+    using Steerer<CELL_TYPE>::region;
+
+#ifdef LIBGEODECOMP_WITH_MPI
+    GlobalReduction(
+        const Selector<CELL_TYPE>& selector,
+        Operation operation,
+        unsigned period = 1,
+        MPI_Comm communicator = MPI_COMM_WORLD) :
+        Steerer<CELL_TYPE>(period),
+        selector(selector),
+        operation(operation),
+        histogramMin(0),
+        histogramMax(0),
+        mpiLayer(communicator)
+    {
+        init(1);
+    }
+
+    /**
+     * Creates a histogram with numBins bins of equal width spanning
+     * [histogramMin, histogramMax). Values outside of that range are
+     * counted in the first/last bin.
+     */
+    GlobalReduction(
+        const Selector<CELL_TYPE>& selector,
+        double histogramMin,
+        double histogramMax,
+        std::size_t numBins,
+        unsigned period = 1,
+        MPI_Comm communicator = MPI_COMM_WORLD) :
+        Steerer<CELL_TYPE>(period),
+        selector(selector),
+        operation(HISTOGRAM),
+        histogramMin(histogramMin),
+        histogramMax(histogramMax),
+        mpiLayer(communicator)
+    {
+        init(numBins);
+    }
+#else
+    GlobalReduction(
+        const Selector<CELL_TYPE>& selector,
+        Operation operation,
+        unsigned period = 1) :
+        Steerer<CELL_TYPE>(period),
+        selector(selector),
+        operation(operation),
+        histogramMin(0),
+        histogramMax(0)
+    {
+        init(1);
+    }
+
+    GlobalReduction(
+        const Selector<CELL_TYPE>& selector,
+        double histogramMin,
+        double histogramMax,
+        std::size_t numBins,
+        unsigned period = 1) :
+        Steerer<CELL_TYPE>(period),
+        selector(selector),
+        operation(HISTOGRAM),
+        histogramMin(histogramMin),
+        histogramMax(histogramMax)
+    {
+        init(numBins);
+    }
+#endif
+
+    ~GlobalReduction()
+    {
+        completePendingReduction();
+    }
+
+    virtual void nextStep(
+        GridType *grid,
+        const Region<DIM>& validRegion,
+        const CoordType& globalDimensions,
+        unsigned step,
+        SteererEvent event,
+        std::size_t rank,
+        bool lastCall,
+        SteererFeedback *feedback)
+    {
+        if (hasPendingReduction && (step > pendingStep)) {
+            completePendingReduction();
+        }
+
+        Partial& partial = partials[step];
+        if (partial.values.empty()) {
+            partial.values = neutralElement();
+        }
+
+        // Simulators may hand us ghost cells or call us multiple
+        // times with overlapping regions, so we need to make sure
+        // that each cell is counted exactly once:
+        Region<DIM> todo = (validRegion & region) - partial.coveredRegion;
+        if (!todo.empty()) {
+            partial.coveredRegion += todo;
+            reduceLocally(grid, todo, &partial.values);
+        }
+
+        if (lastCall) {
+            completePendingReduction();
+            startReduction(step, partial.values);
+            partials.erase(step);
+
+            if (event == STEERER_ALL_DONE) {
+                completePendingReduction();
+            }
+        }
+    }
+
+    /**
+     * The result of the most recently completed reduction for SUM,
+     * MIN or MAX. For histograms this yields the total count.
+     */
+    double value() const
+    {
+        if (operation == HISTOGRAM) {
+            double ret = 0;
+            for (std::size_t i = 0; i < result.size(); ++i) {
+                ret += result[i];
+            }
+            return ret;
+        }
+
+        return result[0];
+    }
+
+    /**
+     * The bin counts of the most recently completed histogram.
+     */
+    const std::vector<double>& bins() const
+    {
+        return result;
+    }
+
+    /**
+     * The time step to which value() and bins() refer.
+     */
+    unsigned resultStep() const
+    {
+        return currentResultStep;
+    }
+
+    /**
+     * Will be false until the first reduction has been completed.
+     */
+    bool hasResult() const
+    {
+        return resultAvailable;
+    }
+
+private:
+    class Partial
+    {
+    public:
+        std::vector<double> values;
+        Region<DIM> coveredRegion;
+    };
+
+    typedef void (GlobalReduction::*Accumulator)(const char*, std::size_t, std::vector<double>*) const;
+
+    Selector<CELL_TYPE> selector;
+    Operation operation;
+    double histogramMin;
+    double histogramMax;
+    std::size_t numBins;
+    Accumulator accumulator;
+    std::size_t valueSize;
+    std::map<unsigned, Partial> partials;
+    std::vector<char> buffer;
+    std::vector<double> sendBuffer;
+    std::vector<double> receiveBuffer;
+    std::vector<double> result;
+    unsigned pendingStep;
+    unsigned currentResultStep;
+    bool hasPendingReduction;
+    bool resultAvailable;
+#ifdef LIBGEODECOMP_WITH_MPI
+    MPILayer mpiLayer;
+#endif
+
+    void init(std::size_t newNumBins)
+    {
+        numBins = newNumBins;
+        pendingStep = 0;
+        currentResultStep = 0;
+        hasPendingReduction = false;
+        resultAvailable = false;
+
+        if ((operation == HISTOGRAM) && ((numBins == 0) || !(histogramMax > histogramMin))) {
+            throw std::invalid_argument("GlobalReduction needs at least one bin and a non-empty range for histograms");
+        }
+
+        if (!(tryValueType<double>() ||
+              tryValueType<float>() ||
+              tryValueType<int>() ||
+              tryValueType<unsigned>() ||
+              tryValueType<long>() ||
+              tryValueType<unsigned long>() ||
+              tryValueType<long long>() ||
+              tryValueType<unsigned long long>() ||
+              tryValueType<short>() ||
+              tryValueType<unsigned short>() ||
+              tryValueType<char>() ||
+              tryValueType<signed char>() ||
+              tryValueType<unsigned char>() ||
+              tryValueType<bool>())) {
+            throw std::invalid_argument(
+                "GlobalReduction can't handle type of member " + selector.name() + ", needs to be arithmetic");
+        }
+
+        result = neutralElement();
+    }
+
+    template<typename VALUE>
+    bool tryValueType()
+    {
+        if (!selector.template checkTypeID<VALUE>()) {
+            return false;
+        }
+
+        accumulator = &GlobalReduction::template accumulate<VALUE>;
+        valueSize = sizeof(VALUE);
+        return true;
+    }
+
+    std::vector<double> neutralElement() const
+    {
+        switch (operation) {
+        case MIN:
+            return std::vector<double>(1, std::numeric_limits<double>::infinity());
+        case MAX:
+            return std::vector<double>(1, -std::numeric_limits<double>::infinity());
+        case HISTOGRAM:
+            return std::vector<double>(numBins, 0);
+        default:
+            return std::vector<double>(1, 0);
+        }
+    }
+
+    void reduceLocally(GridType *grid, const Region<DIM>& todo, std::vector<double> *partial)
+    {
+        buffer.resize(todo.size() * selector.sizeOfExternal());
+        grid->saveMemberUnchecked(&buffer[0], MemoryLocation::HOST, selector, todo);
+        (this->*accumulator)(&buffer[0], buffer.size() / valueSize, partial);
+    }
+
+    template<typename VALUE>
+    void accumulate(const char *data, std::size_t numValues, std::vector<double> *partial) const
+    {
+        const VALUE *values = reinterpret_cast<const VALUE*>(data);
+        long numChunks = (numValues + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        std::vector<std::vector<double> > chunkPartials(numChunks, neutralElement());
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel for schedule(static)
+#endif
+        for (long chunk = 0; chunk < numChunks; ++chunk) {
+            std::size_t begin = chunk * CHUNK_SIZE;
+            std::size_t end = (std::min)(begin + CHUNK_SIZE, numValues);
+            accumulateChunk(values + begin, values + end, &chunkPartials[chunk]);
+        }
+
+        for (long chunk = 0; chunk < numChunks; ++chunk) {
+            combine(chunkPartials[chunk], partial);
+        }
+    }
+
+    template<typename VALUE>
+    void accumulateChunk(const VALUE *begin, const VALUE *end, std::vector<double> *partial) const
+    {
+        double& accu = (*partial)[0];
+
+        switch (operation) {
+        case SUM:
+            for (const VALUE *i = begin; i != end; ++i) {
+                accu += *i;
+            }
+            break;
+        case MIN:
+            for (const VALUE *i = begin; i != end; ++i) {
+                accu = (std::min)(accu, double(*i));
+            }
+            break;
+        case MAX:
+            for (const VALUE *i = begin; i != end; ++i) {
+                accu = (std::max)(accu, double(*i));
+            }
+            break;
+        case HISTOGRAM: {
+            double scale = numBins / (histogramMax - histogramMin);
+            long lastBin = numBins - 1;
+            for (const VALUE *i = begin; i != end; ++i) {
+                double bin = std::floor((*i - histogramMin) * scale);
+                (*partial)[(std::max)(0L, (std::min)(lastBin, long(bin)))] += 1;
+            }
+            break;
+        }
+        }
+    }
+
+    void combine(const std::vector<double>& source, std::vector<double> *target) const
+    {
+        for (std::size_t i = 0; i < source.size(); ++i) {
+            double& accu = (*target)[i];
+
+            switch (operation) {
+            case MIN:
+                accu = (std::min)(accu, source[i]);
+                break;
+            case MAX:
+                accu = (std::max)(accu, source[i]);
+                break;
+            default:
+                accu += source[i];
+                break;
+            }
+        }
+    }
+
+    void startReduction(unsigned step, const std::vector<double>& partial)
+    {
+        sendBuffer = partial;
+        receiveBuffer.resize(sendBuffer.size());
+        pendingStep = step;
+        hasPendingReduction = true;
+
+#ifdef LIBGEODECOMP_WITH_MPI
+        MPI_Op op = MPI_SUM;
+        if (operation == MIN) {
+            op = MPI_MIN;
+        }
+        if (operation == MAX) {
+            op = MPI_MAX;
+        }
+
+        mpiLayer.allReduceNonBlocking(
+            &sendBuffer[0],
+            &receiveBuffer[0],
+            sendBuffer.size(),
+            op,
+            MPILayer::GLOBAL_REDUCTION);
+#else
+        receiveBuffer = sendBuffer;
+#endif
+    }
+
+    void completePendingReduction()
+    {
+        if (!hasPendingReduction) {
+            return;
+        }
+
+#ifdef LIBGEODECOMP_WITH_MPI
+        mpiLayer.wait(MPILayer::GLOBAL_REDUCTION);
+#endif
+        result = receiveBuffer;
+        currentResultStep = pendingStep;
+        hasPendingReduction = false;
+        resultAvailable = true;
+    }
+};
+
+}
+
+#endif
@@ -10,10 +10,24 @@
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/loadbalancer/randombalancer.h>
 
+#include <algorithm>
+#include <map>
+#include <sstream>
+#include <utility>
+
 namespace LibGeoDecomp {
 
 /**
  * Utility class which bundles common MPI-based input/output code.
+ *
+ * By default all cells of a rank are transferred with a single
+ * collective MPI_File_read_all()/MPI_File_write_all() on a file view
+ * which maps the rank's Region to the file. This lets the MPI-IO
+ * layer aggregate requests from all ranks (two-phase I/O) instead of
+ * issuing one seek and one small read/write per streak. Independent
+ * I/O remains available as a fallback. Either way all ranks of the
+ * communicator need to participate in each call, as files are
+ * opened collectively.
  */
 template<
     typename CELL_TYPE,
@@ -22,6 +36,53 @@ template<
 class MPIIO
 {
 public:
+    /**
+     * MPI-IO hints (key/value pairs) which will be passed to
+     * MPI_File_open(), e.g. to tune collective buffering.
+     */
+    typedef std::map<std::string, std::string> Hints;
+
+    /**
+     * A streak's position within the file (in bytes, relative to the
+     * file view's displacement), paired with the streak itself.
+     */
+    template<int DIM>
+    class FileLayout : public std::vector<std::pair<MPI_Offset, Streak<DIM> > >
+    {};
+
+    explicit MPIIO(
+        bool collective = true,
+        const Hints& hints = Hints()) :
+        collective(collective),
+        hints(hints)
+    {}
+
+    /**
+     * Returns hints which enable two-phase collective buffering for
+     * reads and writes (ROMIO syntax). Zero values leave the number
+     * of aggregators and the buffer size to the MPI implementation.
+     */
+    static Hints collectiveBufferingHints(int aggregators = 0, std::size_t bufferSize = 0)
+    {
+        Hints ret;
+        ret["romio_cb_read"] = "enable";
+        ret["romio_cb_write"] = "enable";
+
+        if (aggregators > 0) {
+            std::ostringstream buf;
+            buf << aggregators;
+            ret["cb_nodes"] = buf.str();
+        }
+
+        if (bufferSize > 0) {
+            std::ostringstream buf;
+            buf << bufferSize;
+            ret["cb_buffer_size"] = buf.str();
+        }
+
+        return ret;
+    }
+
     template<typename GRID_TYPE, int DIM>
     void readRegion(
         GRID_TYPE *grid,
@@ -42,6 +103,25 @@ public:
         MPI_File_read(file, &cell, 1, mpiDatatype, MPI_STATUS_IGNORE);
         grid->setEdge(cell);
 
+        if (collective) {
+            FileLayout<DIM> layout = fileLayout(region, dimensions, cellLength);
+            std::vector<CELL_TYPE> buffer(region.size());
+
+            MPI_Datatype fileType = createFileType(layout, 1, cellLength, mpiDatatype);
+            MPI_File_set_view(file, headerLength, mpiDatatype, fileType, const_cast<char*>("native"), MPI_INFO_NULL);
+            MPI_File_read_all(file, bufferPointer(buffer), buffer.size(), mpiDatatype, MPI_STATUS_IGNORE);
+            MPI_Type_free(&fileType);
+
+            CELL_TYPE *cursor = bufferPointer(buffer);
+            for (typename FileLayout<DIM>::iterator i = layout.begin(); i != layout.end(); ++i) {
+                grid->set(i->second, cursor);
+                cursor += i->second.length();
+            }
+
+            MPI_File_close(&file);
+            return;
+        }
+
         for (typename Region<DIM>::StreakIterator i = region.beginStreak();
              i != region.endStreak();
              ++i) {
@@ -111,6 +191,25 @@ public:
                            1, mpiDatatype,  MPI_STATUS_IGNORE);
         }
 
+        if (collective) {
+            FileLayout<DIM> layout = fileLayout(region, dimensions, cellLength);
+            std::vector<CELL_TYPE> buffer(region.size());
+
+            CELL_TYPE *cursor = bufferPointer(buffer);
+            for (typename FileLayout<DIM>::iterator i = layout.begin(); i != layout.end(); ++i) {
+                grid.get(i->second, cursor);
+                cursor += i->second.length();
+            }
+
+            MPI_Datatype fileType = createFileType(layout, 1, cellLength, mpiDatatype);
+            MPI_File_set_view(file, headerLength, mpiDatatype, fileType, const_cast<char*>("native"), MPI_INFO_NULL);
+            MPI_File_write_all(file, bufferPointer(buffer), buffer.size(), mpiDatatype, MPI_STATUS_IGNORE);
+            MPI_Type_free(&fileType);
+
+            MPI_File_close(&file);
+            return;
+        }
+
         for (typename Region<DIM>::StreakIterator i = region.beginStreak();
              i != region.endStreak();
              ++i) {
@@ -138,10 +237,12 @@ public:
         MPI_Comm comm)
     {
         MPI_File file;
+        MPI_Info info = createInfo();
         MPI_File_open(
             comm, const_cast<char*>(filename.c_str()),
-            MPI_MODE_RDONLY, MPI_INFO_NULL,
+            MPI_MODE_RDONLY, info,
             &file);
+        freeInfo(&info);
         MPI_File_set_errhandler(file, MPI_ERRORS_ARE_FATAL);
         return file;
     }
@@ -152,10 +253,12 @@ public:
         MPI_Comm comm)
     {
         MPI_File file;
+        MPI_Info info = createInfo();
         MPI_File_open(
             comm, const_cast<char*>(filename.c_str()),
-            MPI_MODE_CREATE | MPI_MODE_WRONLY, MPI_INFO_NULL,
+            MPI_MODE_CREATE | MPI_MODE_WRONLY, info,
             &file);
+        freeInfo(&info);
         MPI_File_set_errhandler(file, MPI_ERRORS_ARE_FATAL);
         return file;
     }
@@ -168,9 +271,138 @@ public:
         return length;
     }
 
+    bool isCollective() const
+    {
+        return collective;
+    }
+
+    /**
+     * Computes where the region's streaks are located within a file
+     * which stores a grid of the given dimensions with
+     * bytesPerCell per cell. The result is sorted by file offset as
+     * MPI requires file views to have monotonically non-decreasing
+     * displacements (which a Region doesn't guarantee on tori).
+     */
+    template<int DIM>
+    FileLayout<DIM> fileLayout(
+        const Region<DIM>& region,
+        const Coord<DIM>& dimensions,
+        MPI_Offset bytesPerCell)
+    {
+        FileLayout<DIM> ret;
+        ret.reserve(region.numStreaks());
+
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak();
+             i != region.endStreak();
+             ++i) {
+            // the coords need to be normalized because on torus
+            // topologies the coordnates may exceed the bounding box
+            // (especially negative coordnates may occurr).
+            Coord<DIM> coord = TOPOLOGY::normalize(i->origin, dimensions);
+            ret.push_back(std::make_pair(offset(0, coord, dimensions, bytesPerCell), *i));
+        }
+
+        std::stable_sort(ret.begin(), ret.end(), CompareOffsets<DIM>());
+        return ret;
+    }
+
+    /**
+     * Creates (and commits) a file type which selects all streaks of
+     * the layout. Each cell is represented by elementsPerCell
+     * consecutive elements of type elementType, which are
+     * elementLength bytes wide. The caller is responsible for freeing
+     * the type.
+     */
+    template<int DIM>
+    MPI_Datatype createFileType(
+        const FileLayout<DIM>& layout,
+        int elementsPerCell,
+        MPI_Aint elementLength,
+        const MPI_Datatype& elementType)
+    {
+        std::vector<int> blockLengths;
+        std::vector<MPI_Aint> displacements;
+        blockLengths.reserve(layout.size());
+        displacements.reserve(layout.size());
+
+        for (typename FileLayout<DIM>::const_iterator i = layout.begin(); i != layout.end(); ++i) {
+            int length = i->second.length() * elementsPerCell;
+            MPI_Aint displacement = i->first;
+
+            // merge streaks which are adjacent in the file to keep the
+            // type description small:
+            if (!displacements.empty() &&
+                (displacements.back() + blockLengths.back() * elementLength == displacement)) {
+                blockLengths.back() += length;
+                continue;
+            }
+
+            blockLengths << length;
+            displacements << displacement;
+        }
+
+        MPI_Datatype ret;
+        MPI_Type_create_hindexed(
+            blockLengths.size(),
+            bufferPointer(blockLengths),
+            bufferPointer(displacements),
+            elementType,
+            &ret);
+        MPI_Type_commit(&ret);
+
+        return ret;
+    }
+
+    /**
+     * Returns a valid pointer even for empty buffers, which some MPI
+     * implementations insist on.
+     */
+    template<typename T>
+    static T *bufferPointer(std::vector<T>& buffer)
+    {
+        static T dummy;
+        return buffer.empty() ? &dummy : &buffer[0];
+    }
+
 private:
     // fixme: use MPILayer for MPI-IO
     MPILayer mpiLayer;
+    bool collective;
+    Hints hints;
+
+    template<int DIM>
+    class CompareOffsets
+    {
+    public:
+        bool operator()(
+            const std::pair<MPI_Offset, Streak<DIM> >& a,
+            const std::pair<MPI_Offset, Streak<DIM> >& b) const
+        {
+            return a.first < b.first;
+        }
+    };
+
+    MPI_Info createInfo() const
+    {
+        if (hints.empty()) {
+            return MPI_INFO_NULL;
+        }
+
+        MPI_Info info;
+        MPI_Info_create(&info);
+        for (Hints::const_iterator i = hints.begin(); i != hints.end(); ++i) {
+            MPI_Info_set(info, const_cast<char*>(i->first.c_str()), const_cast<char*>(i->second.c_str()));
+        }
+
+        return info;
+    }
+
+    void freeInfo(MPI_Info *info) const
+    {
+        if (*info != MPI_INFO_NULL) {
+            MPI_Info_free(info);
+        }
+    }
 
     template<int DIM>
     MPI_Offset offset(
@@ -24,13 +24,24 @@ public:
     typedef typename APITraits::SelectTopology<CELL_TYPE>::Value Topology;
     static const int DIM = Topology::DIM;
 
+    typedef typename MPIIO<CELL_TYPE>::Hints Hints;
+
+    /**
+     * All ranks of comm need to call grid() exactly once as the
+     * snapshot is read collectively (unless collective is set to
+     * false). hints are passed on to MPI_File_open(), see
+     * MPIIO::collectiveBufferingHints().
+     */
     explicit MPIIOInitializer(
         const std::string& filename,
         const MPI_Datatype& mpiDatatype = Typemaps::lookup<CELL_TYPE>(),
-        const MPI_Comm& comm = MPI_COMM_WORLD) :
+        const MPI_Comm& comm = MPI_COMM_WORLD,
+        bool collective = true,
+        const Hints& hints = Hints()) :
         file(filename),
         datatype(mpiDatatype),
-        communicator(comm)
+        communicator(comm),
+        mpiio(collective, hints)
     {
         mpiio.readMetadata(
             &dimensions, &currentStep, &maximumSteps, file, communicator);
@@ -31,16 +31,21 @@ public:
 
     static const int DIM = Topology::DIM;
 
+    typedef typename MPIIO<CELL_TYPE>::Hints Hints;
+
     MPIIOWriter(
         const std::string& prefix,
         const unsigned period,
         const unsigned maxSteps,
         const MPI_Comm& communicator = MPI_COMM_WORLD,
-        MPI_Datatype mpiDatatype = Typemaps::lookup<CELL_TYPE>()) :
+        MPI_Datatype mpiDatatype = Typemaps::lookup<CELL_TYPE>(),
+        bool collective = true,
+        const Hints& hints = Hints()) :
         Clonable<Writer<CELL_TYPE>, MPIIOWriter<CELL_TYPE> >(prefix, period),
         maxSteps(maxSteps),
         comm(communicator),
-        datatype(mpiDatatype)
+        datatype(mpiDatatype),
+        mpiio(collective, hints)
     {}
 
     virtual void stepFinished(const GridType& grid, unsigned step, WriterEvent event)
@@ -28,12 +28,22 @@ public:
     using ParallelWriter<CELL_TYPE>::period;
     using ParallelWriter<CELL_TYPE>::prefix;
 
+    typedef typename MPIIO<CELL_TYPE>::Hints Hints;
+
+    /**
+     * Snapshots are written via collective MPI-IO unless collective
+     * is set to false. hints are passed on to MPI_File_open(), see
+     * MPIIO::collectiveBufferingHints().
+     */
     ParallelMPIIOWriter(
         const std::string& prefix,
         const unsigned period,
         const unsigned maxSteps,
-        const MPI_Comm& communicator = MPI_COMM_WORLD) :
+        const MPI_Comm& communicator = MPI_COMM_WORLD,
+        bool collective = true,
+        const Hints& hints = Hints()) :
         Clonable<ParallelWriter<CELL_TYPE>, ParallelMPIIOWriter<CELL_TYPE> >(prefix, period),
+        mpiio(collective, hints),
         maxSteps(maxSteps),
         comm(communicator)
     {}
@@ -38,13 +38,17 @@ public:
     typedef Coord<Topology::DIM> CoordType;
 
     /**
-     * is the equivalent to Writer().
+     * is the equivalent to Writer(). If allDoneOnly is set, the
+     * writer will only be called once the simulation is done
+     * (WRITER_ALL_DONE), regardless of its period.
      */
     ParallelWriter(
         const std::string& prefix,
-        const unsigned period) :
+        const unsigned period,
+        const bool allDoneOnly = false) :
         prefix(prefix),
-        period(period)
+        period(period),
+        allDoneOnly(allDoneOnly)
     {
         if (period == 0) {
             throw std::invalid_argument("period must be positive");
@@ -103,6 +107,11 @@ public:
         return period;
     }
 
+    bool isAllDoneOnly() const
+    {
+        return allDoneOnly;
+    }
+
     const std::string& getPrefix() const
     {
         return prefix;
@@ -112,6 +121,7 @@ protected:
     Region<Topology::DIM> region;
     std::string prefix;
     unsigned period;
+    bool allDoneOnly;
 };
 
 }
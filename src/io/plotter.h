@@ -1,6 +1,8 @@
 #ifndef LIBGEODECOMP_IO_PLOTTER_H
 #define LIBGEODECOMP_IO_PLOTTER_H
 
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/io/imagepainter.h>
 #include <libgeodecomp/io/simplecellplotter.h>
 #include <libgeodecomp/io/writer.h>
 #include <libgeodecomp/storage/grid.h>
@@ -13,6 +15,7 @@
 #include <cmath>
 #endif
 
+#include <stdexcept>
 #include <vector>
 
 namespace LibGeoDecomp {
@@ -21,6 +24,11 @@ namespace LibGeoDecomp {
  * This class renders a 2D grid of cells by stitching together the 2D
  * tiles generated per cell by the CELL_PLOTTER. Useful for generating
  * output images in a Writer, e.g. PPMWriter.
+ *
+ * If the image would be too large, a stride may be given: then only
+ * every stride.x()-th cell along the x-axis (stride.y()-th along the
+ * y-axis) will be plotted, which yields a cheap level of detail
+ * reduction via nearest neighbor sampling.
  */
 template<typename CELL, class CELL_PLOTTER = SimpleCellPlotter<CELL> >
 class Plotter
@@ -28,12 +36,26 @@ class Plotter
 public:
     friend class PPMWriterTest;
 
+    /**
+     * Number of cells per tile for plotGridTiled(). A band of
+     * BAND_HEIGHT rows of cells is read from the grid at once, then
+     * its tiles are painted in parallel.
+     */
+    static const int TILE_WIDTH = 64;
+    static const int BAND_HEIGHT = 16;
+
     Plotter(
         const Coord<2>& cellDim,
-        const CELL_PLOTTER& cellPlotter) :
+        const CELL_PLOTTER& cellPlotter,
+        const Coord<2>& stride = Coord<2>(1, 1)) :
 	cellDim(cellDim),
-        cellPlotter(cellPlotter)
-    {}
+        cellPlotter(cellPlotter),
+        stride(stride)
+    {
+        if ((stride.x() < 1) || (stride.y() < 1)) {
+            throw std::invalid_argument("stride must be positive");
+        }
+    }
 
     virtual ~Plotter()
     {}
@@ -41,10 +63,7 @@ public:
     template<typename PAINTER>
     void plotGrid(const typename Writer<CELL>::GridType& grid, PAINTER& painter) const
     {
-        CoordBox<2> viewport(
-            Coord<2>(0, 0),
-            Coord<2>(cellDim.x() * grid.dimensions().x(),
-                     cellDim.y() * grid.dimensions().y()));
+        CoordBox<2> viewport(Coord<2>(0, 0), calcImageDim(grid.dimensions()));
         plotGridInViewport(grid, painter, viewport);
     }
 
@@ -58,40 +77,134 @@ public:
         PAINTER& painter,
         const CoordBox<2>& viewport) const
     {
-        int sx = viewport.origin.x() / cellDim.x();
-        int sy = viewport.origin.y() / cellDim.y();
-        int ex = ceil((double(viewport.origin.x()) + viewport.dimensions.x()) / cellDim.x());
-        int ey = ceil((double(viewport.origin.y()) + viewport.dimensions.y()) / cellDim.y());
-        ex = std::min(ex, grid.dimensions().x());
-        ey = std::min(ey, grid.dimensions().y());
-
-        for (int y = sy; y < ey; ++y) {
-            for (int x = sx; x < ex; ++x) {
-                Coord<2> relativeUpperLeft =
-                    Coord<2>(x * cellDim.x(),
-                             y * cellDim.y()) - viewport.origin;
-                painter.moveTo(relativeUpperLeft);
+        CoordBox<2> tiles = tilesInViewport(grid, viewport);
+
+        int ex = tiles.origin.x() + tiles.dimensions.x();
+        int ey = tiles.origin.y() + tiles.dimensions.y();
+
+        for (int y = tiles.origin.y(); y < ey; ++y) {
+            for (int x = tiles.origin.x(); x < ex; ++x) {
+                Coord<2> tile(x, y);
+                painter.moveTo(tile.scale(cellDim) - viewport.origin);
                 cellPlotter(
-                    grid.get(Coord<2>(x, y)),
+                    grid.get(tile.scale(stride)),
                     painter,
                     cellDim);
             }
         }
     }
 
+    /**
+     * Same as plotGrid(), but renders directly into an Image, which
+     * allows us to paint multiple tiles of the image in parallel
+     * (via OpenMP). Cells are fetched from the grid in bulk, one
+     * band at a time, as random access to e.g. SoA grids is neither
+     * fast nor thread-safe.
+     */
+    void plotGridTiled(const typename Writer<CELL>::GridType& grid, Image *image) const
+    {
+        plotGridTiledInViewport(grid, image, CoordBox<2>(Coord<2>(0, 0), image->getDimensions()));
+    }
+
+    void plotGridTiledInViewport(
+        const typename Writer<CELL>::GridType& grid,
+        Image *image,
+        const CoordBox<2>& viewport) const
+    {
+        CoordBox<2> tiles = tilesInViewport(grid, viewport);
+        if ((tiles.dimensions.x() <= 0) || (tiles.dimensions.y() <= 0)) {
+            return;
+        }
+
+        int startX = tiles.origin.x() * stride.x();
+        int endX = (tiles.origin.x() + tiles.dimensions.x() - 1) * stride.x() + 1;
+        int rowLength = endX - startX;
+        int tilesPerRow = (tiles.dimensions.x() - 1) / TILE_WIDTH + 1;
+        // local copy as std::min() takes its arguments by reference,
+        // which would require an out-of-class definition:
+        int maxBandHeight = BAND_HEIGHT;
+        std::vector<CELL> band;
+
+        for (int bandY = 0; bandY < tiles.dimensions.y(); bandY += BAND_HEIGHT) {
+            int bandHeight = (std::min)(maxBandHeight, tiles.dimensions.y() - bandY);
+            band.resize(std::size_t(rowLength) * bandHeight);
+
+            for (int y = 0; y < bandHeight; ++y) {
+                int gridY = (tiles.origin.y() + bandY + y) * stride.y();
+                grid.get(
+                    Streak<2>(Coord<2>(startX, gridY), endX),
+                    &band[std::size_t(rowLength) * y]);
+            }
+
+            int numTiles = tilesPerRow * bandHeight;
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel for schedule(dynamic)
+#endif
+            for (int t = 0; t < numTiles; ++t) {
+                int y = t / tilesPerRow;
+                int tileStart = (t % tilesPerRow) * TILE_WIDTH;
+                int tileEnd = (std::min)(tileStart + TILE_WIDTH, tiles.dimensions.x());
+                // each tile covers a disjoint set of pixels, so every
+                // thread can safely use its own painter:
+                ImagePainter painter(image);
+
+                for (int x = tileStart; x < tileEnd; ++x) {
+                    Coord<2> tile = tiles.origin + Coord<2>(x, bandY + y);
+                    painter.moveTo(tile.scale(cellDim) - viewport.origin);
+                    cellPlotter(
+                        band[std::size_t(rowLength) * y + x * stride.x()],
+                        painter,
+                        cellDim);
+                }
+            }
+        }
+    }
+
     const Coord<2>& getCellDim()
     {
         return cellDim;
     }
 
-    Coord<2> calcImageDim(const Coord<2>& gridDim)
+    const Coord<2>& getStride()
     {
-        return cellDim.scale(gridDim);
+        return stride;
+    }
+
+    Coord<2> calcImageDim(const Coord<2>& gridDim) const
+    {
+        return cellDim.scale(numTiles(gridDim));
     }
 
 private:
     Coord<2> cellDim;
     CELL_PLOTTER cellPlotter;
+    Coord<2> stride;
+
+    Coord<2> numTiles(const Coord<2>& gridDim) const
+    {
+        return Coord<2>(
+            (gridDim.x() + stride.x() - 1) / stride.x(),
+            (gridDim.y() + stride.y() - 1) / stride.y());
+    }
+
+    /**
+     * Returns the range of tiles (i.e. plotted cells, in units of
+     * the stride) which intersect the viewport.
+     */
+    CoordBox<2> tilesInViewport(
+        const typename Writer<CELL>::GridType& grid,
+        const CoordBox<2>& viewport) const
+    {
+        Coord<2> tiles = numTiles(grid.dimensions());
+        int sx = viewport.origin.x() / cellDim.x();
+        int sy = viewport.origin.y() / cellDim.y();
+        int ex = ceil((double(viewport.origin.x()) + viewport.dimensions.x()) / cellDim.x());
+        int ey = ceil((double(viewport.origin.y()) + viewport.dimensions.y()) / cellDim.y());
+        ex = std::min(ex, tiles.x());
+        ey = std::min(ey, tiles.y());
+
+        return CoordBox<2>(Coord<2>(sx, sy), Coord<2>(ex - sx, ey - sy));
+    }
 };
 
 }
@@ -14,6 +14,7 @@
 #include <fstream>
 #include <iomanip>
 #include <string>
+#include <vector>
 
 namespace LibGeoDecomp {
 
@@ -21,6 +22,10 @@ namespace LibGeoDecomp {
  * This writer will periodically write images in PPM format. The
  * CELL_PLOTTER is responsible for rendering individual cells into
  * tiles. The default will render uniformly colored tiles.
+ *
+ * For very large grids a stride may be specified, so that only every
+ * n-th cell gets plotted (see Plotter). Rendering is multi-threaded
+ * if OpenMP is available.
  */
 template<typename CELL_TYPE, typename CELL_PLOTTER = SimpleCellPlotter<CELL_TYPE> >
 class PPMWriter : public Clonable<Writer<CELL_TYPE>, PPMWriter<CELL_TYPE, CELL_PLOTTER> >
@@ -44,9 +49,10 @@ public:
         MEMBER maxValue,
         const std::string& prefix,
         const unsigned period = 1,
-        const Coord<2>& cellDimensions = Coord<2>(8, 8)) :
+        const Coord<2>& cellDimensions = Coord<2>(8, 8),
+        const Coord<2>& stride = Coord<2>(1, 1)) :
         Clonable<Writer<CELL_TYPE>, PPMWriter<CELL_TYPE, CELL_PLOTTER> >(prefix, period),
-        plotter(cellDimensions, CELL_PLOTTER(member, QuickPalette<MEMBER>(minValue, maxValue)))
+        plotter(cellDimensions, CELL_PLOTTER(member, QuickPalette<MEMBER>(minValue, maxValue)), stride)
     {}
 
     /**
@@ -60,9 +66,10 @@ public:
         const PALETTE& palette,
         const std::string& prefix,
         const unsigned period = 1,
-        const Coord<2>& cellDimensions = Coord<2>(8, 8)) :
+        const Coord<2>& cellDimensions = Coord<2>(8, 8),
+        const Coord<2>& stride = Coord<2>(1, 1)) :
         Clonable<Writer<CELL_TYPE>, PPMWriter<CELL_TYPE, CELL_PLOTTER> >(prefix, period),
-       plotter(cellDimensions, CELL_PLOTTER(member, palette))
+        plotter(cellDimensions, CELL_PLOTTER(member, palette), stride)
     {}
 
     virtual void stepFinished(const GridType& grid, unsigned step, WriterEvent event)
@@ -73,8 +80,7 @@ public:
 
         Coord<2> imageDim = plotter.calcImageDim(grid.boundingBox().dimensions);
         Image image(imageDim);
-        ImagePainter painter(&image);
-        plotter.plotGrid(grid, painter);
+        plotter.plotGridTiled(grid, &image);
         writePPM(image, step);
     }
 
@@ -86,7 +92,7 @@ public:
         std::ostringstream filename;
         filename << prefix << "." << std::setfill('0') << std::setw(4)
                  << step << ".ppm";
-        std::ofstream outfile(filename.str().c_str());
+        std::ofstream outfile(filename.str().c_str(), std::ios::binary);
         if (!outfile) {
             throw FileOpenException(filename.str());
         }
@@ -95,13 +101,17 @@ public:
         outfile << "P6 " << img.getDimensions().x()
                 << " "   << img.getDimensions().y() << " 255\n";
 
-        // body second:
+        // body second, one line at a time:
+        std::vector<char> buffer(3 * img.getDimensions().x());
         for (int y = 0; y < img.getDimensions().y(); ++y) {
             for (int x = 0; x < img.getDimensions().x(); ++x) {
                 const Color& rgb = img[Coord<2>(x, y)];
-                outfile << (char)rgb.red()
-                        << (char)rgb.green()
-                        << (char)rgb.blue();
+                buffer[3 * x + 0] = rgb.red();
+                buffer[3 * x + 1] = rgb.green();
+                buffer[3 * x + 2] = rgb.blue();
+            }
+            if (!buffer.empty()) {
+                outfile.write(&buffer[0], buffer.size());
             }
         }
 
@@ -2,13 +2,15 @@
 #define LIBGEODECOMP_IO_REMOTESTEERER_H
 
 #include <libgeodecomp/config.h>
-#ifdef LIBGEODECOMP_WITH_BOOST_ASIO
+#ifdef LIBGEODECOMP_WITH_REMOTE_STEERER
 #ifdef LIBGEODECOMP_WITH_THREADS
 #ifdef LIBGEODECOMP_WITH_MPI
 
 #include <libgeodecomp/communication/typemaps.h>
 #include <libgeodecomp/communication/mpilayer.h>
 #include <libgeodecomp/io/steerer.h>
+#include <libgeodecomp/io/remotesteerer/bulkgetaction.h>
+#include <libgeodecomp/io/remotesteerer/bulkgethandler.h>
 #include <libgeodecomp/io/remotesteerer/commandserver.h>
 #include <libgeodecomp/io/remotesteerer/handler.h>
 #include <libgeodecomp/io/remotesteerer/gethandler.h>
@@ -47,17 +49,22 @@ public:
     typedef std::map<std::string, typename SharedPtr<Handler<CELL_TYPE> >::Type> HandlerMap;
     static const int DIM = Topology::DIM;
 
+    /**
+     * If unixSocketPath is given, the CommandServer will accept
+     * connections via that Unix domain socket, too.
+     */
     RemoteSteerer(
         unsigned period,
         int port,
         int root = 0,
-        MPI_Comm communicator = MPI_COMM_WORLD) :
+        MPI_Comm communicator = MPI_COMM_WORLD,
+        const std::string& unixSocketPath = "") :
         Steerer<CELL_TYPE>(period),
         port(port),
         pipe(new Pipe(root, communicator))
     {
         if (MPILayer(communicator).rank() == root) {
-            commandServer.reset(new CommandServer<CELL_TYPE>(port, pipe));
+            commandServer.reset(new CommandServer<CELL_TYPE>(port, pipe, unixSocketPath));
         }
     }
 
@@ -121,6 +128,20 @@ public:
         handlers["get_" + accessor->name()].reset(new GetHandler<CELL_TYPE, MEMBER_TYPE>(accessorPtr));
     }
 
+    /**
+     * Adds the command "bulk_NAME" (with NAME being the selector's
+     * name) which streams the selected member of a box in binary
+     * form. See BulkGetHandler for details.
+     */
+    void addSelector(const Selector<CELL_TYPE>& selector)
+    {
+        if (commandServer) {
+            addAction(new BulkGetAction<CELL_TYPE>(selector.name()));
+        }
+
+        addHandler(new BulkGetHandler<CELL_TYPE>(selector));
+    }
+
     void sendCommand(const std::string& command)
     {
         CommandServer<CELL_TYPE>::sendCommand(command, port);
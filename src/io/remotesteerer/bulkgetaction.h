@@ -0,0 +1,31 @@
+#ifndef LIBGEODECOMP_IO_REMOTESTEERER_BULKGETACTION_H
+#define LIBGEODECOMP_IO_REMOTESTEERER_BULKGETACTION_H
+
+#include <libgeodecomp/io/remotesteerer/passthroughaction.h>
+
+namespace LibGeoDecomp {
+
+namespace RemoteSteererHelpers {
+
+/**
+ * Streams the raw values of the specified member for a whole box,
+ * see BulkGetHandler for the reply format.
+ */
+template<typename CELL_TYPE>
+class BulkGetAction : public PassThroughAction<CELL_TYPE>
+{
+public:
+    explicit BulkGetAction(const std::string& memberName) :
+        PassThroughAction<CELL_TYPE>(
+            "bulk_" + memberName,
+            "usage: \"bulk_" + memberName +
+            " X Y [Z] DIM_X DIM_Y [DIM_Z]\", will return the binary values of member " + memberName +
+            " for all cells within the box at origin (X, Y, Z) with the given dimensions")
+    {}
+};
+
+}
+
+}
+
+#endif
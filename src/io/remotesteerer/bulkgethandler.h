@@ -0,0 +1,95 @@
+#ifndef LIBGEODECOMP_IO_REMOTESTEERER_BULKGETHANDLER_H
+#define LIBGEODECOMP_IO_REMOTESTEERER_BULKGETHANDLER_H
+
+#include <libgeodecomp/io/remotesteerer/handler.h>
+#include <libgeodecomp/storage/selector.h>
+
+#include <sstream>
+
+namespace LibGeoDecomp {
+
+namespace RemoteSteererHelpers {
+
+/**
+ * Copies a member of all cells within a box to the user in binary
+ * form, via Selector and GridBase::saveMemberUnchecked(). This avoids
+ * formatting each cell as a string, so monitoring even large regions
+ * is cheap for the simulation.
+ *
+ * Each node replies with one feedback entry for its share of the
+ * box (nodes which don't hold any part of the box stay silent):
+ *
+ *   bulk NAME STEP NUM_STREAKS NUM_BYTES
+ *   X Y [Z] END_X
+ *   ...
+ *   <NUM_BYTES bytes of raw member data>
+ *
+ * The NUM_STREAKS lines following the header give the streaks which
+ * the data covers, in the order in which the values are stored. The
+ * reply is complete once the streaks cover the requested box.
+ */
+template<typename CELL_TYPE>
+class BulkGetHandler : public Handler<CELL_TYPE>
+{
+public:
+    typedef typename APITraits::SelectTopology<CELL_TYPE>::Value Topology;
+    typedef GridBase<CELL_TYPE, Topology::DIM> GridType;
+
+    static const int DIM = Topology::DIM;
+
+    explicit BulkGetHandler(const Selector<CELL_TYPE>& selector) :
+        Handler<CELL_TYPE>("bulk_" + selector.name()),
+        selector(selector)
+    {}
+
+    virtual bool operator()(const StringVec& parameters, Pipe& pipe, GridType *grid, const Region<DIM>& validRegion, unsigned step)
+    {
+        if (parameters.size() != (2 * DIM)) {
+            pipe.addSteeringFeedback("bad parameters for bulk_" + selector.name() + ", expected " + StringOps::itoa(2 * DIM));
+            return true;
+        }
+
+        Coord<DIM> origin;
+        Coord<DIM> dimensions;
+        for (int d = 0; d < DIM; ++d) {
+            origin[d]     = StringOps::atoi(parameters[d]);
+            dimensions[d] = StringOps::atoi(parameters[DIM + d]);
+        }
+
+        Region<DIM> region;
+        region << CoordBox<DIM>(origin, dimensions);
+        region &= validRegion;
+        if (region.empty()) {
+            return true;
+        }
+
+        std::size_t numBytes = region.size() * selector.sizeOfExternal();
+        buffer.resize(numBytes);
+        grid->saveMemberUnchecked(&buffer[0], MemoryLocation::HOST, selector, region);
+
+        std::stringstream header;
+        header << "bulk " << selector.name() << " " << step << " " << region.numStreaks() << " " << numBytes << "\n";
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            for (int d = 0; d < DIM; ++d) {
+                header << i->origin[d] << " ";
+            }
+            header << i->endX << "\n";
+        }
+
+        std::string reply = header.str();
+        reply.append(buffer.begin(), buffer.end());
+        pipe.addSteeringFeedback(reply);
+
+        return true;
+    }
+
+private:
+    Selector<CELL_TYPE> selector;
+    std::vector<char> buffer;
+};
+
+}
+
+}
+
+#endif
@@ -6,25 +6,39 @@
 #include <libgeodecomp/io/remotesteerer/action.h>
 #include <libgeodecomp/io/remotesteerer/getaction.h>
 #include <libgeodecomp/io/remotesteerer/interactor.h>
+#include <libgeodecomp/io/remotesteerer/socket.h>
 #include <libgeodecomp/io/remotesteerer/waitaction.h>
 #include <libgeodecomp/misc/stringops.h>
 
 #include <cerrno>
-#include <iostream>
+#include <cstring>
+#include <map>
+#include <mutex>
 #include <string>
 #include <stdexcept>
-#include <map>
+#include <thread>
+#include <vector>
+
+#include <poll.h>
 
 namespace LibGeoDecomp {
 
 namespace RemoteSteererHelpers {
 
 /**
- * A server which can be reached by TCP (nc, telnet, ...). Its purpose
- * is to do connection handling and parsing of incoming user commands.
- * Action objects can be bound to certain commands and will be
- * invoked. This allows a flexible extension of the CommandServer's
- * functionality by composition, without having to resort to inheritance.
+ * A server which can be reached by TCP (nc, telnet, ...) and,
+ * optionally, via a Unix domain socket. Its purpose is to do
+ * connection handling and parsing of incoming user commands. Action
+ * objects can be bound to certain commands and will be invoked. This
+ * allows a flexible extension of the CommandServer's functionality by
+ * composition, without having to resort to inheritance.
+ *
+ * All sockets are served by a single thread running a poll() based
+ * event loop, so any number of clients may be connected at once and
+ * no call will block the simulation. Steering feedback is forwarded
+ * to the client which most recently issued a command as soon as it
+ * becomes available. While no client is connected, feedback remains
+ * in the Pipe.
  */
 template<typename CELL_TYPE>
 class CommandServer
@@ -33,9 +47,12 @@ public:
     typedef std::map<std::string, typename SharedPtr<Action<CELL_TYPE> >::Type > ActionMap;
 
     /**
-     * This helper class lets us and the user safely close the
-     * CommandServer's network service, which is nice as it is using
-     * blocking IO and it's a major PITA to cancel that.
+     * Upper bound for the latency of feedback forwarding.
+     */
+    static const int POLL_INTERVAL = 20;
+
+    /**
+     * Lets the user close the CommandServer's network service.
      */
     // fixme: move to dedicated file
     class QuitAction : public Action<CELL_TYPE>
@@ -58,9 +75,7 @@ public:
 
     /**
      * This class is just a NOP, which may be used by the client to
-     * retrieve new steering feedback. This can't happen automatically
-     * as the CommandServer's listener thread blocks for input from
-     * the client.
+     * check whether the CommandServer is still alive.
      */
     // fixme: move to dedicated file
     class PingAction : public Action<CELL_TYPE>
@@ -69,74 +84,82 @@ public:
         using Action<CELL_TYPE>::key;
 
         PingAction() :
-            Action<CELL_TYPE>("ping", "wake the CommandServer, useful to retrieve a new batch of feedback"),
+            Action<CELL_TYPE>("ping", "check whether the CommandServer is alive, replies with \"pong N\""),
             c(0)
         {}
 
         void operator()(const StringVec& parameters, Pipe& pipe)
         {
-            // // Do only reply if there is no feedback already waiting.
-            // // This is useful if the client is using ping to keep us
-            // // alive, but can only savely read back one line in
-            // // return. In that case this stragety avoids a memory leak
-            // // in our write buffer.
-            // if (pipe.copySteeringFeedback().size() == 0) {
-                pipe.addSteeringFeedback("pong " + StringOps::itoa(++c));
-            // }
+            pipe.addSteeringFeedback("pong " + StringOps::itoa(++c));
         }
 
     private:
         int c;
     };
 
+    /**
+     * Binds the server to port (and unixSocketPath, unless empty).
+     * Throws an IOException if that fails.
+     */
     CommandServer(
         int port,
-        SharedPtr<Pipe>::Type pipe) :
+        SharedPtr<Pipe>::Type pipe,
+        const std::string& unixSocketPath = "") :
         port(port),
-        pipe(pipe)
-        // serverThread(&CommandServer::runServer, this)
+        unixSocketPath(unixSocketPath),
+        pipe(pipe),
+        activeClient(-1),
+        continueFlag(true)
     {
         addAction(new QuitAction(&continueFlag));
         addAction(new PingAction);
         addAction(new WaitAction<CELL_TYPE>);
 
-        // The thread may take a while to start up. We need to wait
-        // here so we don't try to clean up in the d-tor before the
-        // thread has created anything.
+        if (::pipe(wakeupFDs) != 0) {
+            throw IOException(std::string("could not create wakeup pipe: ") + std::strerror(errno));
+        }
+
+        try {
+            listenFDs << Socket::listenTCP(port);
+            if (!unixSocketPath.empty()) {
+                listenFDs << Socket::listenUnix(unixSocketPath);
+            }
 
-        // fixme
-        // boost::unique_lock<boost::mutex> lock(mutex);
-        // while(!acceptor) {
-        //     threadCreationVar.wait(lock);
-        // }
+            for (std::vector<int>::iterator i = listenFDs.begin(); i != listenFDs.end(); ++i) {
+                Socket::setNonBlocking(*i);
+            }
+        } catch (...) {
+            closeAll();
+            throw;
+        }
+
+        serverThread = std::thread(&CommandServer::runServer, this);
     }
 
     ~CommandServer()
     {
-        // fixme
-        // signalClose();
-        // LOG(DBG, "CommandServer waiting for network thread");
-        // serverThread.join();
+        signalClose();
+        LOG(DBG, "CommandServer waiting for network thread");
+        serverThread.join();
+        closeAll();
     }
 
     /**
      * Sends a message back to the end user. This is the primary way
-     * for (user-defined) Actions to give feedback.
+     * for (user-defined) Actions to give feedback, which is why it
+     * may only be called from within Actions (i.e. from the
+     * CommandServer's thread). Data is sent asynchronously.
      */
     void sendMessage(const std::string& message)
     {
         LOG(DBG, "CommandServer::sendMessage(" << message << ")");
-        // fixme
-        // boost::system::error_code errorCode;
-        // boost::asio::write(
-        //     *socket,
-        //     boost::asio::buffer(message),
-        //     boost::asio::transfer_all(),
-        //     errorCode);
-
-        // if (errorCode) {
-        //     LOG(WARN, "CommandServer::sendMessage encountered " << errorCode.message());
-        // }
+        typename ClientMap::iterator client = clients.find(activeClient);
+        if (client == clients.end()) {
+            LOG(WARN, "CommandServer::sendMessage: no client connected");
+            return;
+        }
+
+        client->second.output += message;
     }
 
     /**
@@ -154,52 +177,6 @@ public:
         Interactor interactor(command, feedbackLines, false, port, host);
         interactor();
         return interactor.feedback();
-        // fixme
-        // boost::asio::io_service ioService;
-        // tcp::resolver resolver(ioService);
-        // tcp::resolver::query query(host, StringOps::itoa(port));
-        // tcp::resolver::iterator endpointIterator = resolver.resolve(query);
-        // tcp::socket socket(ioService);
-        // boost::asio::connect(socket, endpointIterator);
-        // boost::system::error_code errorCode;
-
-        // boost::asio::write(
-        //     socket,
-        //     boost::asio::buffer(command),
-        //     boost::asio::transfer_all(),
-        //     errorCode);
-
-        // if (errorCode) {
-        //     LOG(WARN, "error while writing to socket: " << errorCode.message());
-        // }
-
-        StringVec ret;
-
-        for (int i = 0; i < feedbackLines; ++i) {
-            // fixme
-            // boost::asio::streambuf buf;
-            // boost::system::error_code errorCode;
-
-            LOG(DBG, "CommandServer::sendCommandWithFeedback() reading line");
-
-            // fixme
-            // std::size_t length = boost::asio::read_until(socket, buf, '\n', errorCode);
-            // if (errorCode) {
-            //     LOG(WARN, "error while writing to socket: " << errorCode.message());
-            // }
-
-            // // purge \n at end of line
-            // if (length) {
-            //     length -= 1;
-            // }
-
-            // std::istream lineBuf(&buf);
-            // std::string line(length, 'X');
-            // lineBuf.read(&line[0], length);
-            // ret << line;
-        }
-
-        return ret;
     }
 
     /**
@@ -209,58 +186,209 @@ public:
      */
     void addAction(Action<CELL_TYPE> *action)
     {
+        std::lock_guard<std::mutex> lock(actionsMutex);
         actions[action->key()] = typename SharedPtr<Action<CELL_TYPE> >::Type(action);
     }
 
 private:
+    /**
+     * Per-connection state. Input is buffered until a complete line
+     * has arrived, output until the socket is writable.
+     */
+    class Client
+    {
+    public:
+        std::string input;
+        std::string output;
+    };
+
+    typedef std::map<int, Client> ClientMap;
+
     int port;
+    std::string unixSocketPath;
     SharedPtr<Pipe>::Type pipe;
-    // fixme
-    // boost::asio::io_service ioService;
-    // SharedPtr<tcp::acceptor>::Type acceptor;
-    // SharedPtr<tcp::socket>::Type socket;
-    // boost::thread serverThread;
-    // boost::condition_variable threadCreationVar;
-    // boost::mutex mutex;
+    std::thread serverThread;
+    std::mutex actionsMutex;
     ActionMap actions;
+    int wakeupFDs[2];
+    std::vector<int> listenFDs;
+    ClientMap clients;
+    int activeClient;
     bool continueFlag;
 
-    void runSession()
+    void runServer()
     {
-        // fixme
-        // for (;;) {
-        //     boost::array<char, 1024> buf;
-        //     boost::system::error_code errorCode;
-        //     LOG(DBG, "CommandServer::runSession(): reading");
-        //     std::size_t length = socket->read_some(boost::asio::buffer(buf), errorCode);
-        //     LOG(DBG, "CommandServer::runSession(): read " << length << " bytes");
-
-        //     if (length > 0) {
-        //         std::string input(buf.data(), length);
-        //         handleInput(input);
-        //     }
-
-        //     if (errorCode == boost::asio::error::eof) {
-        //         LOG(INFO, "CommandServer::runSession(): client closed connection");
-        //         return;
-        //     }
-
-        //     if (errorCode) {
-        //         LOG(WARN, "CommandServer::runSession encountered " << errorCode.message());
-        //     }
-
-        //     if (!socket->is_open()) {
-        //         return;
-        //     }
-
-        //     StringVec feedback = pipe->retrieveSteeringFeedback();
-        //     for (StringVec::iterator i = feedback.begin();
-        //          i != feedback.end();
-        //          ++i) {
-        //         LOG(DBG, "CommandServer::runSession sending »" << *i << "«");
-        //         sendMessage(*i + "\n");
-        //     }
-        // }
+        std::vector<pollfd> fds;
+
+        while (continueFlag) {
+            fds.clear();
+            addPollFD(&fds, wakeupFDs[0], POLLIN);
+            for (std::vector<int>::iterator i = listenFDs.begin(); i != listenFDs.end(); ++i) {
+                addPollFD(&fds, *i, POLLIN);
+            }
+            for (typename ClientMap::iterator i = clients.begin(); i != clients.end(); ++i) {
+                addPollFD(&fds, i->first, POLLIN | (i->second.output.empty() ? 0 : POLLOUT));
+            }
+
+            int res = poll(&fds[0], fds.size(), POLL_INTERVAL);
+            if ((res < 0) && (errno != EINTR)) {
+                LOG(FATAL, "CommandServer::runServer() listening on port " << port
+                    << " encountered " << std::strerror(errno) << ", exiting");
+                return;
+            }
+
+            if (fds[0].revents & POLLIN) {
+                // the simulation may have queued feedback right
+                // before shutting us down, which the client still
+                // waits for:
+                forwardFeedback();
+                return;
+            }
+
+            std::size_t cursor = 1;
+            for (; cursor < (1 + listenFDs.size()); ++cursor) {
+                if (fds[cursor].revents & POLLIN) {
+                    acceptClients(fds[cursor].fd);
+                }
+            }
+
+            for (; cursor < fds.size(); ++cursor) {
+                int fd = fds[cursor].fd;
+                short events = fds[cursor].revents;
+                bool open = true;
+
+                if (events & (POLLIN | POLLHUP | POLLERR)) {
+                    open = readFromClient(fd);
+                }
+                if (open && (events & POLLOUT)) {
+                    open = flush(fd);
+                }
+                if (!open) {
+                    closeClient(fd);
+                }
+            }
+
+            forwardFeedback();
+        }
+    }
+
+    static void addPollFD(std::vector<pollfd> *fds, int fd, short events)
+    {
+        pollfd entry;
+        entry.fd = fd;
+        entry.events = events;
+        entry.revents = 0;
+        *fds << entry;
+    }
+
+    void acceptClients(int listenFD)
+    {
+        for (;;) {
+            int fd = accept(listenFD, 0, 0);
+            if (fd < 0) {
+                if ((errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR)) {
+                    LOG(WARN, "CommandServer::acceptClients() encountered " << std::strerror(errno));
+                }
+                return;
+            }
+
+            Socket::setNonBlocking(fd);
+            clients[fd] = Client();
+            LOG(INFO, "CommandServer: client connected");
+        }
+    }
+
+    /**
+     * Returns false if the connection has been closed.
+     */
+    bool readFromClient(int fd)
+    {
+        char buf[4096];
+        Client& client = clients[fd];
+
+        for (;;) {
+            ssize_t length = recv(fd, buf, sizeof(buf), 0);
+            if (length == 0) {
+                LOG(INFO, "CommandServer: client closed connection");
+                return false;
+            }
+            if (length < 0) {
+                if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                    break;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                LOG(WARN, "CommandServer::readFromClient() encountered " << std::strerror(errno));
+                return false;
+            }
+
+            client.input.append(buf, length);
+        }
+
+        std::size_t end = client.input.rfind('\n');
+        if (end != std::string::npos) {
+            std::string lines = client.input.substr(0, end + 1);
+            client.input.erase(0, end + 1);
+            activeClient = fd;
+            handleInput(lines);
+        }
+
+        return true;
+    }
+
+    /**
+     * Returns false if the connection has been closed.
+     */
+    bool flush(int fd)
+    {
+        std::string& output = clients[fd].output;
+
+        while (!output.empty()) {
+            ssize_t written = send(fd, output.data(), output.size(), MSG_NOSIGNAL);
+            if (written < 0) {
+                if ((errno == EAGAIN) || (errno == EWOULDBLOCK)) {
+                    break;
+                }
+                if (errno == EINTR) {
+                    continue;
+                }
+                LOG(WARN, "CommandServer::flush() encountered " << std::strerror(errno));
+                return false;
+            }
+
+            output.erase(0, written);
+        }
+
+        return true;
+    }
+
+    void forwardFeedback()
+    {
+        typename ClientMap::iterator client = clients.find(activeClient);
+        if (client == clients.end()) {
+            return;
+        }
+
+        StringVec feedback = pipe->retrieveSteeringFeedback();
+        for (StringVec::iterator i = feedback.begin(); i != feedback.end(); ++i) {
+            LOG(DBG, "CommandServer::forwardFeedback sending »" << *i << "«");
+            client->second.output += *i;
+            client->second.output += '\n';
+        }
+
+        if (!client->second.output.empty() && !flush(activeClient)) {
+            closeClient(activeClient);
+        }
+    }
+
+    void closeClient(int fd)
+    {
+        close(fd);
+        clients.erase(fd);
+        if (activeClient == fd) {
+            activeClient = -1;
+        }
     }
 
     void handleInput(const std::string& input)
@@ -286,57 +414,51 @@ private:
             }
 
             std::string command = pop_front(parameters);
-            if (actions.count(command) == 0) {
+            typename SharedPtr<Action<CELL_TYPE> >::Type action;
+            {
+                std::lock_guard<std::mutex> lock(actionsMutex);
+                typename ActionMap::iterator i = actions.find(command);
+                if (i != actions.end()) {
+                    action = i->second;
+                }
+            }
+
+            if (!action) {
                 std::string message = "command not found: " + command;
                 LOG(WARN, message);
                 pipe->addSteeringFeedback(message);
                 pipe->addSteeringFeedback("try \"help\"");
             } else {
-                (*actions[command])(parameters, *pipe);
+                (*action)(parameters, *pipe);
             }
         }
     }
 
-    int runServer()
+    void signalClose()
     {
-        // fixme
-        // try {
-        //     // Thread-aware initialization, allows c-tor to exit safely.
-        //     {
-        //         boost::unique_lock<boost::mutex> lock(mutex);
-        //         acceptor.reset(new tcp::acceptor(ioService, tcp::endpoint(tcp::v4(), port)));
-        //     }
-        //     threadCreationVar.notify_one();
-
-        //     boost::system::error_code errorCode;
-        //     continueFlag = true;
-
-        //     while (continueFlag) {
-        //         LOG(DBG, "CommandServer: waiting for new connection");
-        //         socket.reset(new tcp::socket(ioService));
-        //         acceptor->accept(*socket, errorCode);
-
-        //         if (errorCode) {
-        //             LOG(WARN, "CommandServer::runServer() encountered " << errorCode.message());
-        //         } else {
-        //             LOG(INFO, "CommandServer: client connected");
-        //             runSession();
-        //             LOG(INFO, "CommandServer: client disconnected");
-        //         }
-        //     }
-        // }
-        // catch (std::exception& e) {
-        //     LOG(FATAL, "CommandServer::runServer() listening on port " << port
-        //         << " caught exception " << e.what() << ", exiting");
-        //     return 1;
-        // }
-
-        return 0;
+        char c = 0;
+        while ((write(wakeupFDs[1], &c, 1) < 0) && (errno == EINTR)) {
+        }
     }
 
-    void signalClose()
+    void closeAll()
     {
-        sendCommand("quit", port);
+        for (typename ClientMap::iterator i = clients.begin(); i != clients.end(); ++i) {
+            close(i->first);
+        }
+        clients.clear();
+
+        for (std::vector<int>::iterator i = listenFDs.begin(); i != listenFDs.end(); ++i) {
+            close(*i);
+        }
+        listenFDs.clear();
+
+        if (!unixSocketPath.empty()) {
+            unlink(unixSocketPath.c_str());
+        }
+
+        close(wakeupFDs[0]);
+        close(wakeupFDs[1]);
     }
 };
 
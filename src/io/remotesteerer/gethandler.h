@@ -5,6 +5,8 @@
 #include <libgeodecomp/misc/sharedptr.h>
 #include <libgeodecomp/storage/dataaccessor.h>
 
+#include <sstream>
+
 namespace LibGeoDecomp {
 
 namespace RemoteSteererHelpers {
@@ -27,32 +29,37 @@ public:
         accessor(accessor)
     {}
 
+    /**
+     * Expects the parameters "T X Y [Z]". Requests for future time
+     * steps are deferred, the node which owns the cell replies with
+     * "NAME(X, Y[, Z]) = VALUE".
+     */
     virtual bool operator()(const StringVec& parameters, Pipe& pipe, GridType *grid, const Region<DIM>& validRegion, unsigned step)
     {
         LOG(DBG, "GetHander::operator()(" << parameters << " step: " << step << ")");
 
-        Coord<DIM> c;
-        int index;
+        if (parameters.size() < std::size_t(DIM + 1)) {
+            pipe.addSteeringFeedback("usage: get_" + accessor->name() + " T X Y [Z]");
+            return true;
+        }
 
         unsigned time = StringOps::atoi(parameters[0]);
-
-        for (index = 1; index < DIM; ++index) {
-            c[index] = StringOps::atoi(parameters[index]);
+        if (step < time) {
+            return false;
         }
 
-        if (step > time) {
-            return true;
+        Coord<DIM> c;
+        for (int d = 0; d < DIM; ++d) {
+            c[d] = StringOps::atoi(parameters[d + 1]);
         }
 
-        std::cout << "get(" << MPILayer().rank() << ") " << c << "\n";
-        pipe.addSteeringFeedback("bingo bongo");
-
         if (validRegion.count(c)) {
-            std::cout << "  get result(" << c << ") = " << accessor->get(grid->get(c)) << "\n";
-            return true;
+            std::stringstream buf;
+            buf << accessor->name() << c << " = " << accessor->get(grid->get(c));
+            pipe.addSteeringFeedback(buf.str());
         }
 
-        return false;
+        return true;
     }
 
 private:
@@ -2,9 +2,14 @@
 #define LIBGEODECOMP_IO_REMOTESTEERER_INTERACTOR_H
 
 #include <libgeodecomp/io/logger.h>
+#include <libgeodecomp/io/remotesteerer/socket.h>
 #include <libgeodecomp/misc/stringops.h>
 #include <libgeodecomp/misc/stringvec.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace LibGeoDecomp {
 
 namespace RemoteSteererHelpers {
@@ -18,7 +23,6 @@ namespace RemoteSteererHelpers {
 class Interactor
 {
 public:
-
     Interactor(
         const std::string& command,
         std::size_t feedbackLines,
@@ -37,132 +41,163 @@ public:
         // are set in advance. But this is crucial as otherwise the
         // results of the thread might be overwritten.
         if (threaded) {
-            // fixme
-            // thread = boost::thread(ThreadWrapper<Interactor>(this));
+            thread = std::thread(ThreadWrapper<Interactor>(this));
+            waitForStartup();
+        }
+    }
+
+    /**
+     * Connects via the Unix domain socket at unixSocketPath instead
+     * of TCP.
+     */
+    Interactor(
+        const std::string& command,
+        std::size_t feedbackLines,
+        bool threaded,
+        const std::string& unixSocketPath) :
+        command(command),
+        feedbackLines(feedbackLines),
+        port(-1),
+        unixSocketPath(unixSocketPath),
+        started(false),
+        completed(false)
+    {
+        if (threaded) {
+            thread = std::thread(ThreadWrapper<Interactor>(this));
             waitForStartup();
         }
     }
 
     ~Interactor()
     {
-        // fixme
-        // if (thread.joinable()) {
-        //     thread.join();
-        // }
+        if (thread.joinable()) {
+            thread.join();
+        }
     }
 
     void waitForCompletion()
     {
-        // fixme
-
-        // boost::unique_lock<boost::mutex> lock(mutex);
-        // while(!completed) {
-        //     signal.wait(lock);
-        // }
+        std::unique_lock<std::mutex> lock(mutex);
+        while(!completed) {
+            signal.wait(lock);
+        }
     }
 
     StringVec feedback()
     {
+        std::lock_guard<std::mutex> lock(mutex);
         return feedbackBuffer;
     }
 
     int operator()()
     {
         LOG(DBG, "Interactor::operator(" << command << ")");
-        // fixme
-        // boost::asio::io_service ioService;
-        // tcp::resolver resolver(ioService);
-        // tcp::resolver::query query(host, StringOps::itoa(port));
-        // tcp::resolver::iterator endpointIterator = resolver.resolve(query);
-        // tcp::socket socket(ioService);
-        // boost::asio::connect(socket, endpointIterator);
-        // boost::system::error_code errorCode;
-
-        // std::string commandSuffix = "\nwait " + StringOps::itoa(feedbackLines) + "\n";
-        // boost::asio::write(
-        //     socket,
-        //     boost::asio::buffer(command + commandSuffix),
-        //     boost::asio::transfer_all(),
-        //     errorCode);
-
-        // if (errorCode) {
-        //     LOG(Logger::WARN, "error while writing to socket: " << errorCode.message());
-        // }
-
-        // notifyStartup();
-
-        // for (;;) {
-        //     LOG(DBG, "Interactor::operator() reading... [" << feedbackBuffer.size() << "/" << feedbackLines << "]");
-        //     if (feedbackBuffer.size() >= feedbackLines) {
-        //         break;
-        //     }
-
-        //     boost::array<char, 1024> buf;
-        //     boost::system::error_code errorCode;
-        //     std::size_t length = socket.read_some(boost::asio::buffer(buf), errorCode);
-        //     std::string input(buf.data(), length);
-        //     StringVec lines = StringOps::tokenize(input, "\n");
-        //     handleInput(lines);
-        // }
-
-        // notifyCompletion();
-
-        // LOG(DBG, "Interactor::operator() done");
+        int fd = -1;
+
+        try {
+            fd = unixSocketPath.empty() ?
+                Socket::connectTCP(host, port) :
+                Socket::connectUnix(unixSocketPath);
+            Socket::writeAll(fd, command + "\n");
+        } catch (const IOException& e) {
+            LOG(Logger::WARN, "Interactor: " << e.what());
+            if (fd >= 0) {
+                close(fd);
+            }
+            notifyStartup();
+            notifyCompletion();
+            return 1;
+        }
+
+        notifyStartup();
+
+        std::string input;
+        for (;;) {
+            LOG(DBG, "Interactor::operator() reading... [" << feedbackBuffer.size() << "/" << feedbackLines << "]");
+            if (feedbackBuffer.size() >= feedbackLines) {
+                break;
+            }
+
+            char buf[1024];
+            ssize_t length = recv(fd, buf, sizeof(buf), 0);
+            if ((length < 0) && (errno == EINTR)) {
+                continue;
+            }
+            if (length <= 0) {
+                LOG(Logger::WARN, "Interactor: connection closed before all feedback was received");
+                break;
+            }
+
+            input.append(buf, length);
+            std::size_t end = input.rfind('\n');
+            if (end != std::string::npos) {
+                handleInput(StringOps::tokenize(input.substr(0, end), "\n"));
+                input.erase(0, end + 1);
+            }
+        }
+
+        close(fd);
+        notifyCompletion();
+
+        LOG(DBG, "Interactor::operator() done");
         return 0;
     }
 
 private:
     StringVec feedbackBuffer;
-    // boost::condition_variable signal;
-    // boost::mutex mutex;
+    std::condition_variable signal;
+    std::mutex mutex;
     std::string command;
     std::size_t feedbackLines;
     int port;
     std::string host;
+    std::string unixSocketPath;
     bool started;
     bool completed;
-    // boost::thread thread;
+    std::thread thread;
 
     void waitForStartup()
     {
-        // boost::unique_lock<boost::mutex> lock(mutex);
-        // while(!started) {
-        //     signal.wait(lock);
-        // }
+        std::unique_lock<std::mutex> lock(mutex);
+        while(!started) {
+            signal.wait(lock);
+        }
     }
 
     void notifyStartup()
     {
-        // boost::unique_lock<boost::mutex> lock(mutex);
-        // started = true;
-        // signal.notify_one();
+        std::lock_guard<std::mutex> lock(mutex);
+        started = true;
+        signal.notify_all();
     }
 
     void notifyCompletion()
     {
-        // boost::unique_lock<boost::mutex> lock(mutex);
-        // completed = true;
-        // signal.notify_one();
+        std::lock_guard<std::mutex> lock(mutex);
+        completed = true;
+        signal.notify_all();
     }
 
     void handleInput(const StringVec& lines)
     {
         LOG(DBG, "Interactor::handleInput(" << lines << ")");
-        // // only add lines which are not equal to "\0"
-        // for (std::size_t i = 0; i < lines.size(); ++i) {
-        //     const std::string& line = lines[i];
-        //     if (line == "") {
-        //         LOG(WARN, "Interactor rejects empty line as feedback");
-        //         continue;
-        //     }
-        //     if ((line.size() == 1) || (line[0] == 0)) {
-        //         LOG(WARN, "Interactor rejects null line as feedback");
-        //         continue;
-        //     }
-
-        //     LOG(DBG, "Interactor accepted line »" << line << "«");
-        //     feedbackBuffer << line;
-        // }
+        std::lock_guard<std::mutex> lock(mutex);
+
+        // only add lines which are not equal to "\0"
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            const std::string& line = lines[i];
+            if (line == "") {
+                LOG(WARN, "Interactor rejects empty line as feedback");
+                continue;
+            }
+            if ((line.size() == 1) && (line[0] == 0)) {
+                LOG(WARN, "Interactor rejects null line as feedback");
+                continue;
+            }
+
+            LOG(DBG, "Interactor accepted line »" << line << "«");
+            feedbackBuffer << line;
+        }
     }
 
     template<typename DELEGATE>
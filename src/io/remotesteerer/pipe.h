@@ -6,9 +6,11 @@
 #include <libgeodecomp/io/logger.h>
 #include <libgeodecomp/misc/stringops.h>
 
-// #include <boost/thread/condition_variable.hpp>
-// #include <boost/thread/mutex.hpp>
-// #include <boost/thread/locks.hpp>
+#include <libgeodecomp/io/remotesteerer/requestqueue.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+
+#include <condition_variable>
+#include <mutex>
 
 namespace LibGeoDecomp {
 
@@ -31,194 +33,204 @@ public:
 #ifdef LIBGEODECOMP_WITH_MPI
     explicit Pipe(
         int root = 0,
-        MPI_Comm communicator = MPI_COMM_WORLD)
-        // mpiLayer(communicator),
-        // root(root)
+        MPI_Comm communicator = MPI_COMM_WORLD) :
+        mpiLayer(communicator),
+        root(root)
+    {}
+#else
+    Pipe()
     {}
 #endif
 
+    /**
+     * Lock-free, so the CommandServer's thread will never stall the
+     * simulation (or vice versa) when queueing requests.
+     */
     void addSteeringRequest(const std::string& request)
     {
-        // fixme
-        // LOG(DBG, "Pipe::addSteeringRequest(" << request << ")");
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // steeringRequestsQueue << request;
+        LOG(DBG, "Pipe::addSteeringRequest(" << request << ")");
+        incomingRequests.push(request);
     }
 
     void addSteeringFeedback(const std::string& feedback)
     {
-        // fixme
-        // LOG(DBG, "Pipe::addSteeringFeedback(" << feedback << ")");
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // steeringFeedback << feedback;
-        // signal.notify_one();
+        LOG(DBG, "Pipe::addSteeringFeedback(" << feedback << ")");
+        std::lock_guard<std::mutex> lock(mutex);
+        steeringFeedback << feedback;
+        signal.notify_all();
     }
 
     StringVec retrieveSteeringRequests()
     {
-        // fixme
-        // using std::swap;
-        // LOG(DBG, "Pipe::retrieveSteeringRequests()");
+        using std::swap;
+        LOG(DBG, "Pipe::retrieveSteeringRequests()");
         StringVec requests;
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // swap(requests, steeringRequests);
-        // LOG(DBG, "  retrieveSteeringRequests yields " << requests.size());
-        // if (requests.size() > 0) {
-        //     LOG(DBG, "  steeringRequests: " << requests);
-        // }
+        std::lock_guard<std::mutex> lock(mutex);
+        swap(requests, steeringRequests);
+        LOG(DBG, "  retrieveSteeringRequests yields " << requests.size());
         return requests;
     }
 
     StringVec copySteeringRequestsQueue()
     {
-        // fixme
-        // LOG(DBG, "Pipe::copySteeringRequestsQueue()");
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // StringVec requests = steeringRequestsQueue;
-        StringVec requests;
+        LOG(DBG, "Pipe::copySteeringRequestsQueue()");
+        std::lock_guard<std::mutex> lock(mutex);
+        incomingRequests.retrieveAll(&steeringRequestsQueue);
+        StringVec requests = steeringRequestsQueue;
         return requests;
     }
 
     StringVec retrieveSteeringFeedback()
     {
-        // fixme
-        // using std::swap;
-        // LOG(DBG, "Pipe::retrieveSteeringFeedback()");
+        using std::swap;
+        LOG(DBG, "Pipe::retrieveSteeringFeedback()");
         StringVec feedback;
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // swap(feedback, steeringFeedback);
-        // LOG(DBG, "  retrieveSteeringFeedback yields " << feedback.size());
-        // LOG(DBG, "  retrieveSteeringFeedback is " << feedback);
+        std::lock_guard<std::mutex> lock(mutex);
+        swap(feedback, steeringFeedback);
+        LOG(DBG, "  retrieveSteeringFeedback yields " << feedback.size());
         return feedback;
     }
 
     StringVec copySteeringFeedback()
     {
-        // fixme
-        // LOG(DBG, "Pipe::copySteeringFeedback()");
-        // std::lock_guard<boost::mutex> lock(mutex);
-        // StringVec feedback = steeringFeedback;
-
-        StringVec feedback;
+        LOG(DBG, "Pipe::copySteeringFeedback()");
+        std::lock_guard<std::mutex> lock(mutex);
+        StringVec feedback = steeringFeedback;
         return feedback;
     }
 
+    /**
+     * Makes all queued requests available to
+     * retrieveSteeringRequests() (on all nodes) and moves the feedback
+     * of all nodes to the root. This is a collective operation. The
+     * mutex is not held during MPI communication, so the
+     * CommandServer can continue serving clients meanwhile.
+     */
     void sync()
     {
-//         LOG(DBG, "Pipe::sync()");
-//         std::lock_guard<boost::mutex> lock(mutex);
-// #ifdef LIBGEODECOMP_WITH_MPI
-//         broadcastSteeringRequests();
-//         moveSteeringFeedbackToRoot();
-// #endif
+        using std::swap;
+        LOG(DBG, "Pipe::sync()");
+        StringVec requests;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            incomingRequests.retrieveAll(&steeringRequestsQueue);
+            swap(requests, steeringRequestsQueue);
+        }
+
+#ifdef LIBGEODECOMP_WITH_MPI
+        broadcastSteeringRequests(&requests);
+
+        StringVec feedback;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            swap(feedback, steeringFeedback);
+        }
+        moveSteeringFeedbackToRoot(&feedback);
+#endif
+
+        std::lock_guard<std::mutex> lock(mutex);
+        append(steeringRequests, requests);
+#ifdef LIBGEODECOMP_WITH_MPI
+        // feedback which arrived during the gather goes last:
+        append(feedback, steeringFeedback);
+        swap(feedback, steeringFeedback);
+        signal.notify_all();
+#endif
     }
 
     void waitForFeedback(std::size_t lines = 1)
     {
-        // LOG(DBG, "Pipe::waitForFeedback(" << lines << ")");
-        // boost::unique_lock<boost::mutex> lock(mutex);
-
-        // while (steeringFeedback.size() < lines) {
-        //     LOG(DBG, "  still waiting for feedback (" << steeringFeedback.size() << "/" << lines << ")\n");
-        //     signal.wait(lock);
-        // }
-        // LOG(DBG, "  feedback acquired");
+        LOG(DBG, "Pipe::waitForFeedback(" << lines << ")");
+        std::unique_lock<std::mutex> lock(mutex);
+
+        while (steeringFeedback.size() < lines) {
+            signal.wait(lock);
+        }
+        LOG(DBG, "  feedback acquired");
     }
 
 private:
-    // fixme
-//     boost::mutex mutex;
-//     boost::condition_variable signal;
+    RequestQueue incomingRequests;
+    std::mutex mutex;
+    std::condition_variable signal;
     StringVec steeringRequestsQueue;
     StringVec steeringRequests;
     StringVec steeringFeedback;
 
-// #ifdef LIBGEODECOMP_WITH_MPI
-//     MPILayer mpiLayer;
-//     int root;
-
-//     void broadcastSteeringRequests()
-//     {
-//         LOG(DBG, "Pipe::broadcastSteeringRequests()");
-
-//         int numRequests = mpiLayer.broadcast(steeringRequestsQueue.size(), root);
-//         if (mpiLayer.rank() != root) {
-//             steeringRequestsQueue.resize(numRequests);
-//         } else {
-//             LOG(DBG, "  steeringRequestsQueue: " << steeringRequestsQueue);
-//         }
-
-//         std::vector<int> requestSizes(numRequests);
-
-//         if (mpiLayer.rank() == root) {
-//             for (int i = 0; i < numRequests; ++i) {
-//                 requestSizes[i] = steeringRequestsQueue[i].size();
-//             }
-//         }
-
-//         mpiLayer.broadcastVector(&requestSizes, root);
-//         if (mpiLayer.rank() != root) {
-//             for (int i = 0; i < numRequests; ++i) {
-//                 steeringRequestsQueue[i].resize(requestSizes[i]);
-//             }
-//         }
-
-//         for (int i = 0; i < numRequests; ++i) {
-//             mpiLayer.broadcast(&steeringRequestsQueue[i][0], requestSizes[i], root);
-//         }
-
-//         append(steeringRequests, steeringRequestsQueue);
-//         steeringRequestsQueue.clear();
-//         LOG(DBG, "  steeringRequests: " << steeringRequests);
-//     }
-
-//     /**
-//      * Will move steering requests from the compute nodes to the root
-//      * where it can then be forwarded to the user.
-//      */
-//     void moveSteeringFeedbackToRoot()
-//     {
-//         // marshall all feedback in order to use scalable gather afterwards
-//         std::vector<char> localBuffer;
-//         std::vector<int> localLengths;
-//         for (StringVec::iterator i = steeringFeedback.begin();
-//              i != steeringFeedback.end();
-//              ++i) {
-//             localBuffer.insert(localBuffer.end(), i->begin(), i->end());
-//             localLengths << i->size();
-//         }
-//         LOG(DBG, "moveSteeringFeedbackToRoot: " << localBuffer << " " << localLengths);
-
-//         // how many strings are sent per node?
-//         std::vector<int> numFeedback = mpiLayer.gather((int)localLengths.size(), root);
-
-//         // all lengths of all strings:
-//         std::vector<int> allFeedbackLengths(sum(numFeedback));
-//         mpiLayer.gatherV(localLengths, numFeedback, root, allFeedbackLengths);
-
-//         // gather all messages in a single, giant buffer:
-//         std::vector<int> charsPerNode = mpiLayer.gather((int)localBuffer.size(), root);
-//         std::vector<char> globalBuffer(sum(charsPerNode));
-
-//         mpiLayer.gatherV(localBuffer, charsPerNode, root, globalBuffer);
-
-//         // reconstruct strings:
-//         std::size_t cursor = 0;
-//         steeringFeedback.resize(0);
-
-//         for (std::vector<int>::iterator i = allFeedbackLengths.begin();
-//              i != allFeedbackLengths.end();
-//              ++i) {
-//             std::size_t nextCursor = cursor + *i;
-//             steeringFeedback << std::string(globalBuffer.begin() + cursor,
-//                                             globalBuffer.begin() + nextCursor);
-//             cursor = nextCursor;
-//         }
-
-//         LOG(DBG, "  notifying... steeringFeedback(" << mpiLayer.rank() << ") == " << steeringFeedback);
-//         signal.notify_one();
-//     }
-// #endif
+#ifdef LIBGEODECOMP_WITH_MPI
+    MPILayer mpiLayer;
+    int root;
+
+    /**
+     * Replaces requests on all nodes by those present on the root.
+     * All strings are marshalled into a single buffer so that the
+     * number of collectives doesn't depend on the number of requests.
+     */
+    void broadcastSteeringRequests(StringVec *requests)
+    {
+        std::vector<int> lengths;
+        std::vector<char> buffer;
+
+        if (mpiLayer.rank() == root) {
+            for (StringVec::iterator i = requests->begin(); i != requests->end(); ++i) {
+                lengths << int(i->size());
+                buffer.insert(buffer.end(), i->begin(), i->end());
+            }
+        }
+
+        mpiLayer.broadcastVector(&lengths, root);
+        if (lengths.empty()) {
+            requests->clear();
+            return;
+        }
+        mpiLayer.broadcastVector(&buffer, root);
+
+        if (mpiLayer.rank() != root) {
+            unmarshal(buffer, lengths, requests);
+        }
+    }
+
+    /**
+     * Will move steering feedback from the compute nodes to the root
+     * where it can then be forwarded to the user.
+     */
+    void moveSteeringFeedbackToRoot(StringVec *feedback)
+    {
+        // marshall all feedback in order to use scalable gather afterwards
+        std::vector<char> localBuffer;
+        std::vector<int> localLengths;
+        for (StringVec::iterator i = feedback->begin(); i != feedback->end(); ++i) {
+            localBuffer.insert(localBuffer.end(), i->begin(), i->end());
+            localLengths << int(i->size());
+        }
+
+        // how many strings are sent per node?
+        std::vector<int> numFeedback = mpiLayer.gather(int(localLengths.size()), root);
+
+        // all lengths of all strings:
+        std::vector<int> allFeedbackLengths(sum(numFeedback));
+        mpiLayer.gatherV(localLengths, numFeedback, root, allFeedbackLengths);
+
+        // gather all messages in a single, giant buffer:
+        std::vector<int> charsPerNode = mpiLayer.gather(int(localBuffer.size()), root);
+        std::vector<char> globalBuffer(sum(charsPerNode));
+        mpiLayer.gatherV(localBuffer, charsPerNode, root, globalBuffer);
+
+        unmarshal(globalBuffer, allFeedbackLengths, feedback);
+    }
+
+    static void unmarshal(const std::vector<char>& buffer, const std::vector<int>& lengths, StringVec *target)
+    {
+        target->clear();
+        std::size_t cursor = 0;
+
+        for (std::vector<int>::const_iterator i = lengths.begin(); i != lengths.end(); ++i) {
+            std::size_t nextCursor = cursor + *i;
+            *target << std::string(buffer.begin() + cursor, buffer.begin() + nextCursor);
+            cursor = nextCursor;
+        }
+    }
+#endif
 };
 
 }
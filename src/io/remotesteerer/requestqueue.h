@@ -0,0 +1,106 @@
+#ifndef LIBGEODECOMP_IO_REMOTESTEERER_REQUESTQUEUE_H
+#define LIBGEODECOMP_IO_REMOTESTEERER_REQUESTQUEUE_H
+
+#include <libgeodecomp/misc/stringvec.h>
+
+#include <atomic>
+#include <string>
+
+namespace LibGeoDecomp {
+
+namespace RemoteSteererHelpers {
+
+/**
+ * A lock-free multi-producer/single-consumer queue for steering
+ * requests. Producers (e.g. the CommandServer's thread) push()
+ * single requests, the consumer (the simulation thread) removes all
+ * pending requests at once via retrieveAll(). As nodes are never
+ * removed individually, this is simply a Treiber stack whose contents
+ * get reversed upon retrieval -- no ABA problem can arise.
+ */
+class RequestQueue
+{
+public:
+    RequestQueue() :
+        head(0)
+    {}
+
+    ~RequestQueue()
+    {
+        deleteList(head.exchange(0));
+    }
+
+    void push(const std::string& request)
+    {
+        Node *node = new Node(request);
+        node->next = head.load(std::memory_order_relaxed);
+
+        while (!head.compare_exchange_weak(
+                   node->next,
+                   node,
+                   std::memory_order_release,
+                   std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * Appends all pending requests to target, in the order in which
+     * they were pushed.
+     */
+    void retrieveAll(StringVec *target)
+    {
+        Node *list = head.exchange(0, std::memory_order_acquire);
+
+        // reverse list to restore FIFO order:
+        Node *reversed = 0;
+        while (list) {
+            Node *next = list->next;
+            list->next = reversed;
+            reversed = list;
+            list = next;
+        }
+
+        for (Node *i = reversed; i != 0; i = i->next) {
+            target->push_back(i->request);
+        }
+        deleteList(reversed);
+    }
+
+    bool empty() const
+    {
+        return head.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    class Node
+    {
+    public:
+        explicit Node(const std::string& request) :
+            request(request),
+            next(0)
+        {}
+
+        std::string request;
+        Node *next;
+    };
+
+    std::atomic<Node*> head;
+
+    RequestQueue(const RequestQueue&);
+    void operator=(const RequestQueue&);
+
+    static void deleteList(Node *list)
+    {
+        while (list) {
+            Node *next = list->next;
+            delete list;
+            list = next;
+        }
+    }
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,183 @@
+#ifndef LIBGEODECOMP_IO_REMOTESTEERER_SOCKET_H
+#define LIBGEODECOMP_IO_REMOTESTEERER_SOCKET_H
+
+#include <libgeodecomp/io/ioexception.h>
+#include <libgeodecomp/misc/stringops.h>
+
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace LibGeoDecomp {
+
+namespace RemoteSteererHelpers {
+
+/**
+ * Thin wrappers for the BSD socket calls needed by CommandServer and
+ * Interactor. All functions throw an IOException on failure.
+ */
+class Socket
+{
+public:
+    static const int BACKLOG = 16;
+
+    /**
+     * Creates a TCP socket listening on all interfaces.
+     */
+    static int listenTCP(int port)
+    {
+        int fd = createSocket(AF_INET);
+        int yes = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &yes, sizeof(yes));
+
+        sockaddr_in address;
+        std::memset(&address, 0, sizeof(address));
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+
+        bindAndListen(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address), "port " + StringOps::itoa(port));
+        return fd;
+    }
+
+    /**
+     * Creates a Unix domain socket at path. A stale socket file from
+     * a previous run is removed first.
+     */
+    static int listenUnix(const std::string& path)
+    {
+        sockaddr_un address = unixAddress(path);
+        int fd = createSocket(AF_UNIX);
+        unlink(path.c_str());
+
+        bindAndListen(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address), path);
+        return fd;
+    }
+
+    static int connectTCP(const std::string& host, int port)
+    {
+        addrinfo hints;
+        std::memset(&hints, 0, sizeof(hints));
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+
+        addrinfo *addresses = 0;
+        std::string service = StringOps::itoa(port);
+        int status = getaddrinfo(host.c_str(), service.c_str(), &hints, &addresses);
+        if (status != 0) {
+            throw IOException("could not resolve " + host + ": " + gai_strerror(status));
+        }
+
+        int fd = -1;
+        for (addrinfo *i = addresses; i != 0; i = i->ai_next) {
+            fd = socket(i->ai_family, i->ai_socktype, i->ai_protocol);
+            if (fd < 0) {
+                continue;
+            }
+            if (connect(fd, i->ai_addr, i->ai_addrlen) == 0) {
+                break;
+            }
+
+            close(fd);
+            fd = -1;
+        }
+        freeaddrinfo(addresses);
+
+        if (fd < 0) {
+            throw IOException("could not connect to " + host + ":" + service + ": " + std::strerror(errno));
+        }
+
+        int yes = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &yes, sizeof(yes));
+        return fd;
+    }
+
+    static int connectUnix(const std::string& path)
+    {
+        sockaddr_un address = unixAddress(path);
+        int fd = createSocket(AF_UNIX);
+
+        if (connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            int error = errno;
+            close(fd);
+            throw IOException("could not connect to " + path + ": " + std::strerror(error));
+        }
+
+        return fd;
+    }
+
+    static void setNonBlocking(int fd)
+    {
+        int flags = fcntl(fd, F_GETFL, 0);
+        if ((flags < 0) || (fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0)) {
+            throw IOException(std::string("could not set socket to non-blocking mode: ") + std::strerror(errno));
+        }
+    }
+
+    /**
+     * Blocking write of the whole buffer, for clients only.
+     */
+    static void writeAll(int fd, const std::string& data)
+    {
+        std::size_t cursor = 0;
+
+        while (cursor < data.size()) {
+            ssize_t written = send(fd, data.data() + cursor, data.size() - cursor, MSG_NOSIGNAL);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                throw IOException(std::string("error while writing to socket: ") + std::strerror(errno));
+            }
+            cursor += written;
+        }
+    }
+
+private:
+    static int createSocket(int domain)
+    {
+        int fd = socket(domain, SOCK_STREAM, 0);
+        if (fd < 0) {
+            throw IOException(std::string("could not create socket: ") + std::strerror(errno));
+        }
+
+        return fd;
+    }
+
+    static sockaddr_un unixAddress(const std::string& path)
+    {
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            throw IOException("socket path too long: " + path);
+        }
+        std::strcpy(address.sun_path, path.c_str());
+
+        return address;
+    }
+
+    static void bindAndListen(int fd, sockaddr *address, socklen_t length, const std::string& name)
+    {
+        if ((bind(fd, address, length) != 0) || (listen(fd, BACKLOG) != 0)) {
+            int error = errno;
+            close(fd);
+            throw IOException("could not listen on " + name + ": " + std::strerror(error));
+        }
+    }
+};
+
+}
+
+}
+
+#endif
@@ -0,0 +1,82 @@
+#include <libgeodecomp/io/remotesteerer/bulkgethandler.h>
+#include <libgeodecomp/io/remotesteerer/pipe.h>
+#include <libgeodecomp/misc/testcell.h>
+#include <libgeodecomp/storage/grid.h>
+
+#include <cxxtest/TestSuite.h>
+#include <cstring>
+#include <sstream>
+
+using namespace LibGeoDecomp;
+using namespace LibGeoDecomp::RemoteSteererHelpers;
+
+namespace LibGeoDecomp {
+
+class BulkGetHandlerTest : public CxxTest::TestSuite
+{
+public:
+    void testBasic()
+    {
+        Pipe pipe;
+        BulkGetHandler<TestCell<2> > handler(Selector<TestCell<2> >(&TestCell<2>::testValue, "testValue"));
+        TS_ASSERT_EQUALS("bulk_testValue", handler.key());
+
+        Grid<TestCell<2> > grid(Coord<2>(10, 5));
+        for (int y = 0; y < 5; ++y) {
+            for (int x = 0; x < 10; ++x) {
+                grid[Coord<2>(x, y)].testValue = y * 100 + x;
+            }
+        }
+
+        // only the left half of the grid is held by this node:
+        Region<2> validRegion;
+        validRegion << CoordBox<2>(Coord<2>(0, 0), Coord<2>(5, 5));
+
+        StringVec parameters;
+        parameters << "3" << "1" << "4" << "2";
+        TS_ASSERT(handler(parameters, pipe, &grid, validRegion, 123));
+
+        StringVec feedback = pipe.retrieveSteeringFeedback();
+        TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
+
+        std::stringstream reply(feedback[0]);
+        std::string header;
+        std::getline(reply, header);
+        TS_ASSERT_EQUALS("bulk testValue 123 2 32", header);
+
+        std::string streak;
+        std::getline(reply, streak);
+        TS_ASSERT_EQUALS("3 1 5", streak);
+        std::getline(reply, streak);
+        TS_ASSERT_EQUALS("3 2 5", streak);
+
+        double values[4];
+        reply.read(reinterpret_cast<char*>(values), sizeof(values));
+        TS_ASSERT_EQUALS(std::size_t(reply.gcount()), sizeof(values));
+        TS_ASSERT_EQUALS(103.0, values[0]);
+        TS_ASSERT_EQUALS(104.0, values[1]);
+        TS_ASSERT_EQUALS(203.0, values[2]);
+        TS_ASSERT_EQUALS(204.0, values[3]);
+        TS_ASSERT_EQUALS(EOF, reply.get());
+    }
+
+    void testNoOverlapAndBadParameters()
+    {
+        Pipe pipe;
+        BulkGetHandler<TestCell<2> > handler(Selector<TestCell<2> >(&TestCell<2>::testValue, "testValue"));
+        Grid<TestCell<2> > grid(Coord<2>(10, 5));
+        Region<2> validRegion;
+        validRegion << CoordBox<2>(Coord<2>(0, 0), Coord<2>(5, 5));
+
+        StringVec parameters;
+        parameters << "6" << "0" << "4" << "5";
+        TS_ASSERT(handler(parameters, pipe, &grid, validRegion, 0));
+        TS_ASSERT_EQUALS(std::size_t(0), pipe.retrieveSteeringFeedback().size());
+
+        parameters.pop_back();
+        TS_ASSERT(handler(parameters, pipe, &grid, validRegion, 0));
+        TS_ASSERT_EQUALS(std::size_t(1), pipe.retrieveSteeringFeedback().size());
+    }
+};
+
+}
@@ -1,7 +1,11 @@
 #include <libgeodecomp/io/remotesteerer/commandserver.h>
+#include <libgeodecomp/io/remotesteerer/interactor.h>
+#include <libgeodecomp/io/remotesteerer/passthroughaction.h>
 #include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/misc/tempfile.h>
 
 #include <cxxtest/TestSuite.h>
+#include <unistd.h>
 
 using namespace LibGeoDecomp;
 using namespace LibGeoDecomp::RemoteSteererHelpers;
@@ -38,25 +42,68 @@ public:
 
     void testActionInvocationAndFeedback()
     {
-        // fixme
-        // int port = 47110;
-        // CommandServer<int> server(port, pipe);
-        // server.addAction(new MockAction());
-        // StringVec feedback = CommandServer<int>::sendCommandWithFeedback("mock 1 2 3", 1, port);
-        // TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
-        // TS_ASSERT_EQUALS(feedback[0], "MockAction mocks you!");
+        int port = 47110;
+        CommandServer<int> server(port, pipe);
+        server.addAction(new MockAction());
+        StringVec feedback = CommandServer<int>::sendCommandWithFeedback("mock 1 2 3", 1, port);
+        TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
+        TS_ASSERT_EQUALS(feedback[0], "MockAction mocks you!");
     }
 
     void testInvalidCommand()
     {
-        // fixme
-        // int port = 47114;
-        // CommandServer<int> server(port, pipe);
-        // StringVec feedback = CommandServer<int>::sendCommandWithFeedback("blah", 2, port);
-
-        // TS_ASSERT_EQUALS(feedback.size(), std::size_t(2));
-        // TS_ASSERT_EQUALS(feedback[0], "command not found: blah");
-        // TS_ASSERT_EQUALS(feedback[1], "try \"help\"");
+        int port = 47114;
+        CommandServer<int> server(port, pipe);
+        StringVec feedback = CommandServer<int>::sendCommandWithFeedback("blah", 2, port);
+
+        TS_ASSERT_EQUALS(feedback.size(), std::size_t(2));
+        TS_ASSERT_EQUALS(feedback[0], "command not found: blah");
+        TS_ASSERT_EQUALS(feedback[1], "try \"help\"");
+    }
+
+    void testUnixSocket()
+    {
+        int port = 47115;
+        std::string path = TempFile::serial("commandservertest_socket");
+        CommandServer<int> server(port, pipe, path);
+        server.addAction(new MockAction());
+
+        Interactor interactor("mock", 1, false, path);
+        interactor();
+        StringVec feedback = interactor.feedback();
+        TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
+        TS_ASSERT_EQUALS(feedback[0], "MockAction mocks you!");
+    }
+
+    void testFeedbackFromSimulation()
+    {
+        int port = 47116;
+        CommandServer<int> server(port, pipe);
+        server.addAction(new PassThroughAction<int>("echo", "forwards to simulation"));
+
+        // the reply is sent by the server once the (simulated)
+        // Handler has added it to the Pipe:
+        Interactor interactor("echo 4711", 1, true, port);
+        StringVec requests;
+        while (requests.empty()) {
+            pipe->sync();
+            requests = pipe->retrieveSteeringRequests();
+            usleep(1000);
+        }
+        TS_ASSERT_EQUALS(requests[0], "echo 4711");
+        pipe->addSteeringFeedback("echo reply 4711");
+
+        interactor.waitForCompletion();
+        StringVec feedback = interactor.feedback();
+        TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
+        TS_ASSERT_EQUALS(feedback[0], "echo reply 4711");
+    }
+
+    void testBindFailure()
+    {
+        int port = 47117;
+        CommandServer<int> server(port, pipe);
+        TS_ASSERT_THROWS(CommandServer<int>(port, pipe), IOException&);
     }
 
 private:
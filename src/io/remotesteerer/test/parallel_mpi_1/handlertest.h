@@ -33,27 +33,26 @@ public:
 
     void testBasic()
     {
-        // fixme
-        // Pipe pipe;
-        // MockHandler handler;
-
-        // TS_ASSERT_EQUALS("mock", handler.key());
-        // StringVec parameters;
-        // parameters << "arrrr"
-        //            << "matey";
-        // Grid<TestCell<2> > grid(Coord<2>(10, 5));
-        // Region<2> region;
-        // region << grid.boundingBox();
-
-        // grid[Coord<2>(1, 1)].testValue = -1;
-        // TS_ASSERT_EQUALS(grid[Coord<2>(1, 1)].testValue, -1);
-
-        // bool res = handler(parameters, pipe, &grid, region, 123);
-        // StringVec feedback = pipe.retrieveSteeringFeedback();
-        // TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
-        // TS_ASSERT_EQUALS(feedback[0], "MockHandler mocks you! arrrr");
-        // TS_ASSERT_EQUALS(grid[Coord<2>(1, 1)].testValue, 4711.0);
-        // TS_ASSERT(res);
+        Pipe pipe;
+        MockHandler handler;
+
+        TS_ASSERT_EQUALS("mock", handler.key());
+        StringVec parameters;
+        parameters << "arrrr"
+                   << "matey";
+        Grid<TestCell<2> > grid(Coord<2>(10, 5));
+        Region<2> region;
+        region << grid.boundingBox();
+
+        grid[Coord<2>(1, 1)].testValue = -1;
+        TS_ASSERT_EQUALS(grid[Coord<2>(1, 1)].testValue, -1);
+
+        bool res = handler(parameters, pipe, &grid, region, 123);
+        StringVec feedback = pipe.retrieveSteeringFeedback();
+        TS_ASSERT_EQUALS(feedback.size(), std::size_t(1));
+        TS_ASSERT_EQUALS(feedback[0], "MockHandler mocks you! arrrr");
+        TS_ASSERT_EQUALS(grid[Coord<2>(1, 1)].testValue, 4711.0);
+        TS_ASSERT(res);
     }
 };
 
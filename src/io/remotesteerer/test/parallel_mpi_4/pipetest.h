@@ -8,6 +8,7 @@
 #include <libgeodecomp/io/remotesteerer/pipe.h>
 
 #include <cxxtest/TestSuite.h>
+#include <thread>
 
 using namespace LibGeoDecomp;
 using namespace LibGeoDecomp::RemoteSteererHelpers;
@@ -24,22 +25,21 @@ public:
         MPILayer mpiLayer;
         Pipe pipe;
 
-        // fixme
-        // if (mpiLayer.rank() == 0) {
-        //     pipe.addSteeringRequest("set heat 0.1 100 120 110");
-        //     pipe.addSteeringRequest("set flow 6.9 100 120 110");
-        // }
+        if (mpiLayer.rank() == 0) {
+            pipe.addSteeringRequest("set heat 0.1 100 120 110");
+            pipe.addSteeringRequest("set flow 6.9 100 120 110");
+        }
 
-        // pipe.sync();
+        pipe.sync();
 
-        // TS_ASSERT_EQUALS(pipe.steeringRequests.size(), std::size_t(2));
-        // TS_ASSERT_EQUALS(pipe.steeringFeedback.size(), std::size_t(0));
+        TS_ASSERT_EQUALS(pipe.steeringRequests.size(), std::size_t(2));
+        TS_ASSERT_EQUALS(pipe.steeringFeedback.size(), std::size_t(0));
 
-        // TS_ASSERT_EQUALS(pipe.steeringRequests[0], "set heat 0.1 100 120 110");
-        // TS_ASSERT_EQUALS(pipe.steeringRequests[1], "set flow 6.9 100 120 110");
+        TS_ASSERT_EQUALS(pipe.steeringRequests[0], "set heat 0.1 100 120 110");
+        TS_ASSERT_EQUALS(pipe.steeringRequests[1], "set flow 6.9 100 120 110");
 
-        // TS_ASSERT_EQUALS(pipe.retrieveSteeringRequests().size(), unsigned(2));
-        // TS_ASSERT_EQUALS(pipe.steeringRequests.size(), std::size_t(0));
+        TS_ASSERT_EQUALS(pipe.retrieveSteeringRequests().size(), unsigned(2));
+        TS_ASSERT_EQUALS(pipe.steeringRequests.size(), std::size_t(0));
     }
 
     void testSyncSteeringFeedback()
@@ -47,20 +47,68 @@ public:
         MPILayer mpiLayer;
         Pipe pipe;
 
-        // fixme
-        // pipe.addSteeringFeedback("node " + StringOps::itoa(mpiLayer.rank()) + " starting");
-        // if (mpiLayer.rank() == 2) {
-        //     pipe.addSteeringFeedback("node 2 encountered error");
-        // }
-        // pipe.addSteeringFeedback("node " + StringOps::itoa(mpiLayer.rank()) + " shutting down");
-
-        // pipe.sync();
-        // // 4 ranks with 2x feedback each ("starting" + "shutting down"), plus rank 2 with an error message
-        // unsigned expectedSize = (mpiLayer.rank() == 0)? 9 : 0;
-        // TS_ASSERT_EQUALS(pipe.steeringFeedback.size(),           expectedSize);
-        // TS_ASSERT_EQUALS(pipe.copySteeringFeedback().size(),     expectedSize);
-        // TS_ASSERT_EQUALS(pipe.retrieveSteeringFeedback().size(), expectedSize);
-        // TS_ASSERT_EQUALS(pipe.steeringFeedback.size(), std::size_t(0));
+        pipe.addSteeringFeedback("node " + StringOps::itoa(mpiLayer.rank()) + " starting");
+        if (mpiLayer.rank() == 2) {
+            pipe.addSteeringFeedback("node 2 encountered error");
+        }
+        pipe.addSteeringFeedback("node " + StringOps::itoa(mpiLayer.rank()) + " shutting down");
+
+        pipe.sync();
+        // 4 ranks with 2x feedback each ("starting" + "shutting down"), plus rank 2 with an error message
+        unsigned expectedSize = (mpiLayer.rank() == 0)? 9 : 0;
+        TS_ASSERT_EQUALS(pipe.steeringFeedback.size(),           expectedSize);
+        TS_ASSERT_EQUALS(pipe.copySteeringFeedback().size(),     expectedSize);
+        TS_ASSERT_EQUALS(pipe.retrieveSteeringFeedback().size(), expectedSize);
+        TS_ASSERT_EQUALS(pipe.steeringFeedback.size(), std::size_t(0));
+    }
+
+    class Producer
+    {
+    public:
+        Producer(Pipe *pipe, int id) :
+            pipe(pipe),
+            id(id)
+        {}
+
+        void operator()()
+        {
+            for (int i = 0; i < 1000; ++i) {
+                pipe->addSteeringRequest(StringOps::itoa(id) + " " + StringOps::itoa(i));
+            }
+        }
+
+    private:
+        Pipe *pipe;
+        int id;
+    };
+
+    void testConcurrentSteeringRequests()
+    {
+        MPILayer mpiLayer;
+        Pipe pipe;
+
+        if (mpiLayer.rank() == 0) {
+            std::vector<std::thread> producers;
+            for (int id = 0; id < 4; ++id) {
+                producers.push_back(std::thread(Producer(&pipe, id)));
+            }
+            for (int id = 0; id < 4; ++id) {
+                producers[id].join();
+            }
+        }
+
+        pipe.sync();
+        StringVec requests = pipe.retrieveSteeringRequests();
+        TS_ASSERT_EQUALS(requests.size(), std::size_t(4000));
+
+        // requests of each producer need to retain their order:
+        std::vector<int> next(4, 0);
+        for (StringVec::iterator i = requests.begin(); i != requests.end(); ++i) {
+            StringVec tokens = StringOps::tokenize(*i, " ");
+            int id = StringOps::atoi(tokens[0]);
+            TS_ASSERT_EQUALS(next[id], StringOps::atoi(tokens[1]));
+            ++next[id];
+        }
     }
 
     class Runner
@@ -85,17 +133,16 @@ public:
         MPILayer mpiLayer;
         Pipe pipe;
 
-        // fixme
-        // if (mpiLayer.rank() == 0) {
-        //     boost::thread myThread((Runner(&pipe)));
-        //     pipe.waitForFeedback();
-        //     StringVec actual = pipe.retrieveSteeringFeedback();
-        //     StringVec expected;
-        //     expected << "bingobongo\n";
-        //     TS_ASSERT_EQUALS(actual, expected);
-
-        //     myThread.join();
-        // }
+        if (mpiLayer.rank() == 0) {
+            std::thread myThread((Runner(&pipe)));
+            pipe.waitForFeedback();
+            StringVec actual = pipe.retrieveSteeringFeedback();
+            StringVec expected;
+            expected << "bingobongo\n";
+            TS_ASSERT_EQUALS(actual, expected);
+
+            myThread.join();
+        }
     }
 };
 
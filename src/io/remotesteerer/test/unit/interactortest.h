@@ -1,6 +1,8 @@
 #include <libgeodecomp/io/remotesteerer/interactor.h>
+#include <libgeodecomp/io/remotesteerer/socket.h>
 
 #include <cxxtest/TestSuite.h>
+#include <unistd.h>
 
 using namespace LibGeoDecomp;
 using namespace LibGeoDecomp::RemoteSteererHelpers;
@@ -14,44 +16,57 @@ class InteractorTest : public CxxTest::TestSuite
 public:
     void testThreaded()
     {
-        // fixme
-        // int port = 47111;
-        // StringVec expectedFeedback;
-        // expectedFeedback << "bingo bongo";
-
-        // // listen on port "port"
-        // boost::asio::io_service ioService;
-        // tcp::acceptor acceptor(ioService, tcp::endpoint(tcp::v4(), port));
-        // tcp::socket socket(ioService);
-
-        // // start the interactor and wait until it has sent its commands
-        // Interactor interactor("command blah\n", 1, true, port);
-
-        // // grab the data from the interactor:
-        // boost::system::error_code errorCode;
-        // acceptor.accept(socket, errorCode);
-        // boost::asio::streambuf buf;
-        // std::size_t length = boost::asio::read_until(socket, buf, '\n', errorCode);
-        // // gah, converting streambuf to string couldn't be any easier...
-        // std::istream lineBuf(&buf);
-        // std::string line(length, 'X');
-        // lineBuf.read(&line[0], length);
-
-        // // write back some feedback
-        // boost::asio::write(
-        //     socket,
-        //     boost::asio::buffer("bingo bongo\n"),
-        //     boost::asio::transfer_all(),
-        //     errorCode);
-
-        // // check the results
-        // StringVec tokens = StringOps::tokenize(line, " \r\n");
-        // StringVec expected;
-        // expected << "command"
-        //          << "blah";
-        // TS_ASSERT_EQUALS(tokens, expected);
-        // interactor.waitForCompletion();
-        // TS_ASSERT_EQUALS(interactor.feedback(), expectedFeedback);
+        int port = 47111;
+        StringVec expectedFeedback;
+        expectedFeedback << "bingo bongo";
+
+        // listen on port "port"
+        int acceptor = Socket::listenTCP(port);
+
+        // start the interactor and wait until it has sent its commands
+        Interactor interactor("command blah", 1, true, port);
+
+        // grab the data from the interactor:
+        int socket = accept(acceptor, 0, 0);
+        std::string line = readLine(socket);
+
+        // write back some feedback, fragmented to check line buffering
+        Socket::writeAll(socket, "bingo ");
+        usleep(10000);
+        Socket::writeAll(socket, "bongo\n");
+
+        // check the results
+        StringVec tokens = StringOps::tokenize(line, " \r\n");
+        StringVec expected;
+        expected << "command"
+                 << "blah";
+        TS_ASSERT_EQUALS(tokens, expected);
+        interactor.waitForCompletion();
+        TS_ASSERT_EQUALS(interactor.feedback(), expectedFeedback);
+
+        close(socket);
+        close(acceptor);
+    }
+
+    void testConnectionFailure()
+    {
+        // nobody is listening on this port, so the Interactor should
+        // give up instead of blocking:
+        Interactor interactor("command blah", 1, false, 47118);
+        TS_ASSERT_EQUALS(1, interactor());
+        TS_ASSERT_EQUALS(std::size_t(0), interactor.feedback().size());
+    }
+
+private:
+    std::string readLine(int socket)
+    {
+        std::string ret;
+        char c = 0;
+        while ((recv(socket, &c, 1, 0) == 1) && (c != '\n')) {
+            ret += c;
+        }
+
+        return ret;
     }
 };
 
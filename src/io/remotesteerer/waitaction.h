@@ -8,7 +8,10 @@ namespace LibGeoDecomp {
 namespace RemoteSteererHelpers {
 
 /**
- * Suspends the command server until feedback is available.
+ * Retained for compatibility with older clients, which had to suspend
+ * the CommandServer until feedback was available. As the
+ * CommandServer now forwards feedback as soon as it arrives, this is
+ * a NOP -- blocking would stall all other clients.
  */
 template<typename CELL_TYPE>
 class WaitAction : public Action<CELL_TYPE>
@@ -17,18 +20,11 @@ public:
     WaitAction() :
         Action<CELL_TYPE>(
             "wait",
-            "usage: \"wait [n]\", will wait until n lines of feedback from the simulation have been received. If n is omitted, it will wait for 1 line.")
+            "usage: \"wait [n]\", deprecated: feedback is now sent as soon as it's available.")
     {}
 
     void operator()(const StringVec& parameters, Pipe& pipe)
-    {
-        int lines = 1;
-        if (parameters.size() > 0) {
-            lines = StringOps::atoi(parameters[0]);
-        }
-
-        pipe.waitForFeedback(lines);
-    }
+    {}
 };
 
 }
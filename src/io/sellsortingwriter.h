@@ -22,45 +22,45 @@ namespace LibGeoDecomp {
 namespace SellSortingWriterHelpers {
 
 /**
- * Helper class which sorts the actual UnstructuredSoAGrid members
- * regarding to used SELL matrix.
+ * Helper class which gathers a single member of an
+ * UnstructuredSoAGrid into a buffer, reverting the row permutation
+ * of the given SELL matrix. The grid itself is only read.
  */
 template<typename CELL, typename VALUE_TYPE, int C, int SIGMA>
-class SortMember
+class GatherMember
 {
 public:
     inline
-    SortMember(const Selector<CELL>& selector,
-               const SellCSigmaSparseMatrixContainer<VALUE_TYPE, C, SIGMA>& matrix,
-               bool forward) :
+    GatherMember(const Selector<CELL>& selector,
+                 const SellCSigmaSparseMatrixContainer<VALUE_TYPE, C, SIGMA>& matrix,
+                 std::vector<char> *buffer) :
         selector(selector),
         matrix(matrix),
-        forward(forward)
+        buffer(buffer)
     {}
 
     template<long DIM_X, long DIM_Y, long DIM_Z, long INDEX>
-    void operator()(LibFlatArray::soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX> accessor)
+    void operator()(LibFlatArray::soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX> accessor) const
     {
-        const auto& rowsVec = forward ? matrix.realRowToSortedVec() : matrix.chunkRowToRealVec();
-        const std::size_t size = rowsVec.size(); // -> corresponds to rowsPadded
-        char *data = accessor.access_member(selector.sizeOfMember(), selector.offset());
-        std::vector<char> copy(size * selector.sizeOfMember());
-        std::memcpy(copy.data(), data, size * selector.sizeOfMember());
+        const auto& realRowToSorted = matrix.realRowToSortedVec();
+        const std::size_t size = realRowToSorted.size(); // -> corresponds to rowsPadded
+        const std::size_t memberSize = selector.sizeOfMember();
+        const char *data = accessor.access_member(memberSize, selector.offset());
+        buffer->resize(size * memberSize);
+        char *target = buffer->data();
 
-        // sort
         for (std::size_t row = 0; row < size; ++row) {
-            std::size_t realRow = rowsVec[row];
             // e.g. copy 8 bytes for double
-            std::memcpy(data + row * selector.sizeOfMember(),
-                        copy.data() + realRow * selector.sizeOfMember(),
-                        selector.sizeOfMember());
+            std::memcpy(target + row * memberSize,
+                        data + realRowToSorted[row] * memberSize,
+                        memberSize);
         }
     }
 
 private:
     const Selector<CELL>& selector;
     const SellCSigmaSparseMatrixContainer<VALUE_TYPE, C, SIGMA>& matrix;
-    bool forward;
+    std::vector<char> *buffer;
 };
 
 }
@@ -68,8 +68,14 @@ private:
 /**
  * This writer works as a proxy writer. If the user use unstructured grids
  * and vectorization (SoA memory layout) the output has to be sorted according
- * to the used SELL matrix. This writer sorts the output grid and just calls
- * the real writer.
+ * to the used SELL matrix. This writer gathers the selected member in
+ * original row order into a private output grid and hands that to the
+ * real writer. The simulation grid is never modified, so it needn't be
+ * sorted back afterwards, and the gather could safely run concurrently
+ * to other readers of the grid.
+ *
+ * Only the selected member is valid in the grid passed to the
+ * delegate, all other members retain their default values.
  */
 template<typename CELL, typename WRITER>
 class SellSortingWriter : public Clonable<Writer<CELL>, SellSortingWriter<CELL, WRITER> >
@@ -95,7 +101,8 @@ public:
         Clonable<Writer<CELL>, SellSortingWriter<CELL, WRITER> >(prefix, period),
         delegate(proxy),
         selector(memberPointer, "unused name"),
-        matrixID(matrixID)
+        matrixID(matrixID),
+        outputGrid(CoordBox<DIM>())
     {
         if (SIGMA <= 1) {
             throw std::logic_error("The SortingWriter makes only sense to use with a SIGMA greater 1.");
@@ -116,15 +123,18 @@ public:
             return;
         }
 
-        // sort forward for output
-        sort(grid, true);
-        delegate->stepFinished(grid, step, event);
-        // sort back for further computations
-        sort(grid, false);
+        gather(grid);
+        delegate->stepFinished(outputGrid, step, event);
     }
 
 private:
-    void sort(const GridType& grid, bool forward)
+    WRITER *delegate;
+    Selector<CELL> selector;
+    std::size_t matrixID;
+    SoAGrid outputGrid;
+    std::vector<char> buffer;
+
+    void gather(const GridType& grid)
     {
         const auto *soaGrid = dynamic_cast<const SoAGrid *>(&grid);
         if (soaGrid == nullptr) {
@@ -132,16 +142,24 @@ private:
                                    "Did you forget to specify HasSoA apitrait?");
         }
 
+        // the output grid is reused for all steps unless the
+        // simulation's grid changes its shape:
+        if (outputGrid.boundingBox() != soaGrid->boundingBox()) {
+            outputGrid = SoAGrid(soaGrid->boundingBox());
+        }
+        outputGrid.setEdge(soaGrid->getEdge());
+
         const auto& matrix = soaGrid->getWeights(matrixID);
-        // fixme: we'll need to rework this api at some later point of time as a
-        //        writer should treat the grid as read-only'
         soaGrid->callback(SellSortingWriterHelpers::
-                          SortMember<CELL, ValueType, C, SIGMA>(selector, matrix, forward));
-    }
+                          GatherMember<CELL, ValueType, C, SIGMA>(selector, matrix, &buffer));
 
-    WRITER *delegate;
-    Selector<CELL> selector;
-    std::size_t matrixID;
+        Region<DIM> region;
+        region << outputGrid.boundingBox();
+        if (buffer.size() < (region.size() * selector.sizeOfMember())) {
+            throw std::logic_error("SellSortingWriter requires the weights of the given matrix to be set.");
+        }
+        outputGrid.loadMemberUnchecked(buffer.data(), MemoryLocation::HOST, selector, region);
+    }
 };
 
 }
@@ -0,0 +1,319 @@
+#ifndef LIBGEODECOMP_IO_STREAKINITIALIZER_H
+#define LIBGEODECOMP_IO_STREAKINITIALIZER_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/geometry/streak.h>
+#include <libgeodecomp/io/simpleinitializer.h>
+#include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/storage/displacedgrid.h>
+#include <libgeodecomp/storage/grid.h>
+#include <libgeodecomp/storage/soagrid.h>
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#include <omp.h>
+#endif
+
+#include <vector>
+
+namespace LibGeoDecomp {
+
+namespace StreakInitializerHelpers {
+
+/**
+ * Distributes the planes of the Region (XY-planes in 3D, rows in 2D)
+ * among OpenMP threads with a static schedule, just like the
+ * threaded UpdateFunctor does it, and hands each plane's Streaks to
+ * the functor.
+ */
+template<int DIM, typename FUNCTOR>
+void forEachPlane(const Region<DIM>& region, const FUNCTOR& functor)
+{
+    // OpenMP 2.5 (MSVC) insists on signed loop counters:
+    long numPlanes = region.numPlanes();
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel for schedule(static)
+#endif
+    for (long c = 0; c < numPlanes; ++c) {
+        functor(region.planeStreakIterator(c + 0), region.planeStreakIterator(c + 1));
+    }
+}
+
+/**
+ * Lets the Initializer write directly to the memory of Grid and
+ * DisplacedGrid, which store each Streak contiguously. Writes to
+ * disjoint Streaks are safe to run concurrently.
+ */
+template<typename INITIALIZER, typename GRID>
+class InitAoSPlane
+{
+public:
+    InitAoSPlane(const INITIALIZER *initializer, GRID *grid) :
+        initializer(initializer),
+        grid(grid)
+    {}
+
+    template<typename ITERATOR>
+    void operator()(ITERATOR i, const ITERATOR& end) const
+    {
+        for (; i != end; ++i) {
+            initializer->initStreak(*i, &(*grid)[i->origin]);
+        }
+    }
+
+private:
+    const INITIALIZER *initializer;
+    GRID *grid;
+};
+
+/**
+ * Hands the Initializer a LibFlatArray accessor positioned at each
+ * Streak's first cell, so it can fill the member arrays directly.
+ */
+template<typename INITIALIZER, int DIM, typename ACCESSOR>
+class InitSoAPlane
+{
+public:
+    InitSoAPlane(
+        const INITIALIZER *initializer,
+        const ACCESSOR& accessor,
+        const Coord<DIM>& origin,
+        const Coord<3>& edgeRadii) :
+        initializer(initializer),
+        accessor(accessor),
+        origin(origin),
+        edgeRadii(edgeRadii)
+    {}
+
+    template<typename ITERATOR>
+    void operator()(ITERATOR i, const ITERATOR& end) const
+    {
+        // each thread needs its own index:
+        ACCESSOR cursor = accessor;
+
+        for (; i != end; ++i) {
+            cursor.index() = SoAGridHelpers::GenIndex<ACCESSOR::DIM_X, ACCESSOR::DIM_Y, ACCESSOR::DIM_Z>()(
+                i->origin - origin, edgeRadii);
+            initializer->initStreak(*i, cursor);
+        }
+    }
+
+private:
+    const INITIALIZER *initializer;
+    ACCESSOR accessor;
+    Coord<DIM> origin;
+    Coord<3> edgeRadii;
+};
+
+/**
+ * Callback for SoAGrid which retrieves the accessor, see InitSoAPlane.
+ */
+template<typename INITIALIZER, typename CELL, int DIM>
+class InitSoARegion
+{
+public:
+    InitSoARegion(
+        const INITIALIZER *initializer,
+        const Region<DIM>& region,
+        const Coord<DIM>& origin,
+        const Coord<3>& edgeRadii) :
+        initializer(initializer),
+        region(region),
+        origin(origin),
+        edgeRadii(edgeRadii)
+    {}
+
+    template<long DIM_X, long DIM_Y, long DIM_Z, long INDEX>
+    void operator()(LibFlatArray::soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX> accessor) const
+    {
+        typedef LibFlatArray::soa_accessor<CELL, DIM_X, DIM_Y, DIM_Z, INDEX> Accessor;
+
+        forEachPlane(
+            region,
+            InitSoAPlane<INITIALIZER, DIM, Accessor>(initializer, accessor, origin, edgeRadii));
+    }
+
+private:
+    const INITIALIZER *initializer;
+    const Region<DIM>& region;
+    Coord<DIM> origin;
+    Coord<3> edgeRadii;
+};
+
+/**
+ * Fallback for all other grids: GridBase::set() isn't guaranteed to
+ * be thread-safe (e.g. SoAGrid reuses a staging buffer), so each
+ * plane is set up in a temporary buffer and copying it into the grid
+ * is serialized.
+ */
+template<typename INITIALIZER, typename CELL, int DIM>
+class InitBufferedPlane
+{
+public:
+    InitBufferedPlane(const INITIALIZER *initializer, GridBase<CELL, DIM> *grid) :
+        initializer(initializer),
+        grid(grid)
+    {}
+
+    template<typename ITERATOR>
+    void operator()(const ITERATOR& begin, const ITERATOR& end) const
+    {
+        std::size_t length = 0;
+        for (ITERATOR i = begin; i != end; ++i) {
+            length += i->length();
+        }
+
+        std::vector<CELL> buffer(length);
+        CELL *cursor = &buffer[0];
+        for (ITERATOR i = begin; i != end; ++i) {
+            initializer->initStreak(*i, cursor);
+            cursor += i->length();
+        }
+
+        cursor = &buffer[0];
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp critical(LibGeoDecompStreakInitializer)
+#endif
+        for (ITERATOR i = begin; i != end; ++i) {
+            grid->set(*i, cursor);
+            cursor += i->length();
+        }
+    }
+
+private:
+    const INITIALIZER *initializer;
+    GridBase<CELL, DIM> *grid;
+};
+
+}
+
+/**
+ * Convenience class for Initializers which can set up a whole Streak
+ * of cells at once, implemented using CRTP. Instead of calling the
+ * virtual GridBase::set() once per cell, grid() lets INITIALIZER
+ * write each Streak directly to the grid's memory. INITIALIZER needs
+ * to provide
+ *
+ *   void initStreak(const Streak<DIM>& streak, CELL *cells) const
+ *
+ * which sets up the streak.length() cells of the given Streak in the
+ * array cells. If CELL supports SoA, it additionally needs to provide
+ *
+ *   template<typename ACCESSOR>
+ *   void initStreak(const Streak<DIM>& streak, ACCESSOR accessor) const
+ *
+ * which is handed a LibFlatArray accessor positioned at the Streak's
+ * first cell for filling the member arrays directly, e.g. via
+ * "accessor.foo() = 1; ++accessor.index();". Which of both gets
+ * called depends on the grid's memory layout.
+ *
+ * The Region is split into planes (XY-planes in 3D, rows in 2D)
+ * which are distributed among OpenMP threads with a static schedule.
+ * initStreak() will be called concurrently for disjoint Streaks and
+ * therefore needs to be thread-safe. This also means that pages get
+ * first touched by the threads which will later update them.
+ * Beware: Random uses a global generator, so seedRNG() can't be used
+ * from within initStreak().
+ *
+ * Only Grid, DisplacedGrid and SoAGrid are written to directly. For
+ * other grids the Streaks are set up in a buffer and copying them
+ * into the grid is serialized.
+ *
+ * Edge cells are left untouched. Derived classes may override grid()
+ * and call setEdge() after invoking StreakInitializer::grid().
+ */
+template<typename CELL, typename INITIALIZER>
+class StreakInitializer : public SimpleInitializer<CELL>
+{
+public:
+    typedef typename SimpleInitializer<CELL>::Topology Topology;
+    typedef typename APITraits::SelectSoA<CELL>::Value SupportsSoA;
+    const static int DIM = Topology::DIM;
+
+    explicit StreakInitializer(
+        const Coord<DIM>& dimensions,
+        const unsigned steps = 300) :
+        SimpleInitializer<CELL>(dimensions, steps)
+    {}
+
+    virtual void grid(GridBase<CELL, DIM> *target)
+    {
+        Region<DIM> region;
+        region << target->boundingBox();
+        grid(target, region);
+    }
+
+    /**
+     * Initializes only the cells in region, which needs to be
+     * contained within the target's bounding box. Calls for
+     * disjoint Regions may be issued from multiple threads.
+     */
+    void grid(GridBase<CELL, DIM> *target, const Region<DIM>& region)
+    {
+        using namespace StreakInitializerHelpers;
+        const INITIALIZER *initializer = static_cast<const INITIALIZER*>(this);
+
+        if (initSoA(target, region, SupportsSoA())) {
+            return;
+        }
+
+        typedef Grid<CELL, Topology> PlainGrid;
+        PlainGrid *plainGrid = dynamic_cast<PlainGrid*>(target);
+        if (plainGrid != 0) {
+            forEachPlane(region, InitAoSPlane<INITIALIZER, PlainGrid>(initializer, plainGrid));
+            return;
+        }
+
+        typedef DisplacedGrid<CELL, Topology, false> DisplacedGridType;
+        DisplacedGridType *displacedGrid = dynamic_cast<DisplacedGridType*>(target);
+        if (displacedGrid != 0) {
+            forEachPlane(region, InitAoSPlane<INITIALIZER, DisplacedGridType>(initializer, displacedGrid));
+            return;
+        }
+
+        forEachPlane(region, InitBufferedPlane<INITIALIZER, CELL, DIM>(initializer, target));
+    }
+
+private:
+    bool initSoA(GridBase<CELL, DIM> * /* target */, const Region<DIM>& /* region */, APITraits::FalseType)
+    {
+        return false;
+    }
+
+    bool initSoA(GridBase<CELL, DIM> *target, const Region<DIM>& region, APITraits::TrueType)
+    {
+        typedef SoAGrid<CELL, Topology, false> SoAGridType;
+        typedef SoAGrid<CELL, Topology, true> TopologicallyCorrectSoAGridType;
+
+        SoAGridType *soaGrid = dynamic_cast<SoAGridType*>(target);
+        if (soaGrid != 0) {
+            initSoAGrid(soaGrid, region);
+            return true;
+        }
+
+        TopologicallyCorrectSoAGridType *topologicallyCorrectSoAGrid =
+            dynamic_cast<TopologicallyCorrectSoAGridType*>(target);
+        if (topologicallyCorrectSoAGrid != 0) {
+            initSoAGrid(topologicallyCorrectSoAGrid, region);
+            return true;
+        }
+
+        return false;
+    }
+
+    template<typename SOA_GRID>
+    void initSoAGrid(SOA_GRID *grid, const Region<DIM>& region)
+    {
+        grid->callback(
+            StreakInitializerHelpers::InitSoARegion<INITIALIZER, CELL, DIM>(
+                static_cast<const INITIALIZER*>(this),
+                region,
+                grid->boundingBox().origin,
+                grid->getEdgeRadii()));
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,112 @@
+#include <libgeodecomp/io/asyncparallelwriter.h>
+#include <libgeodecomp/io/asyncwriter.h>
+#include <libgeodecomp/io/memorywriter.h>
+#include <libgeodecomp/io/mockwriter.h>
+#include <libgeodecomp/io/testinitializer.h>
+#include <libgeodecomp/loadbalancer/noopbalancer.h>
+#include <libgeodecomp/parallelization/serialsimulator.h>
+#include <libgeodecomp/parallelization/stripingsimulator.h>
+
+#include <cxxtest/TestSuite.h>
+#include <chrono>
+#include <stdexcept>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class AsyncWriterTest : public CxxTest::TestSuite
+{
+public:
+    void testSerial()
+    {
+#if defined(LIBGEODECOMP_WITH_CPP14) && defined(LIBGEODECOMP_WITH_THREADS)
+        SerialSimulator<TestCell<2> > sim(new TestInitializer<TestCell<2> >());
+        MemoryWriter<TestCell<2> > *expected = new MemoryWriter<TestCell<2> >(3);
+        MemoryWriter<TestCell<2> > *actual   = new MemoryWriter<TestCell<2> >(3);
+        sim.addWriter(expected);
+        sim.addWriter(new AsyncWriter<TestCell<2> >(actual));
+
+        sim.run();
+
+        TS_ASSERT_EQUALS(expected->getGrids().size(), actual->getGrids().size());
+        TS_ASSERT_EQUALS(expected->getGrids(),        actual->getGrids());
+#endif
+    }
+
+    void testParallel()
+    {
+#if defined(LIBGEODECOMP_WITH_CPP14) && defined(LIBGEODECOMP_WITH_THREADS)
+        SharedPtr<MockWriter<>::EventsStore>::Type expectedEvents(new MockWriter<>::EventsStore);
+        SharedPtr<MockWriter<>::EventsStore>::Type actualEvents(new MockWriter<>::EventsStore);
+
+        {
+            StripingSimulator<TestCell<2> > sim(new TestInitializer<TestCell<2> >(), new NoOpBalancer);
+            sim.addWriter(new MockWriter<>(expectedEvents, 3));
+            sim.addWriter(new AsyncParallelWriter<TestCell<2> >(new MockWriter<>(actualEvents, 3), 1));
+
+            sim.run();
+        }
+
+        TS_ASSERT_EQUALS(*expectedEvents, *actualEvents);
+#endif
+    }
+
+    void testBackPressure()
+    {
+#if defined(LIBGEODECOMP_WITH_CPP14) && defined(LIBGEODECOMP_WITH_THREADS)
+        std::mutex mutex;
+        std::vector<int> log;
+        int pending = 0;
+        int maxPending = 0;
+
+        {
+            AsyncWriterHelpers::JobQueue queue(2);
+
+            for (int i = 0; i < 20; ++i) {
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    ++pending;
+                    maxPending = (std::max)(maxPending, pending);
+                }
+
+                queue.push([&mutex, &log, &pending, i]() {
+                        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                        std::unique_lock<std::mutex> lock(mutex);
+                        log << i;
+                        --pending;
+                    });
+            }
+
+            queue.flush();
+            TS_ASSERT_EQUALS(0, pending);
+        }
+
+        // two queued jobs plus the one being executed plus the one
+        // we're about to push:
+        TS_ASSERT(maxPending <= 4);
+
+        std::vector<int> expected;
+        for (int i = 0; i < 20; ++i) {
+            expected << i;
+        }
+        TS_ASSERT_EQUALS(expected, log);
+#endif
+    }
+
+    void testExceptionsArePropagated()
+    {
+#if defined(LIBGEODECOMP_WITH_CPP14) && defined(LIBGEODECOMP_WITH_THREADS)
+        AsyncWriterHelpers::JobQueue queue(1);
+        queue.push([]() {
+                throw std::runtime_error("disk full");
+            });
+
+        TS_ASSERT_THROWS(queue.flush(), std::runtime_error&);
+        // the error is only reported once:
+        queue.flush();
+#endif
+    }
+};
+
+}
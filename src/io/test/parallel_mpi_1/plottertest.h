@@ -139,6 +139,78 @@ public:
         TS_ASSERT_EQUALS(actSlice, uncSlice);
     }
 
+    void testPlotGridTiled()
+    {
+        // neither of the dimensions is a multiple of the tile size:
+        Coord<2> gridDim(150, 40);
+        Grid<TestCell<2> > testGrid(gridDim);
+        for (int y = 0; y < gridDim.y(); ++y) {
+            for (int x = 0; x < gridDim.x(); ++x) {
+                testGrid[Coord<2>(x, y)].testValue = (x * 7 + y * 13) % 256;
+            }
+        }
+
+        Image expected(plotter->calcImageDim(gridDim));
+        ImagePainter painter(&expected);
+        plotter->plotGrid(testGrid, painter);
+
+        Image actual(plotter->calcImageDim(gridDim));
+        plotter->plotGridTiled(testGrid, &actual);
+        TS_ASSERT_EQUALS(expected, actual);
+
+        CoordBox<2> viewport(Coord<2>(333, 111), Coord<2>(700, 500));
+        Image expectedExcerpt(viewport.dimensions);
+        ImagePainter excerptPainter(&expectedExcerpt);
+        plotter->plotGridInViewport(testGrid, excerptPainter, viewport);
+
+        Image actualExcerpt(viewport.dimensions);
+        plotter->plotGridTiledInViewport(testGrid, &actualExcerpt, viewport);
+        TS_ASSERT_EQUALS(expectedExcerpt, actualExcerpt);
+    }
+
+    void testStride()
+    {
+        Coord<2> gridDim(7, 5);
+        Grid<TestCell<2> > testGrid(gridDim);
+        for (int y = 0; y < gridDim.y(); ++y) {
+            for (int x = 0; x < gridDim.x(); ++x) {
+                testGrid[Coord<2>(x, y)].testValue = x + 10 * y;
+            }
+        }
+
+        Plotter<TestCell<2> > downsampler(
+            Coord<2>(2, 1),
+            SimpleCellPlotter<TestCell<2> >(&TestCell<2>::testValue, TestCellPalette()),
+            Coord<2>(3, 2));
+        Coord<2> imageDim = downsampler.calcImageDim(gridDim);
+        TS_ASSERT_EQUALS(Coord<2>(6, 3), imageDim);
+
+        Image expected(imageDim);
+        for (int y = 0; y < 3; ++y) {
+            for (int x = 0; x < 3; ++x) {
+                Color color(3 * x + 20 * y, 47, 11);
+                expected[Coord<2>(2 * x + 0, y)] = color;
+                expected[Coord<2>(2 * x + 1, y)] = color;
+            }
+        }
+
+        Image actual(imageDim);
+        ImagePainter painter(&actual);
+        downsampler.plotGrid(testGrid, painter);
+        TS_ASSERT_EQUALS(expected, actual);
+
+        Image tiled(imageDim);
+        downsampler.plotGridTiled(testGrid, &tiled);
+        TS_ASSERT_EQUALS(expected, tiled);
+
+        TS_ASSERT_THROWS(
+            Plotter<TestCell<2> >(
+                Coord<2>(2, 1),
+                SimpleCellPlotter<TestCell<2> >(&TestCell<2>::testValue, TestCellPalette()),
+                Coord<2>(0, 1)),
+            std::invalid_argument&);
+    }
+
     void testPlotGridInViewportLarge()
     {
         Grid<TestCell<2> > testGrid(Coord<2>(2000, 2000));
@@ -30,6 +30,16 @@ public:
     }
 
     void testBasic()
+    {
+        checkWriter(true);
+    }
+
+    void testIndependentIO()
+    {
+        checkWriter(false);
+    }
+
+    void checkWriter(bool collective)
     {
         TestInitializer<TestCell<3> > *init = new TestInitializer<TestCell<3> >();
         Coord<3> dimensions(init->gridDimensions());
@@ -39,7 +49,10 @@ public:
         simTest.addWriter(new BOVWriter<TestCell<3> >(
                               Selector<TestCell<3> >(&TestCell<3>::testValue, "val"),
                               "testbovwriter",
-                              4));
+                              4,
+                              Coord<3>(),
+                              MPI_COMM_WORLD,
+                              collective));
         simTest.run();
 
         MPILayer().barrier();
@@ -0,0 +1,145 @@
+#include <libgeodecomp/geometry/partitions/zcurvepartition.h>
+#include <libgeodecomp/io/asyncparallelwriter.h>
+#include <libgeodecomp/io/chrometracewriter.h>
+#include <libgeodecomp/io/testinitializer.h>
+#include <libgeodecomp/loadbalancer/noopbalancer.h>
+#include <libgeodecomp/misc/tempfile.h>
+#include <libgeodecomp/parallelization/hiparsimulator.h>
+#include <libgeodecomp/parallelization/stripingsimulator.h>
+
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <sstream>
+#include <unistd.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+/**
+ * Records the steps and events it was called for.
+ */
+template<typename CELL_TYPE>
+class AllDoneOnlyTestWriter : public Clonable<ParallelWriter<CELL_TYPE>, AllDoneOnlyTestWriter<CELL_TYPE> >
+{
+public:
+    typedef typename ParallelWriter<CELL_TYPE>::GridType GridType;
+    typedef typename ParallelWriter<CELL_TYPE>::RegionType RegionType;
+    typedef typename ParallelWriter<CELL_TYPE>::CoordType CoordType;
+
+    explicit AllDoneOnlyTestWriter(std::vector<std::pair<unsigned, WriterEvent> > *calls) :
+        Clonable<ParallelWriter<CELL_TYPE>, AllDoneOnlyTestWriter<CELL_TYPE> >("", 1, true),
+        calls(calls)
+    {}
+
+    virtual void stepFinished(
+        const GridType& grid,
+        const RegionType& validRegion,
+        const CoordType& globalDimensions,
+        unsigned step,
+        WriterEvent event,
+        std::size_t rank,
+        bool lastCall)
+    {
+        if (lastCall) {
+            *calls << std::make_pair(step, event);
+        }
+    }
+
+private:
+    std::vector<std::pair<unsigned, WriterEvent> > *calls;
+};
+
+class ChromeTraceWriterTest : public CxxTest::TestSuite
+{
+public:
+    void testGatherTracesOfAllRanks()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        MPILayer mpiLayer;
+        std::string prefix = TempFile::parallel("chrometracewritertest");
+
+        {
+            StripingSimulator<TestCell<3> > sim(
+                new TestInitializer<TestCell<3> >(Coord<3>(10, 20, 30), 5, 0),
+                mpiLayer.rank() ? 0 : new NoOpBalancer);
+            sim.addWriter(new ChromeTraceWriter<TestCell<3> >(prefix));
+            sim.run();
+        }
+        TimelineTracer::disable();
+
+        if (mpiLayer.rank() == 0) {
+            std::string filename = prefix + ".json";
+            std::ifstream file(filename.c_str());
+            std::stringstream buf;
+            buf << file.rdbuf();
+            std::string trace = buf.str();
+            unlink(filename.c_str());
+
+            TS_ASSERT_EQUALS(0, trace.find("[\n"));
+            TS_ASSERT_EQUALS(trace.size() - 4, trace.rfind("}\n]\n"));
+            TS_ASSERT_EQUALS(std::string::npos, trace.find(",\n]"));
+
+            for (int rank = 0; rank < mpiLayer.size(); ++rank) {
+                std::stringstream pid;
+                pid << "\"pid\":" << rank << ",";
+                TS_ASSERT_DIFFERS(std::string::npos, trace.find("\"name\":\"process_name\",\"ph\":\"M\"," + pid.str()));
+                TS_ASSERT_DIFFERS(std::string::npos, trace.find("\"name\":\"compute_time_inner\",\"ph\":\"X\"," + pid.str()));
+                TS_ASSERT_DIFFERS(std::string::npos, trace.find("\"name\":\"communication_time\",\"ph\":\"X\"," + pid.str()));
+            }
+        }
+#endif
+    }
+
+    void testAllDoneOnly()
+    {
+        typedef std::vector<std::pair<unsigned, WriterEvent> > CallVec;
+        CallVec expected;
+        expected << std::make_pair(25u, WRITER_ALL_DONE);
+
+        CallVec stripingCalls;
+        {
+            StripingSimulator<TestCell<2> > sim(
+                new TestInitializer<TestCell<2> >(Coord<2>(20, 30), 25, 0),
+                MPILayer().rank() ? 0 : new NoOpBalancer);
+            sim.addWriter(new AllDoneOnlyTestWriter<TestCell<2> >(&stripingCalls));
+            sim.run();
+        }
+        TS_ASSERT_EQUALS(expected, stripingCalls);
+
+        CallVec hiParCalls;
+        {
+            HiParSimulator<TestCell<2>, ZCurvePartition<2> > sim(
+                new TestInitializer<TestCell<2> >(Coord<2>(20, 30), 25, 0),
+                new NoOpBalancer);
+            sim.addWriter(new AllDoneOnlyTestWriter<TestCell<2> >(&hiParCalls));
+            sim.run();
+        }
+        TS_ASSERT_EQUALS(expected, hiParCalls);
+    }
+
+    void testAsyncAllDoneOnly()
+    {
+#if defined(LIBGEODECOMP_WITH_CPP14) && defined(LIBGEODECOMP_WITH_THREADS)
+        typedef std::vector<std::pair<unsigned, WriterEvent> > CallVec;
+        CallVec expected;
+        expected << std::make_pair(25u, WRITER_ALL_DONE);
+
+        CallVec calls;
+        {
+            AsyncParallelWriter<TestCell<2> > *writer = new AsyncParallelWriter<TestCell<2> >(
+                new AllDoneOnlyTestWriter<TestCell<2> >(&calls));
+            TS_ASSERT(writer->isAllDoneOnly());
+
+            HiParSimulator<TestCell<2>, ZCurvePartition<2> > sim(
+                new TestInitializer<TestCell<2> >(Coord<2>(20, 30), 25, 0),
+                new NoOpBalancer);
+            sim.addWriter(writer);
+            sim.run();
+        }
+        TS_ASSERT_EQUALS(expected, calls);
+#endif
+    }
+};
+
+}
@@ -14,6 +14,37 @@ class CollectingWriterTest : public CxxTest::TestSuite
 {
 public:
     void setUp()
+    {
+        // default chunk size, which means the whole Region will be
+        // transmitted at once:
+        initSimulator(1 << 24);
+    }
+
+    void tearDown()
+    {
+        sim.reset();
+    }
+
+    void testBasic()
+    {
+        sim->run();
+        checkGrids();
+    }
+
+    void testSmallChunks()
+    {
+        // 7 cells per chunk won't line up with the grid's 13 cells
+        // wide streaks, so streaks need to be split across chunks:
+        initSimulator(7 * sizeof(TestCell<3>) + 3);
+        sim->run();
+        checkGrids();
+    }
+
+private:
+    SharedPtr<StripingSimulator<TestCell<3> > >::Type sim;
+    MemoryWriter<TestCell<3> > *writer;
+
+    void initSimulator(std::size_t maxChunkSize)
     {
         TestInitializer<TestCell<3> > *init = getInit();
 
@@ -26,18 +57,16 @@ public:
             writer = 0;
         }
 
-        sim->addWriter(new CollectingWriter<TestCell<3> >(writer, 0));
-    }
-
-    void tearDown()
-    {
-        sim.reset();
+        sim->addWriter(new CollectingWriter<TestCell<3> >(
+                           writer,
+                           0,
+                           MPI_COMM_WORLD,
+                           APITraits::SelectMPIDataType<TestCell<3> >::value(),
+                           maxChunkSize));
     }
 
-    void testBasic()
+    void checkGrids()
     {
-        sim->run();
-
         if (MPILayer().rank() == 0) {
             int size = writer->getGrids().size();
             unsigned cycle = 0;
@@ -56,10 +85,6 @@ public:
         }
     }
 
-private:
-    SharedPtr<StripingSimulator<TestCell<3> > >::Type sim;
-    MemoryWriter<TestCell<3> > *writer;
-
     TestInitializer<TestCell<3> > *getInit()
     {
         return new TestInitializer<TestCell<3> >();
@@ -0,0 +1,185 @@
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/io/globalreduction.h>
+#include <libgeodecomp/io/testinitializer.h>
+#include <libgeodecomp/loadbalancer/noopbalancer.h>
+#include <libgeodecomp/misc/testcell.h>
+#include <libgeodecomp/parallelization/stripingsimulator.h>
+#include <libgeodecomp/storage/grid.h>
+
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+/**
+ * Records the results of a GlobalReduction, just like a Steerer
+ * acting upon them would use them.
+ */
+class GlobalReductionRecorder : public Steerer<TestCell<2> >
+{
+public:
+    GlobalReductionRecorder(GlobalReduction<TestCell<2> > *reduction, unsigned period) :
+        Steerer<TestCell<2> >(period),
+        reduction(reduction)
+    {}
+
+    virtual void nextStep(
+        GridType *grid,
+        const Region<2>& validRegion,
+        const CoordType& globalDimensions,
+        unsigned step,
+        SteererEvent event,
+        std::size_t rank,
+        bool lastCall,
+        SteererFeedback *feedback)
+    {
+        if (lastCall && reduction->hasResult()) {
+            resultSteps << reduction->resultStep();
+            values << reduction->value();
+        }
+    }
+
+    GlobalReduction<TestCell<2> > *reduction;
+    std::vector<unsigned> resultSteps;
+    std::vector<double> values;
+};
+
+class GlobalReductionTest : public CxxTest::TestSuite
+{
+public:
+    typedef GlobalReduction<TestCell<2> > ReductionType;
+    typedef Grid<TestCell<2>, Topologies::Cube<2>::Topology> GridType;
+
+    void setUp()
+    {
+        dim = Coord<2>(20, 10);
+        grid = GridType(dim);
+        for (int y = 0; y < dim.y(); ++y) {
+            for (int x = 0; x < dim.x(); ++x) {
+                grid[Coord<2>(x, y)].testValue = y * 100 + x;
+            }
+        }
+
+        // each rank owns half of the grid, but gets to see one
+        // additional row of ghost cells:
+        int myOffset = 5 * MPILayer().rank();
+        ownRegion.clear();
+        ownRegion << CoordBox<2>(Coord<2>(0, myOffset), Coord<2>(20, 5));
+        validRegion.clear();
+        validRegion << CoordBox<2>(Coord<2>(0, 4), Coord<2>(20, 2));
+        validRegion += ownRegion;
+    }
+
+    void testOperations()
+    {
+        Selector<TestCell<2> > selector(&TestCell<2>::testValue, "testValue");
+        ReductionType sum(selector, ReductionType::SUM);
+        ReductionType min(selector, ReductionType::MIN);
+        ReductionType max(selector, ReductionType::MAX);
+        ReductionType histogram(selector, 0, 1000, 4);
+
+        ReductionType *reductions[] = { &sum, &min, &max, &histogram };
+        for (int i = 0; i < 4; ++i) {
+            reductions[i]->setRegion(ownRegion);
+            call(reductions[i], 10, true);
+            TS_ASSERT(!reductions[i]->hasResult());
+        }
+
+        // results are published one step later:
+        for (int i = 0; i < 4; ++i) {
+            call(reductions[i], 11, true);
+            TS_ASSERT(reductions[i]->hasResult());
+            TS_ASSERT_EQUALS(unsigned(10), reductions[i]->resultStep());
+        }
+
+        // sum over y of y * 100 * 20 plus sum over x of x * 10:
+        TS_ASSERT_EQUALS(45 * 2000 + 190 * 10, sum.value());
+        TS_ASSERT_EQUALS(  0, min.value());
+        TS_ASSERT_EQUALS(919, max.value());
+
+        std::vector<double> expectedBins;
+        expectedBins << 60
+                     << 40
+                     << 60
+                     << 40;
+        TS_ASSERT_EQUALS(expectedBins, histogram.bins());
+        TS_ASSERT_EQUALS(200, histogram.value());
+    }
+
+    void testMultipleCallsPerStep()
+    {
+        ReductionType reduction(Selector<TestCell<2> >(&TestCell<2>::cycleCounter, "cycleCounter"), ReductionType::SUM);
+        reduction.setRegion(ownRegion);
+        for (CoordBox<2>::Iterator i = grid.boundingBox().begin(); i != grid.boundingBox().end(); ++i) {
+            grid[*i].cycleCounter = 1;
+        }
+
+        // overlapping calls must not lead to cells being counted twice:
+        call(&reduction, 0, false);
+        call(&reduction, 0, true);
+        call(&reduction, 1, true, STEERER_ALL_DONE);
+
+        TS_ASSERT_EQUALS(unsigned(1), reduction.resultStep());
+        TS_ASSERT_EQUALS(200, reduction.value());
+    }
+
+    void testUnsupportedType()
+    {
+        TS_ASSERT_THROWS(
+            ReductionType(Selector<TestCell<2> >(&TestCell<2>::pos, "pos"), ReductionType::SUM),
+            std::invalid_argument&);
+        TS_ASSERT_THROWS(
+            ReductionType(Selector<TestCell<2> >(&TestCell<2>::testValue, "testValue"), 1, 0, 4),
+            std::invalid_argument&);
+    }
+
+    void testWithSimulator()
+    {
+        int maxSteps = 21;
+        unsigned period = 4;
+
+        StripingSimulator<TestCell<2> > parallelSim(
+            new TestInitializer<TestCell<2> >(dim, maxSteps),
+            MPILayer().rank() ? 0 : new NoOpBalancer);
+        ReductionType *parallelReduction = new ReductionType(
+            Selector<TestCell<2> >(&TestCell<2>::cycleCounter, "cycleCounter"), ReductionType::SUM, period);
+        GlobalReductionRecorder *parallelRecorder = new GlobalReductionRecorder(parallelReduction, period);
+        parallelSim.addSteerer(parallelReduction);
+        parallelSim.addSteerer(parallelRecorder);
+        parallelSim.run();
+
+        // StripingSimulator only notifies Steerers on regular steps,
+        // so the last result lags behind by one period:
+        std::vector<unsigned> expectedSteps;
+        expectedSteps << 0
+                      << 4
+                      << 8
+                      << 12
+                      << 16;
+        TS_ASSERT_EQUALS(expectedSteps, parallelRecorder->resultSteps);
+        TS_ASSERT_EQUALS(expectedSteps.size(), parallelRecorder->values.size());
+
+        // each cell has been updated once per nano step:
+        double numCells = dim.prod();
+        unsigned nanoSteps = APITraits::SelectNanoSteps<TestCell<2> >::VALUE;
+        for (std::size_t i = 0; i < parallelRecorder->values.size(); ++i) {
+            double expected = numCells * parallelRecorder->resultSteps[i] * nanoSteps;
+            TS_ASSERT_EQUALS(expected, parallelRecorder->values[i]);
+        }
+    }
+
+private:
+    Coord<2> dim;
+    GridType grid;
+    Region<2> ownRegion;
+    Region<2> validRegion;
+
+    void call(ReductionType *reduction, unsigned step, bool lastCall, SteererEvent event = STEERER_NEXT_STEP)
+    {
+        ReductionType::SteererFeedback feedback;
+        reduction->nextStep(&grid, validRegion, dim, step, event, MPILayer().rank(), lastCall, &feedback);
+    }
+};
+
+}
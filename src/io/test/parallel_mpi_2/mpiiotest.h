@@ -1,6 +1,7 @@
 #include <libgeodecomp/communication/mpilayer.h>
 #include <libgeodecomp/io/mpiio.h>
 #include <libgeodecomp/misc/tempfile.h>
+#include <libgeodecomp/geometry/coordbox.h>
 #include <libgeodecomp/storage/grid.h>
 
 #include <unistd.h>
@@ -16,7 +17,65 @@ public:
     void testReadWrite()
     {
         MPIIO<double, Topologies::Cube<3>::Topology> mpiio;
+        checkReadWrite(mpiio);
+    }
+
+    void testReadWriteIndependent()
+    {
+        MPIIO<double, Topologies::Cube<3>::Topology> mpiio(false);
+        TS_ASSERT(!mpiio.isCollective());
+        checkReadWrite(mpiio);
+    }
+
+    void testReadWriteWithHints()
+    {
+        typedef MPIIO<double, Topologies::Cube<3>::Topology> MPIIOType;
+        MPIIOType::Hints hints = MPIIOType::collectiveBufferingHints(1, 1024);
+        TS_ASSERT_EQUALS(std::string("enable"), hints["romio_cb_write"]);
+        TS_ASSERT_EQUALS(std::string("1"),      hints["cb_nodes"]);
+        TS_ASSERT_EQUALS(std::string("1024"),   hints["cb_buffer_size"]);
+
+        MPIIOType mpiio(true, hints);
+        checkReadWrite(mpiio);
+    }
+
+    void testTorusWrapAround()
+    {
+        // streaks with negative coordinates end up at the end of the
+        // file, so the region's order doesn't match the file's:
+        MPIIO<double, Topologies::Torus<2>::Topology> mpiio;
+        Coord<2> dim(6, 4);
+        int rank = MPILayer().rank();
+        std::string filename = TempFile::parallel("mpiio_torus");
+
+        Grid<double, Topologies::Torus<2>::Topology> grid1(dim, -2);
+        for (int y = 0; y < dim.y(); ++y) {
+            for (int x = 0; x < dim.x(); ++x) {
+                grid1[Coord<2>(x, y)] = y * 10 + x;
+            }
+        }
+
+        Region<2> region;
+        if (rank == 0) {
+            region << Streak<2>(Coord<2>(0, -1), 6)
+                   << Streak<2>(Coord<2>(0,  0), 6);
+        } else {
+            region << Streak<2>(Coord<2>(0,  1), 6)
+                   << Streak<2>(Coord<2>(0,  2), 6);
+        }
+        mpiio.writeRegion(grid1, dim, 1, 2, filename, region);
 
+        Grid<double, Topologies::Torus<2>::Topology> grid2(dim, -1);
+        region.clear();
+        region << CoordBox<2>(Coord<2>(), dim);
+        mpiio.readRegion(&grid2, filename, region);
+
+        TS_ASSERT_EQUALS(grid1, grid2);
+    }
+
+    template<typename MPIIO_TYPE>
+    void checkReadWrite(MPIIO_TYPE& mpiio)
+    {
         int width = 5;
         int height = 3;
         int depth = 7;
@@ -8,7 +8,7 @@
 #include <libgeodecomp/loadbalancer/noopbalancer.h>
 #include <libgeodecomp/parallelization/stripingsimulator.h>
 
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
 
 #include <libgeodecomp/io/remotesteerer.h>
 #include <libgeodecomp/io/remotesteerer/interactor.h>
@@ -24,7 +24,7 @@ DEFINE_DATAACCESSOR(TestValueAccessor, TestCell<2>, double, testValue);
 class RemoteSteererTest : public CxxTest::TestSuite
 {
 public:
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
     class FlushAction : public Action<TestCell<2> >
     {
     public:
@@ -95,7 +95,7 @@ public:
 
     void setUp()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         mpiLayer.reset(new MPILayer());
         unsigned steererPeriod = 3;
         unsigned writerPeriod = 2;
@@ -118,7 +118,7 @@ public:
 
     void tearDown()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         sim.reset();
         mpiLayer.reset();
 #endif
@@ -126,7 +126,7 @@ public:
 
     void testBasic()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         if (mpiLayer->rank() == 0) {
             steerer->addAction(new FlushAction);
             StringVec feedback = steerer->sendCommandWithFeedback("flush 1234 9", 1);
@@ -159,7 +159,7 @@ public:
 
     void testNonExistentAction()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         if (mpiLayer->rank() == 0) {
             StringVec res;
             res = steerer->sendCommandWithFeedback("nonExistentAction  1 2 3", 2);
@@ -174,7 +174,7 @@ public:
 
     void testInvalidHandler()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         SharedPtr<Interactor>::Type interactor;
 
         if (mpiLayer->rank() == 0) {
@@ -205,7 +205,7 @@ public:
 
     void testHandlerNotFound1()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         if (mpiLayer->rank() == 0) {
             steerer->addAction(new PassThroughAction<TestCell<2> >("echo", "blah"));
         }
@@ -238,7 +238,7 @@ public:
 
     void testHandlerNotFound2()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         if (mpiLayer->rank() == 0) {
             steerer->addAction(new PassThroughAction<TestCell<2> >("echo", "blah"));
         }
@@ -271,7 +271,7 @@ public:
 
     void testHandlerNotFound3()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         if (mpiLayer->rank() == 0) {
             steerer->addAction(new PassThroughAction<TestCell<2> >("echo", "blah"));
         }
@@ -303,13 +303,13 @@ public:
 
     void testGetSet()
     {
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO && 0
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
         steerer->addDataAccessor(new TestValueAccessor());
         SharedPtr<Interactor>::Type interactor;
         mpiLayer->barrier();
 
         if (mpiLayer->rank() == 0) {
-            interactor.reset(new Interactor("get_testValue 2 1 3", 2, true, port));
+            interactor.reset(new Interactor("get_testValue 2 1 3", 1, true, port));
         }
 
         // sleep until the request has made it into the pipeline
@@ -324,19 +324,70 @@ public:
 
         if (interactor) {
             interactor->waitForCompletion();
-            std::cout << "feedback: " << interactor->feedback();
+            StringVec expected;
+            expected << "testValue(1, 3) = 62";
+            TS_ASSERT_EQUALS(interactor->feedback(), expected);
+        }
+#endif
+    }
+
+    /**
+     * Steers the simulation from a client on a different rank than
+     * the CommandServer: the flush has to travel from rank 1 via
+     * TCP to rank 0, get broadcast to all Handlers and show up in
+     * the simulation's output and in the reply to a later request.
+     */
+    void testEndToEnd()
+    {
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
+        steerer->addDataAccessor(new TestValueAccessor());
+        if (mpiLayer->rank() == 0) {
+            steerer->addAction(new FlushAction);
+        }
+        mpiLayer->barrier();
+        SharedPtr<Interactor>::Type interactor;
+
+        if (mpiLayer->rank() == 1) {
+            StringVec feedback = steerer->sendCommandWithFeedback("flush 1000 9", 1);
+            TS_ASSERT_EQUALS(std::size_t(1), feedback.size());
+            TS_ASSERT_EQUALS("flush received", feedback[0]);
+
+            interactor.reset(new Interactor("get_testValue 12 4 3", 1, true, port));
+        }
+
+        // sleep until both requests have made it into the pipeline
+        if (mpiLayer->rank() == 0) {
+            while (steerer->pipe->copySteeringRequestsQueue().size() < 2) {
+                usleep(10000);
+            }
+        }
+        mpiLayer->barrier();
+
+        sim->run();
+
+        TS_ASSERT_EQUALS(writer->getGrids().size(), static_cast<std::size_t>(16));
+        TS_ASSERT_EQUALS(writer->getGrid( 8)[Coord<2>(4, 3)].testValue, 65.0);
+        TS_ASSERT_EQUALS(writer->getGrid( 8)[Coord<2>(5, 8)].testValue, 166.0);
+        TS_ASSERT_EQUALS(writer->getGrid(10)[Coord<2>(4, 3)].testValue, 65.0 + 1000);
+        TS_ASSERT_EQUALS(writer->getGrid(10)[Coord<2>(5, 8)].testValue, 166.0 + 1000);
+        TS_ASSERT_EQUALS(writer->getGrid(30)[Coord<2>(5, 8)].testValue, 166.0 + 1000);
+
+        if (interactor) {
+            interactor->waitForCompletion();
+            StringVec expected;
+            expected << "testValue(4, 3) = 1065";
+            TS_ASSERT_EQUALS(interactor->feedback(), expected);
         }
 #endif
     }
 
 private:
-#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_BOOST_ASIO
+#if defined LIBGEODECOMP_WITH_THREADS && defined LIBGEODECOMP_WITH_REMOTE_STEERER
     SharedPtr<MPILayer>::Type mpiLayer;
     SharedPtr<StripingSimulator<TestCell<2> > >::Type sim;
     RemoteSteerer<TestCell<2> > *steerer;
     ParallelMemoryWriter<TestCell<2> > *writer;
     int port;
-    // fixme: test set/get
     // fixme: test remotesteerer with 1 proc
     // fixme: add help function
     // fixme: refactor steerer interface
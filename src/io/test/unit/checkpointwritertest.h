@@ -0,0 +1,317 @@
+#include <libgeodecomp/io/checkpointcodec.h>
+#include <libgeodecomp/io/checkpointinitializer.h>
+#include <libgeodecomp/io/checkpointwriter.h>
+#include <libgeodecomp/misc/tempfile.h>
+#include <libgeodecomp/storage/displacedgrid.h>
+#include <libgeodecomp/storage/grid.h>
+
+#include <cstdio>
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class CheckpointTestCell
+{
+public:
+    class API : public APITraits::HasCubeTopology<2>
+    {};
+
+    explicit CheckpointTestCell(double temperature = 0, int flag = 0) :
+        temperature(temperature),
+        flag(flag)
+    {}
+
+    bool operator==(const CheckpointTestCell& other) const
+    {
+        return (temperature == other.temperature) && (flag == other.flag);
+    }
+
+    double temperature;
+    int flag;
+};
+
+class CheckpointWriterTest : public CxxTest::TestSuite
+{
+public:
+    typedef CheckpointWriter<CheckpointTestCell> WriterType;
+    typedef CheckpointInitializer<CheckpointTestCell> InitializerType;
+    typedef Topologies::Cube<2>::Topology Topology;
+    typedef Grid<CheckpointTestCell, Topology> GridType;
+    typedef DisplacedGrid<CheckpointTestCell, Topology> DisplacedGridType;
+
+    void setUp()
+    {
+        prefix = TempFile::serial("checkpointwritertest") + "_";
+        dim = Coord<2>(100, 60);
+        grid = GridType(dim);
+
+        for (int y = 0; y < dim.y(); ++y) {
+            for (int x = 0; x < dim.x(); ++x) {
+                grid[Coord<2>(x, y)] = CheckpointTestCell(x * 0.5 + y, x % 3);
+            }
+        }
+
+        // two ranks, neither of which is aligned to the tiles:
+        regions.clear();
+        regions << Region<2>()
+                << Region<2>();
+        regions[0] << CoordBox<2>(Coord<2>( 0, 0), Coord<2>(37, 60));
+        regions[1] << CoordBox<2>(Coord<2>(37, 0), Coord<2>(63, 60));
+
+        selectors.clear();
+        selectors << Selector<CheckpointTestCell>(&CheckpointTestCell::temperature, "temperature")
+                  << Selector<CheckpointTestCell>(&CheckpointTestCell::flag,        "flag");
+    }
+
+    void tearDown()
+    {
+        for (std::vector<unsigned>::iterator step = steps.begin(); step != steps.end(); ++step) {
+            remove(CheckpointHelpers::fileName(prefix, *step, "checkpoint").c_str());
+            for (std::size_t rank = 0; rank < regions.size(); ++rank) {
+                remove(CheckpointHelpers::fileName(prefix, *step, rank, "index").c_str());
+                remove(CheckpointHelpers::fileName(prefix, *step, rank, "data").c_str());
+            }
+        }
+        steps.clear();
+    }
+
+    void testCodec()
+    {
+        std::vector<char> source;
+        for (int i = 0; i < 1000; ++i) {
+            // runs of varying length, interspersed with literals:
+            source << char(i % 7);
+            for (int j = 0; j < (i % 200); ++j) {
+                source << char(i / 7);
+            }
+        }
+
+        std::vector<char> shuffled;
+        std::vector<char> compressed;
+        std::vector<char> decompressed;
+        std::vector<char> unshuffled;
+
+        CheckpointCodec::shuffle(source, 8, &shuffled);
+        CheckpointCodec::compress(shuffled, &compressed);
+        TS_ASSERT_LESS_THAN(compressed.size(), source.size() / 10);
+
+        CheckpointCodec::decompress(compressed, shuffled.size(), &decompressed);
+        TS_ASSERT_EQUALS(shuffled, decompressed);
+        CheckpointCodec::unshuffle(decompressed, 8, &unshuffled);
+        TS_ASSERT_EQUALS(source, unshuffled);
+
+        TS_ASSERT_THROWS(
+            CheckpointCodec::decompress(compressed, shuffled.size() + 1, &decompressed),
+            IOException&);
+        compressed.pop_back();
+        TS_ASSERT_THROWS(
+            CheckpointCodec::decompress(compressed, shuffled.size(), &decompressed),
+            IOException&);
+
+        std::vector<char> empty;
+        CheckpointCodec::compress(empty, &compressed);
+        TS_ASSERT(compressed.empty());
+    }
+
+    void testRestartWithDifferentDecomposition()
+    {
+        std::vector<WriterType> writers = makeWriters();
+        checkpoint(&writers, 10);
+
+        InitializerType initializer(prefix, 10, selectors);
+        TS_ASSERT_EQUALS(dim, initializer.gridDimensions());
+        TS_ASSERT_EQUALS(unsigned(10), initializer.startStep());
+        TS_ASSERT_EQUALS(unsigned(100), initializer.maxSteps());
+
+        GridType restored(dim);
+        initializer.grid(&restored);
+        TS_ASSERT_EQUALS(grid, restored);
+
+        // a subdomain spanning both of the former ranks:
+        CoordBox<2> box(Coord<2>(20, 10), Coord<2>(51, 33));
+        DisplacedGridType subdomain(box);
+        initializer.grid(&subdomain);
+
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TS_ASSERT_EQUALS(grid[*i], subdomain[*i]);
+        }
+    }
+
+    void testIncrementalCheckpoints()
+    {
+        std::vector<WriterType> writers = makeWriters();
+        checkpoint(&writers, 0);
+        std::size_t fullSize = writers[0].getBytesWritten() + writers[1].getBytesWritten();
+        TS_ASSERT_LESS_THAN(std::size_t(0), fullSize);
+        // the codec should achieve at least some compression:
+        TS_ASSERT_LESS_THAN(fullSize, dim.prod() * (sizeof(double) + sizeof(int)));
+
+        GridType original = grid;
+        Coord<2> changed(70, 45);
+        grid[changed].temperature = -1;
+        checkpoint(&writers, 10);
+        TS_ASSERT_EQUALS(std::size_t(0), writers[0].getBytesWritten());
+        TS_ASSERT_LESS_THAN(std::size_t(0), writers[1].getBytesWritten());
+        TS_ASSERT_LESS_THAN(writers[1].getBytesWritten() * 20, fullSize);
+
+        checkpoint(&writers, 20);
+        TS_ASSERT_EQUALS(std::size_t(0), writers[0].getBytesWritten());
+        TS_ASSERT_EQUALS(std::size_t(0), writers[1].getBytesWritten());
+
+        GridType restored(dim);
+        InitializerType(prefix, 0, selectors).grid(&restored);
+        TS_ASSERT_EQUALS(original, restored);
+
+        InitializerType(prefix, 20, selectors).grid(&restored);
+        TS_ASSERT_EQUALS(grid, restored);
+        TS_ASSERT_EQUALS(-1, restored[changed].temperature);
+    }
+
+    void testPartialRestart()
+    {
+        std::vector<WriterType> writers = makeWriters();
+        checkpoint(&writers, 30);
+
+        std::vector<Selector<CheckpointTestCell> > flagOnly;
+        flagOnly << Selector<CheckpointTestCell>(&CheckpointTestCell::flag, "flag");
+
+        GridType restored(dim, CheckpointTestCell(4711, 0));
+        InitializerType(prefix, 30, flagOnly).grid(&restored);
+
+        for (CoordBox<2>::Iterator i = grid.boundingBox().begin(); i != grid.boundingBox().end(); ++i) {
+            TS_ASSERT_EQUALS(4711, restored[*i].temperature);
+            TS_ASSERT_EQUALS(grid[*i].flag, restored[*i].flag);
+        }
+
+        std::vector<Selector<CheckpointTestCell> > unknown;
+        unknown << Selector<CheckpointTestCell>(&CheckpointTestCell::flag, "pressure");
+        TS_ASSERT_THROWS(InitializerType(prefix, 30, unknown), std::invalid_argument&);
+        TS_ASSERT_THROWS(InitializerType(prefix, 31, selectors), FileOpenException&);
+    }
+
+    void testIndexFilesMatchHeader()
+    {
+        std::vector<WriterType> writers = makeWriters();
+        checkpoint(&writers, 40);
+
+        // stale index of a former run with more ranks, referring to a
+        // data file which doesn't exist:
+        std::string staleFileName = CheckpointHelpers::fileName(prefix, 40, 2, "index");
+        {
+            std::ofstream stale(staleFileName.c_str());
+            std::ifstream index(CheckpointHelpers::fileName(prefix, 40, 1, "index").c_str());
+            std::string line;
+            // bounding box:
+            std::getline(index, line);
+            stale << line << "\n";
+
+            while (std::getline(index, line)) {
+                std::size_t begin = line.find(' ') + 1;
+                std::size_t end = line.find(' ', begin);
+                stale << line.replace(begin, end - begin, prefix + "missing") << "\n";
+            }
+        }
+
+        GridType restored(dim);
+        InitializerType initializer(prefix, 40, selectors);
+        initializer.grid(&restored);
+        TS_ASSERT_EQUALS(grid, restored);
+        remove(staleFileName.c_str());
+
+        remove(CheckpointHelpers::fileName(prefix, 40, 1, "index").c_str());
+        TS_ASSERT_THROWS(initializer.grid(&restored), FileOpenException&);
+
+        TS_ASSERT_THROWS(
+            writers[0].stepFinished(grid, regions[0], dim, 50, WRITER_STEP_FINISHED, 2, true),
+            std::invalid_argument&);
+    }
+
+    void testHashCollisionsDontReuseBlocks()
+    {
+        std::vector<WriterType> writers = makeWriters();
+        checkpoint(&writers, 60);
+
+        Coord<2> changed(70, 45);
+        grid[changed].temperature = -1;
+
+        // forge collisions: let the previous blocks carry the hashes
+        // of the modified blocks.
+        WriterType probe = writers[1];
+        steps << 61;
+        probe.stepFinished(grid, regions[1], dim, 61, WRITER_ALL_DONE, 1, true);
+        WriterType::BlockMap& blocks = writers[1].previousBlocks;
+        for (WriterType::BlockMap::iterator i = blocks.begin(); i != blocks.end(); ++i) {
+            for (std::size_t j = 0; j < i->second.size(); ++j) {
+                i->second[j].hash = probe.previousBlocks[i->first][j].hash;
+            }
+        }
+
+        checkpoint(&writers, 70);
+        TS_ASSERT_LESS_THAN(std::size_t(0), writers[1].getBytesWritten());
+
+        GridType restored(dim);
+        InitializerType(prefix, 70, selectors).grid(&restored);
+        TS_ASSERT_EQUALS(grid, restored);
+    }
+
+    void testSkipIndicesOfDisjointRanks()
+    {
+        std::vector<WriterType> writers = makeWriters();
+        checkpoint(&writers, 80);
+
+        // rank 0's domain doesn't intersect rank 1's, so a corrupted
+        // index of the latter mustn't matter:
+        std::string indexFileName = CheckpointHelpers::fileName(prefix, 80, 1, "index");
+        std::string box;
+        {
+            std::ifstream index(indexFileName.c_str());
+            std::getline(index, box);
+        }
+        {
+            std::ofstream index(indexFileName.c_str());
+            index << box << "\n" << "garbage\n";
+        }
+
+        DisplacedGridType restored(regions[0].boundingBox());
+        InitializerType initializer(prefix, 80, selectors);
+        initializer.grid(&restored);
+        for (CoordBox<2>::Iterator i = restored.boundingBox().begin(); i != restored.boundingBox().end(); ++i) {
+            TS_ASSERT_EQUALS(grid[*i], restored[*i]);
+        }
+
+        GridType all(dim);
+        TS_ASSERT_THROWS(initializer.grid(&all), FileReadException&);
+    }
+
+private:
+    std::string prefix;
+    Coord<2> dim;
+    GridType grid;
+    std::vector<Region<2> > regions;
+    std::vector<Selector<CheckpointTestCell> > selectors;
+    std::vector<unsigned> steps;
+
+    std::vector<WriterType> makeWriters()
+    {
+        std::vector<WriterType> ret;
+        for (std::size_t i = 0; i < regions.size(); ++i) {
+            ret << WriterType(prefix, 10, 100, selectors, Coord<2>(16, 16), regions.size());
+        }
+
+        return ret;
+    }
+
+    void checkpoint(std::vector<WriterType> *writers, unsigned step)
+    {
+        steps << step;
+
+        for (std::size_t rank = 0; rank < writers->size(); ++rank) {
+            (*writers)[rank].stepFinished(grid, regions[rank], dim, step, WRITER_STEP_FINISHED, rank, true);
+        }
+    }
+};
+
+}
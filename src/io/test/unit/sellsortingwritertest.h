@@ -0,0 +1,137 @@
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/io/sellsortingwriter.h>
+#include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/storage/unstructuredsoagrid.h>
+
+#include <libflatarray/macros.hpp>
+
+#include <cxxtest/TestSuite.h>
+#include <map>
+#include <vector>
+
+using namespace LibGeoDecomp;
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+namespace LibGeoDecomp {
+
+class SellSortingTestCell
+{
+public:
+    class API :
+        public APITraits::HasSoA,
+        public APITraits::HasUnstructuredTopology,
+        public APITraits::HasSellType<double>,
+        public APITraits::HasSellMatrices<1>,
+        public APITraits::HasSellC<4>,
+        public APITraits::HasSellSigma<8>
+    {
+    public:
+        LIBFLATARRAY_CUSTOM_SIZES((16)(32)(64)(128), (1), (1))
+    };
+
+    explicit SellSortingTestCell(double value = 0, int id = 0) :
+        value(value),
+        id(id)
+    {}
+
+    bool operator==(const SellSortingTestCell& other) const
+    {
+        return (value == other.value) && (id == other.id);
+    }
+
+    bool operator!=(const SellSortingTestCell& other) const
+    {
+        return !(*this == other);
+    }
+
+    double value;
+    int id;
+};
+
+/**
+ * Records the values it gets to see so we can check the order.
+ */
+class SellSortingMockWriter : public Clonable<Writer<SellSortingTestCell>, SellSortingMockWriter>
+{
+public:
+    SellSortingMockWriter() :
+        Clonable<Writer<SellSortingTestCell>, SellSortingMockWriter>("", 1)
+    {}
+
+    virtual void stepFinished(const GridType& grid, unsigned step, WriterEvent event)
+    {
+        values.clear();
+        CoordBox<1> box = grid.boundingBox();
+        for (CoordBox<1>::Iterator i = box.begin(); i != box.end(); ++i) {
+            values << grid.get(*i).value;
+        }
+        steps << step;
+    }
+
+    std::vector<double> values;
+    std::vector<unsigned> steps;
+};
+
+}
+
+LIBFLATARRAY_REGISTER_SOA(LibGeoDecomp::SellSortingTestCell, ((double)(value))((int)(id)))
+
+#endif
+
+namespace LibGeoDecomp {
+
+class SellSortingWriterTest : public CxxTest::TestSuite
+{
+public:
+    void testGatherLeavesGridUntouched()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        typedef UnstructuredSoAGrid<SellSortingTestCell, 1, double, 4, 8> GridType;
+        const int dim = 30;
+        CoordBox<1> box(Coord<1>(0), Coord<1>(dim));
+        GridType grid(box);
+
+        // rows get increasing lengths so that the sorting will
+        // reverse their order within each sigma window:
+        std::map<Coord<2>, double> matrix;
+        for (int row = 0; row < dim; ++row) {
+            for (int j = 0; j <= row; ++j) {
+                matrix[Coord<2>(row, (row + j) % dim)] = j;
+            }
+        }
+        grid.setWeights(0, matrix);
+
+        // just like in a simulation, the cells are stored in sorted order:
+        const std::vector<int>& realRowToSorted = grid.getWeights(0).realRowToSortedVec();
+        TS_ASSERT_DIFFERS(0, realRowToSorted[0]);
+        for (int row = 0; row < dim; ++row) {
+            grid.set(Coord<1>(realRowToSorted[row]), SellSortingTestCell(row * 1.5, row));
+        }
+        GridType reference = grid;
+
+        SellSortingMockWriter *mockWriter = new SellSortingMockWriter();
+        SellSortingWriter<SellSortingTestCell, SellSortingMockWriter> writer(
+            mockWriter, 0, "unused", &SellSortingTestCell::value, 2);
+
+        writer.stepFinished(grid, 3, WRITER_STEP_FINISHED);
+        TS_ASSERT_EQUALS(std::size_t(0), mockWriter->steps.size());
+
+        for (unsigned step = 4; step <= 6; step += 2) {
+            writer.stepFinished(grid, step, WRITER_STEP_FINISHED);
+            TS_ASSERT_EQUALS(step, mockWriter->steps.back());
+            TS_ASSERT_EQUALS(std::size_t(dim), mockWriter->values.size());
+
+            for (int row = 0; row < dim; ++row) {
+                TS_ASSERT_EQUALS(row * 1.5, mockWriter->values[row]);
+            }
+
+            for (int i = 0; i < dim; ++i) {
+                TS_ASSERT_EQUALS(reference.get(Coord<1>(i)), grid.get(Coord<1>(i)));
+            }
+        }
+#endif
+    }
+};
+
+}
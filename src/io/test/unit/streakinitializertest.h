@@ -0,0 +1,152 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/io/streakinitializer.h>
+#include <libgeodecomp/storage/displacedgrid.h>
+#include <libgeodecomp/storage/proxygrid.h>
+#include <libgeodecomp/storage/soagrid.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class StreakInitializerTestCell
+{
+public:
+    class API :
+        public APITraits::HasSoA,
+        public APITraits::HasCubeTopology<3>
+    {};
+
+    explicit StreakInitializerTestCell(int v = -1) :
+        v(v)
+    {}
+
+    int v;
+};
+
+}
+
+LIBFLATARRAY_REGISTER_SOA(LibGeoDecomp::StreakInitializerTestCell, ((int)(v)))
+
+namespace LibGeoDecomp {
+
+class IndexStreakInitializer : public StreakInitializer<StreakInitializerTestCell, IndexStreakInitializer>
+{
+public:
+    IndexStreakInitializer() :
+        StreakInitializer<StreakInitializerTestCell, IndexStreakInitializer>(Coord<3>(70, 40, 30)),
+        aosStreaks(0),
+        soaStreaks(0)
+    {}
+
+    void initStreak(const Streak<3>& streak, StreakInitializerTestCell *cells) const
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp atomic
+#endif
+        ++aosStreaks;
+
+        Coord<3> c = streak.origin;
+        for (; c.x() < streak.endX; ++c.x()) {
+            *cells++ = StreakInitializerTestCell(c.toIndex(gridDimensions()));
+        }
+    }
+
+    template<typename ACCESSOR>
+    void initStreak(const Streak<3>& streak, ACCESSOR accessor) const
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp atomic
+#endif
+        ++soaStreaks;
+
+        Coord<3> c = streak.origin;
+        for (; c.x() < streak.endX; ++c.x()) {
+            accessor.v() = c.toIndex(gridDimensions());
+            ++accessor.index();
+        }
+    }
+
+    mutable int aosStreaks;
+    mutable int soaStreaks;
+};
+
+class StreakInitializerTest : public CxxTest::TestSuite
+{
+public:
+    void testAoS()
+    {
+        IndexStreakInitializer init;
+        CoordBox<3> box(Coord<3>(10, 5, 2), Coord<3>(50, 30, 20));
+        DisplacedGrid<StreakInitializerTestCell, Topologies::Cube<3>::Topology> grid(box);
+        init.grid(&grid);
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TS_ASSERT_EQUALS(int(i->toIndex(init.gridDimensions())), grid.get(*i).v);
+        }
+        TS_ASSERT_EQUALS(30 * 20, init.aosStreaks);
+        TS_ASSERT_EQUALS(0, init.soaStreaks);
+    }
+
+    void testPlainGrid()
+    {
+        IndexStreakInitializer init;
+        Grid<StreakInitializerTestCell, Topologies::Cube<3>::Topology> grid(init.gridDimensions());
+        init.grid(&grid);
+
+        CoordBox<3> box = grid.boundingBox();
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TS_ASSERT_EQUALS(int(i->toIndex(init.gridDimensions())), grid.get(*i).v);
+        }
+        TS_ASSERT_EQUALS(40 * 30, init.aosStreaks);
+    }
+
+    void testSoA()
+    {
+        IndexStreakInitializer init;
+        CoordBox<3> box(Coord<3>(10, 5, 2), Coord<3>(50, 30, 20));
+        SoAGrid<StreakInitializerTestCell, Topologies::Cube<3>::Topology> grid(box);
+        init.grid(&grid);
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TS_ASSERT_EQUALS(int(i->toIndex(init.gridDimensions())), grid.get(*i).v);
+        }
+        TS_ASSERT_EQUALS(0, init.aosStreaks);
+        TS_ASSERT_EQUALS(30 * 20, init.soaStreaks);
+    }
+
+    void testOtherGrids()
+    {
+        IndexStreakInitializer init;
+        CoordBox<3> box(Coord<3>(), init.gridDimensions());
+        CoordBox<3> viewBox(Coord<3>(10, 5, 2), Coord<3>(50, 30, 20));
+        SoAGrid<StreakInitializerTestCell, Topologies::Cube<3>::Topology> grid(box);
+        ProxyGrid<StreakInitializerTestCell, 3> proxy(&grid, viewBox);
+        init.grid(&proxy);
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            int expected = viewBox.inBounds(*i) ? int(i->toIndex(init.gridDimensions())) : -1;
+            TS_ASSERT_EQUALS(expected, grid.get(*i).v);
+        }
+        TS_ASSERT_EQUALS(30 * 20, init.aosStreaks);
+        TS_ASSERT_EQUALS(0, init.soaStreaks);
+    }
+
+    void testRegion()
+    {
+        IndexStreakInitializer init;
+        CoordBox<3> box(Coord<3>(), init.gridDimensions());
+        SoAGrid<StreakInitializerTestCell, Topologies::Cube<3>::Topology> grid(box);
+
+        Region<3> region;
+        region << CoordBox<3>(Coord<3>(5, 5, 5), Coord<3>(20, 10, 10))
+               << Streak<3>(Coord<3>(30, 20, 25), 69);
+        init.grid(&grid, region);
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            int expected = region.count(*i) ? int(i->toIndex(init.gridDimensions())) : -1;
+            TS_ASSERT_EQUALS(expected, grid.get(*i).v);
+        }
+    }
+};
+
+}
@@ -15,6 +15,9 @@
 
 #ifdef LIBGEODECOMP_WITH_MPI
 #include <mpi.h>
+#include <libgeodecomp/io/checkpointinitializer.h>
+#include <libgeodecomp/io/checkpointwriter.h>
+#include <libgeodecomp/io/chrometracewriter.h>
 #include <libgeodecomp/io/collectingwriter.h>
 #include <libgeodecomp/io/parallelwriter.h>
 #include <libgeodecomp/parallelization/hiparsimulator.h>
@@ -25,20 +28,25 @@
 #endif
 
 #ifdef LIBGEODECOMP_WITH_THREADS
+#include <libgeodecomp/io/asyncparallelwriter.h>
+#include <libgeodecomp/io/asyncwriter.h>
 #include <libgeodecomp/parallelization/openmpsimulator.h>
 #endif
 
+#include <libgeodecomp/communication/binaryserialization.h>
 #include <libgeodecomp/communication/boostserialization.h>
 #include <libgeodecomp/communication/hpxserialization.h>
 #include <libgeodecomp/geometry/floatcoord.h>
 #include <libgeodecomp/geometry/stencils.h>
 #include <libgeodecomp/geometry/voronoimesher.h>
+#include <libgeodecomp/io/globalreduction.h>
 #include <libgeodecomp/io/ppmwriter.h>
 #include <libgeodecomp/io/remotesteerer.h>
 #include <libgeodecomp/io/serialbovwriter.h>
 #include <libgeodecomp/io/silowriter.h>
 #include <libgeodecomp/io/simplecellplotter.h>
 #include <libgeodecomp/io/simpleinitializer.h>
+#include <libgeodecomp/io/streakinitializer.h>
 #include <libgeodecomp/io/tracingwriter.h>
 #include <libgeodecomp/loadbalancer/noopbalancer.h>
 #include <libgeodecomp/loadbalancer/oozebalancer.h>
@@ -46,15 +54,19 @@
 #include <libgeodecomp/misc/apitraits.h>
 #include <libgeodecomp/misc/color.h>
 #include <libgeodecomp/misc/random.h>
+#include <libgeodecomp/misc/threadaffinity.h>
+#include <libgeodecomp/misc/timelinetracer.h>
 #include <libgeodecomp/parallelization/serialsimulator.h>
 #include <libgeodecomp/parallelization/stripingsimulator.h>
 #include <libgeodecomp/storage/boxcell.h>
 #include <libgeodecomp/storage/containercell.h>
+#include <libgeodecomp/storage/firsttouch.h>
 #include <libgeodecomp/storage/fixedarray.h>
 #include <libgeodecomp/storage/memberfilter.h>
 #include <libgeodecomp/storage/multicontainercell.h>
 #include <libgeodecomp/storage/simplearrayfilter.h>
 #include <libgeodecomp/storage/simplefilter.h>
+#include <libgeodecomp/storage/verletboxcell.h>
 #include <libgeodecomp/storage/passthroughcontainer.h>
 
 #endif
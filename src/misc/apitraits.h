@@ -217,6 +217,14 @@ public:
      * This qualifier should be used to flag models which sport a static
      * updateLineX() function, which is expected to update a streak of
      * cells along the X axis.
+     *
+     * Beware: for unstructured SoA grids hoodNew points to the first
+     * cell of the line, i.e. cell hoodOld.index() * C, when
+     * updateLineX() is called. Cells need to address the new grid
+     * relative to it (e.g. "hoodNew << cell; ++hoodNew;"). In
+     * LibGeoDecomp 0.4.0 and earlier hoodNew pointed to the grid's
+     * first cell, so models which compute absolute offsets (like
+     * "&hoodNew->sum() + hoodOld.index() * C") need to be updated.
      */
     class HasUpdateLineX
     {
@@ -684,6 +692,44 @@ public:
 
     // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
 
+    /**
+     * Decide whether a model can be (de-)serialized with
+     * BinaryOArchive/BinaryIArchive. Requires C++14 support.
+     */
+    template<typename CELL, typename HAS_BINARY_SERIALIZATION = void>
+    class SelectBinarySerialization
+    {
+    public:
+        typedef FalseType Value;
+    };
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+    template<typename CELL>
+    class SelectBinarySerialization<CELL, typename CELL::API::SupportsBinarySerialization>
+    {
+    public:
+        typedef TrueType Value;
+    };
+#endif
+
+    /**
+     * Like HasBoostSerialization, this flags models whose cells vary
+     * in size, but selects LibGeoDecomp's own BinaryOArchive for
+     * ghost zone exchange. It's much faster than Boost.Serialization
+     * as it has no stream layer and copies trivially copyable members
+     * in bulk, but it can't handle pointers. Cells need a member
+     * function template<class ARCHIVE> void serialize(ARCHIVE&,
+     * unsigned), which may be shared with Boost.Serialization. If
+     * both flags are present, this one takes precedence.
+     */
+    class HasBinarySerialization
+    {
+    public:
+        typedef void SupportsBinarySerialization;
+    };
+
+    // XXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXXX
+
     template<typename CELL, typename HAS_SPEED = void>
     class SelectStaticData
     {
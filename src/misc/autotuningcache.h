@@ -0,0 +1,216 @@
+#ifndef LIBGEODECOMP_MISC_AUTOTUNINGCACHE_H
+#define LIBGEODECOMP_MISC_AUTOTUNINGCACHE_H
+
+#include <libgeodecomp/config.h>
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+#include <libgeodecomp/io/logger.h>
+#include <libgeodecomp/misc/simulationparameters.h>
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#include <omp.h>
+#endif
+
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Persists the results of AutoTuningSimulator in a plain text file
+ * so that subsequent runs on the same machine can skip the tuning
+ * phase. Results are keyed by everything that is likely to change
+ * the optimum: the cell type, grid dimensions, number of OpenMP
+ * threads and the CPU model.
+ *
+ * Each line of the file holds one entry:
+ *
+ *   KEY SIMULATION_TYPE NUM_PARAMS NAME_1 VALUE_1 ... NAME_N VALUE_N
+ *
+ * The values are the parameters' raw values as returned by
+ * OptimizableParameter::getValue().
+ */
+class AutoTuningCache
+{
+public:
+    explicit AutoTuningCache(const std::string& fileName) :
+        fileName(fileName)
+    {}
+
+    template<typename COORD>
+    static std::string key(
+        const std::string& cellType,
+        const COORD& gridDimensions,
+        unsigned numThreads = defaultNumThreads(),
+        const std::string& cpuModel = hostCPUModel())
+    {
+        std::stringstream buf;
+        buf << cellType << "/";
+        for (int d = 0; d < COORD::DIM; ++d) {
+            buf << (d ? "x" : "") << gridDimensions[d];
+        }
+        buf << "/" << numThreads << "/" << sanitize(cpuModel);
+
+        return sanitize(buf.str());
+    }
+
+    /**
+     * The number of threads the simulators will actually use, which
+     * is subject to OMP_NUM_THREADS, not the number of cores.
+     */
+    static unsigned defaultNumThreads()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        return omp_get_max_threads();
+#else
+        return 1;
+#endif
+    }
+
+    /**
+     * Reads the CPU model from /proc/cpuinfo. Yields "unknown" on
+     * platforms where that file isn't available.
+     */
+    static std::string hostCPUModel()
+    {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.compare(0, 10, "model name") == 0) {
+                std::size_t pos = line.find(':');
+                if (pos != std::string::npos) {
+                    return sanitize(line.substr(pos + 1));
+                }
+            }
+        }
+
+        return "unknown";
+    }
+
+    /**
+     * Looks up the entry for key. If successful, simulationType and
+     * the matching parameters are updated. Entries whose parameter
+     * names don't match params (e.g. because the SimulationFactory
+     * has changed) are ignored.
+     */
+    bool lookup(
+        const std::string& key,
+        std::string *simulationType,
+        std::map<std::string, SimulationParameters> *params) const
+    {
+        EntryMap entries = readEntries();
+        EntryMap::iterator entry = entries.find(key);
+        if (entry == entries.end()) {
+            return false;
+        }
+
+        std::stringstream buf(entry->second);
+        std::string type;
+        std::size_t numParams = 0;
+        buf >> type >> numParams;
+        std::map<std::string, SimulationParameters>::iterator i = params->find(type);
+        if (!buf || (i == params->end()) || (numParams != i->second.size())) {
+            return false;
+        }
+
+        SimulationParameters restored = i->second;
+        std::vector<std::string> names = restored.parameterNames();
+        for (std::size_t p = 0; p < numParams; ++p) {
+            std::string name;
+            double value;
+            buf >> name >> value;
+            if (!buf || (name != names[p])) {
+                return false;
+            }
+            restored[p].setValue(value);
+        }
+
+        *simulationType = type;
+        i->second = restored;
+        return true;
+    }
+
+    /**
+     * Adds an entry for key, replacing any previous one.
+     */
+    void store(
+        const std::string& key,
+        const std::string& simulationType,
+        const SimulationParameters& params) const
+    {
+        EntryMap entries = readEntries();
+
+        std::stringstream buf;
+        buf << std::setprecision(17) << simulationType << " " << params.size();
+        std::vector<std::string> names = params.parameterNames();
+        for (std::size_t p = 0; p < params.size(); ++p) {
+            buf << " " << names[p] << " " << params[p].getValue();
+        }
+        entries[key] = buf.str();
+
+        std::ofstream file(fileName.c_str());
+        for (EntryMap::iterator i = entries.begin(); i != entries.end(); ++i) {
+            file << i->first << " " << i->second << "\n";
+        }
+
+        if (!file.good()) {
+            LOG(Logger::WARN, "could not write auto-tuning cache " << fileName);
+        }
+    }
+
+private:
+    typedef std::map<std::string, std::string> EntryMap;
+
+    std::string fileName;
+
+    EntryMap readEntries() const
+    {
+        EntryMap ret;
+        std::ifstream file(fileName.c_str());
+        std::string line;
+
+        while (std::getline(file, line)) {
+            std::size_t pos = line.find(' ');
+            if (pos != std::string::npos) {
+                ret[line.substr(0, pos)] = line.substr(pos + 1);
+            }
+        }
+
+        return ret;
+    }
+
+    /**
+     * Keys must not contain whitespace as that is our delimiter.
+     */
+    static std::string sanitize(const std::string& input)
+    {
+        std::string ret;
+        for (std::string::const_iterator i = input.begin(); i != input.end(); ++i) {
+            if (std::isspace(static_cast<unsigned char>(*i))) {
+                if (!ret.empty() && (ret[ret.size() - 1] != '_')) {
+                    ret += '_';
+                }
+            } else {
+                ret += *i;
+            }
+        }
+
+        if (!ret.empty() && (ret[ret.size() - 1] == '_')) {
+            ret.erase(ret.size() - 1);
+        }
+
+        return ret;
+    }
+};
+
+}
+
+#endif
+
+#endif
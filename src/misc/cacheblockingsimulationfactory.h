@@ -18,6 +18,7 @@ public:
     using SimulationFactory<CELL>::addSteerers;
     using SimulationFactory<CELL>::addWriters;
     typedef typename SimulationFactory<CELL>::InitPtr InitPtr;
+    static const int DIM = CacheBlockingSimulator<CELL>::DIM;
 
     explicit
     CacheBlockingSimulationFactory<CELL>(InitPtr initializer):
@@ -42,7 +43,12 @@ protected:
         int wavefrontWidth  = params["WavefrontWidth"];
         int wavefrontHeight = params["WavefrontHeight"];
 
-        Coord<2> wavefrontDim(wavefrontWidth, wavefrontHeight);
+        Coord<DIM - 1> wavefrontDim;
+        wavefrontDim[0] = wavefrontWidth;
+        if (DIM > 2) {
+            wavefrontDim[DIM - 2] = wavefrontHeight;
+        }
+
         CacheBlockingSimulator<CELL> *sim =
             new CacheBlockingSimulator<CELL>(
                 initializer->clone(),
@@ -2,6 +2,7 @@
 #define LIBGEODECOMP_MISC_CHRONOMETER_H
 
 #include <libgeodecomp/misc/scopedtimer.h>
+#include <libgeodecomp/misc/timelinetracer.h>
 #include <libgeodecomp/storage/fixedarray.h>
 
 #include <iomanip>
@@ -126,7 +127,9 @@ public:
                                                                     \
         ~CLASS_NAME()                                               \
         {                                                           \
+            double begin = t;                                       \
             t = elapsed();                                          \
+            TimelineTracer::record(EVENT_NAME, begin, begin + t);   \
         }                                                           \
     };
 }
@@ -205,6 +208,8 @@ public:
  * This class can be used to measure execution time of different parts
  * of our code. This is useful to determine the relative load of a
  * node or to find out which part of the algorithm the most time.
+ * While TimelineTracer is enabled, each event is also logged with its
+ * start and end time.
  */
 class Chronometer
 {
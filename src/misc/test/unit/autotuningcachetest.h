@@ -0,0 +1,126 @@
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/geometry/coord.h>
+#include <libgeodecomp/misc/autotuningcache.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/misc/tempfile.h>
+
+#include <cstdio>
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class AutoTuningCacheTest : public CxxTest::TestSuite
+{
+public:
+    void setUp()
+    {
+        fileName = TempFile::serial("autotuningcachetest");
+    }
+
+    void tearDown()
+    {
+        remove(fileName.c_str());
+    }
+
+    void testKey()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        TS_ASSERT_EQUALS(
+            "Cell/100x200x30/8/Some_CPU_@_2.00GHz",
+            AutoTuningCache::key("Cell", Coord<3>(100, 200, 30), 8, " Some  CPU @ 2.00GHz\t"));
+
+        std::string key = AutoTuningCache::key("Cell", Coord<2>(10, 20));
+        TS_ASSERT_EQUALS(std::string::npos, key.find(' '));
+        TS_ASSERT_EQUALS(0, key.find("Cell/10x20/"));
+#endif
+    }
+
+    void testKeyFollowsOpenMPThreads()
+    {
+#if defined(LIBGEODECOMP_WITH_CPP14) && defined(LIBGEODECOMP_WITH_THREADS)
+        int oldNumThreads = omp_get_max_threads();
+
+        omp_set_num_threads(3);
+        std::string key3 = AutoTuningCache::key("Cell", Coord<2>(10, 20));
+        omp_set_num_threads(5);
+        std::string key5 = AutoTuningCache::key("Cell", Coord<2>(10, 20));
+        omp_set_num_threads(oldNumThreads);
+
+        TS_ASSERT_EQUALS(0, key3.find("Cell/10x20/3/"));
+        TS_ASSERT_EQUALS(0, key5.find("Cell/10x20/5/"));
+#endif
+    }
+
+    void testStoreAndLookup()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        std::map<std::string, SimulationParameters> params = defaultParams();
+        std::string simulationType;
+        AutoTuningCache cache(fileName);
+        TS_ASSERT(!cache.lookup("keyA", &simulationType, &params));
+
+        SimulationParameters tuned = params["CacheBlockingSimulation"];
+        tuned["WavefrontWidth"].setValue(123);
+        tuned["Variant"].setValue(2);
+        cache.store("keyA", "CacheBlockingSimulation", tuned);
+        cache.store("keyB", "SerialSimulation", params["SerialSimulation"]);
+
+        TS_ASSERT(cache.lookup("keyA", &simulationType, &params));
+        TS_ASSERT_EQUALS("CacheBlockingSimulation", simulationType);
+        TS_ASSERT(params["CacheBlockingSimulation"]["WavefrontWidth"] == 133);
+        TS_ASSERT(params["CacheBlockingSimulation"]["Variant"] == 4);
+
+        TS_ASSERT(cache.lookup("keyB", &simulationType, &params));
+        TS_ASSERT_EQUALS("SerialSimulation", simulationType);
+
+        // later results replace earlier ones:
+        cache.store("keyA", "SerialSimulation", params["SerialSimulation"]);
+        TS_ASSERT(cache.lookup("keyA", &simulationType, &params));
+        TS_ASSERT_EQUALS("SerialSimulation", simulationType);
+        TS_ASSERT(!cache.lookup("keyC", &simulationType, &params));
+#endif
+    }
+
+    void testMismatchingParametersAreIgnored()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        std::map<std::string, SimulationParameters> params = defaultParams();
+        AutoTuningCache cache(fileName);
+        cache.store("key", "CacheBlockingSimulation", params["CacheBlockingSimulation"]);
+
+        std::string simulationType = "untouched";
+        std::map<std::string, SimulationParameters> changedParams;
+        changedParams["CacheBlockingSimulation"].addParameter("PipelineLength", 1, 30);
+        changedParams["CacheBlockingSimulation"].addParameter("WavefrontWidth", 10, 1000);
+        TS_ASSERT(!cache.lookup("key", &simulationType, &changedParams));
+
+        changedParams.clear();
+        changedParams["SerialSimulation"] = SimulationParameters();
+        TS_ASSERT(!cache.lookup("key", &simulationType, &changedParams));
+        TS_ASSERT_EQUALS("untouched", simulationType);
+#endif
+    }
+
+private:
+    std::string fileName;
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+    std::map<std::string, SimulationParameters> defaultParams()
+    {
+        std::vector<int> variants;
+        variants << 1
+                 << 2
+                 << 4;
+
+        std::map<std::string, SimulationParameters> ret;
+        ret["SerialSimulation"] = SimulationParameters();
+        ret["CacheBlockingSimulation"].addParameter("WavefrontWidth", 10, 1000);
+        ret["CacheBlockingSimulation"].addParameter("Variant", variants);
+        return ret;
+    }
+#endif
+};
+
+}
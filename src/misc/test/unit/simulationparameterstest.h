@@ -191,6 +191,40 @@ public:
         TS_ASSERT_EQUALS("DiscreteSet([a, b, c], 2)", params["foo"].toString());
     }
 
+    void testDiscreteSetSetValue()
+    {
+        std::vector<int> values;
+        values << 3
+               << 5
+               << 7;
+        SimulationParameters params;
+        params.addParameter("x", values);
+
+        params[0].setValue(2);
+        TS_ASSERT_EQUALS(2, params[0].getValue());
+        TS_ASSERT(params["x"] == 7);
+
+        params[0].setValue(47);
+        TS_ASSERT_EQUALS(2, params[0].getValue());
+
+        params[0].setValue(-1);
+        TS_ASSERT(params["x"] == 3);
+    }
+
+    void testParameterNames()
+    {
+        SimulationParameters params;
+        params.addParameter("foo", 1, 5);
+        params.addParameter("bar", 2, 4);
+        params.addParameter("baz", 3, 6);
+
+        std::vector<std::string> expected;
+        expected << "foo"
+                 << "bar"
+                 << "baz";
+        TS_ASSERT_EQUALS(expected, params.parameterNames());
+    }
+
     void testToString()
     {
         std::stringstream buf;
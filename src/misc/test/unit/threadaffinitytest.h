@@ -0,0 +1,57 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/misc/threadaffinity.h>
+
+#include <thread>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class ThreadAffinityTest : public CxxTest::TestSuite
+{
+public:
+    class Pinner
+    {
+    public:
+        Pinner(int cpu, int *actualCPU) :
+            cpu(cpu),
+            actualCPU(actualCPU)
+        {}
+
+        void operator()()
+        {
+            ThreadAffinity::pinCurrentThread(cpu);
+#ifdef __linux__
+            *actualCPU = sched_getcpu();
+#else
+            *actualCPU = cpu;
+#endif
+        }
+
+    private:
+        int cpu;
+        int *actualCPU;
+    };
+
+    void testPinCurrentThread()
+    {
+        const std::vector<int>& cpus = ThreadAffinity::availableCPUs();
+#ifdef __linux__
+        TS_ASSERT(!cpus.empty());
+#endif
+        if (cpus.empty()) {
+            return;
+        }
+
+        // pin a separate thread so the test runner stays unaffected:
+        int actualCPU = -1;
+        std::thread thread((Pinner(cpus.back(), &actualCPU)));
+        thread.join();
+        TS_ASSERT_EQUALS(cpus.back(), actualCPU);
+
+        // the set of available CPUs must not shrink due to pinning:
+        TS_ASSERT_EQUALS(cpus.size(), ThreadAffinity::availableCPUs().size());
+    }
+};
+
+}
@@ -0,0 +1,102 @@
+#include <libgeodecomp/misc/chronometer.h>
+#include <libgeodecomp/misc/timelinetracer.h>
+
+#include <cxxtest/TestSuite.h>
+#include <sstream>
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+#include <thread>
+#endif
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class TimelineTracerTest : public CxxTest::TestSuite
+{
+public:
+    void tearDown()
+    {
+        TimelineTracer::disable();
+    }
+
+    void testDisabledByDefault()
+    {
+        TS_ASSERT(!TimelineTracer::isEnabled());
+        {
+            TimelineTracer::ScopedSpan span("foo");
+        }
+
+        TS_ASSERT_EQUALS(std::string::npos, TimelineTracer::chromeTraceEvents().find("foo"));
+    }
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+    void testScopedSpansAndChronometerEvents()
+    {
+        TimelineTracer::enable();
+        Chronometer chrono;
+
+        {
+            TimelineTracer::ScopedSpan span("my \"span\"");
+            TimeComputeInner t(&chrono);
+            ScopedTimer::busyWait(1000);
+        }
+
+        std::string events = TimelineTracer::chromeTraceEvents(3);
+        TS_ASSERT_DIFFERS(std::string::npos, events.find("\"name\":\"my \\\"span\\\"\",\"ph\":\"X\",\"pid\":3,\"tid\":0"));
+        TS_ASSERT_DIFFERS(std::string::npos, events.find("\"name\":\"compute_time_inner\",\"ph\":\"X\",\"pid\":3,\"tid\":0"));
+        TS_ASSERT_DIFFERS(std::string::npos, events.find("\"name\":\"process_name\",\"ph\":\"M\",\"pid\":3"));
+        // only the innermost event is traced, not its parents:
+        TS_ASSERT_EQUALS(std::string::npos, events.find("\"compute_time\""));
+        TS_ASSERT_LESS_THAN(0, chrono.interval<TimeCompute>());
+
+        std::stringstream trace;
+        TimelineTracer::writeChromeTrace(trace, 3);
+        TS_ASSERT_EQUALS("[\n" + events + "]\n", trace.str());
+    }
+
+    void testRingBufferDropsOldestSpans()
+    {
+        const char *names[] = { "s0", "s1", "s2", "s3", "s4", "s5", "s6", "s7", "s8", "s9" };
+
+        TimelineTracer::enable(4);
+        for (int i = 0; i < 10; ++i) {
+            TimelineTracer::record(names[i], i, i + 0.5);
+        }
+
+        std::string events = TimelineTracer::chromeTraceEvents();
+        for (int i = 0; i < 6; ++i) {
+            TS_ASSERT_EQUALS(std::string::npos, events.find(std::string("\"") + names[i] + "\""));
+        }
+        std::size_t last = 0;
+        for (int i = 6; i < 10; ++i) {
+            std::size_t pos = events.find(std::string("\"") + names[i] + "\"");
+            TS_ASSERT_DIFFERS(std::string::npos, pos);
+            TS_ASSERT_LESS_THAN(last, pos);
+            last = pos;
+        }
+        TS_ASSERT_DIFFERS(std::string::npos, events.find("\"ts\":9000000.000,\"dur\":500000.000"));
+
+        // enabling again discards all previous events:
+        TimelineTracer::enable(4);
+        TS_ASSERT_EQUALS(std::string::npos, TimelineTracer::chromeTraceEvents().find("\"s9\""));
+    }
+
+    void testThreadsGetSeparateTimelines()
+    {
+        TimelineTracer::enable();
+        TimelineTracer::record("main", 1, 2);
+
+        std::thread thread([]() {
+                TimelineTracer::record("worker", 1, 2);
+            });
+        thread.join();
+
+        std::string events = TimelineTracer::chromeTraceEvents();
+        TS_ASSERT_DIFFERS(std::string::npos, events.find("\"name\":\"main\",\"ph\":\"X\",\"pid\":0,\"tid\":0"));
+        TS_ASSERT_DIFFERS(std::string::npos, events.find("\"name\":\"worker\",\"ph\":\"X\",\"pid\":0,\"tid\":1"));
+    }
+#endif
+};
+
+}
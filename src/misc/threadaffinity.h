@@ -0,0 +1,116 @@
+#ifndef LIBGEODECOMP_MISC_THREADAFFINITY_H
+#define LIBGEODECOMP_MISC_THREADAFFINITY_H
+
+#include <libgeodecomp/config.h>
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#include <omp.h>
+#endif
+
+#include <stdexcept>
+#include <vector>
+
+namespace LibGeoDecomp {
+
+/**
+ * Helpers for pinning threads to CPUs. Without pinning the OS may
+ * migrate threads between sockets, which defeats NUMA-aware memory
+ * placement (see FirstTouch). Only implemented for Linux, on other
+ * platforms pinning is a NOP.
+ */
+class ThreadAffinity
+{
+public:
+    /**
+     * The CPUs the calling process may run on. The set is captured
+     * on the first call, so that pinning threads doesn't shrink it.
+     * With MPI it's typically the set which the launcher bound the
+     * current rank to.
+     */
+    static const std::vector<int>& availableCPUs()
+    {
+        static std::vector<int> cpus = queryCPUs();
+        return cpus;
+    }
+
+    /**
+     * Restricts the calling thread to the given CPU.
+     */
+    static void pinCurrentThread(int cpu)
+    {
+        if (!tryPin(cpu)) {
+            throw std::runtime_error("could not pin thread to CPU");
+        }
+    }
+
+    /**
+     * Pins the i-th thread of OpenMP's thread team to the i-th
+     * available CPU (round robin if there are more threads than
+     * CPUs). As long as later parallel regions use the same number
+     * of threads, OpenMP will reuse the pinned threads.
+     */
+    static void pinOpenMPThreads()
+    {
+        const std::vector<int>& cpus = availableCPUs();
+        if (cpus.empty()) {
+            return;
+        }
+
+        // exceptions must not escape OpenMP regions, hence the detour:
+        int failures = 0;
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel reduction(+:failures)
+        {
+            failures += !tryPin(cpus[omp_get_thread_num() % cpus.size()]);
+        }
+#else
+        failures += !tryPin(cpus[0]);
+#endif
+
+        if (failures > 0) {
+            throw std::runtime_error("could not pin OpenMP threads to CPUs");
+        }
+    }
+
+private:
+    static bool tryPin(int cpu)
+    {
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+        return true;
+#endif
+    }
+
+    static std::vector<int> queryCPUs()
+    {
+        std::vector<int> ret;
+
+#ifdef __linux__
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        if (sched_getaffinity(0, sizeof(set), &set) != 0) {
+            throw std::runtime_error("could not retrieve CPU affinity");
+        }
+
+        for (int i = 0; i < CPU_SETSIZE; ++i) {
+            if (CPU_ISSET(i, &set)) {
+                ret.push_back(i);
+            }
+        }
+#endif
+
+        return ret;
+    }
+};
+
+}
+
+#endif
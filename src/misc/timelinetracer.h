@@ -0,0 +1,288 @@
+#ifndef LIBGEODECOMP_MISC_TIMELINETRACER_H
+#define LIBGEODECOMP_MISC_TIMELINETRACER_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/misc/scopedtimer.h>
+
+#include <algorithm>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+#include <atomic>
+#include <memory>
+#include <mutex>
+#endif
+
+namespace LibGeoDecomp {
+
+/**
+ * TimelineTracer records timestamped spans (e.g. updating the inner
+ * set, waiting for a ghost zone or calling a Writer) per thread.
+ * Unlike Chronometer, which only accumulates totals per event class,
+ * the resulting timeline shows when something happened and how
+ * activities on different threads and ranks overlap. All Chronometer
+ * events are recorded automatically while tracing is enabled.
+ *
+ * The timeline can be exported in Chrome's trace event format, which
+ * is understood by chrome://tracing and Perfetto (see
+ * ChromeTraceWriter for gathering the traces of all ranks).
+ *
+ * Tracing is disabled by default and costs a single branch per
+ * event in that case. Each thread logs to its own ring buffer, so
+ * recording doesn't need any locks. Once a buffer is full, the
+ * oldest spans get overwritten. Export and enable() are only safe
+ * while no other thread is recording, e.g. at the end of a run.
+ *
+ * Span names need to be string literals (or otherwise outlive the
+ * tracer) as only the pointers are being stored.
+ */
+class TimelineTracer
+{
+public:
+    friend class TimelineTracerTest;
+
+    class Span
+    {
+    public:
+        inline Span(
+            const char *name = 0,
+            double begin = 0,
+            double end = 0) :
+            name(name),
+            begin(begin),
+            end(end)
+        {}
+
+        const char *name;
+        double begin;
+        double end;
+    };
+
+    /**
+     * Records the time between its creation and destruction, but only
+     * if tracing was enabled upon creation.
+     */
+    class ScopedSpan
+    {
+    public:
+        inline explicit ScopedSpan(const char *name) :
+            name(name),
+            begin(isEnabled() ? ScopedTimer::time() : -1)
+        {}
+
+        inline ~ScopedSpan()
+        {
+            if (begin >= 0) {
+                record(name, begin, ScopedTimer::time());
+            }
+        }
+
+    private:
+        const char *name;
+        double begin;
+    };
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+    /**
+     * Discards all spans recorded so far and starts recording with a
+     * capacity of capacityPerThread spans in each thread's buffer.
+     */
+    static void enable(std::size_t capacityPerThread = 65536)
+    {
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+        reg.logs.clear();
+        reg.capacity = (std::max)(capacityPerThread, std::size_t(1));
+        ++reg.generation;
+        reg.enabled = true;
+    }
+
+    static void disable()
+    {
+        registry().enabled = false;
+    }
+
+    static inline bool isEnabled()
+    {
+        return registry().enabled.load(std::memory_order_relaxed);
+    }
+
+    static inline void record(const char *name, double begin, double end)
+    {
+        if (!isEnabled()) {
+            return;
+        }
+
+        threadLog()->record(Span(name, begin, end));
+    }
+
+#else
+
+    static void enable(std::size_t /* capacityPerThread */ = 65536)
+    {}
+
+    static void disable()
+    {}
+
+    static inline bool isEnabled()
+    {
+        return false;
+    }
+
+    static inline void record(const char * /* name */, double /* begin */, double /* end */)
+    {}
+
+#endif
+
+    /**
+     * Writes the recorded spans as a complete Chrome trace (a JSON
+     * array of events) to the given stream. pid should be the rank
+     * of the calling process.
+     */
+    static void writeChromeTrace(std::ostream& stream, int pid = 0)
+    {
+        stream << "[\n" << chromeTraceEvents(pid) << "]\n";
+    }
+
+    /**
+     * Returns the recorded spans as Chrome trace events, one per
+     * line, each followed by a comma. This allows the traces of
+     * multiple processes to be simply concatenated.
+     */
+    static std::string chromeTraceEvents(int pid = 0)
+    {
+        std::ostringstream buf;
+        buf << std::fixed << std::setprecision(3);
+        buf << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << pid
+            << ",\"args\":{\"name\":\"rank " << pid << "\"}},\n";
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+        Registry& reg = registry();
+        std::lock_guard<std::mutex> lock(reg.mutex);
+
+        for (std::size_t i = 0; i < reg.logs.size(); ++i) {
+            std::vector<Span> spans = reg.logs[i]->spans();
+            for (std::vector<Span>::iterator span = spans.begin(); span != spans.end(); ++span) {
+                buf << "{\"name\":\"";
+                escape(span->name, &buf);
+                buf << "\",\"ph\":\"X\",\"pid\":" << pid
+                    << ",\"tid\":" << i
+                    << ",\"ts\":" << (span->begin * 1e6)
+                    << ",\"dur\":" << ((span->end - span->begin) * 1e6)
+                    << "},\n";
+            }
+        }
+#endif
+
+        return buf.str();
+    }
+
+private:
+#ifdef LIBGEODECOMP_WITH_CPP14
+    /**
+     * Ring buffer of spans. Only written to by its owning thread.
+     */
+    class ThreadLog
+    {
+    public:
+        explicit ThreadLog(std::size_t capacity) :
+            buffer(capacity),
+            counter(0)
+        {}
+
+        inline void record(const Span& span)
+        {
+            buffer[counter % buffer.size()] = span;
+            ++counter;
+        }
+
+        /**
+         * Returns the buffered spans, oldest first.
+         */
+        std::vector<Span> spans() const
+        {
+            std::vector<Span> ret;
+            std::size_t begin = 0;
+            if (counter > buffer.size()) {
+                begin = counter - buffer.size();
+            }
+
+            for (std::size_t i = begin; i < counter; ++i) {
+                ret.push_back(buffer[i % buffer.size()]);
+            }
+
+            return ret;
+        }
+
+    private:
+        std::vector<Span> buffer;
+        std::size_t counter;
+    };
+
+    class Registry
+    {
+    public:
+        Registry() :
+            capacity(0),
+            generation(0),
+            enabled(false)
+        {}
+
+        std::mutex mutex;
+        std::vector<std::unique_ptr<ThreadLog> > logs;
+        std::size_t capacity;
+        std::atomic<int> generation;
+        std::atomic<bool> enabled;
+    };
+
+    static Registry& registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    /**
+     * Returns the calling thread's log. Logs are registered lazily
+     * (the only occasion which requires locking) and invalidated by
+     * enable().
+     */
+    static ThreadLog *threadLog()
+    {
+        thread_local ThreadLog *log = 0;
+        thread_local int generation = -1;
+
+        Registry& reg = registry();
+        if ((log == 0) || (generation != reg.generation)) {
+            std::lock_guard<std::mutex> lock(reg.mutex);
+            reg.logs.push_back(std::unique_ptr<ThreadLog>(new ThreadLog(reg.capacity)));
+            log = reg.logs.back().get();
+            generation = reg.generation;
+        }
+
+        return log;
+    }
+#endif
+
+    static void escape(const char *name, std::ostream *stream)
+    {
+        if (name == 0) {
+            return;
+        }
+
+        for (const char *c = name; *c != 0; ++c) {
+            if ((*c == '"') || (*c == '\\')) {
+                *stream << '\\';
+            }
+            *stream << *c;
+        }
+    }
+};
+
+}
+
+#endif
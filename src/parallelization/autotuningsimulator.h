@@ -5,7 +5,9 @@
 
 #ifdef LIBGEODECOMP_WITH_CPP14
 
+#include <libgeodecomp/misc/autotuningcache.h>
 #include <libgeodecomp/misc/optimizer.h>
+#include <libgeodecomp/misc/random.h>
 #include <libgeodecomp/misc/cacheblockingsimulationfactory.h>
 #include <libgeodecomp/misc/cudasimulationfactory.h>
 #include <libgeodecomp/misc/serialsimulationfactory.h>
@@ -13,7 +15,12 @@
 #include <libgeodecomp/io/initializer.h>
 #include <libgeodecomp/io/varstepinitializerproxy.h>
 #include <libgeodecomp/io/logger.h>
+#include <algorithm>
 #include <cfloat>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <typeinfo>
 
 namespace LibGeoDecomp {
 
@@ -45,6 +52,33 @@ public:
     double fitness;
 };
 
+/**
+ * One parameterization of a Simulation, as evaluated during
+ * successive halving.
+ */
+template<typename CELL_TYPE>
+class Candidate
+{
+public:
+    typedef typename SharedPtr<Simulation<CELL_TYPE> >::Type SimulationPtr;
+
+    Candidate(SimulationPtr simulation, const SimulationParameters& parameters) :
+        simulation(simulation),
+        parameters(parameters),
+        fitness(-std::numeric_limits<double>::max())
+    {}
+
+    bool operator<(const Candidate& other) const
+    {
+        // sorts candidates by descending fitness
+        return fitness > other.fitness;
+    }
+
+    SimulationPtr simulation;
+    SimulationParameters parameters;
+    double fitness;
+};
+
 }
 
 /**
@@ -53,6 +87,17 @@ public:
  * and suitable parameters for the given simulation model and
  * hardware.
  *
+ * Tuning results can be persisted via setCacheFile(), so that
+ * subsequent runs with the same model, grid size, thread count and
+ * CPU skip the tuning phase altogether.
+ *
+ * Instead of running the OPTIMIZER_TYPE on each Simulation,
+ * enableSuccessiveHalving() will sample a number of random
+ * parameterizations per Simulation. All of these are run for a few
+ * steps, the better half is kept and run again with twice the number
+ * of steps, until only one candidate remains. This is cheaper than
+ * the optimizers if only a few steps are to be simulated.
+ *
  * fixme: shouldn't we inherit from Monolithic- or DistributedSimulator?
  */
 template<typename CELL_TYPE, typename OPTIMIZER_TYPE>
@@ -80,9 +125,33 @@ public:
 
     void run();
 
+    /**
+     * Tuning results will be read from/written to this file.
+     */
+    void setCacheFile(const std::string& fileName)
+    {
+        cacheFile = fileName;
+    }
+
+    /**
+     * Replaces the OPTIMIZER_TYPE by successive halving with the
+     * given number of candidates per Simulation.
+     */
+    void enableSuccessiveHalving(unsigned candidatesPerSimulation = 8)
+    {
+        if (candidatesPerSimulation < 1) {
+            throw std::invalid_argument("successive halving needs at least one candidate per simulation");
+        }
+        halvingCandidates = candidatesPerSimulation;
+    }
+
 private:
+    typedef AutoTuningSimulatorHelpers::Candidate<CELL_TYPE> Candidate;
+
     std::map<const std::string, SimulationPtr> simulations;
     unsigned optimizationSteps; // maximum number of Steps for the optimizer
+    std::string cacheFile;
+    unsigned halvingCandidates;
     typename SharedPtr<VarStepInitializerProxy<CELL_TYPE> >::Type varStepInitializer;
     std::vector<typename SharedPtr<ParallelWriter<CELL_TYPE> >::Type> parallelWriters;
     std::vector<typename SharedPtr<Writer<CELL_TYPE> >::Type> writers;
@@ -113,8 +182,19 @@ private:
 
     void runTest();
 
+    void runSuccessiveHalving(unsigned steps);
+
     void prepareSimulations();
 
+    std::string cacheKey() const
+    {
+        return AutoTuningCache::key(typeid(CELL_TYPE).name(), varStepInitializer->gridDimensions());
+    }
+
+    bool loadFromCache(std::string *bestSimulation);
+
+    void storeInCache(const std::string& bestSimulation);
+
     SimulationPtr getSimulation(const std::string& simulatorName)
     {
         if (simulations.find(simulatorName) == simulations.end()) {
@@ -128,6 +208,7 @@ private:
 template<typename CELL_TYPE,typename OPTIMIZER_TYPE>
 AutoTuningSimulator<CELL_TYPE, OPTIMIZER_TYPE>::AutoTuningSimulator(Initializer<CELL_TYPE> *initializer, unsigned optimizationSteps):
     optimizationSteps(optimizationSteps),
+    halvingCandidates(0),
     varStepInitializer(new VarStepInitializerProxy<CELL_TYPE>(initializer))
 {
     addSimulation(SerialSimulationFactory<CELL_TYPE>(varStepInitializer));
@@ -171,13 +252,28 @@ void AutoTuningSimulator<CELL_TYPE, OPTIMIZER_TYPE>::run()
     unsigned defaultInitializerSteps = 5;
 
     prepareSimulations();
-    if (!normalizeSteps(fitnessGoal, defaultInitializerSteps)) {
+
+    std::string best;
+    if (loadFromCache(&best)) {
+        runToCompletion(best);
+        return;
+    }
+
+    unsigned steps = normalizeSteps(fitnessGoal, defaultInitializerSteps);
+    if (!steps) {
         LOG(Logger::WARN, "normalize Steps was not successful, default step number will be used");
+        steps = defaultInitializerSteps;
         varStepInitializer->setMaxSteps(defaultInitializerSteps);
     }
 
-    runTest();
-    std::string best = getBestSim();
+    if (halvingCandidates > 0) {
+        runSuccessiveHalving(steps);
+    } else {
+        runTest();
+    }
+
+    best = getBestSim();
+    storeInCache(best);
     runToCompletion(best);
 }
 
@@ -185,7 +281,8 @@ template<typename CELL_TYPE,typename OPTIMIZER_TYPE>
 std::string AutoTuningSimulator<CELL_TYPE, OPTIMIZER_TYPE>::getBestSim()
 {
     std::string bestSimulation;
-    double tmpFitness = std::numeric_limits<double>::min();
+    // fitness values are negative (see SimulationFactory):
+    double tmpFitness = -std::numeric_limits<double>::max();
     typedef typename std::map<const std::string, SimulationPtr>::iterator IterType;
 
     for (IterType iter = simulations.begin(); iter != simulations.end(); iter++) {
@@ -259,6 +356,99 @@ void AutoTuningSimulator<CELL_TYPE, OPTIMIZER_TYPE>::runTest()
     }
 }
 
+template<typename CELL_TYPE,typename OPTIMIZER_TYPE>
+void AutoTuningSimulator<CELL_TYPE, OPTIMIZER_TYPE>::runSuccessiveHalving(unsigned steps)
+{
+    typedef typename std::map<const std::string, SimulationPtr>::iterator IterType;
+    std::vector<Candidate> candidates;
+
+    for (IterType iter = simulations.begin(); iter != simulations.end(); iter++) {
+        SimulationParameters& defaults = iter->second->parameters;
+        iter->second->fitness = -std::numeric_limits<double>::max();
+        candidates << Candidate(iter->second, defaults);
+
+        // without parameters there is nothing to sample:
+        unsigned numCandidates = defaults.size() ? halvingCandidates : 1;
+        for (unsigned i = 1; i < numCandidates; ++i) {
+            SimulationParameters params(defaults);
+            for (std::size_t p = 0; p < params.size(); ++p) {
+                params[p].setValue(params[p].getMin() + Random::genDouble(params[p].getMax() - params[p].getMin()));
+            }
+            candidates << Candidate(iter->second, params);
+        }
+    }
+
+    // start with short runs so that the total effort amounts to
+    // roughly that of evaluating each candidate once for the
+    // normalized number of steps:
+    unsigned rounds = std::ceil(std::log(double(candidates.size())) / std::log(2.0));
+    steps = (std::max)(1u, steps >> rounds);
+
+    for (;;) {
+        varStepInitializer->setMaxSteps(steps);
+        for (typename std::vector<Candidate>::iterator i = candidates.begin(); i != candidates.end(); ++i) {
+            // randomly sampled parameters may well be rejected by the
+            // Simulator (e.g. a pipeline longer than the grid):
+            try {
+                i->fitness = (*i->simulation->simulationFactory)(i->parameters);
+            } catch (const std::invalid_argument& e) {
+                LOG(Logger::DBG, "rejecting candidate " << i->simulation->simulationType << ": " << e.what());
+                i->fitness = -std::numeric_limits<double>::max();
+            }
+        }
+
+        std::stable_sort(candidates.begin(), candidates.end());
+        LOG(Logger::DBG, "successive halving with " << candidates.size() << " candidates and "
+            << steps << " steps, best: " << candidates.front().simulation->simulationType
+            << " at " << candidates.front().fitness);
+
+        if (candidates.size() == 1) {
+            break;
+        }
+
+        candidates.erase(candidates.begin() + (candidates.size() + 1) / 2, candidates.end());
+        steps *= 2;
+    }
+
+    Candidate& winner = candidates.front();
+    winner.simulation->parameters = winner.parameters;
+    winner.simulation->fitness = winner.fitness;
+}
+
+template<typename CELL_TYPE,typename OPTIMIZER_TYPE>
+bool AutoTuningSimulator<CELL_TYPE, OPTIMIZER_TYPE>::loadFromCache(std::string *bestSimulation)
+{
+    if (cacheFile.empty()) {
+        return false;
+    }
+
+    typedef typename std::map<const std::string, SimulationPtr>::iterator IterType;
+    std::map<std::string, SimulationParameters> params;
+    for (IterType iter = simulations.begin(); iter != simulations.end(); iter++) {
+        params[iter->first] = iter->second->parameters;
+    }
+
+    std::string key = cacheKey();
+    if (!AutoTuningCache(cacheFile).lookup(key, bestSimulation, &params)) {
+        LOG(Logger::INFO, "no cached tuning result for " << key);
+        return false;
+    }
+
+    LOG(Logger::INFO, "using cached tuning result for " << key << ": " << *bestSimulation);
+    getSimulation(*bestSimulation)->parameters = params[*bestSimulation];
+    return true;
+}
+
+template<typename CELL_TYPE,typename OPTIMIZER_TYPE>
+void AutoTuningSimulator<CELL_TYPE, OPTIMIZER_TYPE>::storeInCache(const std::string& bestSimulation)
+{
+    if (cacheFile.empty()) {
+        return;
+    }
+
+    AutoTuningCache(cacheFile).store(cacheKey(), bestSimulation, getSimulation(bestSimulation)->parameters);
+}
+
 template<typename CELL_TYPE,typename OPTIMIZER_TYPE>
 void AutoTuningSimulator<CELL_TYPE, OPTIMIZER_TYPE>::prepareSimulations()
 {
@@ -10,12 +10,34 @@
 #include <libgeodecomp/storage/displacedgrid.h>
 #include <libgeodecomp/storage/updatefunctor.h>
 
+#include <algorithm>
+#include <stdexcept>
+
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
 namespace LibGeoDecomp {
 
 /**
- * CacheBlockingSimulator is an experimental simulator to explore the
- * infrastructure required to implement a pipelined wavefront update
- * algorith and which benefits is may provide.
+ * CacheBlockingSimulator implements temporal blocking via pipelined
+ * wavefronts: the grid is cut into tiles along all but the slowest
+ * dimension (e.g. columns in the X/Y plane for 3D models). Each
+ * thread sweeps a tile along the slowest dimension (the wavefront
+ * direction) and advances it by pipelineLength nano steps in a
+ * single pass. Intermediate time levels are kept in small per-thread
+ * ring buffers which only hold 2 * RADIUS + 1 planes each, so they
+ * stay in cache and only the initial and final time level touch main
+ * memory. Tiles are extended by a halo of RADIUS cells per nano step
+ * which is computed redundantly. This allows all tiles to be updated
+ * concurrently.
+ *
+ * Both constant and periodic boundary conditions are supported.
+ * Writers and Steerers are called whenever their period requires it,
+ * as hops will never span across such a step.
+ *
+ * Restrictions: the model needs to use a Cube or Torus topology
+ * (2D or 3D) and must not rely on SoA storage.
  */
 template<typename CELL>
 class CacheBlockingSimulator : public MonolithicSimulator<CELL>
@@ -23,45 +45,53 @@ class CacheBlockingSimulator : public MonolithicSimulator<CELL>
 public:
     friend class CacheBlockingSimulatorTest;
 
+    typedef typename MonolithicSimulator<CELL>::GridType GridBaseType;
     typedef typename APITraits::SelectTopology<CELL>::Value Topology;
-    typedef typename TopologiesHelpers::Topology<3, Topology::template WrapsAxis<0>::VALUE, Topology::template WrapsAxis<1>::VALUE, true> BufferTopology;
+    typedef typename APITraits::SelectStencil<CELL>::Value Stencil;
+    typedef typename Steerer<CELL>::SteererFeedback SteererFeedback;
+    static const int DIM = Topology::DIM;
+    static const int SWEEP_DIM = DIM - 1;
+
+    // wrapping around the sweep dimension turns the buffers into ring
+    // buffers, all other dimensions use absolute coordinates:
+    typedef TopologiesHelpers::Topology<DIM, (SWEEP_DIM == 0), (SWEEP_DIM == 1), (SWEEP_DIM == 2)> BufferTopology;
     typedef Grid<CELL, Topology> GridType;
     typedef DisplacedGrid<CELL, BufferTopology> BufferType;
-    typedef std::vector<std::vector<Region<3> > > WavefrontFrames;
-    static const int DIM = Topology::DIM;
+    typedef std::vector<BufferType> BufferVec;
 
     using MonolithicSimulator<CELL>::NANO_STEPS;
     using MonolithicSimulator<CELL>::chronometer;
 
+    /**
+     * Each hop will advance the grid by pipelineLength nano steps.
+     * wavefrontDim gives the size of the tiles, perpendicular to the
+     * wavefront's direction of travel.
+     */
     CacheBlockingSimulator(
         Initializer<CELL> *initializer,
         int pipelineLength,
         const Coord<DIM - 1>& wavefrontDim) :
         MonolithicSimulator<CELL>(initializer),
-        buffers(omp_get_max_threads()),
         pipelineLength(pipelineLength),
         wavefrontDim(wavefrontDim)
     {
-        Coord<DIM> dim = initializer->gridBox().dimensions;
-        curGrid = new GridType(dim);
-        newGrid = new GridType(dim);
-        initializer->grid(curGrid);
-        initializer->grid(newGrid);
-
-        Coord<DIM> bufferDim;
-
-        for (int i = 0; i < DIM - 1; ++i) {
-            bufferDim[i] = wavefrontDim[i] + 2 * pipelineLength - 2;
-        }
-        bufferDim[DIM - 1] = pipelineLength * 4 - 4;
-
-        for (std::size_t i = 0; i < buffers.size(); ++i) {
-            buffers[i] = BufferType(CoordBox<DIM>(Coord<DIM>(), bufferDim), curGrid->getEdgeCell(), curGrid->getEdgeCell());
-        }
-        LOG(DBG, "created " << buffers.size() << " buffers");
+        init();
+    }
 
-        generateFrames();
-        nanoStep = 0;
+    /**
+     * Derives pipelineLength and wavefrontDim from the size of the
+     * cache, see autoTune().
+     */
+    explicit CacheBlockingSimulator(Initializer<CELL> *initializer) :
+        MonolithicSimulator<CELL>(initializer)
+    {
+        autoTune(
+            initializer->gridDimensions(),
+            cacheSize(),
+            omp_get_max_threads(),
+            &pipelineLength,
+            &wavefrontDim);
+        init();
     }
 
     virtual ~CacheBlockingSimulator()
@@ -70,40 +100,128 @@ public:
         delete curGrid;
     }
 
+    /**
+     * performs a single simulation step.
+     */
     virtual void step()
     {
-        // fixme
+        SteererFeedback feedback;
+        step(&feedback, 1);
     }
 
     virtual void run()
     {
-        initializer->grid(curGrid);
-        stepNum = initializer->startStep();
-        nanoStep = 0;
+        // the constructor has already set up the grids, we only need
+        // to reset them if the simulation has been advanced since:
+        if (!gridsPristine) {
+            initGrids();
+        }
+        setIORegions();
+
+        SteererFeedback feedback;
+        handleInput(STEERER_INITIALIZED, &feedback);
+        handleOutput(WRITER_INITIALIZED);
+
+        while (stepNum < initializer->maxSteps()) {
+            if (feedback.simulationEnded()) {
+                break;
+            }
+
+            step(&feedback, stepsUntilNextEvent());
+        }
+
+        handleInput(STEERER_ALL_DONE, &feedback);
+        handleOutput(WRITER_ALL_DONE);
+    }
+
+    virtual const GridBaseType *getGrid()
+    {
+        return curGrid;
+    }
+
+    inline int getPipelineLength() const
+    {
+        return pipelineLength;
+    }
+
+    inline const Coord<DIM - 1>& getWavefrontDim() const
+    {
+        return wavefrontDim;
+    }
+
+    /**
+     * Picks the largest pipelineLength (up to maxPipelineLength) for
+     * which tiles can be made wide enough to keep the redundantly
+     * computed halo below 50% per dimension while the ring buffers of
+     * one thread still fit into half of the given cache and there are
+     * enough tiles to keep all threads busy. Tiles span the whole
+     * grid along all but the last non-sweep dimension if possible, as
+     * long streaks are much cheaper to update than short ones.
+     */
+    static void autoTune(
+        const Coord<DIM>& gridDim,
+        std::size_t cacheSize,
+        int numThreads,
+        int *pipelineLength,
+        Coord<DIM - 1> *wavefrontDim,
+        int maxPipelineLength = 8)
+    {
+        const int radius = Stencil::RADIUS;
+        std::size_t budget = cacheSize / 2 / sizeof(CELL);
+
+        for (int length = maxPipelineLength; length > 1; --length) {
+            int width = rowTileWidth(gridDim, budget, numThreads, length);
+            if (width >= (4 * length * radius)) {
+                setRowTiles(gridDim, length, width, pipelineLength, wavefrontDim);
+                return;
+            }
+        }
+
+        // rows are too long to fit into the cache, so we try to tile
+        // all dimensions:
+        int maxWidth = 1;
+        for (int d = 0; d < (DIM - 1); ++d) {
+            maxWidth = (std::max)(maxWidth, gridDim[d]);
+        }
+        while ((maxWidth > 1) && (numTiles(gridDim, maxWidth) < numThreads)) {
+            --maxWidth;
+        }
 
-        for(unsigned i = 0; i < writers.size(); ++i) {
-            writers[i]->stepFinished(
-                *getGrid(),
-                getStep(),
-                WRITER_INITIALIZED);
+        int length = maxPipelineLength;
+        int width = maxTileWidth(budget, length, radius, maxWidth);
+        for (; length > 1; --length) {
+            width = maxTileWidth(budget, length, radius, maxWidth);
+            if (width >= (4 * length * radius)) {
+                break;
+            }
         }
 
-        for (stepNum = initializer->startStep();
-             stepNum < initializer->maxSteps();) {
-            hop();
+        // no temporal blocking possible, but long rows still pay off:
+        int rowWidth = rowTileWidth(gridDim, budget, numThreads, 1);
+        if ((length == 1) && (rowWidth > 0)) {
+            setRowTiles(gridDim, length, rowWidth, pipelineLength, wavefrontDim);
+            return;
         }
 
-        for(unsigned i = 0; i < writers.size(); ++i) {
-            writers[i]->stepFinished(
-                *getGrid(),
-                getStep(),
-                WRITER_ALL_DONE);
+        *pipelineLength = length;
+        for (int d = 0; d < (DIM - 1); ++d) {
+            (*wavefrontDim)[d] = (std::min)(width, gridDim[d]);
         }
     }
 
-    virtual const GridType *getGrid()
+    /**
+     * Size of the per-core cache (L2) in bytes, or a conservative
+     * guess if the OS won't tell.
+     */
+    static std::size_t cacheSize()
     {
-        return curGrid;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+        long size = sysconf(_SC_LEVEL2_CACHE_SIZE);
+        if (size > 0) {
+            return size;
+        }
+#endif
+        return 256 * 1024;
     }
 
 private:
@@ -112,225 +230,473 @@ private:
     using MonolithicSimulator<CELL>::stepNum;
     using MonolithicSimulator<CELL>::writers;
     using MonolithicSimulator<CELL>::getStep;
+    using MonolithicSimulator<CELL>::gridDim;
 
     GridType *curGrid;
     GridType *newGrid;
-    std::vector<BufferType> buffers;
     int pipelineLength;
     Coord<DIM - 1> wavefrontDim;
-    Grid<WavefrontFrames> frames;
+    std::vector<CoordBox<DIM> > tiles;
+    std::vector<BufferVec> buffers;
+    Region<DIM> simArea;
     unsigned nanoStep;
+    bool gridsPristine;
 
-    void generateFrames()
+    void init()
     {
-        Coord<DIM> gridDim = initializer->gridBox().dimensions;
+        if (pipelineLength < 1) {
+            throw std::invalid_argument("pipelineLength needs to be positive");
+        }
+
+        for (int d = 0; d < DIM; ++d) {
+            if ((d < SWEEP_DIM) && (wavefrontDim[d] < 1)) {
+                throw std::invalid_argument("wavefrontDim needs to be positive");
+            }
 
-        Coord<DIM - 1> framesDim;
-        for (int i = 0; i < (DIM - 1); ++i) {
-            framesDim[i] = gridDim[i] / wavefrontDim[i];
-            if ((gridDim[i] % wavefrontDim[i]) != 0) {
-                framesDim[i] += 1;
+            // halo accesses may only wrap around the torus once:
+            if (Topology::wrapsAxis(d) && (pipelineLength * Stencil::RADIUS > gridDim[d])) {
+                throw std::invalid_argument("halo of pipelineLength exceeds grid dimensions");
             }
         }
-        frames.resize(framesDim);
 
-        for (int y = 0; y < framesDim.y(); ++y) {
-            for (int x = 0; x < framesDim.x(); ++x) {
-                frames[Coord<2>(x, y)] = generateWavefrontFrames(
-                    Coord<3>(x * wavefrontDim.x(),
-                             y * wavefrontDim.y(),
-                             0));
+        CoordBox<DIM> box = initializer->gridBox();
+        curGrid = new GridType(box.dimensions);
+        newGrid = new GridType(box.dimensions);
+        initGrids();
+        simArea << box;
 
-            }
+        generateTiles();
+        buffers.resize(omp_get_max_threads(), BufferVec(pipelineLength));
+        LOG(DBG, "CacheBlockingSimulator created " << tiles.size() << " tiles, "
+            << buffers.size() << " buffer sets");
+    }
+
+    void initGrids()
+    {
+        stepNum = initializer->startStep();
+        nanoStep = 0;
+        initializer->grid(curGrid);
+        // cheaper than running the Initializer a second time:
+        *newGrid = *curGrid;
+        gridsPristine = true;
+    }
+
+    /**
+     * Width of tiles which span all but the last non-sweep
+     * dimension completely. May be zero or negative if not even a
+     * single row fits into the budget.
+     */
+    static int rowTileWidth(const Coord<DIM>& gridDim, std::size_t budget, int numThreads, int length)
+    {
+        const int tiledDim = DIM - 2;
+        int halo = 2 * length * Stencil::RADIUS;
+        long rowVolume = 1;
+        for (int d = 0; d < tiledDim; ++d) {
+            rowVolume *= gridDim[d] + halo;
         }
+
+        long planeBudget = budget / (length * (2 * Stencil::RADIUS + 1));
+        long width = (std::min)(
+            long(divideRoundingUp(gridDim[tiledDim], numThreads)),
+            planeBudget / rowVolume - halo);
+        return int(width);
     }
 
-    WavefrontFrames generateWavefrontFrames(const Coord<DIM> offset)
+    static void setRowTiles(
+        const Coord<DIM>& gridDim,
+        int length,
+        int width,
+        int *pipelineLength,
+        Coord<DIM - 1> *wavefrontDim)
     {
-        Coord<DIM> gridDim = initializer->gridBox().dimensions;
-        Coord<DIM> wavefrontRegionDim;
-        for (int i = 0; i < (DIM - 1); ++i) {
-            wavefrontRegionDim[i] = wavefrontDim[i];
+        *pipelineLength = length;
+        for (int d = 0; d < (DIM - 2); ++d) {
+            (*wavefrontDim)[d] = gridDim[d];
         }
-        wavefrontRegionDim[DIM - 1] = gridDim[DIM - 1] - offset[DIM - 1];
-        Region<DIM> region;
-        region << CoordBox<DIM>(offset, wavefrontRegionDim);
-        std::vector<Region<3> > regions(pipelineLength);
-        regions[pipelineLength - 1] = region.expandWithTopology(
-            0, gridDim, Topologies::Cube<3>::Topology());
-
-        for (int i = pipelineLength - 2; i >= 0; --i) {
-            regions[i] = regions[i + 1].expandWithTopology(
-                1, gridDim, Topologies::Cube<3>::Topology());
-        }
-
-        int wavefrontLength = gridDim[DIM - 1] + 1;
-        WavefrontFrames ret(wavefrontLength, std::vector<Region<DIM> >(pipelineLength));
-
-        for (int index = 0; index < wavefrontLength; ++index) {
-            Coord<DIM> maskOrigin;
-            maskOrigin[DIM - 1] = index;
-            Topology::normalize(maskOrigin, initializer->gridDimensions());
-            Coord<DIM> maskDim = gridDim;
-            maskDim[DIM - 1] = 1;
-
-            Region<DIM> mask;
-            mask << CoordBox<DIM>(maskOrigin, maskDim);
-            for (int i = 0; i < pipelineLength; ++i) {
-                ret[index][i] = regions[i] & mask;
+        (*wavefrontDim)[DIM - 2] = width;
+    }
+
+    static int maxTileWidth(std::size_t budget, int length, int radius, int maxWidth)
+    {
+        // each pipeline stage holds a ring buffer of 2 * radius + 1
+        // planes, which are extended by the halo:
+        std::size_t planeBudget = budget / (length * (2 * radius + 1));
+        int width = maxWidth;
+        while ((width > 1) && (planeVolume(width + 2 * length * radius) > planeBudget)) {
+            width = (std::min)(width - 1, int(width * 0.9));
+        }
+
+        return width;
+    }
+
+    static std::size_t planeVolume(int width)
+    {
+        std::size_t ret = 1;
+        for (int d = 0; d < (DIM - 1); ++d) {
+            ret *= width;
+        }
+        return ret;
+    }
+
+    static long numTiles(const Coord<DIM>& gridDim, int width)
+    {
+        long ret = 1;
+        for (int d = 0; d < (DIM - 1); ++d) {
+            ret *= divideRoundingUp(gridDim[d], width);
+        }
+        return ret;
+    }
+
+    static int divideRoundingUp(int a, int b)
+    {
+        return (a + b - 1) / b;
+    }
+
+    void generateTiles()
+    {
+        Coord<DIM> tileDim;
+        Coord<DIM> numTiles = Coord<DIM>::diagonal(1);
+        for (int d = 0; d < SWEEP_DIM; ++d) {
+            tileDim[d] = wavefrontDim[d];
+            numTiles[d] = divideRoundingUp(gridDim[d], wavefrontDim[d]);
+        }
+        tileDim[SWEEP_DIM] = gridDim[SWEEP_DIM];
+
+        CoordBox<DIM> tileIndices(Coord<DIM>(), numTiles);
+        for (typename CoordBox<DIM>::Iterator i = tileIndices.begin(); i != tileIndices.end(); ++i) {
+            Coord<DIM> origin;
+            for (int d = 0; d < DIM; ++d) {
+                origin[d] = (*i)[d] * tileDim[d];
             }
+            Coord<DIM> dim = ((gridDim - origin).min)(tileDim);
+            tiles << CoordBox<DIM>(origin, dim);
+        }
+    }
+
+    /**
+     * Advances the simulation by numSteps time steps in one go.
+     * Callers need to make sure that no Steerer or Writer expects to
+     * be called in between.
+     */
+    void step(SteererFeedback *feedback, unsigned numSteps)
+    {
+        TimeTotal t(&chronometer);
+
+        handleInput(STEERER_NEXT_STEP, feedback);
+        gridsPristine = false;
+
+        for (unsigned remaining = numSteps * NANO_STEPS; remaining > 0;) {
+            unsigned hopLength = (std::min)(unsigned(pipelineLength), remaining);
+            hop(hopLength);
+            remaining -= hopLength;
+        }
+
+        handleOutput(WRITER_STEP_FINISHED);
+    }
+
+    /**
+     * Returns the number of steps we may compute without needing to
+     * notify a Writer or Steerer in between.
+     */
+    unsigned stepsUntilNextEvent() const
+    {
+        unsigned ret = initializer->maxSteps() - stepNum;
+
+        for (unsigned i = 0; i < writers.size(); ++i) {
+            unsigned period = writers[i]->getPeriod();
+            ret = (std::min)(ret, period - stepNum % period);
+        }
+
+        for (unsigned i = 0; i < steerers.size(); ++i) {
+            unsigned period = steerers[i]->getPeriod();
+            ret = (std::min)(ret, period - stepNum % period);
         }
 
         return ret;
     }
 
-    void hop()
+    void hop(unsigned hopLength)
     {
         using std::swap;
-        TimeTotal t(&chronometer);
 
-        CoordBox<DIM - 1> frameBox = frames.boundingBox();
-        // for (typename CoordBox<DIM -1>::Iterator waveIter = frameBox.begin();
-        //      waveIter != frameBox.end();
-        //      ++waveIter) {
-        //     updateWavefront(*waveIter);
-        // }
-
-#pragma omp parallel for
-        for (int y = 0; y < frameBox.dimensions.y(); ++y) {
-            for (int x = 0; x < frameBox.dimensions.x(); ++x) {
-                updateWavefront(&buffers[omp_get_thread_num()], Coord<2>(x, y));
+        {
+            TimeCompute t(&chronometer);
+
+#pragma omp parallel for schedule(dynamic)
+            for (int i = 0; i < int(tiles.size()); ++i) {
+                updateTile(tiles[i], &buffers[omp_get_thread_num()], hopLength);
             }
         }
 
         swap(curGrid, newGrid);
-        int curNanoStep = nanoStep + pipelineLength;
+        unsigned curNanoStep = nanoStep + hopLength;
         stepNum += curNanoStep / NANO_STEPS;
         nanoStep = curNanoStep % NANO_STEPS;
     }
 
-    void updateWavefront(BufferType *buffer, const Coord<DIM - 1>& wavefrontCoord)
+    /**
+     * Sweeps the tile's core along the sweep dimension and advances
+     * it by hopLength nano steps. Level 0 is a copy of the current
+     * grid, level k holds the state after k nano steps, level
+     * hopLength is written directly to the new grid. Level k trails
+     * level k - 1 by RADIUS planes so that all neighbors are
+     * available when a plane gets updated.
+     */
+    void updateTile(const CoordBox<DIM>& core, BufferVec *levels, int hopLength)
+    {
+        const int radius = Stencil::RADIUS;
+        const int planes = gridDim[SWEEP_DIM];
+        const bool wrapSweep = Topology::template WrapsAxis<SWEEP_DIM>::VALUE;
+        // level 1 may read straight from the current grid wherever
+        // its stencil doesn't need to be wrapped around the grid's
+        // edges. This saves the copy into level 0 for most tiles.
+        const bool directRows = readsWithinGrid(core, hopLength);
+
+        CoordBox<DIM> bufferBox = expandedTile(core, hopLength, false);
+        bufferBox.origin[SWEEP_DIM] = 0;
+        bufferBox.dimensions[SWEEP_DIM] = 2 * radius + 1;
+
+        for (int k = 0; k < hopLength; ++k) {
+            BufferType& buffer = (*levels)[k];
+            if (buffer.getDimensions() != bufferBox.dimensions) {
+                buffer.resize(bufferBox);
+            }
+            buffer.setOrigin(bufferBox.origin);
+            buffer.setEdge(curGrid->getEdge());
+            buffer.fill(bufferBox, curGrid->getEdge());
+        }
+
+        // the first plane of level k is being processed at time
+        // firstPlane(k) + k * radius:
+        int tBegin = wrapSweep ? -hopLength * radius : -radius;
+        int tEnd   = planes + hopLength * radius;
+
+        for (int t = tBegin; t < tEnd; ++t) {
+            for (int k = 0; k <= hopLength; ++k) {
+                int plane = t - k * radius;
+                int firstPlane = wrapSweep ? (-(hopLength - k) * radius)        : ((k == hopLength) ? 0      : -radius);
+                int endPlane   = wrapSweep ? (planes + (hopLength - k) * radius) : ((k == hopLength) ? planes : planes + radius);
+                if ((plane < firstPlane) || (plane >= endPlane)) {
+                    continue;
+                }
+
+                if (k == 0) {
+                    if (!directRows || (wrapSweep && ((plane < 2 * radius) || (plane >= planes - 2 * radius)))) {
+                        copyIn(core, hopLength, plane, &(*levels)[0]);
+                    }
+                    continue;
+                }
+
+                if (!wrapSweep && ((plane < 0) || (plane >= planes))) {
+                    // constant boundary: readers of this level expect
+                    // edge cells beyond the grid:
+                    BufferType& buffer = (*levels)[k];
+                    CoordBox<DIM> box = planeBox(buffer.boundingBox(), plane);
+                    setRingOrigin(&buffer, plane);
+                    buffer.fill(box, buffer.getEdgeCell());
+                    continue;
+                }
+
+                bool direct = (k == 1) && directRows &&
+                    (!wrapSweep || ((plane >= radius) && (plane + radius < planes)));
+                updatePlane(core, hopLength, k, plane, levels, direct);
+            }
+        }
+    }
+
+    void updatePlane(
+        const CoordBox<DIM>& core,
+        int hopLength,
+        int level,
+        int plane,
+        BufferVec *levels,
+        bool readFromGrid)
     {
-        LOG(INFO, "wavefrontCoord(" << wavefrontCoord << ")");
-        buffer->setEdge(curGrid->getEdge());
-        buffer->fill(buffer->boundingBox(), curGrid->getEdgeCell());
-        fixBufferOrigin(buffer, wavefrontCoord);
+        unsigned curNanoStep = (nanoStep + level - 1) % NANO_STEPS;
+        Region<DIM> region;
+        region << planeBox(expandedTile(core, hopLength - level, true), plane);
 
-        int index = 0;
-        CoordBox<DIM> boundingBox = curGrid->boundingBox();
-        int maxIndex = boundingBox.origin[DIM - 1] + boundingBox.dimensions[DIM - 1];
+        if (readFromGrid) {
+            if (level == hopLength) {
+                UpdateFunctor<CELL>()(region, Coord<DIM>(), Coord<DIM>(), *curGrid, newGrid, curNanoStep);
+                return;
+            }
 
-        // fill pipeline
-        for (; index < 2 * pipelineLength - 2; ++index) {
-            int lastStage = (index >> 1) + 1;
-            pipelinedUpdate(buffer, wavefrontCoord, index, index, 0, lastStage);
+            BufferType& target = (*levels)[level];
+            setRingOrigin(&target, plane);
+            UpdateFunctor<CELL>()(region, Coord<DIM>(), Coord<DIM>(), *curGrid, &target, curNanoStep);
+            return;
         }
 
-        // normal operation
-        for (; index < maxIndex; ++index) {
-            pipelinedUpdate(buffer, wavefrontCoord, index, index, 0, pipelineLength);
+        BufferType& source = (*levels)[level - 1];
+        setRingOrigin(&source, plane);
+
+        if (level == hopLength) {
+            UpdateFunctor<CELL>()(region, Coord<DIM>(), Coord<DIM>(), source, newGrid, curNanoStep);
+            return;
         }
 
-        // let pipeline drain
-        for (; index < (maxIndex + 2 * pipelineLength - 2); ++index) {
-            int firstStage = (index - maxIndex + 1) >> 1 ;
-            pipelinedUpdate(buffer, wavefrontCoord, index, index, firstStage, pipelineLength);
+        BufferType& target = (*levels)[level];
+        setRingOrigin(&target, plane);
+        UpdateFunctor<CELL>()(region, Coord<DIM>(), Coord<DIM>(), source, &target, curNanoStep);
+    }
+
+    /**
+     * Checks whether the first level of the given tile can be
+     * computed directly from the current grid: this holds unless
+     * its stencil reaches across a periodic boundary.
+     */
+    bool readsWithinGrid(const CoordBox<DIM>& core, int hopLength) const
+    {
+        int halo = hopLength * Stencil::RADIUS;
+
+        for (int d = 0; d < DIM; ++d) {
+            if ((d == SWEEP_DIM) || !Topology::wrapsAxis(d)) {
+                continue;
+            }
+
+            if ((core.origin[d] - halo < 0) ||
+                (core.origin[d] + core.dimensions[d] + halo > gridDim[d])) {
+                return false;
+            }
         }
+
+        return true;
     }
 
-    void fixBufferOrigin(BufferType *buffer, const Coord<DIM - 1>& frameCoord)
+    /**
+     * Fills the given plane of level 0 with the corresponding cells
+     * of the current grid, taking boundary conditions into account.
+     */
+    void copyIn(const CoordBox<DIM>& core, int hopLength, int plane, BufferType *target)
     {
-        Coord<DIM> bufferOrigin;
-        // fixme: wrong on boundary with Torus topology
-        for (int d = 0; d < (DIM - 1); ++d) {
-            bufferOrigin[d] = std::max(0, frameCoord[d] * wavefrontDim[d] - pipelineLength + 1);
+        setRingOrigin(target, plane);
+        Region<DIM> region;
+        region << planeBox(target->boundingBox(), plane);
+
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            Coord<DIM> cursor = i->origin;
+
+            while (cursor.x() < i->endX) {
+                Coord<DIM> sourceCoord = Topology::normalize(cursor, gridDim);
+                if (sourceCoord == Coord<DIM>::diagonal(-1)) {
+                    (*target)[cursor] = curGrid->getEdgeCell();
+                    ++cursor.x();
+                    continue;
+                }
+
+                int length = (std::min)(i->endX - cursor.x(), gridDim.x() - sourceCoord.x());
+                const CELL *source = &(*curGrid)[sourceCoord];
+                std::copy(source, source + length, &(*target)[cursor]);
+                cursor.x() += length;
+            }
         }
-        bufferOrigin[DIM - 1] = 0;
-        buffer->setOrigin(bufferOrigin);
     }
 
-    void pipelinedUpdate(
-        BufferType *buffer,
-        const Coord<DIM - 1>& frameCoord,
-        int globalIndex,
-        int localIndex,
-        int firstStage,
-        int lastStage)
+    /**
+     * Extends the tile by radius cells per nano step along all
+     * dimensions except the sweep dimension. Optionally clips the
+     * result at non-periodic boundaries, as cells outside of the grid
+     * must not be updated.
+     */
+    CoordBox<DIM> expandedTile(const CoordBox<DIM>& core, int steps, bool clip) const
     {
-        LOG(DBG, "  pipelinedUpdate(frameCoord = " << frameCoord << ", globalIndex = " << globalIndex << ", localIndex = " << localIndex << ", firstStage = " << firstStage << ", lastStage = " << lastStage << ")");
+        CoordBox<DIM> ret = core;
+        int halo = steps * Stencil::RADIUS;
+
+        for (int d = 0; d < SWEEP_DIM; ++d) {
+            int begin = ret.origin[d] - halo;
+            int end = ret.origin[d] + ret.dimensions[d] + halo;
+            if (clip && !Topology::wrapsAxis(d)) {
+                begin = (std::max)(begin, 0);
+                end = (std::min)(end, gridDim[d]);
+            }
 
-        for (int i = firstStage; i < lastStage; ++i) {
-            bool firstIteration = (i == 0);
-            bool lastIteration =  (i == (pipelineLength - 1));
-            int currentGlobalIndex = globalIndex - 2 * i;
-            bool needsFlushing = (i == firstStage) &&
-                (currentGlobalIndex >= newGrid->getDimensions()[DIM - 1]);
-            int sourceIndex = firstIteration ? currentGlobalIndex : normalizeIndex(localIndex + 2 - 4 * i);
-            int targetIndex = lastIteration  ? currentGlobalIndex : normalizeIndex(localIndex + 0 - 4 * i);
+            ret.origin[d] = begin;
+            ret.dimensions[d] = end - begin;
+        }
 
-            const Region<DIM>& updateFrame = frames[frameCoord][globalIndex - 2 * i][i];
-            unsigned curNanoStep = (nanoStep + i) % NANO_STEPS;
+        return ret;
+    }
 
-            if ( firstIteration &&  lastIteration) {
-                frameUpdate(needsFlushing, updateFrame, sourceIndex, targetIndex, *curGrid, newGrid, curNanoStep);
-            }
+    static CoordBox<DIM> planeBox(CoordBox<DIM> box, int plane)
+    {
+        box.origin[SWEEP_DIM] = plane;
+        box.dimensions[SWEEP_DIM] = 1;
+        return box;
+    }
 
-            if ( firstIteration && !lastIteration) {
-                frameUpdate(needsFlushing, updateFrame, sourceIndex, targetIndex, *curGrid, buffer,  curNanoStep);
-            }
+    /**
+     * The ring buffer's topology only wraps once, so we need to move
+     * its origin along with the plane being accessed. The origin is
+     * always a multiple of the ring's size, so that each plane
+     * always maps to the same slot. Also, the plane must not end up
+     * on the first or last slot, as the UpdateFunctor would take it
+     * for the grid's boundary otherwise.
+     */
+    static void setRingOrigin(BufferType *buffer, int plane)
+    {
+        const int ringSize = buffer->getDimensions()[SWEEP_DIM];
+        int slot = ((plane % ringSize) + ringSize) % ringSize;
+
+        Coord<DIM> origin = buffer->getOrigin();
+        origin[SWEEP_DIM] = plane - slot;
+        if (slot == 0) {
+            origin[SWEEP_DIM] -= ringSize;
+        }
+        if (slot == (ringSize - 1)) {
+            origin[SWEEP_DIM] += ringSize;
+        }
+
+        buffer->setOrigin(origin);
+    }
 
-            if (!firstIteration &&  lastIteration) {
-                frameUpdate(needsFlushing, updateFrame, sourceIndex, targetIndex, *buffer,  newGrid, curNanoStep);
+    /**
+     * notifies all registered Writers
+     */
+    void handleOutput(WriterEvent event)
+    {
+        TimeOutput t(&chronometer);
+
+        for (unsigned i = 0; i < writers.size(); i++) {
+            if ((event != WRITER_STEP_FINISHED) ||
+                ((getStep() % writers[i]->getPeriod()) == 0)) {
+                writers[i]->stepFinished(
+                    *curGrid,
+                    getStep(),
+                    event);
             }
+        }
+    }
 
-            if (!firstIteration && !lastIteration) {
-                frameUpdate(needsFlushing, updateFrame, sourceIndex, targetIndex, *buffer,  buffer,  curNanoStep);
+    /**
+     * notifies all registered Steerers
+     */
+    void handleInput(SteererEvent event, SteererFeedback *feedback)
+    {
+        TimeInput t(&chronometer);
+
+        for (unsigned i = 0; i < steerers.size(); ++i) {
+            if ((event != STEERER_NEXT_STEP) ||
+                (stepNum % steerers[i]->getPeriod() == 0)) {
+                steerers[i]->nextStep(
+                    curGrid,
+                    simArea,
+                    gridDim,
+                    getStep(),
+                    event,
+                    0,
+                    true,
+                    feedback);
             }
         }
     }
 
-    template<class GRID1, class GRID2>
-    void frameUpdate(
-        bool needsFlushing,
-        const Region<DIM>& updateFrame,
-        int sourceIndex,
-        int targetIndex,
-        const GRID1& sourceGrid,
-        GRID2 *targetGrid,
-        unsigned curNanoStep)
-    {
-        LOG(DBG, "    frameUpdate("
-            << needsFlushing << ", "
-            << updateFrame.boundingBox() << ", "
-            << sourceIndex << ", "
-            << targetIndex <<  ")");
-
-        if (needsFlushing) {
-            // fixme: only works with cube topologies
-            Coord<DIM> fillOrigin = buffers[omp_get_thread_num()].getOrigin();
-            fillOrigin[DIM - 1] = targetIndex;
-            Coord<DIM> fillDim = buffers[omp_get_thread_num()].getDimensions();
-            fillDim[DIM - 1] = 1;
-
-            buffers[omp_get_thread_num()].fill(
-                CoordBox<DIM>(fillOrigin, fillDim),
-                buffers[omp_get_thread_num()].getEdgeCell());
-        } else {
-            Coord<DIM> sourceOffset;
-            Coord<DIM> targetOffset;
-            sourceOffset[DIM - 1] = sourceIndex;
-            targetOffset[DIM - 1] = targetIndex;
-
-            UpdateFunctor<CELL>()(updateFrame, sourceOffset, targetOffset, sourceGrid, targetGrid, curNanoStep);
-        }
-     }
-
-    // wraps the index (for 3D this will be the Z coordinate) around
-    // the buffer's dimension
-    int normalizeIndex(int localIndex)
-    {
-        int bufferSize = buffers[0].getDimensions()[DIM - 1];
-        return (localIndex + bufferSize) % bufferSize;
+    void setIORegions()
+    {
+        for (unsigned i = 0; i < steerers.size(); i++) {
+            steerers[i]->setRegion(simArea);
+        }
     }
 };
 
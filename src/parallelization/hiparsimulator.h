@@ -12,6 +12,7 @@
 #include <libgeodecomp/loadbalancer/loadbalancer.h>
 #include <libgeodecomp/misc/sharedptr.h>
 #include <libgeodecomp/parallelization/hierarchicalsimulator.h>
+#include <libgeodecomp/parallelization/nesting/migrationinitializer.h>
 #include <libgeodecomp/parallelization/nesting/parallelwriteradapter.h>
 #include <libgeodecomp/parallelization/nesting/steereradapter.h>
 #include <libgeodecomp/parallelization/nesting/mpiupdategroup.h>
@@ -29,6 +30,13 @@ namespace LibGeoDecomp {
  * inter-node or inter-NUMA-domain communication and OpenMP and/or
  * CUDA for local paralelism.
  *
+ * If a LoadBalancer is given, the relative load of each rank will
+ * be measured periodically and cells will be migrated between ranks
+ * according to the new weights. The migration itself is deferred to
+ * the next nano step at which the ghost zones are synchronized and a
+ * time step is complete, as only then each rank's subdomain is in a
+ * consistent state.
+ *
  * fixme: check if code runs with a communicator which is merely a subset of MPI_COMM_WORLD
  */
 template<
@@ -55,6 +63,7 @@ public:
     typedef typename ParentType::GridType GridType;
     typedef ParallelWriterAdapter<typename UpdateGroupType::GridType, CELL_TYPE> ParallelWriterAdapterType;
     typedef SteererAdapter<typename UpdateGroupType::GridType, CELL_TYPE> SteererAdapterType;
+    typedef MigrationInitializer<CELL_TYPE, typename UpdateGroupType::GridType> MigrationInitializerType;
 
     static const int DIM = Topology::DIM;
 
@@ -71,7 +80,8 @@ public:
             enableFineGrainedParallelism),
         balancer(balancer),
         ghostZoneWidth(ghostZoneWidth),
-        mpiLayer(communicator)
+        mpiLayer(communicator),
+        firstGroupNanoStep(0)
     {}
 
     inline void run()
@@ -159,6 +169,15 @@ private:
     unsigned ghostZoneWidth;
     MPILayer mpiLayer;
     typename SharedPtr<UpdateGroupType>::Type updateGroup;
+    typename SharedPtr<PARTITION>::Type partition;
+    // nano step at which the current UpdateGroup was set up. Ghost
+    // zone synchronization happens every ghostZoneWidth nano steps
+    // relative to this point.
+    long firstGroupNanoStep;
+    // statistics of the current UpdateGroup as seen during the
+    // previous load balancing
+    Chronometer lastStatistics;
+    LoadBalancer::WeightVec pendingWeights;
 
     typename UpdateGroupType::PatchProviderVec steererAdaptersGhost;
     typename UpdateGroupType::PatchProviderVec steererAdaptersInner;
@@ -170,9 +189,17 @@ private:
         long remainingNanoSteps = s;
         while (remainingNanoSteps > 0) {
             long hop = std::min(remainingNanoSteps, timeToNextEvent());
+            if (!pendingWeights.empty()) {
+                hop = std::min(hop, timeToNextMigration());
+            }
+
             updateGroup->update(hop);
             handleEvents();
             remainingNanoSteps -= hop;
+
+            if (!pendingWeights.empty() && (timeToNextMigration() == 0)) {
+                migrate();
+            }
         }
     }
 
@@ -193,8 +220,6 @@ private:
         }
 
         CoordBox<DIM> box = initializer->gridBox();
-        Region<DIM> globalRegion;
-        globalRegion << box;
 
         double mySpeed = APITraits::SelectSpeedGuide<CELL_TYPE>::value();
         std::vector<double> rankSpeeds = mpiLayer.allGather(mySpeed);
@@ -202,14 +227,11 @@ private:
             box.dimensions.prod(),
             rankSpeeds);
 
-        typename SharedPtr<PARTITION>::Type partition(
-            new PARTITION(
-                box.origin,
-                box.dimensions,
-                0,
-                weights,
-                initializer->getAdjacency(globalRegion)));
+        partition = makePartition(weights);
+        firstGroupNanoStep = long(initializer->startStep()) * NANO_STEPS;
 
+        // the adapters are retained as they need to be handed on to
+        // the UpdateGroup which gets set up after migrating cells
         updateGroup.reset(
             new UpdateGroupType(
                 partition,
@@ -224,32 +246,265 @@ private:
                 enableFineGrainedParallelism,
                 mpiLayer.communicator()));
 
-        writerAdaptersGhost.clear();
-        writerAdaptersInner.clear();
-        steererAdaptersGhost.clear();
-        steererAdaptersInner.clear();
-
         initEvents();
     }
 
+    inline typename SharedPtr<PARTITION>::Type makePartition(const std::vector<std::size_t>& weights) const
+    {
+        CoordBox<DIM> box = initializer->gridBox();
+        Region<DIM> globalRegion;
+        globalRegion << box;
+
+        return typename SharedPtr<PARTITION>::Type(
+            new PARTITION(
+                box.origin,
+                box.dimensions,
+                0,
+                weights,
+                initializer->getAdjacency(globalRegion)));
+    }
+
+    /**
+     * Returns a box which contains the Region of the given node,
+     * expanded by the given width. Along periodic axes the expanded
+     * Region may wrap around, in which case the box will span the
+     * whole axis.
+     */
+    inline CoordBox<DIM> expandedBoundingBox(
+        const PARTITION& somePartition,
+        std::size_t node,
+        unsigned width,
+        const CoordBox<DIM>& gridBox) const
+    {
+        return expandedBoundingBox(somePartition, node, width, gridBox, Topology());
+    }
+
+    /**
+     * Regions of unstructured grids are expanded along their
+     * Adjacency, which may link any two nodes. Hence only the whole
+     * grid is guaranteed to contain the expanded Region.
+     */
+    inline CoordBox<DIM> expandedBoundingBox(
+        const PARTITION& /* unused: somePartition */,
+        std::size_t /* unused: node */,
+        unsigned /* unused: width */,
+        const CoordBox<DIM>& gridBox,
+        Topologies::Unstructured::Topology /* used just for overload */) const
+    {
+        return gridBox;
+    }
+
+    template<typename TOPOLOGY>
+    inline CoordBox<DIM> expandedBoundingBox(
+        const PARTITION& somePartition,
+        std::size_t node,
+        unsigned width,
+        const CoordBox<DIM>& gridBox,
+        TOPOLOGY /* used just for overload */) const
+    {
+        CoordBox<DIM> ret = somePartition.getBoundingBox(node);
+        if (ret.dimensions.prod() == 0) {
+            return ret;
+        }
+
+        for (int d = 0; d < DIM; ++d) {
+            ret.origin[d] -= width;
+            ret.dimensions[d] += 2 * width;
+
+            if (TOPOLOGY::wrapsAxis(d) &&
+                ((ret.origin[d] < gridBox.origin[d]) ||
+                 ((ret.origin[d] + ret.dimensions[d]) > (gridBox.origin[d] + gridBox.dimensions[d])))) {
+                ret.origin[d] = gridBox.origin[d];
+                ret.dimensions[d] = gridBox.dimensions[d];
+            }
+        }
+
+        return ret;
+    }
+
     inline long currentNanoStep() const
     {
         std::pair<int, int> now = updateGroup->currentStep();
         return (long)now.first * NANO_STEPS + now.second;
     }
 
+    /**
+     * Gathers the relative load (compute time vs. wall clock time
+     * since the last invocation) of all ranks and lets the
+     * LoadBalancer on rank 0 decide upon new weights. If these differ
+     * from the current ones the migration will be scheduled.
+     */
     inline void balanceLoad()
     {
-        if (mpiLayer.rank() == 0) {
-            if (!balancer) {
-                return;
+        const Chronometer& statistics = updateGroup->statistics();
+        double computeTime =
+            statistics.interval<TimeCompute>() - lastStatistics.interval<TimeCompute>();
+        double totalTime =
+            statistics.interval<TimeTotal>()   - lastStatistics.interval<TimeTotal>();
+        lastStatistics = statistics;
+
+        // same convention as Chronometer::ratio()
+        double myLoad = (totalTime == 0) ? 0.5 : (computeTime / totalTime);
+        LoadBalancer::LoadVec loads = mpiLayer.gather(myLoad, 0);
+        LoadBalancer::WeightVec newWeights;
+
+        if ((mpiLayer.rank() == 0) && balancer) {
+            newWeights = balancer->balance(updateGroup->getWeights(), loads);
+        }
+        newWeights = mpiLayer.broadcastVector(newWeights, 0);
+
+        if (newWeights.empty() || (newWeights == updateGroup->getWeights())) {
+            return;
+        }
+        if ((newWeights.size() != updateGroup->getWeights().size()) ||
+            (sum(newWeights) != sum(updateGroup->getWeights()))) {
+            throw std::invalid_argument("LoadBalancer returned weights which don't match the current ones");
+        }
+
+        // not worth the effort if the simulation will be over by then
+        if (timeToNextMigration() < timeToLastEvent()) {
+            pendingWeights = newWeights;
+        }
+    }
+
+    /**
+     * returns the number of nano steps until the subdomains are in a
+     * consistent state, i.e. the ghost zones have been synchronized
+     * and no time step is half-way done.
+     */
+    inline long timeToNextMigration() const
+    {
+        long nanoStep = currentNanoStep();
+        long ret = 0;
+
+        while ((((nanoStep + ret) - firstGroupNanoStep) % ghostZoneWidth) ||
+               ((nanoStep + ret) % NANO_STEPS)) {
+            ++ret;
+        }
+
+        return ret;
+    }
+
+    /**
+     * Redistributes the cells according to pendingWeights: each rank
+     * sends those cells of its current subdomain which are required
+     * by others (including their ghost zones) under the new
+     * decomposition, then a new UpdateGroup is set up which receives
+     * its initial state via a MigrationInitializer.
+     */
+    inline void migrate()
+    {
+        typedef typename UpdateGroupType::PatchLinkAccepter PatchLinkAccepter;
+        typedef typename UpdateGroupType::PatchLinkProvider PatchLinkProvider;
+        typedef typename UpdateGroupType::PatchLinkAccepterPtr PatchLinkAccepterPtr;
+        typedef typename UpdateGroupType::PatchLinkProviderPtr PatchLinkProviderPtr;
+
+        typename SharedPtr<PARTITION>::Type newPartition = makePartition(pendingWeights);
+        pendingWeights.clear();
+
+        CoordBox<DIM> box = initializer->gridBox();
+        PartitionManager<Topology> newPartitionManager;
+        newPartitionManager.resetRegions(
+            initializer,
+            box,
+            newPartition,
+            mpiLayer.rank(),
+            ghostZoneWidth);
+
+        std::size_t nanoStep = currentNanoStep();
+        unsigned step = nanoStep / NANO_STEPS;
+        Region<DIM> oldOwnRegion = partition->getRegion(mpiLayer.rank());
+        const Region<DIM>& newOwnExpandedRegion = newPartitionManager.ownExpandedRegion();
+
+        CoordBox<DIM> oldOwnBox = oldOwnRegion.boundingBox();
+        CoordBox<DIM> newOwnExpandedBox = newOwnExpandedRegion.boundingBox();
+
+        std::vector<PatchLinkAccepterPtr> outgoingLinks;
+        typename MigrationInitializerType::PatchProviderVec incomingLinks;
+
+        // Bounding boxes are much cheaper to obtain than Regions, so
+        // we use them to skip all ranks which can't be our neighbors:
+        for (int i = 0; i < mpiLayer.size(); ++i) {
+            Region<DIM> outgoing;
+            if (expandedBoundingBox(*newPartition, i, ghostZoneWidth, box).intersects(oldOwnBox)) {
+                outgoing = oldOwnRegion & newPartitionManager.getRegion(i, ghostZoneWidth);
             }
+            if (!outgoing.empty()) {
+                PatchLinkAccepterPtr link(
+                    new PatchLinkAccepter(
+                        outgoing,
+                        i,
+                        MPILayer::LOAD_MIGRATION,
+                        SerializationBuffer<CELL_TYPE>::cellMPIDataType(),
+                        mpiLayer.communicator()));
+                link->charge(nanoStep, nanoStep, 1);
+                link->put(updateGroup->grid(), oldOwnRegion, box.dimensions, nanoStep, mpiLayer.rank());
+                outgoingLinks << link;
+            }
+
+            Region<DIM> incoming;
+            if (partition->getBoundingBox(i).intersects(newOwnExpandedBox)) {
+                incoming = newOwnExpandedRegion & partition->getRegion(i);
+            }
+            if (!incoming.empty()) {
+                PatchLinkProviderPtr link(
+                    new PatchLinkProvider(
+                        incoming,
+                        i,
+                        MPILayer::LOAD_MIGRATION,
+                        SerializationBuffer<CELL_TYPE>::cellMPIDataType(),
+                        mpiLayer.communicator()));
+                link->charge(nanoStep, nanoStep, 1);
+                incomingLinks << link;
+            }
+        }
 
-            LoadBalancer::LoadVec loads(mpiLayer.size(), 1.0);
-            LoadBalancer::WeightVec newWeights =
-                balancer->balance(updateGroup->getWeights(), loads);
-            // fixme: actually balance the load!
+        // The new adapters for the ghost zone resume where the inner
+        // set adapters left off: the old UpdateGroup has already
+        // handled the ghost zone beyond the current time step, but
+        // that was done for the old subdomain.
+        for (std::size_t i = 0; i < writerAdaptersGhost.size(); ++i) {
+            writerAdaptersGhost[i].reset(
+                new ParallelWriterAdapterType(
+                    static_cast<const ParallelWriterAdapterType&>(*writerAdaptersInner[i]),
+                    false));
+        }
+        for (std::size_t i = 0; i < steererAdaptersGhost.size(); ++i) {
+            steererAdaptersGhost[i].reset(
+                new SteererAdapterType(
+                    static_cast<const SteererAdapterType&>(*steererAdaptersInner[i]),
+                    false));
         }
+
+        typename UpdateGroupType::InitPtr migrationInitializer(
+            new MigrationInitializerType(
+                initializer,
+                step,
+                updateGroup->grid().getEdge(),
+                incomingLinks));
+
+        // tear down the old UpdateGroup prior to setting up the new
+        // one, so the PatchLinks' pending transmissions get drained
+        chronometer += updateGroup->statistics();
+        updateGroup.reset();
+
+        partition = newPartition;
+        firstGroupNanoStep = nanoStep;
+        lastStatistics = Chronometer();
+
+        updateGroup.reset(
+            new UpdateGroupType(
+                partition,
+                box,
+                ghostZoneWidth,
+                migrationInitializer,
+                static_cast<STEPPER*>(0),
+                writerAdaptersGhost,
+                writerAdaptersInner,
+                steererAdaptersGhost,
+                steererAdaptersInner,
+                enableFineGrainedParallelism,
+                mpiLayer.communicator()));
     }
 };
 
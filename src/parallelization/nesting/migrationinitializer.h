@@ -0,0 +1,113 @@
+#ifndef LIBGEODECOMP_PARALLELIZATION_NESTING_MIGRATIONINITIALIZER_H
+#define LIBGEODECOMP_PARALLELIZATION_NESTING_MIGRATIONINITIALIZER_H
+
+#include <libgeodecomp/io/initializer.h>
+#include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/storage/patchprovider.h>
+#include <stdexcept>
+
+namespace LibGeoDecomp {
+
+/**
+ * The MigrationInitializer is used to hand over the state of a
+ * running simulation to a new UpdateGroup after the load balancer
+ * has changed the domain decomposition. It mimics the original
+ * Initializer, except that the simulation starts at the time step of
+ * the migration and that the grid is filled by a set of
+ * PatchProviders (usually PatchLinks connected to the previous
+ * owners of the cells) instead of computing the initial state.
+ */
+template<typename CELL_TYPE, typename GRID_TYPE>
+class MigrationInitializer : public Initializer<CELL_TYPE>
+{
+public:
+    typedef typename Initializer<CELL_TYPE>::AdjacencyPtr AdjacencyPtr;
+    typedef typename Initializer<CELL_TYPE>::Topology Topology;
+    typedef typename SharedPtr<Initializer<CELL_TYPE> >::Type InitPtr;
+    typedef typename SharedPtr<PatchProvider<GRID_TYPE> >::Type PatchProviderPtr;
+    typedef std::vector<PatchProviderPtr> PatchProviderVec;
+
+    static const int DIM = Topology::DIM;
+    static const unsigned NANO_STEPS = APITraits::SelectNanoSteps<CELL_TYPE>::VALUE;
+
+    /**
+     * The providers need to be charged for the nano step
+     * corresponding to startStep. They will be drained on the first
+     * call to grid(), subsequent calls will only reset the grid's
+     * edge cell.
+     */
+    MigrationInitializer(
+        InitPtr delegate,
+        unsigned startStep,
+        const CELL_TYPE& edgeCell,
+        const PatchProviderVec& providers) :
+        delegate(delegate),
+        myStartStep(startStep),
+        edgeCell(edgeCell),
+        providers(providers)
+    {}
+
+    virtual void grid(GridBase<CELL_TYPE, DIM> *target)
+    {
+        target->setEdge(edgeCell);
+        if (providers.empty()) {
+            return;
+        }
+
+        GRID_TYPE *grid = dynamic_cast<GRID_TYPE*>(target);
+        if (grid == 0) {
+            throw std::invalid_argument("MigrationInitializer can only fill grids of the Stepper's grid type");
+        }
+
+        Region<DIM> patchableRegion;
+        patchableRegion << grid->boundingBox();
+
+        for (typename PatchProviderVec::iterator i = providers.begin(); i != providers.end(); ++i) {
+            (*i)->get(
+                grid,
+                patchableRegion,
+                gridDimensions(),
+                myStartStep * NANO_STEPS,
+                0,
+                true);
+        }
+
+        // release the migration buffers as they'll never be read again
+        providers.clear();
+    }
+
+    virtual CoordBox<DIM> gridBox()
+    {
+        return delegate->gridBox();
+    }
+
+    virtual Coord<DIM> gridDimensions() const
+    {
+        return delegate->gridDimensions();
+    }
+
+    virtual unsigned startStep() const
+    {
+        return myStartStep;
+    }
+
+    virtual unsigned maxSteps() const
+    {
+        return delegate->maxSteps();
+    }
+
+    virtual AdjacencyPtr getAdjacency(const Region<DIM>& region) const
+    {
+        return delegate->getAdjacency(region);
+    }
+
+private:
+    InitPtr delegate;
+    unsigned myStartStep;
+    CELL_TYPE edgeCell;
+    PatchProviderVec providers;
+};
+
+}
+
+#endif
@@ -4,50 +4,153 @@
 #include <libgeodecomp/config.h>
 #ifdef LIBGEODECOMP_WITH_THREADS
 
-#include <libgeodecomp/parallelization/nesting/commonstepper.h>
-#include <libgeodecomp/storage/patchbufferfixed.h>
+#include <libgeodecomp/parallelization/nesting/vanillastepper.h>
 
 namespace LibGeoDecomp {
 
 /**
  * MultiCoreStepper is an OpenMP-enabled implementation of the Stepper
- * concept.
+ * concept. It updates the kernel with all threads, but does so in
+ * PROGRESS_CHUNKS slices. Between two slices all PatchAccepters and
+ * PatchProviders of the ghost zone are given the chance to progress
+ * their pending transmissions. Without this many MPI implementations
+ * would only complete the ghost zone exchange once the Stepper
+ * blocks in PatchLink::wait(), which effectively serializes
+ * communication and calculation.
  *
  * fixme: how to handle threading if user code has a multithreaded
  *        update() itself? (e.g. n-body codes)
  *
  * fixme: cache blocking?
- *
- * fixme: mpi pacing?
  */
-template<typename CELL_TYPE>
-class MultiCoreStepper : public CommonStepper<CELL_TYPE>
+template<typename CELL_TYPE, int PROGRESS_CHUNKS = 8>
+class MultiCoreStepper : public VanillaStepper<CELL_TYPE, UpdateFunctorHelpers::ConcurrencyEnableOpenMP>
 {
 public:
-    typedef typename Stepper<CELL_TYPE>::Topology Topology;
-    typedef typename Stepper<CELL_TYPE>::InitPtr InitPtr;
-    typedef typename Stepper<CELL_TYPE>::PartitionManagerPtr PartitionManagerPtr;
-    typedef class Stepper<CELL_TYPE> ParentType;
+    friend class MulticoreStepperTest;
+
+    typedef UpdateFunctorHelpers::ConcurrencyEnableOpenMP ConcurrencySpec;
+    typedef VanillaStepper<CELL_TYPE, ConcurrencySpec> ParentType;
+    typedef typename ParentType::Topology Topology;
     typedef typename ParentType::GridType GridType;
-    typedef PartitionManager<Topology> PartitionManagerType;
-    typedef PatchBufferFixed<GridType, GridType, 1> PatchBufferType1;
-    typedef PatchBufferFixed<GridType, GridType, 2> PatchBufferType2;
     typedef typename ParentType::PatchAccepterVec PatchAccepterVec;
+    typedef typename ParentType::PatchProviderVec PatchProviderVec;
+    typedef typename ParentType::InitPtr InitPtr;
+    typedef typename ParentType::PartitionManagerPtr PartitionManagerPtr;
 
     const static int DIM = Topology::DIM;
-    const static unsigned NANO_STEPS = APITraits::SelectNanoSteps<CELL_TYPE>::VALUE;
+
+    using ParentType::curNanoStep;
+    using ParentType::enableFineGrainedParallelism;
+    using ParentType::ghostZoneWidth;
+    using ParentType::innerSet;
+    using ParentType::newGrid;
+    using ParentType::oldGrid;
+    using ParentType::patchAccepters;
+    using ParentType::patchProviders;
 
     inline MultiCoreStepper(
         PartitionManagerPtr partitionManager,
         InitPtr initializer,
         const PatchAccepterVec& ghostZonePatchAccepters = PatchAccepterVec(),
-        const PatchAccepterVec& innerSetPatchAccepters = PatchAccepterVec()) :
-        CommonStepper<CELL_TYPE>(
+        const PatchAccepterVec& innerSetPatchAccepters = PatchAccepterVec(),
+        const PatchProviderVec& ghostZonePatchProvidersPhase0 = PatchProviderVec(),
+        const PatchProviderVec& ghostZonePatchProvidersPhase1 = PatchProviderVec(),
+        const PatchProviderVec& innerSetPatchProviders = PatchProviderVec(),
+        bool enableFineGrainedParallelism = false) :
+        ParentType(
             partitionManager,
             initializer,
             ghostZonePatchAccepters,
-            innerSetPatchAccepters)
+            innerSetPatchAccepters,
+            ghostZonePatchProvidersPhase0,
+            ghostZonePatchProvidersPhase1,
+            innerSetPatchProviders,
+            enableFineGrainedParallelism)
     {}
+
+protected:
+    /**
+     * The inner sets don't change during the lifetime of a Stepper,
+     * so we can afford to slice them up only once.
+     */
+    std::vector<std::vector<Region<DIM> > > innerSetChunks;
+
+    inline virtual void updateInnerSet(unsigned index)
+    {
+        const std::vector<Region<DIM> >& chunks = getInnerSetChunks(index);
+
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            UpdateFunctor<CELL_TYPE, ConcurrencySpec>()(
+                chunks[i],
+                Coord<DIM>(),
+                Coord<DIM>(),
+                *oldGrid,
+                &*newGrid,
+                curNanoStep,
+                ConcurrencySpec(false, enableFineGrainedParallelism));
+
+            progressCommunication();
+        }
+    }
+
+    inline const std::vector<Region<DIM> >& getInnerSetChunks(unsigned index)
+    {
+        if (innerSetChunks.empty()) {
+            innerSetChunks.resize(ghostZoneWidth() + 1);
+            for (unsigned i = 0; i <= ghostZoneWidth(); ++i) {
+                innerSetChunks[i] = sliceRegion(innerSet(i));
+            }
+        }
+
+        return innerSetChunks[index];
+    }
+
+    /**
+     * Splits the region along its slowest dimension into at most
+     * PROGRESS_CHUNKS slices. Each slice still contains enough
+     * planes to keep all threads busy.
+     */
+    static std::vector<Region<DIM> > sliceRegion(const Region<DIM>& region)
+    {
+        std::size_t numPlanes = region.numPlanes();
+        std::size_t numChunks = (std::min)(std::size_t(PROGRESS_CHUNKS), numPlanes);
+        std::vector<Region<DIM> > ret;
+
+        for (std::size_t c = 0; c < numChunks; ++c) {
+            std::size_t start = numPlanes * (c + 0) / numChunks;
+            std::size_t end   = numPlanes * (c + 1) / numChunks;
+
+            Region<DIM> chunk;
+            typename Region<DIM>::StreakIterator endIter = region.planeStreakIterator(end);
+            for (typename Region<DIM>::StreakIterator i = region.planeStreakIterator(start);
+                 i != endIter;
+                 ++i) {
+                chunk << *i;
+            }
+
+            ret << chunk;
+        }
+
+        return ret;
+    }
+
+    inline void progressCommunication()
+    {
+        for (int type = ParentType::GHOST_PHASE_0; type <= ParentType::GHOST_PHASE_1; ++type) {
+            for (typename ParentType::PatchAccepterList::iterator i = patchAccepters[type].begin();
+                 i != patchAccepters[type].end();
+                 ++i) {
+                (*i)->progress();
+            }
+
+            for (typename ParentType::PatchProviderList::iterator i = patchProviders[type].begin();
+                 i != patchProviders[type].end();
+                 ++i) {
+                (*i)->progress();
+            }
+        }
+    }
 };
 
 }
@@ -3,6 +3,7 @@
 
 #include <libgeodecomp/io/parallelwriter.h>
 #include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/misc/timelinetracer.h>
 #include <libgeodecomp/storage/patchaccepter.h>
 
 namespace LibGeoDecomp {
@@ -39,10 +40,29 @@ public:
         stride(writer->getPeriod() * NANO_STEPS),
         lastCall(lastCall)
     {
-        pushRequest(firstNanoStep);
+        if (!writer->isAllDoneOnly()) {
+            pushRequest(firstNanoStep);
+        }
         pushRequest(lastNanoStep);
     }
 
+    /**
+     * Creates an adapter which resumes the schedule of other, but
+     * forwards lastCall to the writer. This is required when a
+     * Simulator needs to set up a new Stepper mid-run (e.g. after
+     * migrating cells for load balancing).
+     */
+    ParallelWriterAdapter(
+        const ParallelWriterAdapter& other,
+        bool lastCall) :
+        PatchAccepter<GRID_TYPE>(other),
+        writer(other.writer),
+        firstNanoStep(other.firstNanoStep),
+        lastNanoStep(other.lastNanoStep),
+        stride(other.stride),
+        lastCall(lastCall)
+    {}
+
     virtual void setRegion(const Region<GRID_TYPE::DIM>& region)
     {
         writer->setRegion(region);
@@ -71,6 +91,7 @@ public:
             return;
         }
 
+        TimelineTracer::ScopedSpan span("parallel_writer");
         writer->stepFinished(
             grid,
             validRegion,
@@ -80,8 +101,10 @@ public:
             rank,
             lastCall);
         erase_min(requestedNanoSteps);
-        std::size_t nextNanoStep = nanoStep + stride;
-        pushRequest(nextNanoStep);
+        if (!writer->isAllDoneOnly()) {
+            std::size_t nextNanoStep = nanoStep + stride;
+            pushRequest(nextNanoStep);
+        }
     }
 
 private:
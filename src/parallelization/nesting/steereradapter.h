@@ -2,6 +2,7 @@
 #define LIBGEODECOMP_PARALLELIZATION_NESTING_STEERERADAPTER_H
 
 #include <libgeodecomp/io/steerer.h>
+#include <libgeodecomp/misc/timelinetracer.h>
 #include <libgeodecomp/storage/patchprovider.h>
 
 namespace LibGeoDecomp {
@@ -45,6 +46,22 @@ public:
         storedNanoSteps << lastNanoStep;
     }
 
+    /**
+     * Creates an adapter which resumes the schedule of other, but
+     * forwards lastCall to the steerer. This is required when a
+     * Simulator needs to set up a new Stepper mid-run (e.g. after
+     * migrating cells for load balancing).
+     */
+    SteererAdapter(
+        const SteererAdapter& other,
+        bool lastCall) :
+        PatchProvider<GRID_TYPE>(other),
+        steerer(other.steerer),
+        firstNanoStep(other.firstNanoStep),
+        lastNanoStep(other.lastNanoStep),
+        lastCall(lastCall)
+    {}
+
     virtual void setRegion(const Region<DIM>& region)
     {
         steerer->setRegion(region);
@@ -84,6 +101,7 @@ public:
 
         typename Steerer<CELL_TYPE>::SteererFeedback feedback;
 
+        TimelineTracer::ScopedSpan span("steerer");
         steerer->nextStep(
             destinationGrid,
             patchableRegion,
@@ -30,16 +30,63 @@ public:
         patchAccepter->pushRequest(13);
 
         partitionManager.reset(new PartitionManager<Topology>(rect));
-        // stepper.reset(
-        //     new StepperType(partitionManager, init));
+#ifdef LIBGEODECOMP_WITH_THREADS
+        stepper.reset(
+            new StepperType(partitionManager, init));
+
+        stepper->addPatchAccepter(patchAccepter, StepperType::GHOST_PHASE_0);
+#endif
+    }
+
+    void testUpdate1()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        TS_ASSERT_TEST_GRID(GridType, stepper->grid(), 0);
+        stepper->update(1);
+        TS_ASSERT_TEST_GRID(GridType, stepper->grid(), 1);
+#endif
+    }
+
+    void testUpdateMultiple()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        stepper->update(8);
+        TS_ASSERT_TEST_GRID(GridType, stepper->grid(), 8);
+        stepper->update(30);
+        TS_ASSERT_TEST_GRID(GridType, stepper->grid(), 38);
+#endif
+    }
+
+    void testPutPatch()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        stepper->update(9);
+        TS_ASSERT_EQUALS(std::size_t(2), patchAccepter->getOfferedNanoSteps().size());
 
-        // stepper->addPatchAccepter(patchAccepter, StepperType::GHOST);
+        stepper->update(4);
+        TS_ASSERT_EQUALS(std::size_t(3), patchAccepter->getOfferedNanoSteps().size());
+#endif
     }
 
-    void testFoo()
+    void testSliceRegion()
     {
 #ifdef LIBGEODECOMP_WITH_THREADS
-        std::cout << "fixme\n";
+        Region<2> region;
+        region << CoordBox<2>(Coord<2>(10, 20), Coord<2>(30, 21));
+        std::vector<Region<2> > chunks = StepperType::sliceRegion(region);
+        TS_ASSERT_EQUALS(std::size_t(8), chunks.size());
+
+        Region<2> sum;
+        for (std::size_t i = 0; i < chunks.size(); ++i) {
+            TS_ASSERT((sum & chunks[i]).empty());
+            TS_ASSERT(!chunks[i].empty());
+            sum += chunks[i];
+        }
+        TS_ASSERT_EQUALS(region, sum);
+
+        Region<2> smallRegion;
+        smallRegion << CoordBox<2>(Coord<2>(10, 20), Coord<2>(30, 3));
+        TS_ASSERT_EQUALS(std::size_t(3), StepperType::sliceRegion(smallRegion).size());
 #endif
     }
 
@@ -2,6 +2,8 @@
 #define LIBGEODECOMP_PARALLELIZATION_NESTING_VANILLASTEPPER_H
 
 #include <libgeodecomp/parallelization/nesting/commonstepper.h>
+#include <libgeodecomp/storage/gridvecconv.h>
+#include <libgeodecomp/storage/serializationbuffer.h>
 #include <libgeodecomp/storage/updatefunctor.h>
 
 namespace LibGeoDecomp {
@@ -13,6 +15,13 @@ namespace LibGeoDecomp {
  * calculation and support wide halos (halos = ghostzones). Ghost
  * zones of width k mean that synchronization only needs to be done
  * every k'th (nano) step.
+ *
+ * The ghost zone update runs on newGrid and a third grid, rimGrid,
+ * which keeps the rim for the next round of kernel updates. Thus
+ * the kernel is never touched by the ghost zone update (nor by
+ * PatchProviders acting on it) and needs no save/restore. Per cycle
+ * only the rim and the volatile kernel have to be exchanged between
+ * oldGrid and rimGrid.
  */
 template<typename CELL_TYPE, typename CONCURRENCY_SPEC>
 class VanillaStepper : public CommonStepper<CELL_TYPE>
@@ -43,16 +52,12 @@ public:
     using ParentType::chronometer;
 
     using ParentType::innerSet;
-    using ParentType::saveKernel;
-    using ParentType::restoreRim;
     using ParentType::globalNanoStep;
     using ParentType::rim;
     using ParentType::resetValidGhostZoneWidth;
     using ParentType::initGridsCommon;
     using ParentType::getVolatileKernel;
-    using ParentType::saveRim;
     using ParentType::getInnerRim;
-    using ParentType::restoreKernel;
 
     using ParentType::curStep;
     using ParentType::curNanoStep;
@@ -87,24 +92,41 @@ public:
         initGrids();
     }
 
+protected:
+    /**
+     * Updates innerSet(index) from oldGrid to newGrid. Derived
+     * classes may override this to interleave the update of the
+     * kernel with other tasks (e.g. to progress communication).
+     */
+    inline virtual void updateInnerSet(unsigned index)
+    {
+        UpdateFunctor<CELL_TYPE, CONCURRENCY_SPEC>()(
+            innerSet(index),
+            Coord<DIM>(),
+            Coord<DIM>(),
+            *oldGrid,
+            &*newGrid,
+            curNanoStep,
+            CONCURRENCY_SPEC(false, enableFineGrainedParallelism));
+    }
+
 private:
+    typedef typename SharedPtr<GridType>::Type GridPtr;
+    typedef typename SerializationBuffer<CELL_TYPE>::BufferType BufferType;
+
+    GridPtr rimGrid;
+    BufferType rimStagingBuffer;
+    BufferType kernelStagingBuffer;
+
     inline void update1()
     {
         using std::swap;
         TimeTotal t(&chronometer);
         unsigned index = ghostZoneWidth() - --validGhostZoneWidth;
-        const Region<DIM>& region = innerSet(index);
         {
             TimeComputeInner t(&chronometer);
 
-            UpdateFunctor<CELL_TYPE, CONCURRENCY_SPEC>()(
-                region,
-                Coord<DIM>(),
-                Coord<DIM>(),
-                *oldGrid,
-                &*newGrid,
-                curNanoStep,
-                CONCURRENCY_SPEC(false, enableFineGrainedParallelism));
+            updateInnerSet(index);
             swap(oldGrid, newGrid);
 
             ++curNanoStep;
@@ -128,7 +150,15 @@ private:
 
     inline void initGrids()
     {
-        initGridsCommon();
+        CoordBox<DIM> gridBox = initGridsCommon();
+        rimGrid.reset(new GridType(gridBox, CELL_TYPE(), CELL_TYPE(), initializer->gridDimensions()));
+        *rimGrid = *oldGrid;
+        rimStagingBuffer = SerializationBuffer<CELL_TYPE>::create(rim());
+        kernelStagingBuffer = SerializationBuffer<CELL_TYPE>::create(getVolatileKernel());
+        // we don't save/restore the kernel, so CommonStepper's
+        // PatchBuffers would just occupy memory:
+        rimBuffer = PatchBufferType2();
+        kernelBuffer = PatchBufferType1();
 
         this->notifyPatchAccepters(
             rim(),
@@ -139,7 +169,6 @@ private:
             ParentType::INNER_SET,
             globalNanoStep());
 
-        saveRim(globalNanoStep());
         updateGhost();
     }
 
@@ -147,10 +176,9 @@ private:
      * computes the next ghost zone at time "t_1 = globalNanoStep() +
      * ghostZoneWidth()". Expects that oldGrid has its kernel and its
      * outer ghostzone updated to time "globalNanoStep()" and that the
-     * inner ghostzones (rim) at time t_1 can be retrieved from the
-     * internal patch buffer. Will leave oldgrid in a state so that
-     * its whole ownRegion() will be at time t_1 and the rim will be
-     * saved to the patchBuffer at "t2 = t1 + ghostZoneWidth()".
+     * inner ghostzones (rim) at that time can be found in rimGrid.
+     * Will leave oldGrid's whole ownRegion() at time
+     * "globalNanoStep()" and the rim at time t_1 in rimGrid.
      */
     inline void updateGhost()
     {
@@ -158,23 +186,24 @@ private:
         {
             TimeComputeGhost t(&chronometer);
 
-            // fixme: skip all this ghost zone buffering for
-            // ghostZoneWidth == 1?
-
-            // 1: Prepare grid. The following update of the ghostzone will
-            // destroy parts of the kernel, which is why we'll
-            // save/restore those.
-            saveKernel();
-            // We need to restore the rim since it got destroyed while the
-            // kernel was updated.
-            restoreRim(false);
+            // 1: The kernel update has overwritten parts of the rim
+            // with intermediate results, so we need to put it back.
+            // In turn rimGrid receives the part of the kernel on
+            // which the ghost zone update depends:
+            paste(*rimGrid, &*oldGrid, rim(), &rimStagingBuffer);
+            paste(*oldGrid, &*rimGrid, getVolatileKernel(), &kernelStagingBuffer);
         }
 
-        // 2: actual ghostzone update
+        // 2: actual ghostzone update. It alternates between rimGrid
+        // and newGrid, so oldGrid's kernel remains intact, even if
+        // PatchProviders (e.g. Steerers) modify the source grid:
         std::size_t oldNanoStep = curNanoStep;
         std::size_t oldStep = curStep;
         std::size_t curGlobalNanoStep = globalNanoStep();
 
+        GridPtr kernelGrid = oldGrid;
+        oldGrid = rimGrid;
+
         for (std::size_t t = 0; t < ghostZoneWidth(); ++t) {
             this->notifyPatchProviders(rim(t), ParentType::GHOST_PHASE_0, globalNanoStep());
             this->notifyPatchProviders(rim(t), ParentType::GHOST_PHASE_1, globalNanoStep());
@@ -206,19 +235,45 @@ private:
             this->notifyPatchAccepters(rim(ghostZoneWidth()), ParentType::GHOST_PHASE_0, curGlobalNanoStep);
         }
 
-        {
-            TimeComputeGhost t(&chronometer);
+        // 3: restore grids for kernel update. Whichever grid received
+        // the last ghost step becomes the new rimGrid, the other one
+        // serves as scratch space for the kernel:
+        rimGrid = oldGrid;
+        oldGrid = kernelGrid;
+        curNanoStep = oldNanoStep;
+        curStep = oldStep;
+    }
 
-            saveRim(curGlobalNanoStep);
-            if (ghostZoneWidth() % 2) {
-                swap(oldGrid, newGrid);
-            }
+    /**
+     * Copies the cells in region from source to target. Generic
+     * grids are staged via GridVecConv, just like PatchBufferFixed
+     * does it.
+     */
+    template<typename GRID_TYPE>
+    inline void paste(
+        const GRID_TYPE& source,
+        GRID_TYPE *target,
+        const Region<DIM>& region,
+        BufferType *buffer)
+    {
+        GridVecConv::gridToVector(source, buffer, region);
+        GridVecConv::vectorToGrid(*buffer, target, region);
+    }
 
-            // 3: restore grid for kernel update
-            curNanoStep = oldNanoStep;
-            curStep = oldStep;
-            restoreRim(true);
-            restoreKernel();
+    /**
+     * DisplacedGrids store streaks contiguously, so we can copy them
+     * directly.
+     */
+    template<typename TOPOLOGY, bool TOPOLOGICALLY_CORRECT>
+    inline void paste(
+        const DisplacedGrid<CELL_TYPE, TOPOLOGY, TOPOLOGICALLY_CORRECT>& source,
+        DisplacedGrid<CELL_TYPE, TOPOLOGY, TOPOLOGICALLY_CORRECT> *target,
+        const Region<DIM>& region,
+        BufferType * /* buffer */)
+    {
+        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            const CELL_TYPE *start = &source[i->origin];
+            std::copy(start, start + i->length(), &(*target)[i->origin]);
         }
     }
 };
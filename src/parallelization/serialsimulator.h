@@ -48,12 +48,10 @@ public:
     explicit SerialSimulator(Initializer<CELL_TYPE> *initializer) :
         MonolithicSimulator<CELL_TYPE>(initializer)
     {
-        stepNum = initializer->startStep();
         Coord<DIM> dim = initializer->gridBox().dimensions;
         curGrid = new GridType(CoordBox<DIM>(Coord<DIM>(), dim));
         newGrid = new GridType(CoordBox<DIM>(Coord<DIM>(), dim));
-        initializer->grid(curGrid);
-        initializer->grid(newGrid);
+        initGrids();
 
         CoordBox<DIM> box = curGrid->boundingBox();
         simArea << box;
@@ -79,6 +77,7 @@ public:
         TimeTotal t(&chronometer);
 
         handleInput(STEERER_NEXT_STEP, feedback);
+        gridsPristine = false;
 
         for (unsigned i = 0; i < NANO_STEPS; ++i) {
             nanoStep(i);
@@ -93,8 +92,11 @@ public:
      */
     virtual void run()
     {
-        initializer->grid(curGrid);
-        stepNum = initializer->startStep();
+        // the constructor has already set up the grids, we only need
+        // to reset them if the simulation has been advanced since:
+        if (!gridsPristine) {
+            initGrids();
+        }
         setIORegions();
 
         SteererFeedback feedback;
@@ -125,6 +127,16 @@ protected:
     GridType *curGrid;
     GridType *newGrid;
     Region<DIM> simArea;
+    bool gridsPristine;
+
+    void initGrids()
+    {
+        stepNum = initializer->startStep();
+        initializer->grid(curGrid);
+        // cheaper than running the Initializer a second time:
+        *newGrid = *curGrid;
+        gridsPristine = true;
+    }
 
     virtual void nanoStep(unsigned nanoStep)
     {
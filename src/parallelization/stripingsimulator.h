@@ -282,6 +282,10 @@ private:
     void handleOutput(WriterEvent event)
     {
         for(unsigned i = 0; i < writers.size(); i++) {
+            if (writers[i]->isAllDoneOnly() && (event != WRITER_ALL_DONE)) {
+                continue;
+            }
+
             if ((event != WRITER_STEP_FINISHED) ||
                 ((getStep() % writers[i]->getPeriod()) == 0)) {
                 writers[i]->stepFinished(
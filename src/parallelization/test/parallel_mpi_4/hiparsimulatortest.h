@@ -1,4 +1,6 @@
 #include <libgeodecomp.h>
+#include <libgeodecomp/geometry/regionbasedadjacency.h>
+#include <libgeodecomp/geometry/partitions/unstructuredstripingpartition.h>
 #include <libgeodecomp/geometry/partitions/zcurvepartition.h>
 #include <libgeodecomp/io/mocksteerer.h>
 #include <libgeodecomp/io/mockwriter.h>
@@ -11,6 +13,7 @@
 #include <libgeodecomp/misc/testcell.h>
 #include <libgeodecomp/misc/testhelper.h>
 #include <libgeodecomp/parallelization/hiparsimulator.h>
+#include <libgeodecomp/parallelization/nesting/multicorestepper.h>
 
 #include <cxxtest/TestSuite.h>
 #include <sstream>
@@ -61,6 +64,121 @@ private:
     std::size_t cellsSeen;
 };
 
+/**
+ * Moves a tenth of the first rank's cells to the last rank with each
+ * invocation, regardless of the measured loads. Good for exercising
+ * the migration code.
+ */
+class ShiftingBalancer : public LoadBalancer
+{
+public:
+    virtual WeightVec balance(const WeightVec& weights, const LoadVec& relativeLoads)
+    {
+        WeightVec ret = weights;
+        std::size_t delta = ret.front() / 10;
+        ret.front() -= delta;
+        ret.back()  += delta;
+        return ret;
+    }
+};
+
+/**
+ * Unstructured model which links each node to the node on the
+ * opposite side of the grid. Regions expanded along this adjacency
+ * are far from being contiguous, so this catches code which assumes
+ * that ghost zones are geometrically close to their owners.
+ */
+class RemoteNeighborCell
+{
+public:
+    class API :
+        public APITraits::HasUnstructuredTopology,
+        public APITraits::HasOpaqueMPIDataType<RemoteNeighborCell>
+    {};
+
+    static const int NUM_NODES = 1000;
+
+    explicit RemoteNeighborCell(int id = -1, int step = 0) :
+        id(id),
+        step(step),
+        valid(true)
+    {}
+
+    static int remoteNeighbor(int id)
+    {
+        return (id + NUM_NODES / 2) % NUM_NODES;
+    }
+
+    template<typename HOOD>
+    void update(const HOOD& hood, int /* nanoStep */)
+    {
+        *this = hood[hood.index()];
+        const RemoteNeighborCell& neighbor = hood[remoteNeighbor(id)];
+        valid = valid && (neighbor.id == remoteNeighbor(id)) && (neighbor.step == step);
+        ++step;
+    }
+
+    int id;
+    int step;
+    bool valid;
+};
+
+class RemoteNeighborInitializer : public SimpleInitializer<RemoteNeighborCell>
+{
+public:
+    RemoteNeighborInitializer(unsigned steps) :
+        SimpleInitializer<RemoteNeighborCell>(Coord<1>(RemoteNeighborCell::NUM_NODES), steps)
+    {}
+
+    virtual void grid(GridBase<RemoteNeighborCell, 1> *target)
+    {
+        CoordBox<1> box = target->boundingBox();
+        for (CoordBox<1>::Iterator i = box.begin(); i != box.end(); ++i) {
+            target->set(*i, RemoteNeighborCell(i->x()));
+        }
+    }
+
+    virtual AdjacencyPtr getAdjacency(const Region<1>& region) const
+    {
+        AdjacencyPtr adjacency(new RegionBasedAdjacency());
+
+        for (Region<1>::Iterator i = region.begin(); i != region.end(); ++i) {
+            adjacency->insert(i->x(), RemoteNeighborCell::remoteNeighbor(i->x()));
+        }
+
+        return adjacency;
+    }
+};
+
+/**
+ * Checks that all cells have been updated to the current time step
+ * and never saw a stale neighbor.
+ */
+class RemoteNeighborVerifier : public Clonable<ParallelWriter<RemoteNeighborCell>, RemoteNeighborVerifier>
+{
+public:
+    RemoteNeighborVerifier() :
+        Clonable<ParallelWriter<RemoteNeighborCell>, RemoteNeighborVerifier>("", 1)
+    {}
+
+    virtual void stepFinished(
+        const GridType& grid,
+        const RegionType& validRegion,
+        const CoordType& globalDimensions,
+        unsigned step,
+        WriterEvent event,
+        std::size_t rank,
+        bool lastCall)
+    {
+        for (RegionType::Iterator i = validRegion.begin(); i != validRegion.end(); ++i) {
+            RemoteNeighborCell cell = grid.get(*i);
+            TS_ASSERT_EQUALS(i->x(), cell.id);
+            TS_ASSERT_EQUALS(int(step), cell.step);
+            TS_ASSERT(cell.valid);
+        }
+    }
+};
+
 class HiParSimulatorTest : public CxxTest::TestSuite
 {
 public:
@@ -161,12 +279,17 @@ public:
         TS_ASSERT_EQUALS(dim, grids[t].getDimensions());
 
         if (MPILayer().rank() == 0) {
-            std::string expectedEvents;
-            for (int i = 0; i < 2; ++i) {
-                expectedEvents += "balance() [1415, 1415, 1415, 1416] [1, 1, 1, 1]\n";
+            // relative loads are measured, hence we can only check the weights here
+            std::string expectedPrefix = "balance() [1415, 1415, 1415, 1416] [";
+            std::stringstream events(MockBalancer::events);
+            std::string line;
+            int counter = 0;
+
+            while (std::getline(events, line)) {
+                TS_ASSERT_EQUALS(expectedPrefix, line.substr(0, expectedPrefix.size()));
+                ++counter;
             }
-
-            TS_ASSERT_EQUALS(expectedEvents, MockBalancer::events);
+            TS_ASSERT_EQUALS(2, counter);
         }
     }
 
@@ -1265,6 +1388,87 @@ public:
 #endif
     }
 
+    void testLoadBalancingMigration()
+    {
+        ghostZoneWidth = 3;
+        loadBalancingPeriod = 7;
+        sim.reset(new SimulatorType(
+                      new TestInitializer<TestCell<2> >(dim, maxSteps, firstStep),
+                      new ShiftingBalancer(),
+                      loadBalancingPeriod,
+                      ghostZoneWidth));
+        memoryWriter = new MemoryWriterType(outputPeriod);
+        sim->addWriter(memoryWriter);
+        sim->run();
+
+        std::vector<std::size_t> weights = sim->updateGroup->getWeights();
+        TS_ASSERT_EQUALS(std::size_t(dim.prod()), sum(weights));
+        TS_ASSERT_LESS_THAN(weights.front(), std::size_t(1415));
+        TS_ASSERT_LESS_THAN(std::size_t(1416), weights.back());
+
+        MemoryWriterType::GridMap& grids = memoryWriter->getGrids();
+        for (unsigned t = firstStep; t < maxSteps; t += outputPeriod) {
+            TS_ASSERT_TEST_GRID(
+                MemoryWriterType::GridType,
+                grids[t],
+                t * NANO_STEPS);
+            TS_ASSERT_EQUALS(dim, grids[t].getDimensions());
+        }
+        TS_ASSERT_TEST_GRID(
+            MemoryWriterType::GridType,
+            grids[maxSteps],
+            maxSteps * NANO_STEPS);
+    }
+
+    void testLoadBalancingMigrationWithRemoteNeighbors()
+    {
+        HiParSimulator<RemoteNeighborCell, UnstructuredStripingPartition> sim(
+            new RemoteNeighborInitializer(30),
+            new ShiftingBalancer(),
+            7,
+            2);
+        sim.addWriter(new RemoteNeighborVerifier());
+        sim.run();
+    }
+
+    void testLoadBalancingMigrationWithNonPoDCell()
+    {
+#ifdef LIBGEODECOMP_WITH_BOOST_SERIALIZATION
+
+        HiParSimulator<NonPoDTestCell, ZCurvePartition<2> > sim(
+            new NonPoDTestCell::Initializer(),
+            new ShiftingBalancer(),
+            3,
+            2);
+        sim.run();
+
+#endif
+    }
+
+    void testMultiCoreStepper()
+    {
+#ifdef LIBGEODECOMP_WITH_THREADS
+        typedef HiParSimulator<TestCell<2>, ZCurvePartition<2>, MultiCoreStepper<TestCell<2> > > MultiCoreSimulatorType;
+
+        MultiCoreSimulatorType sim(
+            new TestInitializer<TestCell<2> >(dim, maxSteps, firstStep),
+            new MockBalancer(),
+            loadBalancingPeriod,
+            ghostZoneWidth);
+        memoryWriter = new MemoryWriterType(outputPeriod);
+        sim.addWriter(memoryWriter);
+        sim.run();
+
+        MemoryWriterType::GridMap& grids = memoryWriter->getGrids();
+        for (unsigned t = firstStep; t < maxSteps; t += outputPeriod) {
+            TS_ASSERT_TEST_GRID(
+                MemoryWriterType::GridType,
+                grids[t],
+                t * NANO_STEPS);
+        }
+#endif
+    }
+
     void testIO( )
     {
         sim->addWriter(new AccumulatingWriter());
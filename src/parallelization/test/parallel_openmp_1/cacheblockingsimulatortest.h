@@ -2,124 +2,192 @@
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <libgeodecomp/io/mocksteerer.h>
+#include <libgeodecomp/io/mockwriter.h>
 #include <libgeodecomp/io/testinitializer.h>
 #include <libgeodecomp/misc/sharedptr.h>
 #include <libgeodecomp/misc/stdcontaineroverloads.h>
 #include <libgeodecomp/misc/testcell.h>
 #include <libgeodecomp/misc/testhelper.h>
 #include <libgeodecomp/parallelization/cacheblockingsimulator.h>
+#include <libgeodecomp/parallelization/serialsimulator.h>
 
 using namespace LibGeoDecomp;
 
 namespace LibGeoDecomp {
 
+/**
+ * Counts how often the grid gets initialized.
+ */
+template<typename CELL>
+class CountingTestInitializer : public TestInitializer<CELL>
+{
+public:
+    CountingTestInitializer(const Coord<3>& dim, unsigned maxSteps, int *counter) :
+        TestInitializer<CELL>(dim, maxSteps, 0),
+        counter(counter)
+    {}
+
+    virtual void grid(GridBase<CELL, 3> *target)
+    {
+        ++*counter;
+        TestInitializer<CELL>::grid(target);
+    }
+
+private:
+    int *counter;
+};
+
 class CacheBlockingSimulatorTest : public CxxTest::TestSuite
 {
 public:
+    class LineUpdateAPI :
+        public APITraits::HasUpdateLineX,
+        public APITraits::HasFixedCoordsOnlyUpdate
+    {};
+
     typedef TestCell<3, Stencils::Moore<3, 1>, Topologies::Cube<3>::Topology> TestCellType;
+    typedef TestCell<3, Stencils::Moore<3, 1>, Topologies::Torus<3>::Topology> TorusCellType;
+    typedef TestCell<2, Stencils::Moore<2, 1>, Topologies::Cube<2>::Topology> TestCellType2D;
+    typedef TestCell<2, Stencils::Moore<2, 1>, Topologies::Torus<2>::Topology> TorusCellType2D;
+    typedef TestCell<3, Stencils::Moore<3, 1>, Topologies::Cube<3>::Topology, LineUpdateAPI> LineUpdateCellType;
+    typedef TestCell<3, Stencils::Moore<3, 1>, Topologies::Torus<3>::Topology, LineUpdateAPI> LineUpdateTorusCellType;
+
+    void testHop3D()
+    {
+        checkHops<TestCellType>(Coord<3>(40, 30, 20), 5, Coord<2>(16, 16));
+        checkHops<TestCellType>(Coord<3>(40, 30, 20), 7, Coord<2>(16, 16));
+        checkHops<TestCellType>(Coord<3>(40, 30, 20), 1, Coord<2>(16, 16));
+    }
 
-    void setUp()
+    void testHop3DTorus()
     {
+        checkHops<TorusCellType>(Coord<3>(40, 30, 20), 5, Coord<2>(16, 16));
+        checkHops<TorusCellType>(Coord<3>(17, 13, 11), 3, Coord<2>( 5,  4));
     }
 
-    void tearDown()
+    void testHop2D()
     {
-        // sim.reset();
+        checkHops<TestCellType2D>(Coord<2>(50, 40), 5, Coord<1>(16));
+        checkHops<TorusCellType2D>(Coord<2>(50, 40), 5, Coord<1>(16));
     }
 
-    void testPipelinedUpdate()
+    void testHopWithLineUpdates()
     {
-//         init(Coord<3>(40, 1, 20));
-
-//         sim->buffer.atEdge() = sim->curGrid->atEdge();
-//         sim->buffer.fill(sim->buffer.boundingBox(), sim->curGrid->getEdgeCell());
-//         sim->fixBufferOrigin(Coord<2>(0, 0));
-//         int i = 0;
-
-//         for (; i < 2 * pipelineLength - 2; ++i) {
-//             int lastStage = (i >> 1) + 1;
-//             sim->pipelinedUpdate(Coord<2>(0, 0), i, i, 0, lastStage);
-//         }
-//         for (; i < dim.z(); ++i) {
-//             sim->pipelinedUpdate(Coord<2>(0, 0), i, i, 0, pipelineLength);
-//         }
-//         for (; i < (dim.z() + 2 * pipelineLength - 2); ++i) {
-//             int firstStage = ((i - dim.z() + 1) >> 1);
-//             sim->pipelinedUpdate(Coord<2>(0, 0), i, i, firstStage, pipelineLength);
-//         }
-//     }
-
-//     void testUpdateWavefront()
-//     {
-//         init(Coord<3>(40, 30, 20));
-
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid), 0);
-//         sim->updateWavefront(Coord<2>(0, 0));
-//         sim->updateWavefront(Coord<2>(1, 0));
-//         sim->updateWavefront(Coord<2>(2, 0));
-
-//         sim->updateWavefront(Coord<2>(0, 1));
-//         sim->updateWavefront(Coord<2>(1, 1));
-//         sim->updateWavefront(Coord<2>(2, 1));
-
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->newGrid), pipelineLength);
-//     }
-
-//     void testHop1()
-//     {
-//         init(Coord<3>(40, 30, 20));
-
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid),  0);
-//         sim->hop();
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid),  5);
-//         sim->hop();
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid), 10);
-//         sim->hop();
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid), 15);
-//     }
-
-//     void testHop2()
-//     {
-//         init(Coord<3>(40, 30, 20), 7);
-
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid),  0);
-//         sim->hop();
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid),  7);
-//         sim->hop();
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid), 14);
-//         sim->hop();
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid), 21);
-//     }
-
-//     void testHop3()
-//     {
-//         init(Coord<3>(40, 30, 20), 1);
-
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid),  0);
-//         sim->hop();
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid),  1);
-//         sim->hop();
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid),  2);
-//         sim->hop();
-//         TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *(sim->curGrid),  3);
-//     }
-
-// private:
-//     int pipelineLength;
-//     Coord<3> dim;
-//     SharedPtr<CacheBlockingSimulator<TestCellType> >::Type sim;
-
-//     void init(const Coord<3>& gridDim, int newPipelineLength = 5, const Coord<2> wavefrontDim = Coord<2>(16, 16))
-//     {
-//         pipelineLength = newPipelineLength;
-//         dim = gridDim;
-//         sim.reset(new CacheBlockingSimulator<TestCellType>(
-//                       new TestInitializer<TestCellType>(
-//                           dim,
-//                           10000,
-//                           0),
-//                       pipelineLength,
-//                       wavefrontDim));
+        checkHops<LineUpdateCellType>(Coord<3>(40, 30, 20), 4, Coord<2>(16, 16));
+        checkHops<LineUpdateTorusCellType>(Coord<3>(40, 30, 20), 4, Coord<2>(16, 16));
+    }
+
+    void testStep()
+    {
+        Coord<3> dim(20, 20, 10);
+        CacheBlockingSimulator<TestCellType> sim(new TestInitializer<TestCellType>(dim, 100, 0), 5, Coord<2>(8, 8));
+
+        sim.step();
+        TS_ASSERT_EQUALS(1u, sim.getStep());
+        TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *sim.curGrid, TestCellType::NANO_STEPS);
+
+        sim.step();
+        TS_ASSERT_EQUALS(2u, sim.getStep());
+        TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *sim.curGrid, 2 * TestCellType::NANO_STEPS);
+    }
+
+    void testInitializerRunsOncePerSimulation()
+    {
+        int counter = 0;
+        Coord<3> dim(20, 20, 10);
+        CacheBlockingSimulator<TestCellType> sim(
+            new CountingTestInitializer<TestCellType>(dim, 10, &counter), 5, Coord<2>(8, 8));
+        TS_ASSERT_EQUALS(1, counter);
+
+        sim.run();
+        TS_ASSERT_EQUALS(1, counter);
+        TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *sim.curGrid, 10 * TestCellType::NANO_STEPS);
+
+        // grids have been advanced, so a second run needs to reset them:
+        sim.run();
+        TS_ASSERT_EQUALS(2, counter);
+        TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *sim.curGrid, 10 * TestCellType::NANO_STEPS);
+    }
+
+    void testRunMatchesSerialSimulatorIO()
+    {
+        Coord<3> dim(24, 20, 12);
+        unsigned maxSteps = 23;
+
+        SharedPtr<MockWriter<TestCellType>::EventsStore>::Type expectedWriterEvents(new MockWriter<TestCellType>::EventsStore);
+        SharedPtr<MockWriter<TestCellType>::EventsStore>::Type actualWriterEvents(new MockWriter<TestCellType>::EventsStore);
+        SharedPtr<MockSteerer<TestCellType>::EventsStore>::Type expectedSteererEvents(new MockSteerer<TestCellType>::EventsStore);
+        SharedPtr<MockSteerer<TestCellType>::EventsStore>::Type actualSteererEvents(new MockSteerer<TestCellType>::EventsStore);
+
+        {
+            SerialSimulator<TestCellType> sim(new TestInitializer<TestCellType>(dim, maxSteps, 2));
+            sim.addWriter(new MockWriter<TestCellType>(expectedWriterEvents, 4));
+            sim.addSteerer(new MockSteerer<TestCellType>(7, expectedSteererEvents));
+            sim.run();
+        }
+
+        {
+            CacheBlockingSimulator<TestCellType> sim(new TestInitializer<TestCellType>(dim, maxSteps, 2), 5, Coord<2>(8, 8));
+            sim.addWriter(new MockWriter<TestCellType>(actualWriterEvents, 4));
+            sim.addSteerer(new MockSteerer<TestCellType>(7, actualSteererEvents));
+            sim.run();
+
+            TS_ASSERT_EQUALS(maxSteps, sim.getStep());
+            TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *sim.curGrid, maxSteps * TestCellType::NANO_STEPS);
+        }
+
+        TS_ASSERT_EQUALS(*expectedWriterEvents, *actualWriterEvents);
+        TS_ASSERT_EQUALS(*expectedSteererEvents, *actualSteererEvents);
+    }
+
+    void testAutoTune()
+    {
+        int pipelineLength;
+        Coord<2> wavefrontDim;
+
+        CacheBlockingSimulator<TestCellType>::autoTune(
+            Coord<3>(512, 512, 512), 1024 * 1024, 4, &pipelineLength, &wavefrontDim);
+        TS_ASSERT(pipelineLength > 1);
+        TS_ASSERT(wavefrontDim.x() >= 4 * pipelineLength);
+        TS_ASSERT_EQUALS(wavefrontDim.x(), wavefrontDim.y());
+
+        std::size_t halo = 2 * pipelineLength;
+        std::size_t bufferVolume = pipelineLength * 3 * (wavefrontDim.x() + halo) * (wavefrontDim.y() + halo);
+        TS_ASSERT(bufferVolume * sizeof(TestCellType) <= 512 * 1024);
+
+        // small grids need to be split up among all threads:
+        CacheBlockingSimulator<TestCellType>::autoTune(
+            Coord<3>(64, 64, 64), 64 * 1024 * 1024, 16, &pipelineLength, &wavefrontDim);
+        TS_ASSERT(((64 + wavefrontDim.x() - 1) / wavefrontDim.x()) *
+                  ((64 + wavefrontDim.y() - 1) / wavefrontDim.y()) >= 16);
+
+        // ...but rows are left intact if possible:
+        CacheBlockingSimulator<TestCellType>::autoTune(
+            Coord<3>(64, 64, 64), 64 * 1024 * 1024, 2, &pipelineLength, &wavefrontDim);
+        TS_ASSERT_EQUALS(64, wavefrontDim.x());
+        TS_ASSERT_EQUALS(32, wavefrontDim.y());
+        TS_ASSERT(pipelineLength > 1);
+
+        CacheBlockingSimulator<TestCellType> sim(new TestInitializer<TestCellType>(Coord<3>(30, 20, 10), 3, 0));
+        sim.run();
+        TS_ASSERT_TEST_GRID(CacheBlockingSimulator<TestCellType>::GridType, *sim.curGrid, 3 * TestCellType::NANO_STEPS);
+    }
+
+private:
+    template<typename CELL>
+    void checkHops(const Coord<CELL::DIMENSIONS>& dim, int pipelineLength, const Coord<CELL::DIMENSIONS - 1>& wavefrontDim)
+    {
+        typedef CacheBlockingSimulator<CELL> SimulatorType;
+        typedef typename SimulatorType::GridType GridType;
+
+        SimulatorType sim(new TestInitializer<CELL>(dim, 10000, 0), pipelineLength, wavefrontDim);
+        TS_ASSERT_TEST_GRID2(GridType, *sim.curGrid, 0, typename);
+
+        for (int i = 1; i <= 3; ++i) {
+            sim.hop(pipelineLength);
+            TS_ASSERT_TEST_GRID2(GridType, *sim.curGrid, i * pipelineLength, typename);
+        }
     }
 };
 
@@ -7,7 +7,9 @@
 #include <libgeodecomp/misc/simplexoptimizer.h>
 #include <libgeodecomp/misc/simulationfactory.h>
 #include <libgeodecomp/misc/simulationparameters.h>
+#include <libgeodecomp/misc/tempfile.h>
 #include <libgeodecomp/parallelization/autotuningsimulator.h>
+#include <cstdio>
 #include <sstream>
 
 using namespace LibGeoDecomp;
@@ -157,6 +159,49 @@ public:
 #endif
     }
 
+    void testSuccessiveHalvingAndCache()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        std::string cacheFile = TempFile::serial("autotuningcache");
+        AutoTuningSimulator<SimFabTestCell, PatternOptimizer> ats(
+            new SimFabTestInitializer(Coord<3>(10, 10, 10), maxSteps));
+        ats.setCacheFile(cacheFile);
+        ats.enableSuccessiveHalving(4);
+        TS_ASSERT_THROWS(ats.enableSuccessiveHalving(0), std::invalid_argument&);
+
+        std::string best;
+        TS_ASSERT(!ats.loadFromCache(&best));
+
+        ats.runSuccessiveHalving(8);
+        best = ats.getBestSim();
+        TS_ASSERT(!best.empty());
+        TS_ASSERT_LESS_THAN(ats.getSimulation(best)->fitness, 0);
+        ats.storeInCache(best);
+
+        AutoTuningSimulator<SimFabTestCell, PatternOptimizer> ats2(
+            new SimFabTestInitializer(Coord<3>(10, 10, 10), maxSteps));
+        ats2.setCacheFile(cacheFile);
+        std::string cached;
+        TS_ASSERT(ats2.loadFromCache(&cached));
+        TS_ASSERT_EQUALS(best, cached);
+
+        const SimulationParameters& expected = ats.getSimulation(best)->parameters;
+        const SimulationParameters& actual = ats2.getSimulation(cached)->parameters;
+        TS_ASSERT_EQUALS(expected.size(), actual.size());
+        for (std::size_t i = 0; i < expected.size(); ++i) {
+            TS_ASSERT_EQUALS(expected[i].getValue(), actual[i].getValue());
+        }
+
+        // the grid size is part of the key:
+        AutoTuningSimulator<SimFabTestCell, PatternOptimizer> ats3(
+            new SimFabTestInitializer(Coord<3>(11, 10, 10), maxSteps));
+        ats3.setCacheFile(cacheFile);
+        TS_ASSERT(!ats3.loadFromCache(&cached));
+
+        remove(cacheFile.c_str());
+#endif
+    }
+
 private:
     Coord<3> dim;
     unsigned maxSteps;
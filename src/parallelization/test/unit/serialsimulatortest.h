@@ -19,6 +19,26 @@ using namespace LibGeoDecomp;
 
 namespace LibGeoDecomp {
 
+/**
+ * Counts how often the grid gets initialized.
+ */
+class CountingTestInitializer : public TestInitializer<TestCell<2> >
+{
+public:
+    explicit CountingTestInitializer(int *counter) :
+        counter(counter)
+    {}
+
+    virtual void grid(GridBase<TestCell<2>, 2> *target)
+    {
+        ++*counter;
+        TestInitializer<TestCell<2> >::grid(target);
+    }
+
+private:
+    int *counter;
+};
+
 class SerialSimulatorTest : public CxxTest::TestSuite
 {
 public:
@@ -145,6 +165,20 @@ public:
         TS_ASSERT_EQUALS(grids1, grids2);
     }
 
+    void testInitializerRunsOncePerSimulation()
+    {
+        int counter = 0;
+        SerialSimulator<TestCell<2> > sim(new CountingTestInitializer(&counter));
+        TS_ASSERT_EQUALS(1, counter);
+
+        sim.run();
+        TS_ASSERT_EQUALS(1, counter);
+
+        // grids have been advanced, so a second run needs to reset them:
+        sim.run();
+        TS_ASSERT_EQUALS(2, counter);
+    }
+
     typedef APITraits::SelectTopology<TestCell<3> >::Value Topology;
     typedef Grid<TestCell<3>, Topology> Grid3D;
     typedef GridBase<TestCell<3>, 3> GridBase3D;
@@ -7,6 +7,7 @@
 #include <libgeodecomp/misc/stdcontaineroverloads.h>
 #include <libgeodecomp/storage/neighborhooditerator.h>
 #include <libgeodecomp/storage/fixedarray.h>
+#include <libgeodecomp/storage/soaboxneighborhood.h>
 
 namespace LibGeoDecomp {
 
@@ -17,6 +18,12 @@ namespace LibGeoDecomp {
  * particles (of type Cargo) which reside in its area in the given
  * CONTAINER type (e.g. LibGeoDecomp::FixedArray or std::vector). Particles can
  * access neighboring particles in a given distance during update().
+ *
+ * If CONTAINER uses a Struct of Arrays layout (e.g. SoAArray), then
+ * the particles are not updated one by one. Instead the static
+ * function Cargo::updateBox(Container *particles, const
+ * SoABoxNeighborhood<Container, DIM>& hood, int nanoStep) is called
+ * once per box, which allows for vectorized pair interactions.
  */
 template<typename CONTAINER>
 class BoxCell
@@ -118,7 +125,7 @@ public:
         NeighborhoodAdapterType adapter(this, &hood);
 
         copyOver(hood[Coord<DIM>()], adapter, nanoStep);
-        updateCargo(adapter, nanoStep);
+        updateCargo(adapter, hood, nanoStep, typename APITraits::SelectSoA<Container>::Value());
     }
 
     template<class NEIGHBORHOOD_ADAPTER_SELF>
@@ -157,11 +164,42 @@ public:
         return dimension;
     }
 
+    const Container& getContainer() const
+    {
+        return particles;
+    }
+
+    template<class ARCHIVE>
+    void serialize(ARCHIVE& archive, unsigned)
+    {
+        archive & origin & dimension & particles;
+    }
+
 protected:
     FloatCoord<DIM> origin;
     FloatCoord<DIM> dimension;
     Container particles;
 
+    template<class NEIGHBORHOOD_ADAPTER_ALL, class HOOD>
+    inline void updateCargo(
+        NEIGHBORHOOD_ADAPTER_ALL& allNeighbors,
+        const HOOD& /* hood */,
+        int nanoStep,
+        APITraits::FalseType)
+    {
+        updateCargo(allNeighbors, nanoStep);
+    }
+
+    template<class NEIGHBORHOOD_ADAPTER_ALL, class HOOD>
+    inline void updateCargo(
+        NEIGHBORHOOD_ADAPTER_ALL& /* allNeighbors */,
+        const HOOD& hood,
+        int nanoStep,
+        APITraits::TrueType)
+    {
+        Cargo::updateBox(&particles, SoABoxNeighborhood<Container, DIM>(hood), nanoStep);
+    }
+
     template<typename ITERATOR>
     void addContainedParticles(const ITERATOR& begin, const ITERATOR& end)
     {
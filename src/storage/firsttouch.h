@@ -0,0 +1,94 @@
+#ifndef LIBGEODECOMP_STORAGE_FIRSTTOUCH_H
+#define LIBGEODECOMP_STORAGE_FIRSTTOUCH_H
+
+#include <libgeodecomp/config.h>
+
+#include <cstddef>
+
+namespace LibGeoDecomp {
+
+/**
+ * Operating systems generally map a page of memory to the NUMA
+ * domain of the thread which first writes to it. Grids which are
+ * allocated and initialized by a single thread thus end up entirely
+ * on that thread's socket, and all other sockets are limited to
+ * remote bandwidth -- roughly half of what they could get.
+ *
+ * If enabled, Grid (and thus DisplacedGrid) and SoAGrid will touch
+ * their memory in parallel right after allocation, using the same
+ * plane decomposition (one XY-plane in 3D or one row in 2D per
+ * iteration, OpenMP static schedule) as the threaded
+ * UpdateFunctor. Each page then resides on the socket of the thread
+ * which will update it. This only pays off if threads don't migrate
+ * between sockets, see ThreadAffinity::pinOpenMPThreads().
+ *
+ * The mode is process-wide and disabled by default. It should be
+ * set before the Simulator is created.
+ */
+class FirstTouch
+{
+public:
+    /**
+     * Granularity at which the OS distributes memory
+     */
+    static const std::size_t PAGE_SIZE = 4096;
+
+    /**
+     * Allocations smaller than this aren't worth spawning threads
+     * for.
+     */
+    static const std::size_t MIN_BYTES = 1 << 20;
+
+    static void enable(bool flag = true)
+    {
+        enabledFlag() = flag;
+    }
+
+    static bool enabled()
+    {
+        return enabledFlag();
+    }
+
+    /**
+     * true if an allocation of the given size should be first
+     * touched in parallel.
+     */
+    static bool applies(std::size_t bytes)
+    {
+        return enabled() && (bytes >= MIN_BYTES);
+    }
+
+    /**
+     * Writes to each page of [data, data + bytes) so that pages of
+     * plane i are placed by the thread which gets iteration i in an
+     * OpenMP loop over numPlanes with a static schedule. The contents
+     * of the memory are undefined afterwards.
+     */
+    static void touch(char *data, std::size_t bytes, std::size_t numPlanes)
+    {
+        long planes = numPlanes;
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#pragma omp parallel for schedule(static)
+#endif
+        for (long plane = 0; plane < planes; ++plane) {
+            volatile char *begin = data + plane * bytes / numPlanes;
+            volatile char *end   = data + (plane + 1) * bytes / numPlanes;
+
+            for (volatile char *i = begin; i < end; i += PAGE_SIZE) {
+                *i = 0;
+            }
+        }
+    }
+
+private:
+    static bool& enabledFlag()
+    {
+        static bool flag = false;
+        return flag;
+    }
+};
+
+}
+
+#endif
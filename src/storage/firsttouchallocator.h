@@ -0,0 +1,69 @@
+#ifndef LIBGEODECOMP_STORAGE_FIRSTTOUCHALLOCATOR_H
+#define LIBGEODECOMP_STORAGE_FIRSTTOUCHALLOCATOR_H
+
+#include <libflatarray/aligned_allocator.hpp>
+#include <libgeodecomp/storage/firsttouch.h>
+
+#include <type_traits>
+
+namespace LibGeoDecomp {
+
+/**
+ * Aligned allocator which distributes fresh memory among NUMA
+ * domains by touching it in parallel (see FirstTouch), assuming it
+ * will hold numPlanes planes of equal size. This lets containers
+ * like std::vector, which initialize their elements serially, keep
+ * the page placement of the update threads.
+ */
+template<class T, std::size_t ALIGNMENT>
+class FirstTouchAllocator : public LibFlatArray::aligned_allocator<T, ALIGNMENT>
+{
+public:
+    typedef LibFlatArray::aligned_allocator<T, ALIGNMENT> Base;
+    typedef typename Base::pointer pointer;
+
+    // the plane count belongs to the memory, so it has to travel
+    // with it:
+    typedef std::true_type propagate_on_container_copy_assignment;
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    template<typename OTHER>
+    struct rebind
+    {
+        typedef FirstTouchAllocator<OTHER, ALIGNMENT> other;
+    };
+
+    explicit FirstTouchAllocator(std::size_t numPlanes = 1) :
+        numPlanes(numPlanes)
+    {}
+
+    template<typename OTHER>
+    FirstTouchAllocator(const FirstTouchAllocator<OTHER, ALIGNMENT>& other) :
+        numPlanes(other.planes())
+    {}
+
+    pointer allocate(std::size_t n, const void *hint = 0)
+    {
+        pointer ret = Base::allocate(n, hint);
+        std::size_t bytes = n * sizeof(T);
+
+        if ((ret != 0) && (numPlanes > 0) && FirstTouch::applies(bytes)) {
+            FirstTouch::touch(reinterpret_cast<char*>(ret), bytes, numPlanes);
+        }
+
+        return ret;
+    }
+
+    std::size_t planes() const
+    {
+        return numPlanes;
+    }
+
+private:
+    std::size_t numPlanes;
+};
+
+}
+
+#endif
@@ -1,12 +1,12 @@
 #ifndef LIBGEODECOMP_STORAGE_GRID_H
 #define LIBGEODECOMP_STORAGE_GRID_H
 
-#include <libflatarray/aligned_allocator.hpp>
 #include <libgeodecomp/geometry/coord.h>
 #include <libgeodecomp/geometry/coordbox.h>
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/geometry/topologies.h>
 #include <libgeodecomp/storage/coordmap.h>
+#include <libgeodecomp/storage/firsttouchallocator.h>
 #include <libgeodecomp/storage/gridbase.h>
 #include <libgeodecomp/storage/selector.h>
 
@@ -96,7 +96,8 @@ public:
     const static int DIM = TOPOLOGY::DIM;
 
     // always align on cache line boundaries
-    typedef typename std::vector<CELL_TYPE, LibFlatArray::aligned_allocator<CELL_TYPE, 64> > CellVector;
+    typedef FirstTouchAllocator<CELL_TYPE, 64> Allocator;
+    typedef typename std::vector<CELL_TYPE, Allocator> CellVector;
 
     typedef TOPOLOGY Topology;
     typedef CELL_TYPE Cell;
@@ -107,13 +108,13 @@ public:
         const CELL_TYPE& defaultCell = CELL_TYPE(),
         const CELL_TYPE& edgeCell = CELL_TYPE()) :
         dimensions(dim),
-        cellVector(dim.prod(), defaultCell),
+        cellVector(dim.prod(), defaultCell, allocator(dim)),
         edgeCell(edgeCell)
     {}
 
     explicit Grid(const GridBase<CELL_TYPE, DIM>& base) :
         dimensions(base.dimensions()),
-        cellVector(base.dimensions().prod()),
+        cellVector(base.dimensions().prod(), CELL_TYPE(), allocator(base.dimensions())),
         edgeCell(base.getEdge())
     {
         CoordBox<DIM> box = base.boundingBox();
@@ -134,7 +135,18 @@ public:
     inline void resize(const Coord<DIM>& newDim)
     {
         dimensions = newDim;
-        cellVector.resize(newDim.prod());
+        std::size_t newSize = newDim.prod();
+
+        // vector's growth strategy doesn't know about our planes, so
+        // we allocate the new storage ourselves:
+        if (FirstTouch::applies(newSize * sizeof(CELL_TYPE)) && (newSize > cellVector.capacity())) {
+            CellVector newVector(allocator(newDim));
+            newVector.reserve(newSize);
+            newVector.insert(newVector.end(), cellVector.begin(), cellVector.end());
+            cellVector.swap(newVector);
+        }
+
+        cellVector.resize(newSize);
     }
 
     /**
@@ -327,6 +339,15 @@ private:
     Coord<DIM> dimensions;
     CellVector cellVector;
     CELL_TYPE edgeCell;
+
+    /**
+     * Cells are stored plane by plane, which matches the order in
+     * which the UpdateFunctor distributes them among threads.
+     */
+    static Allocator allocator(const Coord<DIM>& dim)
+    {
+        return Allocator(dim[DIM - 1]);
+    }
 };
 
 template<typename _CharT, typename _Traits, typename _CellT, typename _TopologyT>
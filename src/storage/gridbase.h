@@ -135,6 +135,19 @@ public:
         loadMemberImplementation(reinterpret_cast<const char*>(source), sourceLocation, selector, region);
     }
 
+    /**
+     * Same as loadMember(), but sans the type checking. Counterpart
+     * to saveMemberUnchecked().
+     */
+    void loadMemberUnchecked(
+        const char *source,
+        MemoryLocation::Location sourceLocation,
+        const Selector<CELL>& selector,
+        const Region<DIM>& region)
+    {
+        loadMemberImplementation(source, sourceLocation, selector, region);
+    }
+
     /**
      * Through this function the weights of the edges on unstructured
      * grids can be set. Unavailable on regular grids.
@@ -2,6 +2,7 @@
 #define LIBGEODECOMP_STORAGE_GRIDVECCONV_H
 
 #include <libgeodecomp/config.h>
+#include <libgeodecomp/communication/binaryserialization.h>
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/storage/displacedgrid.h>
 #include <libgeodecomp/storage/unstructuredgrid.h>
@@ -45,7 +46,8 @@ public:
         gridToVector(
             grid, vec, region,
             typename APITraits::SelectSoA<CellType>::Value(),
-            typename APITraits::SelectBoostSerialization<CellType>::Value());
+            typename APITraits::SelectBoostSerialization<CellType>::Value(),
+            typename APITraits::SelectBinarySerialization<CellType>::Value());
     }
 
     template<typename GRID_TYPE, typename VECTOR_TYPE, typename REGION_TYPE>
@@ -58,7 +60,8 @@ public:
         vectorToGrid(
             vec, grid, region,
             typename APITraits::SelectSoA<CellType>::Value(),
-            typename APITraits::SelectBoostSerialization<CellType>::Value());
+            typename APITraits::SelectBoostSerialization<CellType>::Value(),
+            typename APITraits::SelectBinarySerialization<CellType>::Value());
     }
 
     template<typename GRID_TYPE, typename VECTOR_TYPE, typename REGION_TYPE>
@@ -71,10 +74,108 @@ public:
         vectorToGrid(
             vec, grid, region,
             typename APITraits::SelectSoA<CellType>::Value(),
-            typename APITraits::SelectBoostSerialization<CellType>::Value());
+            typename APITraits::SelectBoostSerialization<CellType>::Value(),
+            typename APITraits::SelectBinarySerialization<CellType>::Value());
     }
 
 private:
+    template<typename GRID_TYPE, typename VECTOR_TYPE, typename REGION_TYPE, typename SOA_TYPE, typename BOOST_SERIALIZATION_TYPE>
+    static void gridToVector(
+        const GRID_TYPE& grid,
+        VECTOR_TYPE *vec,
+        const REGION_TYPE& region,
+        const SOA_TYPE& soaFlag,
+        const BOOST_SERIALIZATION_TYPE& boostSerializationFlag,
+        const APITraits::FalseType&)
+    {
+        gridToVector(grid, vec, region, soaFlag, boostSerializationFlag);
+    }
+
+    template<typename GRID_TYPE, typename VECTOR_TYPE, typename REGION_TYPE, typename BOOST_SERIALIZATION_TYPE>
+    static void gridToVector(
+        const GRID_TYPE& grid,
+        VECTOR_TYPE *vec,
+        const REGION_TYPE& region,
+        const APITraits::TrueType& soaFlag,
+        const BOOST_SERIALIZATION_TYPE& boostSerializationFlag,
+        const APITraits::TrueType&)
+    {
+        // SoA yields fixed size buffers, so it beats binary serialization:
+        gridToVector(grid, vec, region, soaFlag, boostSerializationFlag);
+    }
+
+    template<typename GRID_TYPE, typename VECTOR_TYPE, typename REGION_TYPE, typename SOA_TYPE, typename BOOST_SERIALIZATION_TYPE>
+    static void vectorToGrid(
+        VECTOR_TYPE& vec,
+        GRID_TYPE *grid,
+        const REGION_TYPE& region,
+        const SOA_TYPE& soaFlag,
+        const BOOST_SERIALIZATION_TYPE& boostSerializationFlag,
+        const APITraits::FalseType&)
+    {
+        vectorToGrid(vec, grid, region, soaFlag, boostSerializationFlag);
+    }
+
+    template<typename GRID_TYPE, typename VECTOR_TYPE, typename REGION_TYPE, typename BOOST_SERIALIZATION_TYPE>
+    static void vectorToGrid(
+        VECTOR_TYPE& vec,
+        GRID_TYPE *grid,
+        const REGION_TYPE& region,
+        const APITraits::TrueType& soaFlag,
+        const BOOST_SERIALIZATION_TYPE& boostSerializationFlag,
+        const APITraits::TrueType&)
+    {
+        vectorToGrid(vec, grid, region, soaFlag, boostSerializationFlag);
+    }
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+    template<typename GRID_TYPE, typename REGION_TYPE, typename BOOST_SERIALIZATION_TYPE>
+    static void gridToVector(
+        const GRID_TYPE& grid,
+        std::vector<char> *vec,
+        const REGION_TYPE& region,
+        const APITraits::FalseType&,
+        const BOOST_SERIALIZATION_TYPE&,
+        const APITraits::TrueType&)
+    {
+        typedef typename GRID_TYPE::CellType CellType;
+
+        // clear() retains the buffer's capacity from the previous call:
+        vec->clear();
+        BinaryOArchive archive(vec);
+
+        for (typename REGION_TYPE::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            const CellType *cell = &grid[i->origin];
+            for (int x = 0; x < i->length(); ++x) {
+                archive << cell[x];
+            }
+        }
+    }
+
+    template<typename GRID_TYPE, typename VECTOR_TYPE, typename REGION_TYPE, typename BOOST_SERIALIZATION_TYPE>
+    static void vectorToGrid(
+        VECTOR_TYPE& vec,
+        GRID_TYPE *grid,
+        const REGION_TYPE& region,
+        const APITraits::FalseType&,
+        const BOOST_SERIALIZATION_TYPE&,
+        const APITraits::TrueType&)
+    {
+        typedef typename GRID_TYPE::CellType CellType;
+        BinaryIArchive archive(vec.empty() ? 0 : &vec[0], vec.size());
+
+        for (typename REGION_TYPE::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+            CellType *cell = &(*grid)[i->origin];
+            for (int x = 0; x < i->length(); ++x) {
+                archive >> cell[x];
+            }
+        }
+
+        if (archive.remaining() != 0) {
+            throw std::logic_error("raw vector doesn't match region");
+        }
+    }
+#endif
 
     template<typename CELL_TYPE, typename TOPOLOGY_TYPE, bool TOPOLOGICALLY_CORRECT, typename REGION_TYPE>
     static void gridToVector(
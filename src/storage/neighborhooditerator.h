@@ -5,6 +5,8 @@
 #include <libgeodecomp/geometry/coordbox.h>
 #include <libgeodecomp/storage/collectioninterface.h>
 
+#include <iterator>
+
 namespace LibGeoDecomp {
 
 namespace NeighborhoodIteratorHelpers {
@@ -78,6 +80,8 @@ public:
     typedef typename COLLECTION_INTERFACE::Container Container;
     typedef typename COLLECTION_INTERFACE::Container::const_iterator CellIterator;
     typedef typename COLLECTION_INTERFACE::Container::value_type Particle;
+    // SoA containers return their particles by value:
+    typedef typename std::iterator_traits<CellIterator>::reference ParticleReference;
 
     inline NeighborhoodIterator(
         WRITE_CONTAINER *writeContainer,
@@ -136,7 +140,7 @@ public:
             COLLECTION_INTERFACE()(hood[Coord<DIM>::diagonal(1)]).end());
     }
 
-    inline const Particle& operator*() const
+    inline ParticleReference operator*() const
     {
         return *iterator;
     }
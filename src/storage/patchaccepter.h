@@ -59,6 +59,16 @@ public:
         // empty as most implementations won't need it anyway.
     }
 
+    /**
+     * Gives implementations which transmit data asynchronously (e.g.
+     * PatchLink) the chance to drive their pending transmissions
+     * while the Stepper is busy computing.
+     */
+    virtual void progress()
+    {
+        // empty as most implementations won't need it anyway.
+    }
+
     virtual std::size_t nextRequiredNanoStep() const
     {
         if (requestedNanoSteps.empty()) {
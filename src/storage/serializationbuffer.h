@@ -98,6 +98,65 @@ public:
 #endif
 };
 
+/**
+ * Buffers for cells flagged with APITraits::HasBinarySerialization.
+ * Their size is only known after serialization. Users should keep
+ * their buffers across time steps: GridVecConv clear()s them
+ * before serializing, so the capacity of the previous step is
+ * reused and reallocations become rare.
+ */
+template<typename CELL>
+class BinaryImplementation
+{
+public:
+    typedef std::vector<char> BufferType;
+    typedef char ElementType;
+    typedef typename APITraits::FalseType FixedSize;
+
+    template<typename REGION>
+    static BufferType create(const REGION& region)
+    {
+        return BufferType();
+    }
+
+    static ElementType *getData(BufferType& buffer)
+    {
+        // buffers are empty until serialization took place:
+        return buffer.empty() ? 0 : &buffer[0];
+    }
+
+#ifdef LIBGEODECOMP_WITH_MPI
+    static inline MPI_Datatype cellMPIDataType()
+    {
+        return MPI_CHAR;
+    }
+#endif
+};
+
+/**
+ * Binary serialization takes precedence over Boost.Serialization,
+ * but SoA is still preferred as it results in fixed size buffers.
+ */
+template<
+    typename CELL,
+    typename SUPPORTS_SOA = typename APITraits::SelectSoA<CELL>::Value,
+    typename SUPPORTS_BINARY_SERIALIZATION = typename APITraits::SelectBinarySerialization<CELL>::Value>
+class SelectImplementation
+{
+public:
+    typedef Implementation<CELL> Value;
+};
+
+/**
+ * see above
+ */
+template<typename CELL>
+class SelectImplementation<CELL, APITraits::FalseType, APITraits::TrueType>
+{
+public:
+    typedef BinaryImplementation<CELL> Value;
+};
+
 }
 
 /**
@@ -108,7 +167,7 @@ template<typename CELL>
 class SerializationBuffer
 {
 public:
-    typedef SerializationBufferHelpers::Implementation<CELL> Implementation;
+    typedef typename SerializationBufferHelpers::SelectImplementation<CELL>::Value Implementation;
     typedef typename Implementation::BufferType BufferType;
     typedef typename Implementation::ElementType ElementType;
     typedef typename Implementation::FixedSize FixedSize;
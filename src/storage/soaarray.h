@@ -0,0 +1,212 @@
+#ifndef LIBGEODECOMP_STORAGE_SOAARRAY_H
+#define LIBGEODECOMP_STORAGE_SOAARRAY_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/misc/apitraits.h>
+#include <libflatarray/flat_array.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+
+namespace LibGeoDecomp {
+
+/**
+ * The Struct of Arrays (SoA) counterpart to FixedArray: it can store
+ * up to SIZE elements, but each member of T is kept in a separate,
+ * contiguous array (via LibFlatArray::soa_array). This makes it
+ * suitable as a BoxCell's container for particle codes whose pair
+ * interactions shall be vectorized. T needs to be registered with
+ * LIBFLATARRAY_REGISTER_SOA().
+ *
+ * An SoA container can't hand out references to its elements. Hence
+ * its iterators yield copies and elements need to be written via
+ * set() or via the accessors which expose the member arrays.
+ */
+template<typename T, int SIZE>
+class SoAArray
+{
+public:
+    friend class SoAArrayTest;
+
+    typedef T value_type;
+    typedef LibFlatArray::soa_accessor<T, SIZE, 1, 1, 0> Accessor;
+    typedef LibFlatArray::const_soa_accessor<T, SIZE, 1, 1, 0> ConstAccessor;
+
+    /**
+     * Lets BoxCell know that it needs to hand the whole container
+     * to its particles' updateBox().
+     */
+    class API :
+        public APITraits::HasSoA
+    {};
+
+    /**
+     * Random access iterator which returns elements by value.
+     */
+    class const_iterator
+    {
+    public:
+        typedef std::random_access_iterator_tag iterator_category;
+        typedef T value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const T *pointer;
+        typedef T reference;
+
+        inline const_iterator(const SoAArray *array = 0, std::size_t index = 0) :
+            array(array),
+            index(index)
+        {}
+
+        inline T operator*() const
+        {
+            return array->get(index);
+        }
+
+        inline T operator[](difference_type offset) const
+        {
+            return array->get(index + offset);
+        }
+
+        inline const_iterator& operator++()
+        {
+            ++index;
+            return *this;
+        }
+
+        inline const_iterator& operator--()
+        {
+            --index;
+            return *this;
+        }
+
+        inline const_iterator& operator+=(difference_type offset)
+        {
+            index += offset;
+            return *this;
+        }
+
+        inline const_iterator operator+(difference_type offset) const
+        {
+            return const_iterator(array, index + offset);
+        }
+
+        inline difference_type operator-(const const_iterator& other) const
+        {
+            return difference_type(index) - difference_type(other.index);
+        }
+
+        inline bool operator==(const const_iterator& other) const
+        {
+            return (array == other.array) && (index == other.index);
+        }
+
+        inline bool operator!=(const const_iterator& other) const
+        {
+            return !(*this == other);
+        }
+
+        inline bool operator<(const const_iterator& other) const
+        {
+            return index < other.index;
+        }
+
+    private:
+        const SoAArray *array;
+        std::size_t index;
+    };
+
+    typedef const_iterator iterator;
+
+    inline const_iterator begin() const
+    {
+        return const_iterator(this, 0);
+    }
+
+    inline const_iterator end() const
+    {
+        return const_iterator(this, size());
+    }
+
+    inline T get(std::size_t i) const
+    {
+        T ret;
+        store[i] >> ret;
+        return ret;
+    }
+
+    inline void set(std::size_t i, const T& element)
+    {
+        store[i] = element;
+    }
+
+    /**
+     * Accessor pointing to the first element. Taking the address of
+     * one of its members yields a pointer to the array which stores
+     * that member for all elements, e.g. &accessor.posX().
+     */
+    inline Accessor accessor()
+    {
+        return store[0];
+    }
+
+    inline ConstAccessor accessor() const
+    {
+        return store[0];
+    }
+
+    inline static std::size_t capacity()
+    {
+        return SIZE;
+    }
+
+    inline std::size_t size() const
+    {
+        return store.size();
+    }
+
+    inline bool empty() const
+    {
+        return size() == 0;
+    }
+
+    inline void clear()
+    {
+        store.clear();
+    }
+
+    inline void push_back(const T& element)
+    {
+        store.push_back(element);
+    }
+
+    inline SoAArray& operator<<(const T& element)
+    {
+        store.push_back(element);
+        return *this;
+    }
+
+    /**
+     * Removes element i in O(1) by moving the last element into its
+     * place, so the order of elements is not preserved.
+     */
+    inline void remove(std::size_t i)
+    {
+        if (i >= size()) {
+            throw std::out_of_range("index out of range");
+        }
+
+        std::size_t last = size() - 1;
+        if (i != last) {
+            set(i, get(last));
+        }
+        store.pop_back();
+    }
+
+private:
+    LibFlatArray::soa_array<T, SIZE> store;
+};
+
+}
+
+#endif
@@ -0,0 +1,72 @@
+#ifndef LIBGEODECOMP_STORAGE_SOABOXNEIGHBORHOOD_H
+#define LIBGEODECOMP_STORAGE_SOABOXNEIGHBORHOOD_H
+
+#include <libgeodecomp/geometry/coord.h>
+#include <libgeodecomp/geometry/coordbox.h>
+#include <libgeodecomp/geometry/stencils.h>
+
+namespace LibGeoDecomp {
+
+/**
+ * Passed to the updateBox() of particles which are stored in a
+ * BoxCell with an SoA container (e.g. SoAArray). Instead of
+ * iterating particle by particle (as NeighborhoodIterator does) it
+ * exposes the containers of the 3^DIM surrounding boxes (including
+ * the box being updated), so kernels can run vectorized loops over
+ * their member arrays:
+ *
+ *   for (int b = 0; b < hood.size(); ++b) {
+ *       const double *x = &hood[b].accessor().posX();
+ *       // x[0] to x[hood[b].size() - 1] are stored contiguously
+ *   }
+ *
+ * VerletBoxCell uses it, too, to look up particles by box and index.
+ */
+template<typename CONTAINER, int DIM>
+class SoABoxNeighborhood
+{
+public:
+    typedef CONTAINER Container;
+
+    static const int NUM_BOXES = Stencils::Moore<DIM, 1>::VOLUME;
+
+    /**
+     * Boxes are ordered lexicographically by their offset, from
+     * (-1, -1, ...) to (1, 1, ...), the box itself is in the middle.
+     */
+    template<typename HOOD>
+    inline explicit SoABoxNeighborhood(const HOOD& hood)
+    {
+        CoordBox<DIM> box(Coord<DIM>::diagonal(-1), Coord<DIM>::diagonal(3));
+        int index = 0;
+
+        for (typename CoordBox<DIM>::Iterator i = box.begin(); i != box.end(); ++i) {
+            boxes[index++] = &hood[*i].getContainer();
+        }
+    }
+
+    inline int size() const
+    {
+        return NUM_BOXES;
+    }
+
+    inline const Container& operator[](const int index) const
+    {
+        return *boxes[index];
+    }
+
+    /**
+     * The old state of the box being updated.
+     */
+    inline const Container& self() const
+    {
+        return *boxes[NUM_BOXES / 2];
+    }
+
+private:
+    const Container *boxes[NUM_BOXES];
+};
+
+}
+
+#endif
@@ -7,6 +7,7 @@
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/geometry/topologies.h>
 #include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/storage/firsttouch.h>
 #include <libgeodecomp/storage/gridbase.h>
 #include <libgeodecomp/storage/selector.h>
 
@@ -298,6 +299,8 @@ public:
         }
         actualDimensions += edgeRadii * 2;
 
+        delegate.set_parallel_construction(
+            FirstTouch::applies(std::size_t(actualDimensions.prod()) * AGGREGATED_MEMBER_SIZE));
         delegate.resize(
             actualDimensions.x(),
             actualDimensions.y(),
@@ -0,0 +1,79 @@
+#include <cxxtest/TestSuite.h>
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/io/unstructuredtestinitializer.h>
+#include <libgeodecomp/misc/unstructuredtestcell.h>
+#include <libgeodecomp/storage/unstructuredsoagrid.h>
+#include <libgeodecomp/storage/unstructuredupdatefunctor.h>
+#include <libgeodecomp/storage/updatefunctor.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class UnstructuredUpdateFunctorTest : public CxxTest::TestSuite
+{
+public:
+#ifdef LIBGEODECOMP_WITH_CPP14
+    typedef UnstructuredTestCellSoA TestCellType;
+    typedef UnstructuredSoAGrid<TestCellType, 1, double, 32, 1> GridType;
+#endif
+
+    void testSoAThreadedMatchesSerial()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int DIM = 300;
+        UnstructuredTestInitializer<TestCellType> init(DIM, 10);
+        CoordBox<1> box(Coord<1>(0), Coord<1>(DIM));
+
+        GridType gridOld(box);
+        GridType gridNewSerial(box);
+        GridType gridNewThreaded(box);
+        init.grid(&gridOld);
+        init.grid(&gridNewSerial);
+        init.grid(&gridNewThreaded);
+
+        // Fine grained parallelism yields packages of exactly one
+        // chunk, so all but the first one start at a nonzero offset.
+        // Streaks start and end in the middle of chunks to exercise
+        // the loop peeling, too:
+        Region<1> region;
+        region << Streak<1>(Coord<1>(  5),  70)
+               << Streak<1>(Coord<1>( 96), 160)
+               << Streak<1>(Coord<1>(170), 290);
+
+        typedef APITraits::SelectThreadedUpdate<TestCellType>::Value ModelThreadingSpec;
+        UnstructuredUpdateFunctor<TestCellType> functor;
+        functor(
+            region,
+            gridOld,
+            &gridNewSerial,
+            0,
+            UpdateFunctorHelpers::ConcurrencyNoP(),
+            ModelThreadingSpec());
+        functor(
+            region,
+            gridOld,
+            &gridNewThreaded,
+            0,
+            UpdateFunctorHelpers::ConcurrencyEnableOpenMP(false, true),
+            ModelThreadingSpec());
+
+        for (CoordBox<1>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TestCellType serial = gridNewSerial.get(*i);
+            TestCellType threaded = gridNewThreaded.get(*i);
+            unsigned expectedCycle = region.count(*i) ? 1 : 0;
+
+            TS_ASSERT_EQUALS(i->x(), serial.id);
+            TS_ASSERT_EQUALS(expectedCycle, serial.cycleCounter);
+            TS_ASSERT(serial.isValid);
+
+            TS_ASSERT_EQUALS(serial.id, threaded.id);
+            TS_ASSERT_EQUALS(serial.cycleCounter, threaded.cycleCounter);
+            TS_ASSERT_EQUALS(serial.isValid, threaded.isValid);
+        }
+#endif
+    }
+};
+
+}
@@ -1,6 +1,7 @@
 #include <libgeodecomp/geometry/region.h>
 #include <libgeodecomp/storage/boxcell.h>
 #include <libgeodecomp/storage/grid.h>
+#include <libgeodecomp/storage/soaarray.h>
 #include <libgeodecomp/storage/updatefunctor.h>
 #include <libgeodecomp/misc/apitraits.h>
 #include <cxxtest/TestSuite.h>
@@ -103,6 +104,99 @@ private:
     int numParticlesToBeSpawned;
 };
 
+/**
+ * Sums up a short-range potential over all particles in the
+ * surrounding boxes, either one particle at a time (update()) or
+ * vectorized for a whole box (updateBox()).
+ */
+class PotentialParticle
+{
+public:
+    class API : public APITraits::HasCubeTopology<3>
+    {};
+
+    explicit PotentialParticle(const FloatCoord<3>& pos = FloatCoord<3>()) :
+        posX(pos[0]),
+        posY(pos[1]),
+        posZ(pos[2]),
+        potential(0)
+    {}
+
+    inline FloatCoord<3> getPos() const
+    {
+        return FloatCoord<3>(posX, posY, posZ);
+    }
+
+    template<typename HOOD>
+    inline void update(const HOOD& hood, const int nanoStep)
+    {
+        potential = 0;
+
+        for (typename HOOD::Iterator i = hood.begin(); i != hood.end(); ++i) {
+            potential += pairPotential(i->posX - posX, i->posY - posY, i->posZ - posZ);
+        }
+    }
+
+    template<typename CONTAINER, typename HOOD>
+    static void updateBox(CONTAINER *particles, const HOOD& hood, const int nanoStep)
+    {
+        typedef LibFlatArray::short_vec<double, 4> Double;
+        typename CONTAINER::Accessor own = particles->accessor();
+
+        for (std::size_t i = 0; i < particles->size(); ++i) {
+            double x = (&own.posX())[i];
+            double y = (&own.posY())[i];
+            double z = (&own.posZ())[i];
+            Double sum = 0.0;
+            double remainder = 0;
+
+            for (int b = 0; b < hood.size(); ++b) {
+                typename CONTAINER::ConstAccessor other = hood[b].accessor();
+                const double *otherX = &other.posX();
+                const double *otherY = &other.posY();
+                const double *otherZ = &other.posZ();
+                std::size_t j = 0;
+                std::size_t end = hood[b].size();
+
+                for (; (j + 4) <= end; j += 4) {
+                    sum += pairPotential(
+                        Double(otherX + j) - Double(x),
+                        Double(otherY + j) - Double(y),
+                        Double(otherZ + j) - Double(z));
+                }
+
+                for (; j < end; ++j) {
+                    remainder += pairPotential(otherX[j] - x, otherY[j] - y, otherZ[j] - z);
+                }
+            }
+
+            (&own.potential())[i] = sum[0] + sum[1] + sum[2] + sum[3] + remainder;
+        }
+    }
+
+    template<typename DOUBLE>
+    static inline DOUBLE pairPotential(const DOUBLE& deltaX, const DOUBLE& deltaY, const DOUBLE& deltaZ)
+    {
+        return DOUBLE(1.0) / (DOUBLE(1.0) + deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ);
+    }
+
+    double posX;
+    double posY;
+    double posZ;
+    double potential;
+};
+
+}
+
+LIBFLATARRAY_REGISTER_SOA(
+    LibGeoDecomp::PotentialParticle,
+    ((double)(posX))
+    ((double)(posY))
+    ((double)(posZ))
+    ((double)(potential)) )
+
+namespace LibGeoDecomp {
+
 class BoxCellTest : public CxxTest::TestSuite
 {
 public:
@@ -409,6 +503,60 @@ public:
         TS_ASSERT_EQUALS(cell.size(), 0);
     }
 
+    void testSoAContainer()
+    {
+        typedef BoxCell<FixedArray<PotentialParticle, 30> > AoSCellType;
+        typedef BoxCell<SoAArray<PotentialParticle, 30> > SoACellType;
+        typedef APITraits::SelectTopology<AoSCellType>::Value Topology;
+
+        Coord<3> gridDim(4, 5, 3);
+        FloatCoord<3> cellDim(2.0, 3.0, 5.0);
+        CoordBox<3> box(Coord<3>(0, 0, 0), gridDim);
+        Region<3> region;
+        region << box;
+
+        Grid<AoSCellType, Topology> aosGrid1(gridDim);
+        Grid<AoSCellType, Topology> aosGrid2(gridDim);
+        Grid<SoACellType, Topology> soaGrid1(gridDim);
+        Grid<SoACellType, Topology> soaGrid2(gridDim);
+
+        int counter = 0;
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            FloatCoord<3> origin = cellDim.scale(*i);
+            aosGrid1[*i] = AoSCellType(origin, cellDim);
+            soaGrid1[*i] = SoACellType(origin, cellDim);
+
+            // varying numbers of particles to exercise both, the
+            // vectorized loop and the remainder loop:
+            int numParticles = 1 + (counter++ % 11);
+            for (int j = 0; j < numParticles; ++j) {
+                FloatCoord<3> offset(
+                    ((j * 7) % 10) * 0.1,
+                    ((j * 3) % 10) * 0.1,
+                    ((j * 9) % 10) * 0.1);
+                PotentialParticle particle(origin + cellDim.scale(offset));
+                aosGrid1[*i].insert(particle);
+                soaGrid1[*i].insert(particle);
+            }
+        }
+
+        UpdateFunctor<AoSCellType>()(region, Coord<3>(), Coord<3>(), aosGrid1, &aosGrid2, 0);
+        UpdateFunctor<SoACellType>()(region, Coord<3>(), Coord<3>(), soaGrid1, &soaGrid2, 0);
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            const AoSCellType& aosCell = aosGrid2[*i];
+            const SoACellType& soaCell = soaGrid2[*i];
+            TS_ASSERT_EQUALS(aosCell.size(), soaCell.size());
+
+            SoACellType::const_iterator soaParticle = soaCell.begin();
+            for (AoSCellType::const_iterator j = aosCell.begin(); j != aosCell.end(); ++j, ++soaParticle) {
+                TS_ASSERT_EQUALS(j->getPos(), (*soaParticle).getPos());
+                TS_ASSERT_LESS_THAN(0, j->potential);
+                TS_ASSERT_DELTA(j->potential, (*soaParticle).potential, 1e-12);
+            }
+        }
+    }
+
 private:
     Coord<2> gridDim;
     FloatCoord<2> cellDim;
@@ -5,8 +5,9 @@
 #include <libgeodecomp/communication/hpxserializationwrapper.h>
 #include <libgeodecomp/geometry/streak.h>
 #include <libgeodecomp/misc/apitraits.h>
-#include <libgeodecomp/storage/grid.h>
 #include <libgeodecomp/storage/displacedgrid.h>
+#include <libgeodecomp/storage/firsttouch.h>
+#include <libgeodecomp/storage/grid.h>
 #include <libgeodecomp/misc/testcell.h>
 
 #define GRIDWIDTH 4
@@ -481,6 +482,36 @@ public:
         Grid<int, Topologies::Torus<3>::Topology> grid3;
         TS_ASSERT_EQUALS(Coord<3>(), grid3.getDimensions());
     }
+
+    void testFirstTouch()
+    {
+        FirstTouch::enable();
+
+        Coord<3> dim(100, 50, 60);
+        Grid<double, Topologies::Cube<3>::Topology> grid(dim, 1.5, -1);
+        TS_ASSERT_EQUALS(std::size_t(60), grid.cellVector.get_allocator().planes());
+
+        CoordBox<3> box = grid.boundingBox();
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TS_ASSERT_EQUALS(1.5, grid[*i]);
+        }
+        grid[Coord<3>(1, 2, 3)] = 47.11;
+
+        // growing the last dimension needs to preserve the old
+        // contents, just like without first touch:
+        Coord<3> newDim(100, 50, 80);
+        grid.resize(newDim);
+        TS_ASSERT_EQUALS(newDim, grid.getDimensions());
+        TS_ASSERT_EQUALS(std::size_t(80), grid.cellVector.get_allocator().planes());
+        TS_ASSERT_EQUALS(47.11, grid[Coord<3>(1, 2, 3)]);
+        TS_ASSERT_EQUALS(1.5, grid[Coord<3>(99, 49, 59)]);
+        TS_ASSERT_EQUALS(0.0, grid[Coord<3>(99, 49, 79)]);
+
+        Grid<double, Topologies::Cube<3>::Topology> copy(grid);
+        TS_ASSERT_EQUALS(grid, copy);
+
+        FirstTouch::enable(false);
+    }
 };
 
 }
@@ -76,6 +76,34 @@ public:
 
 #endif
 
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+/**
+ * Test model for use with BinaryOArchive/BinaryIArchive
+ */
+class VariableSizeCell
+{
+public:
+    class API : public APITraits::HasBinarySerialization
+    {};
+
+    explicit VariableSizeCell(int id = 0) :
+        id(id)
+    {}
+
+    template<typename ARCHIVE>
+    void serialize(ARCHIVE& archive, unsigned)
+    {
+        archive & id & neighbors & weights;
+    }
+
+    int id;
+    std::vector<int> neighbors;
+    FixedArray<double, 10> weights;
+};
+
+#endif
+
 class GridVecConvTest : public CxxTest::TestSuite
 {
 public:
@@ -247,6 +275,60 @@ public:
         TS_ASSERT_EQUALS( testCell->sublevelSE, null);
 
         TS_ASSERT_EQUALS(gridB[Coord<2>(20, 19)].size(), 7);
+#endif
+    }
+
+    void testBinarySerialization()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        CoordBox<2> box(Coord<2>(10, 10), Coord<2>(30, 20));
+        DisplacedGrid<VariableSizeCell> gridA(box);
+        DisplacedGrid<VariableSizeCell> gridB(box);
+
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            VariableSizeCell& cell = gridA[*i];
+            cell.id = i->x() * 100 + i->y();
+            for (int j = 0; j < (i->x() % 4); ++j) {
+                cell.neighbors.push_back(cell.id + j);
+            }
+            for (int j = 0; j < (i->y() % 11); ++j) {
+                cell.weights << j * 0.5;
+            }
+        }
+
+        Region<2> region;
+        region << Streak<2>(Coord<2>(10, 11), 15)
+               << Streak<2>(Coord<2>(10, 19), 40);
+
+        std::vector<char> buffer;
+        GridVecConv::gridToVector(gridA, &buffer, region);
+        std::size_t size = buffer.size();
+        // serializing again must not append to the previous contents:
+        GridVecConv::gridToVector(gridA, &buffer, region);
+        TS_ASSERT_EQUALS(size, buffer.size());
+
+        GridVecConv::vectorToGrid(buffer, &gridB, region);
+
+        for (CoordBox<2>::Iterator i = box.begin(); i != box.end(); ++i) {
+            const VariableSizeCell& expected = gridA[*i];
+            const VariableSizeCell& actual = gridB[*i];
+
+            if (region.count(*i)) {
+                TS_ASSERT_EQUALS(expected.id, actual.id);
+                TS_ASSERT(expected.neighbors == actual.neighbors);
+                TS_ASSERT_EQUALS(expected.weights, actual.weights);
+            } else {
+                TS_ASSERT_EQUALS(0, actual.id);
+                TS_ASSERT_EQUALS(std::size_t(0), actual.neighbors.size());
+                TS_ASSERT_EQUALS(std::size_t(0), actual.weights.size());
+            }
+        }
+
+        buffer.push_back(0);
+        TS_ASSERT_THROWS(GridVecConv::vectorToGrid(buffer, &gridB, region), std::logic_error&);
+        buffer.pop_back();
+        buffer.pop_back();
+        TS_ASSERT_THROWS(GridVecConv::vectorToGrid(buffer, &gridB, region), std::logic_error&);
 #endif
     }
 };
@@ -0,0 +1,127 @@
+#include <cxxtest/TestSuite.h>
+#include <libgeodecomp/storage/soaarray.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+class SoAArrayTestParticle
+{
+public:
+    explicit SoAArrayTestParticle(double pos = 0, int id = 0) :
+        pos(pos),
+        id(id)
+    {}
+
+    bool operator==(const SoAArrayTestParticle& other) const
+    {
+        return (pos == other.pos) && (id == other.id);
+    }
+
+    double pos;
+    int id;
+};
+
+}
+
+LIBFLATARRAY_REGISTER_SOA(
+    LibGeoDecomp::SoAArrayTestParticle,
+    ((double)(pos))
+    ((int)(id)) )
+
+namespace LibGeoDecomp {
+
+class SoAArrayTest : public CxxTest::TestSuite
+{
+public:
+    typedef SoAArray<SoAArrayTestParticle, 20> ArrayType;
+
+    void testInsertRemove()
+    {
+        ArrayType a;
+        TS_ASSERT(a.empty());
+        TS_ASSERT_EQUALS(std::size_t(20), ArrayType::capacity());
+
+        a << SoAArrayTestParticle(1.5, 1)
+          << SoAArrayTestParticle(2.5, 2)
+          << SoAArrayTestParticle(3.5, 3);
+        a.push_back(SoAArrayTestParticle(4.5, 4));
+        TS_ASSERT_EQUALS(std::size_t(4), a.size());
+        TS_ASSERT_EQUALS(SoAArrayTestParticle(1.5, 1), a.get(0));
+        TS_ASSERT_EQUALS(SoAArrayTestParticle(4.5, 4), a.get(3));
+
+        a.set(2, SoAArrayTestParticle(-1, 5));
+        TS_ASSERT_EQUALS(SoAArrayTestParticle(-1, 5), a.get(2));
+
+        // the last element takes the place of the removed one:
+        a.remove(0);
+        TS_ASSERT_EQUALS(std::size_t(3), a.size());
+        TS_ASSERT_EQUALS(SoAArrayTestParticle(4.5, 4), a.get(0));
+        TS_ASSERT_EQUALS(SoAArrayTestParticle(2.5, 2), a.get(1));
+        TS_ASSERT_EQUALS(SoAArrayTestParticle(-1,  5), a.get(2));
+
+        a.remove(2);
+        TS_ASSERT_EQUALS(std::size_t(2), a.size());
+        TS_ASSERT_THROWS(a.remove(2), std::out_of_range&);
+
+        a.clear();
+        TS_ASSERT(a.empty());
+    }
+
+    void testIteration()
+    {
+        ArrayType a;
+        for (int i = 0; i < 10; ++i) {
+            a << SoAArrayTestParticle(i * 0.5, i);
+        }
+
+        int counter = 0;
+        for (ArrayType::const_iterator i = a.begin(); i != a.end(); ++i) {
+            TS_ASSERT_EQUALS(SoAArrayTestParticle(counter * 0.5, counter), *i);
+            ++counter;
+        }
+        TS_ASSERT_EQUALS(10, counter);
+        TS_ASSERT_EQUALS(10, a.end() - a.begin());
+        TS_ASSERT_EQUALS(SoAArrayTestParticle(3.5, 7), a.begin()[7]);
+    }
+
+    void testCopy()
+    {
+        ArrayType a;
+        a << SoAArrayTestParticle(1, 2)
+          << SoAArrayTestParticle(3, 4);
+
+        ArrayType b = a;
+        a.set(0, SoAArrayTestParticle(5, 6));
+        TS_ASSERT_EQUALS(std::size_t(2), b.size());
+        TS_ASSERT_EQUALS(SoAArrayTestParticle(1, 2), b.get(0));
+        TS_ASSERT_EQUALS(SoAArrayTestParticle(3, 4), b.get(1));
+    }
+
+    void testMemberArrays()
+    {
+        ArrayType a;
+        for (int i = 0; i < 5; ++i) {
+            a << SoAArrayTestParticle(i * 2.0, i);
+        }
+
+        ArrayType::Accessor accessor = a.accessor();
+        double *pos = &accessor.pos();
+        int *id = &accessor.id();
+        for (int i = 0; i < 5; ++i) {
+            TS_ASSERT_EQUALS(i * 2.0, pos[i]);
+            TS_ASSERT_EQUALS(i,       id[i]);
+            pos[i] += 1;
+        }
+
+        const ArrayType& constArray = a;
+        ArrayType::ConstAccessor constAccessor = constArray.accessor();
+        const double *constPos = &constAccessor.pos();
+        for (int i = 0; i < 5; ++i) {
+            TS_ASSERT_EQUALS(i * 2.0 + 1, constPos[i]);
+            TS_ASSERT_EQUALS(i * 2.0 + 1, a.get(i).pos);
+        }
+    }
+};
+
+}
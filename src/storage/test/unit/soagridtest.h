@@ -3,6 +3,7 @@
 #include <libgeodecomp/geometry/stencils.h>
 #include <libgeodecomp/io/simpleinitializer.h>
 #include <libgeodecomp/misc/testcell.h>
+#include <libgeodecomp/storage/firsttouch.h>
 #include <libgeodecomp/storage/soagrid.h>
 #include <libgeodecomp/parallelization/serialsimulator.h>
 
@@ -190,6 +191,29 @@ public:
         TS_ASSERT_EQUALS(grid.get(Coord<3>(2, 2, 3) + box.origin), SoATestCell(4));
     }
 
+    void testFirstTouch()
+    {
+        FirstTouch::enable();
+
+        CoordBox<3> box(Coord<3>(10, 15, 22), Coord<3>(200, 100, 20));
+        SoATestCell defaultCell(1);
+        SoATestCell edgeCell(2);
+
+        SoAGrid<SoATestCell, Topologies::Cube<3>::Topology> grid(box, defaultCell, edgeCell);
+        TS_ASSERT(grid.delegate.parallel_construction());
+        TS_ASSERT_EQUALS(grid.get(Coord<3>(0, 0, 0)), edgeCell);
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            TS_ASSERT_EQUALS(grid.get(*i), defaultCell);
+        }
+
+        // small grids aren't worth the effort:
+        SoAGrid<SoATestCell, Topologies::Cube<3>::Topology> smallGrid(
+            CoordBox<3>(Coord<3>(), Coord<3>(10, 10, 10)), defaultCell, edgeCell);
+        TS_ASSERT(!smallGrid.delegate.parallel_construction());
+
+        FirstTouch::enable(false);
+    }
+
     void test2d()
     {
         CoordBox<2> box(Coord<2>(10, 15), Coord<2>(50, 40));
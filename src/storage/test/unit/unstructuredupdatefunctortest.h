@@ -105,16 +105,17 @@ public:
     template<typename HOOD_NEW, typename HOOD_OLD>
     static void updateLineX(HOOD_NEW& hoodNew, int indexEnd, HOOD_OLD& hoodOld, unsigned /* nanoStep */)
     {
-        for (int i = hoodOld.index(); i < indexEnd / HOOD_OLD::ARITY; ++i, ++hoodOld) {
+        double *sumPtr = &hoodNew->sum();
+        for (int i = hoodOld.index(); i < indexEnd / HOOD_OLD::ARITY; ++i, ++hoodOld, sumPtr += 4) {
             ShortVec tmp;
-            tmp.load_aligned(&hoodNew->sum() + i * 4);
+            tmp.load_aligned(sumPtr);
             for (const auto& j: hoodOld.weights(0)) {
                 ShortVec weights, values;
                 weights.load_aligned(j.second());
                 values.gather(&hoodOld->value(), j.first());
                 tmp += values * weights;
             }
-            tmp.store_aligned(&hoodNew->sum() + i * 4);
+            tmp.store_aligned(sumPtr);
         }
     }
 
@@ -141,8 +142,58 @@ public:
     double sum;
 };
 
+/**
+ * Tags each cell with the ID of the first cell of the line it was
+ * updated with via updateLineX(). This pins down where hoodNew points
+ * to when updateLineX() gets called.
+ */
+class LineStartSoATestCell
+{
+public:
+    class API :
+        public APITraits::HasUpdateLineX,
+        public APITraits::HasSoA,
+        public APITraits::HasUnstructuredTopology,
+        public APITraits::HasSellType<double>,
+        public APITraits::HasSellMatrices<1>,
+        public APITraits::HasSellC<4>,
+        public APITraits::HasSellSigma<1>
+    {
+    public:
+        LIBFLATARRAY_CUSTOM_SIZES((16)(32)(64)(128)(256)(512), (1), (1))
+    };
+
+    inline explicit LineStartSoATestCell(double value = 0) :
+        value(value),
+        lineStart(-1)
+    {}
+
+    template<typename HOOD_NEW, typename HOOD_OLD>
+    static void updateLineX(HOOD_NEW& hoodNew, int indexEnd, HOOD_OLD& hoodOld, unsigned /* nanoStep */)
+    {
+        int start = hoodOld.index() * HOOD_OLD::ARITY;
+
+        for (; hoodOld.index() < indexEnd / HOOD_OLD::ARITY; ++hoodOld) {
+            for (int i = 0; i < HOOD_OLD::ARITY; ++i) {
+                hoodNew->lineStart() = start;
+                ++hoodNew;
+            }
+        }
+    }
+
+    template<typename NEIGHBORHOOD>
+    void update(NEIGHBORHOOD& /* neighborhood */, unsigned /* nanoStep */)
+    {
+        lineStart = -2;
+    }
+
+    double value;
+    int lineStart;
+};
+
 LIBFLATARRAY_REGISTER_SOA(SimpleUnstructuredSoATestCell<1  >, ((double)(sum))((double)(value)))
 LIBFLATARRAY_REGISTER_SOA(SimpleUnstructuredSoATestCell<150>, ((double)(sum))((double)(value)))
+LIBFLATARRAY_REGISTER_SOA(LineStartSoATestCell, ((double)(value))((int)(lineStart)))
 #endif
 
 namespace LibGeoDecomp {
@@ -450,6 +501,204 @@ public:
                 TS_ASSERT_EQUALS(0.0, gridNew.get(coord).sum);
             }
         }
+#endif
+    }
+
+    void testChunkAlignedWorkPackages()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        Region<1> region;
+        region << Streak<1>(Coord<1>( 1),  3);
+        region << Streak<1>(Coord<1>( 6), 19);
+        region << Streak<1>(Coord<1>(24), 32);
+
+        std::vector<std::vector<Streak<1> > > packages =
+            UnstructuredUpdateFunctorHelpers::chunkAlignedWorkPackages(region, 8);
+
+        // streaks are cut at multiples of 8, pieces within the same
+        // 8 cells are grouped in one package:
+        std::vector<std::vector<Streak<1> > > expected(4);
+        expected[0] << Streak<1>(Coord<1>( 1),  3)
+                    << Streak<1>(Coord<1>( 6),  8);
+        expected[1] << Streak<1>(Coord<1>( 8), 16);
+        expected[2] << Streak<1>(Coord<1>(16), 19);
+        expected[3] << Streak<1>(Coord<1>(24), 32);
+
+        TS_ASSERT_EQUALS(expected, packages);
+#endif
+    }
+
+    void testSoAWithStreaksWithinSingleChunk()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int DIM = 20;
+        CoordBox<1> dim(Coord<1>(0), Coord<1>(DIM));
+
+        SimpleUnstructuredSoATestCell<1> defaultCell(200);
+        SimpleUnstructuredSoATestCell<1> edgeCell(-1);
+
+        UnstructuredSoAGrid<SimpleUnstructuredSoATestCell<1>, 1, double, 4, 1> gridOld(dim, defaultCell, edgeCell);
+        UnstructuredSoAGrid<SimpleUnstructuredSoATestCell<1>, 1, double, 4, 1> gridNew(dim, defaultCell, edgeCell);
+
+        Region<1> region;
+        region << Streak<1>(Coord<1>( 1),  3);
+        region << Streak<1>(Coord<1>( 5),  6);
+        region << Streak<1>(Coord<1>(10), 15);
+
+        std::map<Coord<2>, double> matrix;
+        for (int row = 0; row < DIM; ++row) {
+            for (int col = 0; col < row; ++col) {
+                matrix[Coord<2>(row, col)] = 1;
+            }
+        }
+        gridOld.setWeights(0, matrix);
+
+        UnstructuredUpdateFunctor<SimpleUnstructuredSoATestCell<1> > functor;
+        UpdateFunctorHelpers::ConcurrencyNoP concurrencySpec;
+        APITraits::SelectThreadedUpdate<SimpleUnstructuredSoATestCell<1> >::Value modelThreadingSpec;
+
+        functor(region, gridOld, &gridNew, 0, concurrencySpec, modelThreadingSpec);
+
+        for (Coord<1> coord(0); coord < Coord<1>(DIM); ++coord.x()) {
+            if (region.count(coord)) {
+                TS_ASSERT_EQUALS(coord.x() * 200.0, gridNew.get(coord).sum);
+            } else {
+                TS_ASSERT_EQUALS(0.0, gridNew.get(coord).sum);
+            }
+        }
+#endif
+    }
+
+    void testSoAUpdateLineXStartsAtLine()
+    {
+#ifdef LIBGEODECOMP_WITH_CPP14
+        const int DIM = 64;
+        CoordBox<1> dim(Coord<1>(0), Coord<1>(DIM));
+
+        LineStartSoATestCell defaultCell;
+        LineStartSoATestCell edgeCell;
+
+        UnstructuredSoAGrid<LineStartSoATestCell, 1, double, 4, 1> gridOld(dim, defaultCell, edgeCell);
+        UnstructuredSoAGrid<LineStartSoATestCell, 1, double, 4, 1> gridNew(dim, defaultCell, edgeCell);
+
+        Region<1> region;
+        region << Streak<1>(Coord<1>( 5), 30);
+        region << Streak<1>(Coord<1>(41), 64);
+
+        std::map<Coord<2>, double> matrix;
+        for (int row = 0; row < DIM; ++row) {
+            matrix[Coord<2>(row, row)] = 1;
+        }
+        gridOld.setWeights(0, matrix);
+
+        UnstructuredUpdateFunctor<LineStartSoATestCell> functor;
+        UpdateFunctorHelpers::ConcurrencyNoP concurrencySpec;
+        APITraits::SelectThreadedUpdate<LineStartSoATestCell>::Value modelThreadingSpec;
+
+        functor(region, gridOld, &gridNew, 0, concurrencySpec, modelThreadingSpec);
+
+        // lines are [8, 28) and [44, 64), the rest is peeled off:
+        for (Coord<1> coord(0); coord < Coord<1>(DIM); ++coord.x()) {
+            int expected = -1;
+            if (region.count(coord)) {
+                expected = -2;
+            }
+            if ((coord.x() >= 8) && (coord.x() < 28)) {
+                expected = 8;
+            }
+            if (coord.x() >= 44) {
+                expected = 44;
+            }
+
+            TS_ASSERT_EQUALS(expected, gridNew.get(coord).lineStart);
+        }
+#endif
+    }
+
+    void testSoAWithOpenMP()
+    {
+#if defined(LIBGEODECOMP_WITH_CPP14) && defined(LIBGEODECOMP_WITH_THREADS)
+        const int DIM = 500;
+        CoordBox<1> dim(Coord<1>(0), Coord<1>(DIM));
+
+        SimpleUnstructuredSoATestCell<1> defaultCell(200);
+        SimpleUnstructuredSoATestCell<1> edgeCell(-1);
+
+        UnstructuredSoAGrid<SimpleUnstructuredSoATestCell<1>, 1, double, 4, 1> gridOld(dim, defaultCell, edgeCell);
+
+        Region<1> region;
+        region << Streak<1>(Coord<1>(  3), 247);
+        region << Streak<1>(Coord<1>(251), 252);
+        region << Streak<1>(Coord<1>(255), 499);
+
+        // weights matrix looks like this: 1 0 0 1 0 0 1 0 0 ...
+        std::map<Coord<2>, double> matrix;
+        for (int row = 0; row < DIM; ++row) {
+            for (int col = 0; col < DIM; col += 3) {
+                matrix[Coord<2>(row, col)] = 1;
+            }
+        }
+        gridOld.setWeights(0, matrix);
+
+        UnstructuredUpdateFunctor<SimpleUnstructuredSoATestCell<1> > functor;
+        APITraits::SelectThreadedUpdate<SimpleUnstructuredSoATestCell<1> >::Value modelThreadingSpec;
+
+        for (int fineGrained = 0; fineGrained < 2; ++fineGrained) {
+            UnstructuredSoAGrid<SimpleUnstructuredSoATestCell<1>, 1, double, 4, 1> gridNew(dim, defaultCell, edgeCell);
+            UpdateFunctorHelpers::ConcurrencyEnableOpenMP concurrencySpec(false, fineGrained);
+
+            functor(region, gridOld, &gridNew, 0, concurrencySpec, modelThreadingSpec);
+
+            for (Coord<1> coord(0); coord < Coord<1>(DIM); ++coord.x()) {
+                if (region.count(coord)) {
+                    TS_ASSERT_EQUALS(((DIM + 2) / 3) * 200.0, gridNew.get(coord).sum);
+                } else {
+                    TS_ASSERT_EQUALS(0.0, gridNew.get(coord).sum);
+                }
+            }
+        }
+#endif
+    }
+
+    void testAoSWithOpenMP()
+    {
+#if defined(LIBGEODECOMP_WITH_CPP14) && defined(LIBGEODECOMP_WITH_THREADS)
+        const int DIM = 2000;
+        Coord<1> dim(DIM);
+
+        typedef SimpleUnstructuredTestCell<1, EmptyUnstructuredTestCellAPI> TestCellType;
+        TestCellType defaultCell(200);
+        TestCellType edgeCell(-1);
+
+        UnstructuredGrid<TestCellType, 1, double, 4, 1> gridOld(dim, defaultCell, edgeCell);
+        UnstructuredGrid<TestCellType, 1, double, 4, 1> gridNew(dim, defaultCell, edgeCell);
+
+        Region<1> region;
+        region << Streak<1>(Coord<1>(  10), 1030);
+        region << Streak<1>(Coord<1>(1040), 1999);
+
+        // weights matrix looks like this: 1 0 1 0 1 0 ...
+        std::map<Coord<2>, double> matrix;
+        for (int row = 0; row < DIM; ++row) {
+            for (int col = 0; col < DIM; col += 2) {
+                matrix[Coord<2>(row, col)] = 1;
+            }
+        }
+        gridOld.setWeights(0, matrix);
+
+        UnstructuredUpdateFunctor<TestCellType> functor;
+        UpdateFunctorHelpers::ConcurrencyEnableOpenMP concurrencySpec(true, false);
+        APITraits::SelectThreadedUpdate<TestCellType>::Value modelThreadingSpec;
+
+        functor(region, gridOld, &gridNew, 0, concurrencySpec, modelThreadingSpec);
+
+        for (Coord<1> coord(0); coord < Coord<1>(DIM); ++coord.x()) {
+            if (region.count(coord)) {
+                TS_ASSERT_EQUALS((DIM / 2.0) * 200.0, gridNew.get(coord).sum);
+            } else {
+                TS_ASSERT_EQUALS(0.0, gridNew.get(coord).sum);
+            }
+        }
 #endif
     }
 };
@@ -0,0 +1,243 @@
+#include <libgeodecomp/geometry/region.h>
+#include <libgeodecomp/storage/boxcell.h>
+#include <libgeodecomp/storage/grid.h>
+#include <libgeodecomp/storage/updatefunctor.h>
+#include <libgeodecomp/storage/verletboxcell.h>
+#include <cxxtest/TestSuite.h>
+
+using namespace LibGeoDecomp;
+
+namespace LibGeoDecomp {
+
+/**
+ * Moves at a constant velocity and sums up a potential over all
+ * particles closer than the cutoff. Also counts how many particles
+ * it had to look at.
+ */
+class VerletTestParticle
+{
+public:
+    class API : public APITraits::HasCubeTopology<3>
+    {};
+
+    explicit VerletTestParticle(
+        const FloatCoord<3>& pos = FloatCoord<3>(),
+        const FloatCoord<3>& velocity = FloatCoord<3>(),
+        const double cutoff = 0) :
+        pos(pos),
+        velocity(velocity),
+        cutoff2(cutoff * cutoff),
+        potential(0),
+        neighbors(0),
+        candidates(0)
+    {}
+
+    template<typename HOOD>
+    inline void update(const HOOD& hood, const int nanoStep)
+    {
+        potential = 0;
+        neighbors = 0;
+        candidates = 0;
+
+        for (typename HOOD::Iterator i = hood.begin(); i != hood.end(); ++i) {
+            ++candidates;
+            FloatCoord<3> delta = i->pos - pos;
+            double distance2 = delta * delta;
+            if (distance2 < cutoff2) {
+                ++neighbors;
+                potential += cutoff2 - distance2;
+            }
+        }
+
+        pos += velocity;
+    }
+
+    inline const FloatCoord<3>& getPos() const
+    {
+        return pos;
+    }
+
+    FloatCoord<3> pos;
+    FloatCoord<3> velocity;
+    double cutoff2;
+    double potential;
+    int neighbors;
+    int candidates;
+};
+
+class VerletBoxCellTest : public CxxTest::TestSuite
+{
+public:
+    typedef BoxCell<FixedArray<VerletTestParticle, 40> > BoxCellType;
+    typedef VerletBoxCell<VerletTestParticle, 40> VerletCellType;
+    typedef APITraits::SelectTopology<BoxCellType>::Value Topology;
+    typedef Grid<BoxCellType, Topology> BoxGridType;
+    typedef Grid<VerletCellType, Topology> VerletGridType;
+
+    void setUp()
+    {
+        gridDim = Coord<3>(5, 4, 6);
+        box = CoordBox<3>(Coord<3>(), gridDim);
+        region.clear();
+        region << box;
+        cutoff = 0.7;
+        skin = 0.3;
+    }
+
+    void testStaticParticles()
+    {
+        BoxGridType boxGrid1(gridDim);
+        BoxGridType boxGrid2(gridDim);
+        VerletGridType verletGrid1(gridDim);
+        VerletGridType verletGrid2(gridDim);
+        init(&boxGrid1, &verletGrid1, 0);
+
+        for (int t = 0; t < 2; ++t) {
+            step(&boxGrid1, &boxGrid2, &verletGrid1, &verletGrid2);
+            checkEqual(boxGrid2, verletGrid2);
+            step(&boxGrid2, &boxGrid1, &verletGrid2, &verletGrid1);
+            checkEqual(boxGrid1, verletGrid1);
+        }
+
+        int boxCandidates = 0;
+        int verletCandidates = 0;
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            const VerletCellType& cell = verletGrid1[*i];
+            // reference positions were only set once, after the
+            // particles had been inserted initially:
+            TS_ASSERT_EQUALS(1, cell.stamp);
+            TS_ASSERT(!cell.displaced);
+
+            for (std::size_t j = 0; j < cell.size(); ++j) {
+                boxCandidates    += boxGrid1[*i][j].candidates;
+                verletCandidates += cell[j].candidates;
+            }
+        }
+
+        TS_ASSERT_LESS_THAN(0, verletCandidates);
+        TS_ASSERT_LESS_THAN(verletCandidates * 3, boxCandidates);
+    }
+
+    void testMovingParticles()
+    {
+        BoxGridType boxGrid1(gridDim);
+        BoxGridType boxGrid2(gridDim);
+        VerletGridType verletGrid1(gridDim);
+        VerletGridType verletGrid2(gridDim);
+        init(&boxGrid1, &verletGrid1, 0.02);
+
+        for (int t = 0; t < 20; ++t) {
+            step(&boxGrid1, &boxGrid2, &verletGrid1, &verletGrid2);
+            checkEqual(boxGrid2, verletGrid2);
+            step(&boxGrid2, &boxGrid1, &verletGrid2, &verletGrid1);
+            checkEqual(boxGrid1, verletGrid1);
+        }
+
+        // particles have moved far enough to require new reference
+        // positions at least once, but not in every step:
+        int maxStamp = 0;
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            maxStamp = (std::max)(maxStamp, verletGrid1[*i].stamp);
+        }
+        TS_ASSERT_LESS_THAN(1, maxStamp);
+        TS_ASSERT_LESS_THAN(maxStamp, 40);
+    }
+
+    void testOverfullPairList()
+    {
+        BoxGridType boxGrid1(gridDim);
+        BoxGridType boxGrid2(gridDim);
+        VerletGridType verletGrid1(gridDim);
+        VerletGridType verletGrid2(gridDim);
+        // 40 particles per box yield far more than the default
+        // MAX_PAIRS = 40 * 64 candidates:
+        init(&boxGrid1, &verletGrid1, 0, 40);
+
+        for (int t = 0; t < 2; ++t) {
+            step(&boxGrid1, &boxGrid2, &verletGrid1, &verletGrid2);
+            checkEqual(boxGrid2, verletGrid2);
+            step(&boxGrid2, &boxGrid1, &verletGrid2, &verletGrid1);
+            checkEqual(boxGrid1, verletGrid1);
+        }
+
+        // boxes at the boundary have fewer neighbors and may still
+        // fit their lists, but the inner ones must have fallen back:
+        int overflows = 0;
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            const VerletCellType& cell = verletGrid1[*i];
+            TS_ASSERT_EQUALS(std::size_t(40), cell.size());
+            if (cell.offsets.size() == 0) {
+                TS_ASSERT_EQUALS(std::size_t(0), cell.pairs.size());
+                ++overflows;
+            }
+        }
+        TS_ASSERT_LESS_THAN(0, overflows);
+    }
+
+private:
+    Coord<3> gridDim;
+    CoordBox<3> box;
+    Region<3> region;
+    double cutoff;
+    double skin;
+
+    void init(BoxGridType *boxGrid, VerletGridType *verletGrid, double maxVelocity, int particlesPerBox = 8)
+    {
+        FloatCoord<3> cellDim(1.0, 1.0, 1.0);
+        int counter = 0;
+
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            FloatCoord<3> origin = cellDim.scale(*i);
+            (*boxGrid)[*i] = BoxCellType(origin, cellDim);
+            (*verletGrid)[*i] = VerletCellType(origin, cellDim, cutoff, skin);
+
+            for (int j = 0; j < particlesPerBox; ++j) {
+                FloatCoord<3> pos(
+                    origin[0] + random(&counter),
+                    origin[1] + random(&counter),
+                    origin[2] + random(&counter));
+                FloatCoord<3> velocity(
+                    maxVelocity * (2 * random(&counter) - 1),
+                    maxVelocity * (2 * random(&counter) - 1),
+                    maxVelocity * (2 * random(&counter) - 1));
+
+                VerletTestParticle particle(pos, velocity, cutoff);
+                (*boxGrid)[*i].insert(particle);
+                (*verletGrid)[*i].insert(particle);
+            }
+        }
+    }
+
+    /**
+     * A deterministic sequence of numbers in [0, 1).
+     */
+    double random(int *counter)
+    {
+        ++*counter;
+        return ((*counter * 7919) % 1000) * 0.001;
+    }
+
+    void step(BoxGridType *boxGrid1, BoxGridType *boxGrid2, VerletGridType *verletGrid1, VerletGridType *verletGrid2)
+    {
+        UpdateFunctor<BoxCellType>()(region, Coord<3>(), Coord<3>(), *boxGrid1, boxGrid2, 0);
+        UpdateFunctor<VerletCellType>()(region, Coord<3>(), Coord<3>(), *verletGrid1, verletGrid2, 0);
+    }
+
+    void checkEqual(const BoxGridType& boxGrid, const VerletGridType& verletGrid)
+    {
+        for (CoordBox<3>::Iterator i = box.begin(); i != box.end(); ++i) {
+            const BoxCellType& boxCell = boxGrid[*i];
+            const VerletCellType& verletCell = verletGrid[*i];
+            TS_ASSERT_EQUALS(boxCell.size(), verletCell.size());
+
+            for (std::size_t j = 0; j < boxCell.size(); ++j) {
+                TS_ASSERT_EQUALS(boxCell[j].getPos(), verletCell[j].getPos());
+                TS_ASSERT_EQUALS(boxCell[j].neighbors, verletCell[j].neighbors);
+                TS_ASSERT_DELTA(boxCell[j].potential, verletCell[j].potential, 1e-10);
+            }
+        }
+    }
+};
+
+}
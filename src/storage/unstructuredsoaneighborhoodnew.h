@@ -10,7 +10,9 @@ namespace LibGeoDecomp {
 
 /**
  * Neighborhood which is used for hoodNew in updateLineX().
- * Provides access to member pointers of the new grid.
+ * Provides access to member pointers of the new grid. It initially
+ * points to the first cell of the line to be updated, not to the
+ * grid's first cell, see APITraits::HasUpdateLineX.
  */
 template<typename CELL, long DIM_X, long DIM_Y, long DIM_Z, long INDEX>
 class UnstructuredSoANeighborhoodNew
@@ -23,15 +23,138 @@
 #include <libgeodecomp/storage/unstructuredsoascalarneighborhood.h>
 #include <libgeodecomp/storage/updatefunctormacros.h>
 
+#include <algorithm>
+#include <vector>
+
+#if !defined(LGD_UNSTRUCTURED_CHUNKS_PER_PACKAGE)
+#define LGD_UNSTRUCTURED_CHUNKS_PER_PACKAGE 16
+#endif
+
 namespace LibGeoDecomp {
 
 namespace UnstructuredUpdateFunctorHelpers {
 
+/**
+ * Cuts the streaks of the region into work packages whose boundaries
+ * are multiples of packageSize. If packageSize is a multiple of the
+ * SELL-C-sigma chunk size C, then no two packages will ever touch the
+ * same chunk, so they may be updated by different threads
+ * concurrently. Pieces of multiple streaks which fall into the same
+ * package are handled by one thread.
+ */
+template<int DIM>
+std::vector<std::vector<Streak<DIM> > > chunkAlignedWorkPackages(
+    const Region<DIM>& region,
+    int packageSize)
+{
+    std::vector<std::vector<Streak<DIM> > > ret;
+    int currentPackage = -1;
+
+    for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+        for (int x = i->origin.x(); x < i->endX;) {
+            int package = x / packageSize;
+            int endX = (std::min)(i->endX, (package + 1) * packageSize);
+
+            if (package != currentPackage) {
+                ret.push_back(std::vector<Streak<DIM> >());
+                currentPackage = package;
+            }
+
+            Streak<DIM> piece = *i;
+            piece.origin.x() = x;
+            piece.endX = endX;
+            ret.back() << piece;
+
+            x = endX;
+        }
+    }
+
+    return ret;
+}
+
+/**
+ * Applies the functor to all streaks of the region. If the
+ * concurrency spec asks for it, this is done in parallel on
+ * work packages as defined by chunkAlignedWorkPackages(). Fine
+ * grained parallelism yields packages of exactly one chunk, coarse
+ * packages span LGD_UNSTRUCTURED_CHUNKS_PER_PACKAGE chunks.
+ */
+template<int DIM, typename CONCURRENCY_FUNCTOR, typename ANY_THREADED_UPDATE, typename FUNCTOR>
+void forEachStreak(
+    const Region<DIM>& region,
+    int chunkSize,
+    const CONCURRENCY_FUNCTOR& concurrencySpec,
+    const ANY_THREADED_UPDATE& modelThreadingSpec,
+    const FUNCTOR& functor)
+{
+    typedef std::vector<std::vector<Streak<DIM> > > PackageVec;
+    int packageSize = chunkSize;
+    if (!concurrencySpec.preferFineGrainedParallelism()) {
+        packageSize *= LGD_UNSTRUCTURED_CHUNKS_PER_PACKAGE;
+    }
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+    if (concurrencySpec.enableOpenMP() && !modelThreadingSpec.hasOpenMP()) {
+        PackageVec packages = chunkAlignedWorkPackages(region, packageSize);
+        // OpenMP 2.5 (MSVC) insists on signed loop counters:
+        const int numPackages = packages.size();
+
+        if (concurrencySpec.preferStaticScheduling()) {
+#pragma omp parallel for schedule(static)
+            for (int p = 0; p < numPackages; ++p) {
+                for (typename std::vector<Streak<DIM> >::const_iterator i = packages[p].begin();
+                     i != packages[p].end();
+                     ++i) {
+                    functor(*i);
+                }
+            }
+        } else {
+#pragma omp parallel for schedule(dynamic)
+            for (int p = 0; p < numPackages; ++p) {
+                for (typename std::vector<Streak<DIM> >::const_iterator i = packages[p].begin();
+                     i != packages[p].end();
+                     ++i) {
+                    functor(*i);
+                }
+            }
+        }
+
+        return;
+    }
+#endif
+
+#ifdef LIBGEODECOMP_WITH_HPX
+    if (concurrencySpec.enableHPX() && !modelThreadingSpec.hasHPX()) {
+        PackageVec packages = chunkAlignedWorkPackages(region, packageSize);
+        std::vector<hpx::future<void> > updateFutures;
+        updateFutures.reserve(packages.size());
+
+        for (typename PackageVec::const_iterator p = packages.begin(); p != packages.end(); ++p) {
+            updateFutures << hpx::async(
+                [&functor, p]() {
+                    for (typename std::vector<Streak<DIM> >::const_iterator i = p->begin();
+                         i != p->end();
+                         ++i) {
+                        functor(*i);
+                    }
+                });
+        }
+
+        hpx::wait_all(updateFutures);
+        return;
+    }
+#endif
+
+    for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
+        functor(*i);
+    }
+}
+
 /**
  * Functor to be used from with LibFlatArray from within
  * UnstructuredUpdateFunctor. Hides much of the boilerplate code.
  */
-template<typename CELL>
+template<typename CELL, typename CONCURRENCY_FUNCTOR, typename ANY_THREADED_UPDATE>
 class UnstructuredGridSoAUpdateHelper
 {
 public:
@@ -45,13 +168,15 @@ public:
 
     UnstructuredGridSoAUpdateHelper(
         const Grid& gridOld,
-        Grid *gridNew,
         const Region<DIM>& region,
-        unsigned nanoStep) :
+        unsigned nanoStep,
+        const CONCURRENCY_FUNCTOR& concurrencySpec,
+        const ANY_THREADED_UPDATE& modelThreadingSpec) :
         gridOld(gridOld),
-        gridNew(gridNew),
         region(region),
-        nanoStep(nanoStep)
+        nanoStep(nanoStep),
+        concurrencySpec(concurrencySpec),
+        modelThreadingSpec(modelThreadingSpec)
     {}
 
     template<
@@ -61,66 +186,78 @@ public:
         LibFlatArray::soa_accessor<CELL1, MY_DIM_X1, MY_DIM_Y1, MY_DIM_Z1, INDEX1>& oldAccessor,
         LibFlatArray::soa_accessor<CELL2, MY_DIM_X2, MY_DIM_Y2, MY_DIM_Z2, INDEX2>& newAccessor) const
     {
-        // fixme: threading!
-        for (typename Region<DIM>::StreakIterator i = region.beginStreak(); i != region.endStreak(); ++i) {
-            // Assumption: Cell has both (updateLineX and update())
-
-            // loop peeling: streak's start might point to middle of chunks
-            // if so: vectorization cannot be done -> solution: additionally
-            // update the first and last chunk of complete streak scalar by
-            // calling update() instead
-            int startX = i->origin.x();
-            if ((startX % C) != 0) {
-                UnstructuredSoAScalarNeighborhood<CELL, MATRICES, ValueType, C, SIGMA>
-                    hoodOld(gridOld, startX);
-                const int cellsToUpdate = C - (startX % C);
-                FixedArray<CELL, C> cells;
-                Streak<1> cellStreak(Coord<1>(startX), startX + cellsToUpdate);
-
-                // update SoA grid: copy cells to local buffer, update, copy data back to grid
-                gridNew->get(cellStreak, cells.begin());
-                // call update
-                for (int i = 0; i < cellsToUpdate; ++i, ++hoodOld) {
-                    cells[i].update(hoodOld, nanoStep);
+        typedef LibFlatArray::soa_accessor<CELL2, MY_DIM_X2, MY_DIM_Y2, MY_DIM_Z2, INDEX2> NewAccessor;
+
+        forEachStreak(
+            region,
+            C,
+            concurrencySpec,
+            modelThreadingSpec,
+            [this, &oldAccessor, &newAccessor](const Streak<DIM>& streak) {
+                // Assumption: Cell has both (updateLineX and update())
+
+                // loop peeling: streak's start and end might point to
+                // the middle of chunks. These can't be vectorized,
+                // so we update the first and last chunk of a streak
+                // by calling update() instead:
+                int startX = streak.origin.x();
+                int endX = streak.endX;
+                int headEndX = (std::min)(endX, (startX + C - 1) / C * C);
+                int tailStartX = (std::max)(headEndX, endX - endX % C);
+
+                updateScalar(newAccessor, startX, headEndX);
+
+                if (headEndX < tailStartX) {
+                    // call updateLineX with adjusted indices
+                    UnstructuredSoANeighborhood<CELL, MY_DIM_X1, MY_DIM_Y1, MY_DIM_Z1, INDEX1,
+                                                MATRICES, ValueType, C, SIGMA>
+                        hoodOld(oldAccessor, gridOld, headEndX);
+
+                    // the accessor is shared among all threads, but
+                    // updateLineX() may move it, hence the copy.
+                    // Cells write relative to the new accessor, so it
+                    // has to point to the line's first cell:
+                    NewAccessor lineNewAccessor = newAccessor;
+                    lineNewAccessor += long(headEndX);
+                    UnstructuredSoANeighborhoodNew<CELL, MY_DIM_X2, MY_DIM_Y2, MY_DIM_Z2, INDEX2>
+                        hoodNew(&lineNewAccessor);
+                    CELL::updateLineX(hoodNew, tailStartX, hoodOld, nanoStep);
                 }
-                // fixme: woah, avoid these copies!
-                gridNew->set(cellStreak, cells.begin());
 
-                startX += cellsToUpdate;
-            }
-
-            // call updateLineX with adjusted indices
-            UnstructuredSoANeighborhood<CELL, MY_DIM_X1, MY_DIM_Y1, MY_DIM_Z1, INDEX1,
-                                        MATRICES, ValueType, C, SIGMA>
-                hoodOld(oldAccessor, gridOld, startX);
-
-            UnstructuredSoANeighborhoodNew<CELL, MY_DIM_X2, MY_DIM_Y2, MY_DIM_Z2, INDEX2> hoodNew(&newAccessor);
-            CELL::updateLineX(hoodNew, i->endX, hoodOld, nanoStep);
-
-            // call scalar updates for last chunk
-            if ((i->endX % C) != 0) {
-                const int cellsToUpdate = i->endX % C;
-                UnstructuredSoAScalarNeighborhood<CELL, MATRICES, ValueType, C, SIGMA>
-                    hoodOld(gridOld, i->endX - cellsToUpdate);
-                FixedArray<CELL, C> cells;
-                Streak<1> cellStreak(Coord<1>(i->endX - cellsToUpdate), i->endX);
-
-                // update SoA grid: copy cells to local buffer, update, copy data back to grid
-                gridNew->get(cellStreak, cells.begin());
-                // call update
-                for (int i = 0; i < cellsToUpdate; ++i, ++hoodOld) {
-                    cells[i].update(hoodOld, nanoStep);
-                }
-                gridNew->set(cellStreak, cells.begin());
-            }
-        }
+                updateScalar(newAccessor, tailStartX, endX);
+            });
     }
 
 private:
     const Grid& gridOld;
-    Grid *gridNew;
     const Region<DIM>& region;
     unsigned nanoStep;
+    const CONCURRENCY_FUNCTOR& concurrencySpec;
+    const ANY_THREADED_UPDATE& modelThreadingSpec;
+
+    /**
+     * Scalar update of the cells [startX, endX), directly within the
+     * new grid's SoA storage, which saves us the round trip through
+     * the grid's get()/set() and a temporary buffer.
+     */
+    template<typename NEW_ACCESSOR>
+    void updateScalar(NEW_ACCESSOR newAccessor, int startX, int endX) const
+    {
+        if (startX >= endX) {
+            return;
+        }
+
+        UnstructuredSoAScalarNeighborhood<CELL, MATRICES, ValueType, C, SIGMA>
+            hoodOld(gridOld, startX);
+        newAccessor += long(startX);
+        CELL cell;
+
+        for (int x = startX; x < endX; ++x, ++hoodOld, ++newAccessor) {
+            newAccessor >> cell;
+            cell.update(hoodOld, nanoStep);
+            newAccessor << cell;
+        }
+    }
 };
 
 }
@@ -213,20 +350,20 @@ public:
             return;
         }
 #endif
-#define LGD_UPDATE_FUNCTOR_BODY                                         \
-        UnstructuredNeighborhood<CELL, MATRICES, ValueType, C, SIGMA>   \
-            hoodOld(gridOld, i->origin.x());                            \
-        UnstructuredNeighborhoodNew<CELL, MATRICES, ValueType, C, SIGMA>         \
-            hoodNew(*gridNew);                                          \
-        for (int id = i->origin.x(); id != i->endX; ++id, ++hoodOld) {  \
-            hoodNew[id].update(hoodOld, nanoStep);                      \
-        }                                                               \
-        /**/
-        LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_1
-        LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_2
-        LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_3
-        LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_4
-#undef LGD_UPDATE_FUNCTOR_BODY
+        UnstructuredUpdateFunctorHelpers::forEachStreak(
+            region,
+            C,
+            concurrencySpec,
+            modelThreadingSpec,
+            [&gridOld, gridNew, nanoStep](const Streak<DIM>& streak) {
+                UnstructuredNeighborhood<CELL, MATRICES, ValueType, C, SIGMA>
+                    hoodOld(gridOld, streak.origin.x());
+                UnstructuredNeighborhoodNew<CELL, MATRICES, ValueType, C, SIGMA>
+                    hoodNew(*gridNew);
+                for (int id = streak.origin.x(); id != streak.endX; ++id, ++hoodOld) {
+                    hoodNew[id].update(hoodOld, nanoStep);
+                }
+            });
     }
 
     template<typename GRID1, typename GRID2, typename CONCURRENCY_FUNCTOR, typename ANY_THREADED_UPDATE>
@@ -240,19 +377,18 @@ public:
         // has cell updateLineX()?
         APITraits::TrueType)
     {
-        // fixme: fine-grained parallelism?
-#define LGD_UPDATE_FUNCTOR_BODY                                         \
-        UnstructuredNeighborhood<CELL, MATRICES, ValueType, C, SIGMA>   \
-            hoodOld(gridOld, i->origin.x());                            \
-        UnstructuredNeighborhoodNew<CELL, MATRICES, ValueType, C, SIGMA> \
-            hoodNew(*gridNew);                                          \
-        CELL::updateLineX(hoodNew, i->endX, hoodOld, nanoStep);         \
-        /**/
-        LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_1
-        LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_2
-        LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_3
-        LGD_UPDATE_FUNCTOR_THREADING_SELECTOR_4
-#undef LGD_UPDATE_FUNCTOR_BODY
+        UnstructuredUpdateFunctorHelpers::forEachStreak(
+            region,
+            C,
+            concurrencySpec,
+            modelThreadingSpec,
+            [&gridOld, gridNew, nanoStep](const Streak<DIM>& streak) {
+                UnstructuredNeighborhood<CELL, MATRICES, ValueType, C, SIGMA>
+                    hoodOld(gridOld, streak.origin.x());
+                UnstructuredNeighborhoodNew<CELL, MATRICES, ValueType, C, SIGMA>
+                    hoodNew(*gridNew);
+                CELL::updateLineX(hoodNew, streak.endX, hoodOld, nanoStep);
+            });
     }
 
     template<typename GRID1, typename GRID2, typename CONCURRENCY_FUNCTOR, typename ANY_THREADED_UPDATE>
@@ -284,12 +420,13 @@ public:
     {
         gridOld.callback(
             gridNew,
-            // fixme: is missing concurrencySpec, modelThreadingSpec
-            UnstructuredUpdateFunctorHelpers::UnstructuredGridSoAUpdateHelper<CELL>(
-                gridOld,
-                gridNew,
-                region,
-                nanoStep));
+            UnstructuredUpdateFunctorHelpers::UnstructuredGridSoAUpdateHelper<
+                CELL, CONCURRENCY_FUNCTOR, ANY_THREADED_UPDATE>(
+                    gridOld,
+                    region,
+                    nanoStep,
+                    concurrencySpec,
+                    modelThreadingSpec));
     }
 };
 
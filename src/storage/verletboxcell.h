@@ -0,0 +1,404 @@
+#ifndef LIBGEODECOMP_STORAGE_VERLETBOXCELL_H
+#define LIBGEODECOMP_STORAGE_VERLETBOXCELL_H
+
+#include <libgeodecomp/geometry/coord.h>
+#include <libgeodecomp/geometry/coordbox.h>
+#include <libgeodecomp/geometry/floatcoord.h>
+#include <libgeodecomp/storage/boxcell.h>
+#include <libgeodecomp/storage/fixedarray.h>
+#include <libgeodecomp/storage/soaboxneighborhood.h>
+
+#include <algorithm>
+
+namespace LibGeoDecomp {
+
+/**
+ * A BoxCell which caches a Verlet list for each of its particles:
+ * the indices of all particles in the surrounding boxes which are
+ * closer than cutoff + skin. During update() particles then only
+ * get to see these candidates instead of all particles in the 3^DIM
+ * surrounding boxes. Hence models need to ignore all particles
+ * further away than cutoff. Particles need to provide getPos().
+ *
+ * A list remains valid as long as no particle in the neighborhood has
+ * moved more than skin/2 away from its reference position and no box
+ * has gained or lost particles. Each box increments its stamp
+ * whenever it resets its reference positions, so lists are only
+ * rebuilt if one of the stamps they were built from has changed.
+ * Whenever the lists can't be trusted (e.g. right after particles
+ * have migrated) the update falls back to a full traversal of the
+ * neighborhood, just like BoxCell.
+ *
+ * All state is kept in FixedArrays, so cells can still be copied
+ * bitwise. MAX_PAIRS limits the total length of all lists of a box.
+ * Boxes which are too crowded to fit their lists into MAX_PAIRS
+ * don't abort but use the full traversal, too.
+ */
+template<typename CARGO, int SIZE, int MAX_PAIRS = SIZE * 64>
+class VerletBoxCell : public BoxCell<FixedArray<CARGO, SIZE> >
+{
+public:
+    friend class VerletBoxCellTest;
+
+    typedef BoxCell<FixedArray<CARGO, SIZE> > Base;
+    typedef typename Base::Container Container;
+    typedef typename Base::Cargo Cargo;
+
+    const static int DIM = Base::DIM;
+
+    typedef SoABoxNeighborhood<Container, DIM> Boxes;
+
+    const static int NUM_BOXES = Boxes::NUM_BOXES;
+
+    /**
+     * Replaces the neighborhood handed to the particles' update():
+     * it iterates only over the particles in their Verlet list.
+     */
+    class VerletNeighborhood
+    {
+    public:
+        class Iterator
+        {
+        public:
+            inline Iterator(const Boxes *boxes, const int *cursor) :
+                boxes(boxes),
+                cursor(cursor)
+            {}
+
+            inline const Cargo& operator*() const
+            {
+                return (*boxes)[*cursor % NUM_BOXES][*cursor / NUM_BOXES];
+            }
+
+            inline const Cargo *operator->() const
+            {
+                return &**this;
+            }
+
+            inline Iterator& operator++()
+            {
+                ++cursor;
+                return *this;
+            }
+
+            inline bool operator==(const Iterator& other) const
+            {
+                return cursor == other.cursor;
+            }
+
+            inline bool operator!=(const Iterator& other) const
+            {
+                return cursor != other.cursor;
+            }
+
+        private:
+            const Boxes *boxes;
+            const int *cursor;
+        };
+
+        inline VerletNeighborhood(
+            VerletBoxCell *cell,
+            const Boxes *boxes,
+            const int *begin,
+            const int *end) :
+            cell(cell),
+            myBegin(boxes, begin),
+            myEnd(boxes, end)
+        {}
+
+        inline const Iterator& begin() const
+        {
+            return myBegin;
+        }
+
+        inline const Iterator& end() const
+        {
+            return myEnd;
+        }
+
+        template<typename PARTICLE>
+        void operator<<(const PARTICLE& particle)
+        {
+            (*cell) << particle;
+        }
+
+    private:
+        VerletBoxCell *cell;
+        Iterator myBegin;
+        Iterator myEnd;
+    };
+
+    inline explicit VerletBoxCell(
+        const FloatCoord<DIM>& origin = Coord<DIM>(),
+        const FloatCoord<DIM>& dimension = Coord<DIM>(),
+        const double cutoff = 0,
+        const double skin = 0) :
+        Base(origin, dimension),
+        cutoff(cutoff),
+        skin(skin),
+        stamp(0),
+        displaced(false)
+    {
+        std::fill(listStamps, listStamps + NUM_BOXES, -1);
+    }
+
+    inline void insert(const Cargo& particle)
+    {
+        Base::insert(particle);
+        displaced = true;
+    }
+
+    inline void remove(const std::size_t i)
+    {
+        Base::remove(i);
+        displaced = true;
+    }
+
+    inline VerletBoxCell& operator<<(const Cargo& cargo)
+    {
+        insert(cargo);
+        return *this;
+    }
+
+    template<class HOOD>
+    inline void update(HOOD& hood, const int nanoStep)
+    {
+        typedef CollectionInterface::PassThrough<typename HOOD::Cell> PassThroughType;
+        typedef typename Base::template NeighborhoodAdapter<Base, HOOD, PassThroughType>::Value NeighborhoodAdapterType;
+        NeighborhoodAdapterType adapter(this, &hood);
+
+        const VerletBoxCell& oldSelf = hood[Coord<DIM>()];
+        this->copyOver(oldSelf, adapter, nanoStep);
+        cutoff = oldSelf.cutoff;
+        skin = oldSelf.skin;
+
+        bool sameParticles = updateReferences(oldSelf, nanoStep);
+        bool useList = sameParticles && referencesValid(hood);
+
+        if (useList && !listMatches(hood)) {
+            if (oldSelf.listMatches(hood)) {
+                copyList(oldSelf);
+            } else {
+                buildList(hood);
+            }
+        }
+
+        // lists which didn't fit into MAX_PAIRS are left empty:
+        if (useList && (offsets.size() != 0)) {
+            Boxes boxes(hood);
+            updateFromList(boxes, nanoStep);
+        } else {
+            this->updateCargo(adapter, nanoStep);
+        }
+
+        checkDisplacement();
+    }
+
+    double getCutoff() const
+    {
+        return cutoff;
+    }
+
+    double getSkin() const
+    {
+        return skin;
+    }
+
+    template<class ARCHIVE>
+    void serialize(ARCHIVE& archive, unsigned version)
+    {
+        Base::serialize(archive, version);
+        archive & cutoff & skin & stamp & displaced;
+        archive & references & listStamps & offsets & pairs;
+    }
+
+private:
+    double cutoff;
+    double skin;
+    int stamp;
+    bool displaced;
+    FixedArray<FloatCoord<DIM>, SIZE> references;
+    int listStamps[NUM_BOXES];
+    FixedArray<int, SIZE + 1> offsets;
+    FixedArray<int, MAX_PAIRS> pairs;
+
+    /**
+     * Carries over the reference positions from the previous time
+     * step, unless particles have migrated or moved too far. Returns
+     * true iff the particles are the same as in oldSelf (and in the
+     * same order), so that oldSelf's lists still apply to them.
+     */
+    inline bool updateReferences(const VerletBoxCell& oldSelf, const int nanoStep)
+    {
+        bool sameParticles = true;
+
+        // BoxCell only regroups particles in nano step 0, and it
+        // preserves their order if none has crossed a box boundary:
+        if (nanoStep == 0) {
+            sameParticles = (this->particles.size() == oldSelf.particles.size());
+
+            for (std::size_t i = 0; sameParticles && (i < this->particles.size()); ++i) {
+                sameParticles = (this->particles[i].getPos() == oldSelf.particles[i].getPos());
+            }
+        }
+
+        if (sameParticles && !oldSelf.displaced && (oldSelf.references.size() == oldSelf.size())) {
+            // the stamp identifies the reference positions, so we
+            // don't need to copy them if we've got them already:
+            if (stamp != oldSelf.stamp) {
+                stamp = oldSelf.stamp;
+                copy(oldSelf.references, &references);
+            }
+
+            return sameParticles;
+        }
+
+        stamp = oldSelf.stamp + 1;
+        references.clear();
+        for (std::size_t i = 0; i < this->particles.size(); ++i) {
+            references << this->particles[i].getPos();
+        }
+
+        return sameParticles;
+    }
+
+    template<class HOOD>
+    inline bool referencesValid(const HOOD& hood) const
+    {
+        CoordBox<DIM> box(Coord<DIM>::diagonal(-1), Coord<DIM>::diagonal(3));
+
+        for (typename CoordBox<DIM>::Iterator i = box.begin(); i != box.end(); ++i) {
+            const VerletBoxCell& cell = hood[*i];
+            if (cell.displaced || (cell.references.size() != cell.size())) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    template<class HOOD>
+    inline bool listMatches(const HOOD& hood) const
+    {
+        CoordBox<DIM> box(Coord<DIM>::diagonal(-1), Coord<DIM>::diagonal(3));
+        int index = 0;
+
+        for (typename CoordBox<DIM>::Iterator i = box.begin(); i != box.end(); ++i) {
+            if (hood[*i].stamp != listStamps[index++]) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    inline void copyList(const VerletBoxCell& other)
+    {
+        std::copy(other.listStamps, other.listStamps + NUM_BOXES, listStamps);
+        copy(other.offsets, &offsets);
+        copy(other.pairs, &pairs);
+    }
+
+    /**
+     * Builds the lists from the reference positions (not the current
+     * ones), so they remain valid until any particle has moved more
+     * than skin/2 away from its reference. If the lists exceed
+     * MAX_PAIRS, offsets will be empty. The stamps are still
+     * recorded, so we won't retry until the neighborhood changes.
+     */
+    template<class HOOD>
+    inline void buildList(const HOOD& hood)
+    {
+        const VerletBoxCell& center = hood[Coord<DIM>()];
+        const VerletBoxCell *cells[NUM_BOXES];
+        FloatCoord<DIM> shifts[NUM_BOXES];
+        CoordBox<DIM> box(Coord<DIM>::diagonal(-1), Coord<DIM>::diagonal(3));
+        int index = 0;
+
+        for (typename CoordBox<DIM>::Iterator i = box.begin(); i != box.end(); ++i) {
+            cells[index] = &hood[*i];
+            listStamps[index] = cells[index]->stamp;
+
+            // neighbors beyond periodic boundaries are shifted to
+            // where they'd be without the wrap-around:
+            for (int d = 0; d < DIM; ++d) {
+                shifts[index][d] =
+                    center.origin[d] + (*i)[d] * center.dimension[d] - cells[index]->origin[d];
+            }
+
+            ++index;
+        }
+
+        double radius = cutoff + skin;
+        double radius2 = radius * radius;
+        offsets.clear();
+        pairs.clear();
+        offsets << 0;
+
+        for (std::size_t i = 0; i < center.references.size(); ++i) {
+            const FloatCoord<DIM>& pos = center.references[i];
+
+            for (int b = 0; b < NUM_BOXES; ++b) {
+                const FixedArray<FloatCoord<DIM>, SIZE>& candidates = cells[b]->references;
+                FloatCoord<DIM> offset = shifts[b] - pos;
+
+                for (std::size_t j = 0; j < candidates.size(); ++j) {
+                    FloatCoord<DIM> delta = candidates[j] + offset;
+                    if ((delta * delta) < radius2) {
+                        if (pairs.size() == pairs.capacity()) {
+                            offsets.clear();
+                            pairs.clear();
+                            return;
+                        }
+
+                        pairs << int(j * NUM_BOXES + b);
+                    }
+                }
+            }
+
+            offsets << int(pairs.size());
+        }
+    }
+
+    inline void updateFromList(const Boxes& boxes, const int nanoStep)
+    {
+        // we need to fix end here so particles inserted by update()
+        // won't be immediately updated, too:
+        std::size_t end = this->particles.size();
+
+        for (std::size_t i = 0; i < end; ++i) {
+            VerletNeighborhood hood(
+                this,
+                &boxes,
+                pairs.begin() + offsets[i],
+                pairs.begin() + offsets[i + 1]);
+            this->particles[i].update(hood, nanoStep);
+        }
+    }
+
+    inline void checkDisplacement()
+    {
+        displaced = (references.size() != this->particles.size());
+        double maxDisplacement2 = skin * skin * 0.25;
+
+        for (std::size_t i = 0; !displaced && (i < references.size()); ++i) {
+            FloatCoord<DIM> delta = this->particles[i].getPos() - references[i];
+            displaced = ((delta * delta) > maxDisplacement2);
+        }
+    }
+
+    /**
+     * Unlike the assignment operator this only copies the elements
+     * which are actually in use.
+     */
+    template<typename T, int CAPACITY>
+    static inline void copy(const FixedArray<T, CAPACITY>& source, FixedArray<T, CAPACITY> *target)
+    {
+        target->resize(source.size());
+        std::copy(source.begin(), source.end(), target->begin());
+    }
+};
+
+}
+
+#endif
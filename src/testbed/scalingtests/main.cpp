@@ -0,0 +1,176 @@
+#include <mpi.h>
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/testbed/scalingtests/models.h>
+#include <libgeodecomp/testbed/scalingtests/scalingbenchmark.h>
+#include <libflatarray/testbed/evaluate.hpp>
+
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+
+using namespace LibGeoDecomp;
+
+/**
+ * Parameters of the scaling matrix, see printUsage().
+ */
+class Options
+{
+public:
+    Options() :
+        steps(20)
+    {
+        sizes << 64 << 128;
+        widths << 1 << 2 << 4;
+
+        int maxThreads = 1;
+#ifdef LIBGEODECOMP_WITH_THREADS
+        maxThreads = omp_get_max_threads();
+#endif
+        for (int i = 1; i < maxThreads; i *= 2) {
+            threads << i;
+        }
+        threads << maxThreads;
+    }
+
+    std::string name;
+    std::string revision;
+    std::vector<int> sizes;
+    std::vector<int> threads;
+    std::vector<int> widths;
+    unsigned steps;
+};
+
+void printUsage(const std::string& program)
+{
+    std::cerr << "usage: " << program << " [OPTIONS] REVISION\n"
+              << "  -n, --name SUBSTRING  only run simulator/model combinations whose name contains SUBSTRING,\n"
+              << "  --sizes LIST          comma-separated edge lengths of the cubic (per core, for weak scaling) grids,\n"
+              << "  --threads LIST        comma-separated numbers of OpenMP threads,\n"
+              << "  --widths LIST         comma-separated ghost zone widths (HiParSimulator)\n"
+              << "                        or maximum pipeline lengths (CacheBlockingSimulator),\n"
+              << "  --steps N             number of time steps to measure,\n"
+              << "  REVISION is purely for output reasons.\n"
+              << "HiParSimulator is run on 1, 2, 4... and all ranks, StripingSimulator on all ranks,\n"
+              << "the remaining simulators on rank 0 only (best launched with a single rank).\n"
+              << "Each line of output lists (x, y, z, ranks, threads, ghostZoneWidth) as its dimensions\n"
+              << "and reports either MLUPS or the parallel efficiency relative to a SerialSimulator.\n";
+}
+
+std::vector<int> parseList(const std::string& list)
+{
+    std::vector<int> ret;
+    std::stringstream buf(list);
+    std::string item;
+
+    while (std::getline(buf, item, ',')) {
+        ret << std::atoi(item.c_str());
+    }
+
+    return ret;
+}
+
+bool parseOptions(int argc, char **argv, Options *options)
+{
+    int i = 1;
+    for (; i < (argc - 1); i += 2) {
+        std::string flag = argv[i];
+        std::string value = argv[i + 1];
+
+        if ((flag == "-n") || (flag == "--name")) {
+            options->name = value;
+        } else if (flag == "--sizes") {
+            options->sizes = parseList(value);
+        } else if (flag == "--threads") {
+            options->threads = parseList(value);
+        } else if (flag == "--widths") {
+            options->widths = parseList(value);
+        } else if (flag == "--steps") {
+            options->steps = std::atoi(value.c_str());
+        } else {
+            return false;
+        }
+    }
+
+    if (i != (argc - 1)) {
+        return false;
+    }
+
+    options->revision = argv[i];
+    return true;
+}
+
+template<typename RUNNER, typename MODEL>
+void sweep(LibFlatArray::evaluate& eval, const Options& options, bool output)
+{
+    typedef ScalingBenchmark<RUNNER, MODEL> BenchmarkType;
+
+    SharedPtr<ScalingResults>::Type results(new ScalingResults);
+    std::vector<int> rankCounts = RUNNER::rankCounts(MPILayer().size());
+    std::vector<int> threadCounts = RUNNER::THREADED ? options.threads : std::vector<int>(1, 1);
+    std::vector<int> widths = RUNNER::USES_GHOST_ZONE_WIDTH ? options.widths : std::vector<int>(1, 1);
+    ScalingMode modes[] = {STRONG_SCALING, WEAK_SCALING};
+
+    for (int mode = 0; mode < 2; ++mode) {
+        for (std::vector<int>::const_iterator size = options.sizes.begin(); size != options.sizes.end(); ++size) {
+            for (std::vector<int>::iterator ranks = rankCounts.begin(); ranks != rankCounts.end(); ++ranks) {
+                for (std::vector<int>::iterator threads = threadCounts.begin(); threads != threadCounts.end(); ++threads) {
+                    for (std::vector<int>::iterator width = widths.begin(); width != widths.end(); ++width) {
+                        Coord<3> dim = Coord<3>::diagonal(*size);
+                        if (modes[mode] == WEAK_SCALING) {
+                            dim.z() *= *ranks * *threads;
+                        }
+
+                        std::vector<int> params = toVector(dim);
+                        params << *ranks
+                               << *threads
+                               << *width;
+
+                        BenchmarkType benchmark(modes[mode], options.steps, results);
+                        eval(benchmark, params, output);
+                        eval(ScalingEfficiency(benchmark, results), params, output);
+                    }
+                }
+            }
+        }
+    }
+}
+
+int main(int argc, char **argv)
+{
+    MPI_Init(&argc, &argv);
+
+    Options options;
+    if (!parseOptions(argc, argv, &options)) {
+        if (MPILayer().rank() == 0) {
+            printUsage(argv[0]);
+        }
+        MPI_Finalize();
+        return 1;
+    }
+
+    LibFlatArray::evaluate eval(options.name, options.revision);
+
+    bool output = MPILayer().rank() == 0;
+    if (output) {
+        eval.print_header();
+    }
+
+    sweep<StripingSimulatorRunner, Jacobi3DModel>(eval, options, output);
+    sweep<StripingSimulatorRunner, LBMModel     >(eval, options, output);
+    sweep<HiParSimulatorRunner,    Jacobi3DModel>(eval, options, output);
+    sweep<HiParSimulatorRunner,    LBMModel     >(eval, options, output);
+    sweep<OpenMPSimulatorRunner,   Jacobi3DModel>(eval, options, output);
+    sweep<OpenMPSimulatorRunner,   LBMModel     >(eval, options, output);
+#ifdef LIBGEODECOMP_WITH_CPP14
+    // the unstructured grid isn't supported by the other simulators:
+    sweep<OpenMPSimulatorRunner,   SpMVMModel   >(eval, options, output);
+#endif
+#ifdef LIBGEODECOMP_WITH_THREADS
+    sweep<CacheBlockingSimulatorRunner, Jacobi3DModel>(eval, options, output);
+    sweep<CacheBlockingSimulatorRunner, LBMModel     >(eval, options, output);
+#endif
+
+    MPI_Finalize();
+    return 0;
+}
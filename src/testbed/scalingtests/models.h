@@ -0,0 +1,196 @@
+#ifndef LIBGEODECOMP_TESTBED_SCALINGTESTS_MODELS_H
+#define LIBGEODECOMP_TESTBED_SCALINGTESTS_MODELS_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/geometry/fixedcoord.h>
+#include <libgeodecomp/geometry/stencils.h>
+#include <libgeodecomp/io/simpleinitializer.h>
+#include <libgeodecomp/misc/apitraits.h>
+#include <libgeodecomp/testbed/performancetests/lbmcell.h>
+
+#include <map>
+#include <string>
+
+namespace LibGeoDecomp {
+
+/**
+ * Leaves all cells in their default state. This keeps the cost of
+ * initialization out of the measurements, just like the
+ * NoOpInitializer of the single core performance tests.
+ */
+template<typename CELL>
+class DefaultCellInitializer : public SimpleInitializer<CELL>
+{
+public:
+    typedef typename SimpleInitializer<CELL>::Topology Topology;
+
+    DefaultCellInitializer(
+        const Coord<Topology::DIM>& dimensions,
+        unsigned steps) :
+        SimpleInitializer<CELL>(dimensions, steps)
+    {}
+
+    virtual void grid(GridBase<CELL, Topology::DIM> *target)
+    {}
+};
+
+/**
+ * 3D 7-point Jacobi smoother: memory bound, few FLOPs per cell.
+ */
+class JacobiCell
+{
+public:
+    class API :
+        public APITraits::HasFixedCoordsOnlyUpdate,
+        public APITraits::HasStencil<Stencils::VonNeumann<3, 1> >,
+        public APITraits::HasCubeTopology<3>,
+        public APITraits::HasPredefinedMPIDataType<double>
+    {};
+
+    inline explicit JacobiCell(double temp = 1.0) :
+        temp(temp)
+    {}
+
+    template<typename COORD_MAP>
+    void update(const COORD_MAP& neighborhood, unsigned /* nanoStep */)
+    {
+        temp = (neighborhood[FixedCoord< 0,  0, -1>()].temp +
+                neighborhood[FixedCoord< 0, -1,  0>()].temp +
+                neighborhood[FixedCoord<-1,  0,  0>()].temp +
+                neighborhood[FixedCoord< 0,  0,  0>()].temp +
+                neighborhood[FixedCoord< 1,  0,  0>()].temp +
+                neighborhood[FixedCoord< 0,  1,  0>()].temp +
+                neighborhood[FixedCoord< 0,  0,  1>()].temp) * (1.0 / 7.0);
+    }
+
+    double temp;
+};
+
+class Jacobi3DModel
+{
+public:
+    typedef JacobiCell Cell;
+
+    static std::string name()
+    {
+        return "Jacobi3D";
+    }
+
+    static Initializer<Cell> *initializer(const Coord<3>& dim, unsigned steps)
+    {
+        return new DefaultCellInitializer<Cell>(dim, steps);
+    }
+};
+
+/**
+ * D3Q19 lattice Boltzmann method: larger cells and many more FLOPs
+ * per update than Jacobi3D.
+ */
+class LBMModel
+{
+public:
+    typedef LBMCell Cell;
+
+    static std::string name()
+    {
+        return "LBM";
+    }
+
+    static Initializer<Cell> *initializer(const Coord<3>& dim, unsigned steps)
+    {
+        return new DefaultCellInitializer<Cell>(dim, steps);
+    }
+};
+
+#ifdef LIBGEODECOMP_WITH_CPP14
+
+/**
+ * Sparse matrix-vector multiplication on an unstructured grid
+ * (SELL-C-SIGMA storage).
+ */
+class SpMVMCell
+{
+public:
+    class API :
+        public APITraits::HasUnstructuredTopology,
+        public APITraits::HasPredefinedMPIDataType<double>,
+        public APITraits::HasSellType<double>,
+        public APITraits::HasSellMatrices<1>,
+        public APITraits::HasSellC<4>,
+        public APITraits::HasSellSigma<1>
+    {};
+
+    inline explicit SpMVMCell(double value = 1.0) :
+        value(value),
+        sum(0)
+    {}
+
+    template<typename NEIGHBORHOOD>
+    void update(NEIGHBORHOOD& neighborhood, unsigned /* nanoStep */)
+    {
+        sum = 0;
+        for (const auto& j: neighborhood.weights(0)) {
+            sum += neighborhood[j.first()].value * j.second();
+        }
+    }
+
+    double value;
+    double sum;
+};
+
+/**
+ * Sets up the matrix of a 7-point stencil on a grid of the given
+ * dimensions, so one row corresponds to one cell of the stencil
+ * codes and the MLUPS figures remain comparable.
+ */
+class SpMVMInitializer : public SimpleInitializer<SpMVMCell>
+{
+public:
+    SpMVMInitializer(const Coord<3>& dim, unsigned steps) :
+        SimpleInitializer<SpMVMCell>(Coord<1>(dim.prod()), steps),
+        dim(dim)
+    {}
+
+    virtual void grid(GridBase<SpMVMCell, 1> *target)
+    {
+        std::map<Coord<2>, double> weights;
+        int offsets[] = { -dim.x() * dim.y(), -dim.x(), -1, 0, 1, dim.x(), dim.x() * dim.y() };
+        int size = dim.prod();
+
+        for (int row = 0; row < size; ++row) {
+            for (int i = 0; i < 7; ++i) {
+                int column = row + offsets[i];
+                if ((column >= 0) && (column < size)) {
+                    weights[Coord<2>(row, column)] = (offsets[i] == 0) ? 6.0 : -1.0;
+                }
+            }
+        }
+
+        target->setWeights(0, weights);
+    }
+
+private:
+    Coord<3> dim;
+};
+
+class SpMVMModel
+{
+public:
+    typedef SpMVMCell Cell;
+
+    static std::string name()
+    {
+        return "SpMVM";
+    }
+
+    static Initializer<Cell> *initializer(const Coord<3>& dim, unsigned steps)
+    {
+        return new SpMVMInitializer(dim, steps);
+    }
+};
+
+#endif
+
+}
+
+#endif
@@ -0,0 +1,406 @@
+#ifndef LIBGEODECOMP_TESTBED_SCALINGTESTS_SCALINGBENCHMARK_H
+#define LIBGEODECOMP_TESTBED_SCALINGTESTS_SCALINGBENCHMARK_H
+
+#include <libgeodecomp/config.h>
+#include <libgeodecomp/communication/mpilayer.h>
+#include <libgeodecomp/geometry/partitions/recursivebisectionpartition.h>
+#include <libgeodecomp/loadbalancer/noopbalancer.h>
+#include <libgeodecomp/misc/scopedtimer.h>
+#include <libgeodecomp/misc/sharedptr.h>
+#include <libgeodecomp/misc/stdcontaineroverloads.h>
+#include <libgeodecomp/parallelization/cacheblockingsimulator.h>
+#include <libgeodecomp/parallelization/hiparsimulator.h>
+#include <libgeodecomp/parallelization/openmpsimulator.h>
+#include <libgeodecomp/parallelization/serialsimulator.h>
+#include <libgeodecomp/parallelization/stripingsimulator.h>
+#include <libgeodecomp/testbed/performancetests/cpubenchmark.h>
+
+#include <map>
+#include <sstream>
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+#include <omp.h>
+#endif
+
+namespace LibGeoDecomp {
+
+namespace ScalingBenchmarkHelpers {
+
+/**
+ * Runs one step to get any lazy initialization out of the way, then
+ * measures the wall clock time of the given number of steps on all
+ * ranks of the communicator.
+ */
+template<typename SIMULATOR>
+double timeSteps(SIMULATOR *sim, unsigned steps, MPI_Comm communicator)
+{
+    sim->step();
+    MPI_Barrier(communicator);
+
+    double seconds = 0;
+    {
+        ScopedTimer t(&seconds);
+        for (unsigned i = 0; i < steps; ++i) {
+            sim->step();
+        }
+        MPI_Barrier(communicator);
+    }
+
+    return seconds;
+}
+
+}
+
+/**
+ * The runners below wrap the simulators under test. Each one says
+ * which knobs of the scaling matrix apply to it: the numbers of
+ * ranks it can be run on (rankCounts()), whether it uses OpenMP
+ * threads (THREADED) and whether it interprets the ghost zone width
+ * (USES_GHOST_ZONE_WIDTH).
+ */
+class SerialSimulatorRunner
+{
+public:
+    static const bool THREADED = false;
+    static const bool USES_GHOST_ZONE_WIDTH = false;
+
+    static std::string name()
+    {
+        return "SerialSimulator";
+    }
+
+    static std::vector<int> rankCounts(int /* worldSize */)
+    {
+        return std::vector<int>(1, 1);
+    }
+
+    template<typename MODEL>
+    static double run(const Coord<3>& dim, unsigned steps, int /* ghostZoneWidth */, MPI_Comm communicator)
+    {
+        SerialSimulator<typename MODEL::Cell> sim(MODEL::initializer(dim, steps + 1));
+        return ScalingBenchmarkHelpers::timeSteps(&sim, steps, communicator);
+    }
+};
+
+class OpenMPSimulatorRunner
+{
+public:
+    static const bool THREADED = true;
+    static const bool USES_GHOST_ZONE_WIDTH = false;
+
+    static std::string name()
+    {
+        return "OpenMPSimulator";
+    }
+
+    static std::vector<int> rankCounts(int /* worldSize */)
+    {
+        return std::vector<int>(1, 1);
+    }
+
+    template<typename MODEL>
+    static double run(const Coord<3>& dim, unsigned steps, int /* ghostZoneWidth */, MPI_Comm communicator)
+    {
+        OpenMPSimulator<typename MODEL::Cell> sim(MODEL::initializer(dim, steps + 1));
+        return ScalingBenchmarkHelpers::timeSteps(&sim, steps, communicator);
+    }
+};
+
+#ifdef LIBGEODECOMP_WITH_THREADS
+
+/**
+ * The ghost zone width bounds the pipeline length of the temporal
+ * blocking. As step() would advance one time step at a time (and
+ * thus defeat temporal blocking), we time run() instead. The
+ * models' initializers are no-ops, so this doesn't skew the results.
+ */
+class CacheBlockingSimulatorRunner
+{
+public:
+    static const bool THREADED = true;
+    static const bool USES_GHOST_ZONE_WIDTH = true;
+
+    static std::string name()
+    {
+        return "CacheBlockingSimulator";
+    }
+
+    static std::vector<int> rankCounts(int /* worldSize */)
+    {
+        return std::vector<int>(1, 1);
+    }
+
+    template<typename MODEL>
+    static double run(const Coord<3>& dim, unsigned steps, int ghostZoneWidth, MPI_Comm communicator)
+    {
+        typedef CacheBlockingSimulator<typename MODEL::Cell> SimulatorType;
+
+        int pipelineLength;
+        Coord<2> wavefrontDim;
+        SimulatorType::autoTune(
+            dim,
+            SimulatorType::cacheSize(),
+            omp_get_max_threads(),
+            &pipelineLength,
+            &wavefrontDim,
+            ghostZoneWidth);
+        SimulatorType sim(MODEL::initializer(dim, steps), pipelineLength, wavefrontDim);
+
+        MPI_Barrier(communicator);
+        double seconds = 0;
+        {
+            ScopedTimer t(&seconds);
+            sim.run();
+            MPI_Barrier(communicator);
+        }
+
+        return seconds;
+    }
+};
+
+#endif
+
+class StripingSimulatorRunner
+{
+public:
+    static const bool THREADED = false;
+    static const bool USES_GHOST_ZONE_WIDTH = false;
+
+    static std::string name()
+    {
+        return "StripingSimulator";
+    }
+
+    /**
+     * StripingSimulator always spans MPI_COMM_WORLD.
+     */
+    static std::vector<int> rankCounts(int worldSize)
+    {
+        return std::vector<int>(1, worldSize);
+    }
+
+    template<typename MODEL>
+    static double run(const Coord<3>& dim, unsigned steps, int /* ghostZoneWidth */, MPI_Comm communicator)
+    {
+        MPILayer mpiLayer(communicator);
+        StripingSimulator<typename MODEL::Cell> sim(
+            MODEL::initializer(dim, steps + 1),
+            (mpiLayer.rank() == 0) ? new NoOpBalancer : 0);
+        return ScalingBenchmarkHelpers::timeSteps(&sim, steps, communicator);
+    }
+};
+
+class HiParSimulatorRunner
+{
+public:
+    static const bool THREADED = true;
+    static const bool USES_GHOST_ZONE_WIDTH = true;
+
+    static std::string name()
+    {
+        return "HiParSimulator";
+    }
+
+    /**
+     * Powers of two and all ranks.
+     */
+    static std::vector<int> rankCounts(int worldSize)
+    {
+        std::vector<int> ret;
+        for (int i = 1; i < worldSize; i *= 2) {
+            ret << i;
+        }
+        ret << worldSize;
+
+        return ret;
+    }
+
+    template<typename MODEL>
+    static double run(const Coord<3>& dim, unsigned steps, int ghostZoneWidth, MPI_Comm communicator)
+    {
+        HiParSimulator<typename MODEL::Cell, RecursiveBisectionPartition<3> > sim(
+            MODEL::initializer(dim, steps + 1),
+            0,
+            steps + 1,
+            ghostZoneWidth,
+            false,
+            communicator);
+        return ScalingBenchmarkHelpers::timeSteps(&sim, steps, communicator);
+    }
+};
+
+enum ScalingMode {STRONG_SCALING, WEAK_SCALING};
+
+/**
+ * Measurements shared among the copies of a ScalingBenchmark (which
+ * LibFlatArray::evaluate takes by value) and the corresponding
+ * ScalingEfficiency.
+ */
+class ScalingResults
+{
+public:
+    ScalingResults() :
+        efficiency(0)
+    {}
+
+    /**
+     * MLUPS of a SerialSimulator, indexed by model and grid size.
+     */
+    std::map<std::string, double> baselines;
+    double efficiency;
+};
+
+/**
+ * Measures the performance of SIMULATOR_RUNNER for MODEL in MLUPS
+ * (million lattice updates per second). The "dimensions" passed to
+ * performance() encode all parameters of the run, which makes each
+ * line of output self-contained:
+ *
+ *   (x, y, z, ranks, threads, ghostZoneWidth)
+ *
+ * x, y, z give the global grid size. Only the first "ranks" ranks of
+ * MPI_COMM_WORLD participate, all others idle.
+ *
+ * Parallel efficiency is computed relative to a SerialSimulator (run
+ * on rank 0) and reported through a separate ScalingEfficiency. For
+ * strong scaling the baseline uses the same grid, for weak scaling
+ * the grid is shrunk by the degree of parallelism (ranks times
+ * threads) along the z-axis. An efficiency of 1 means perfect
+ * scaling.
+ */
+template<typename SIMULATOR_RUNNER, typename MODEL>
+class ScalingBenchmark : public CPUBenchmark
+{
+public:
+    ScalingBenchmark(
+        ScalingMode mode,
+        unsigned steps,
+        const SharedPtr<ScalingResults>::Type& results) :
+        mode(mode),
+        steps(steps),
+        results(results)
+    {}
+
+    std::string family()
+    {
+        return SIMULATOR_RUNNER::name() + "<" + MODEL::name() + ">";
+    }
+
+    std::string species()
+    {
+        return (mode == STRONG_SCALING) ? "strong" : "weak";
+    }
+
+    double performance(std::vector<int> rawDim)
+    {
+        Coord<3> dim(rawDim[0], rawDim[1], rawDim[2]);
+        int ranks = rawDim[3];
+        int threads = rawDim[4];
+        int ghostZoneWidth = rawDim[5];
+
+        double mlups = measure<SIMULATOR_RUNNER>(dim, ranks, threads, ghostZoneWidth);
+
+        Coord<3> baselineDim = dim;
+        if (mode == WEAK_SCALING) {
+            baselineDim.z() /= ranks * threads;
+        }
+        results->efficiency = mlups / (ranks * threads * baseline(baselineDim));
+
+        return mlups;
+    }
+
+    std::string unit()
+    {
+        return "MLUPS";
+    }
+
+private:
+    ScalingMode mode;
+    unsigned steps;
+    SharedPtr<ScalingResults>::Type results;
+
+    template<typename RUNNER>
+    double measure(const Coord<3>& dim, int ranks, int threads, int ghostZoneWidth)
+    {
+        MPILayer world;
+        bool participating = world.rank() < ranks;
+
+        MPI_Comm communicator;
+        MPI_Comm_split(
+            world.communicator(),
+            participating ? 0 : MPI_UNDEFINED,
+            world.rank(),
+            &communicator);
+
+        double seconds = 0;
+        if (participating) {
+#ifdef LIBGEODECOMP_WITH_THREADS
+            omp_set_num_threads(threads);
+#endif
+            seconds = RUNNER::template run<MODEL>(dim, steps, ghostZoneWidth, communicator);
+            MPI_Comm_free(&communicator);
+        }
+
+        return world.broadcast(1e-6 * steps * dim.prod() / seconds, 0);
+    }
+
+    double baseline(const Coord<3>& dim)
+    {
+        std::stringstream key;
+        key << MODEL::name() << dim;
+
+        std::map<std::string, double>::iterator i = results->baselines.find(key.str());
+        if (i != results->baselines.end()) {
+            return i->second;
+        }
+
+        double mlups = measure<SerialSimulatorRunner>(dim, 1, 1, 1);
+        results->baselines[key.str()] = mlups;
+        return mlups;
+    }
+};
+
+/**
+ * Reports the parallel efficiency determined by the preceding run of
+ * the ScalingBenchmark it was created from, without running anything
+ * itself.
+ */
+class ScalingEfficiency : public CPUBenchmark
+{
+public:
+    template<typename SCALING_BENCHMARK>
+    explicit ScalingEfficiency(SCALING_BENCHMARK benchmark, const SharedPtr<ScalingResults>::Type& results) :
+        familyName(benchmark.family()),
+        speciesName(benchmark.species()),
+        results(results)
+    {}
+
+    std::string family()
+    {
+        return familyName;
+    }
+
+    std::string species()
+    {
+        return speciesName;
+    }
+
+    double performance(std::vector<int> /* rawDim */)
+    {
+        return results->efficiency;
+    }
+
+    std::string unit()
+    {
+        return "efficiency";
+    }
+
+private:
+    std::string familyName;
+    std::string speciesName;
+    SharedPtr<ScalingResults>::Type results;
+};
+
+}
+
+#endif
@@ -23,6 +23,7 @@
 #include <libgeodecomp/storage/unstructuredsoagrid.h>
 #include <libgeodecomp/storage/unstructuredsoaneighborhood.h>
 #include <libgeodecomp/storage/unstructuredupdatefunctor.h>
+#include <libgeodecomp/storage/updatefunctor.h>
 #include <libgeodecomp/testbed/spmvmtests/mmio.h>
 
 #include <libflatarray/short_vec.hpp>
@@ -105,15 +106,15 @@ public:
         auto sumPtr = &hoodNew->sum();
         int offs = 0;
 #pragma loop count(1000)
-        for (int i = hoodOld.index(); i < indexEnd; ++i, ++hoodOld) {
-            tmp.load_aligned(sumPtr + i * C);
+        for (int i = hoodOld.index(); i < indexEnd / C; ++i, ++hoodOld, sumPtr += C) {
+            tmp.load_aligned(sumPtr);
             for (const auto& j: hoodOld.weights(0)) {
                 weights.load_aligned(matPtr + offs);
                 values.gather(&hoodOld->value(), indPtr + offs);
                 tmp += values * weights;
                 offs += C;
             }
-            tmp.store_aligned(sumPtr + i * C);
+            tmp.store_aligned(sumPtr);
         }
     }
 #else
@@ -121,14 +122,15 @@ public:
     static void updateLineX(HOOD_NEW& hoodNew, int indexEnd, HOOD_OLD& hoodOld, unsigned /* nanoStep */)
     {
         ShortVec tmp, weights, values;
-        for (int i = hoodOld.index(); i < indexEnd; ++i, ++hoodOld) {
-            tmp.load_aligned(&hoodNew->sum() + i * C);
+        double *sumPtr = &hoodNew->sum();
+        for (int i = hoodOld.index(); i < indexEnd / C; ++i, ++hoodOld, sumPtr += C) {
+            tmp.load_aligned(sumPtr);
             for (const auto& j: hoodOld.weights(0)) {
                 weights.load_aligned(j.second());
                 values.gather(&hoodOld->value(), j.first());
                 tmp += values * weights;
             }
-            tmp.store_aligned(&hoodNew->sum() + i * C);
+            tmp.store_aligned(sumPtr);
         }
     }
 #endif
@@ -362,8 +364,15 @@ private:
     {
         gridOld.callback(
             gridNew,
-            UnstructuredUpdateFunctorHelpers::UnstructuredGridSoAUpdateHelper<CELL>(
-                gridOld, gridNew, region, nanoStep));
+            UnstructuredUpdateFunctorHelpers::UnstructuredGridSoAUpdateHelper<
+                CELL,
+                UpdateFunctorHelpers::ConcurrencyNoP,
+                typename APITraits::SelectThreadedUpdate<CELL>::Value>(
+                    gridOld,
+                    region,
+                    nanoStep,
+                    UpdateFunctorHelpers::ConcurrencyNoP(),
+                    typename APITraits::SelectThreadedUpdate<CELL>::Value()));
     }
 
 public: